@@ -0,0 +1,206 @@
+/*
+    Copyright (C) 2018-present, SKALE Labs
+
+    This file is part of skaled.
+
+    skaled is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skaled is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with skaled.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * @file KeyBloomFilter.cpp
+ * @date 2020
+ */
+
+#include "KeyBloomFilter.h"
+
+#include "SHA3.h"
+
+#include <boost/filesystem/fstream.hpp>
+
+namespace dev {
+namespace db {
+
+namespace {
+
+const size_t c_bitsPerKey = 12;
+const size_t c_bitsPerKeyInBlock = 8;  // gives <1% false positives with 12 bits per key
+const size_t c_wordsPerBlock = 8;      // 512-bit blocks, one cache line
+const size_t c_growthFactor = 4;       // few segments keep total false positive rate low
+const uint64_t c_fileMagic = 0x3246424b59454bULL;  // "KEYBF2"
+
+// stable across builds and platforms as filters are persisted
+uint64_t hashKey( Slice _key ) {
+    uint64_t h = 0xcbf29ce484222325ULL;  // FNV-1a
+    for ( char c : _key ) {
+        h ^= static_cast< unsigned char >( c );
+        h *= 0x100000001b3ULL;
+    }
+    // splitmix64 finalizer spreads similar keys
+    h ^= h >> 30;
+    h *= 0xbf58476d1ce4e5b9ULL;
+    h ^= h >> 27;
+    h *= 0x94d049bb133111ebULL;
+    h ^= h >> 31;
+    return h;
+}
+
+}  // namespace
+
+KeyBloomFilter::KeyBloomFilter( size_t _expectedKeys ) {
+    m_segments.push_back( makeSegment( std::max< size_t >( _expectedKeys, 64 ) ) );
+}
+
+KeyBloomFilter::Segment KeyBloomFilter::makeSegment( uint64_t _capacity ) {
+    Segment s;
+    s.capacity = _capacity;
+    size_t blocks = ( _capacity * c_bitsPerKey + 511 ) / 512;
+    s.words.resize( blocks * c_wordsPerBlock );
+    return s;
+}
+
+bool KeyBloomFilter::test( Segment const& _segment, uint64_t _hash ) {
+    size_t blocks = _segment.words.size() / c_wordsPerBlock;
+    uint64_t const* block = &_segment.words[( _hash % blocks ) * c_wordsPerBlock];
+    uint64_t h = _hash / blocks;
+    uint64_t delta = ( _hash >> 33 ) | 1;
+    for ( size_t i = 0; i < c_bitsPerKeyInBlock; ++i ) {
+        unsigned bit = ( h + i * delta ) % 512;
+        if ( !( block[bit / 64] & ( uint64_t( 1 ) << ( bit % 64 ) ) ) )
+            return false;
+    }
+    return true;
+}
+
+void KeyBloomFilter::add( Slice _key ) {
+    uint64_t hash = hashKey( _key );
+
+    std::unique_lock< std::shared_mutex > lock( m_mutex );
+    if ( m_segments.back().count >= m_segments.back().capacity )
+        m_segments.push_back( makeSegment( m_segments.back().capacity * c_growthFactor ) );
+
+    Segment& s = m_segments.back();
+    size_t blocks = s.words.size() / c_wordsPerBlock;
+    uint64_t* block = &s.words[( hash % blocks ) * c_wordsPerBlock];
+    uint64_t h = hash / blocks;
+    uint64_t delta = ( hash >> 33 ) | 1;
+    for ( size_t i = 0; i < c_bitsPerKeyInBlock; ++i ) {
+        unsigned bit = ( h + i * delta ) % 512;
+        block[bit / 64] |= uint64_t( 1 ) << ( bit % 64 );
+    }
+    ++s.count;
+}
+
+bool KeyBloomFilter::mayContain( Slice _key ) const {
+    uint64_t hash = hashKey( _key );
+
+    std::shared_lock< std::shared_mutex > lock( m_mutex );
+    for ( auto const& s : m_segments )
+        if ( test( s, hash ) )
+            return true;
+    return false;
+}
+
+size_t KeyBloomFilter::keyCount() const {
+    std::shared_lock< std::shared_mutex > lock( m_mutex );
+    size_t count = 0;
+    for ( auto const& s : m_segments )
+        count += s.count;
+    return count;
+}
+
+void KeyBloomFilter::save( boost::filesystem::path const& _path, h256 const& _identity ) const {
+    bytes data;
+    auto append = [&data]( uint64_t _value ) {
+        for ( size_t i = 0; i < 8; ++i )
+            data.push_back( _byte_( _value >> ( 8 * i ) ) );
+    };
+
+    {
+        std::shared_lock< std::shared_mutex > lock( m_mutex );
+        append( c_fileMagic );
+        data.insert( data.end(), _identity.begin(), _identity.end() );
+        append( m_segments.size() );
+        for ( auto const& s : m_segments ) {
+            append( s.capacity );
+            append( s.count );
+            append( s.words.size() );
+            for ( uint64_t w : s.words )
+                append( w );
+        }
+    }
+    h256 checksum = sha3( data );
+    data.insert( data.end(), checksum.begin(), checksum.end() );
+
+    boost::filesystem::path tmp = _path;
+    tmp += ".tmp";
+    {
+        boost::filesystem::ofstream out( tmp, std::ios::binary | std::ios::trunc );
+        out.write( reinterpret_cast< char const* >( data.data() ), data.size() );
+        if ( !out )
+            BOOST_THROW_EXCEPTION( FileError() << errinfo_path( tmp.string() ) );
+    }
+    boost::filesystem::rename( tmp, _path );
+}
+
+std::unique_ptr< KeyBloomFilter > KeyBloomFilter::load(
+    boost::filesystem::path const& _path, h256 const& _identity ) {
+    boost::system::error_code ec;
+    if ( !boost::filesystem::exists( _path, ec ) )
+        return nullptr;
+
+    boost::filesystem::ifstream in( _path, std::ios::binary );
+    bytes data( ( std::istreambuf_iterator< char >( in ) ), std::istreambuf_iterator< char >() );
+    if ( data.size() < h256::size )
+        return nullptr;
+    bytesConstRef content( data.data(), data.size() - h256::size );
+    if ( sha3( content ) != h256( bytesConstRef( data.data() + content.size(), h256::size ) ) )
+        return nullptr;
+
+    size_t pos = 0;
+    auto read = [&]( uint64_t& _value ) {
+        if ( pos + 8 > content.size() )
+            return false;
+        _value = 0;
+        for ( size_t i = 0; i < 8; ++i )
+            _value |= uint64_t( content[pos++] ) << ( 8 * i );
+        return true;
+    };
+
+    uint64_t magic, segments;
+    if ( !read( magic ) || magic != c_fileMagic )
+        return nullptr;
+    if ( content.size() - pos < h256::size ||
+         h256( content.cropped( pos, h256::size ) ) != _identity )
+        return nullptr;
+    pos += h256::size;
+    if ( !read( segments ) || segments == 0 )
+        return nullptr;
+
+    std::unique_ptr< KeyBloomFilter > filter( new KeyBloomFilter );
+    filter->m_segments.clear();
+    for ( uint64_t i = 0; i < segments; ++i ) {
+        Segment s;
+        uint64_t words;
+        if ( !read( s.capacity ) || !read( s.count ) || !read( words ) || words == 0 ||
+             words % c_wordsPerBlock != 0 || words > ( content.size() - pos ) / 8 )
+            return nullptr;
+        s.words.resize( words );
+        for ( auto& w : s.words )
+            read( w );
+        filter->m_segments.push_back( std::move( s ) );
+    }
+    return filter;
+}
+
+}  // namespace db
+}  // namespace dev
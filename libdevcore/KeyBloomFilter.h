@@ -0,0 +1,78 @@
+/*
+    Copyright (C) 2018-present, SKALE Labs
+
+    This file is part of skaled.
+
+    skaled is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skaled is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with skaled.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * @file KeyBloomFilter.h
+ * @date 2020
+ */
+
+#pragma once
+
+#include "db.h"
+
+#include <boost/filesystem.hpp>
+
+#include <memory>
+#include <shared_mutex>
+#include <vector>
+
+namespace dev {
+namespace db {
+
+/**
+ * @brief Blocked bloom filter of database keys. It never gives false negatives, so a database
+ * need not be read when the filter says it can't contain a key.
+ * It grows by adding bigger segments when the last one is full, which keeps false positive rate
+ * bounded without knowing number of keys beforehand.
+ * @threadsafe
+ */
+class KeyBloomFilter {
+public:
+    explicit KeyBloomFilter( size_t _expectedKeys = 1024 );
+
+    void add( Slice _key );
+    bool mayContain( Slice _key ) const;
+
+    /// Number of keys added, repeated ones are counted every time.
+    size_t keyCount() const;
+
+    /// Writes filter to @a _path replacing it atomically. @a _identity names the set of keys the
+    /// filter was built for, so that a filter of other or changed data is not used by mistake.
+    void save( boost::filesystem::path const& _path, h256 const& _identity ) const;
+    /// @returns filter saved to @a _path or nullptr if it is missing, damaged or was saved with
+    /// other @a _identity.
+    static std::unique_ptr< KeyBloomFilter > load(
+        boost::filesystem::path const& _path, h256 const& _identity );
+
+private:
+    /// Set of 512-bit blocks, all bits of a key are set in one block
+    struct Segment {
+        std::vector< uint64_t > words;
+        uint64_t capacity = 0;  ///< Keys the segment is sized for
+        uint64_t count = 0;     ///< Keys added to the segment
+    };
+
+    static Segment makeSegment( uint64_t _capacity );
+    static bool test( Segment const& _segment, uint64_t _hash );
+
+    mutable std::shared_mutex m_mutex;
+    std::vector< Segment > m_segments;
+};
+
+}  // namespace db
+}  // namespace dev
@@ -19,11 +19,16 @@
 
 #include "LevelDB.h"
 #include "Assertions.h"
+#include "MultisetHash.h"
 
 #include <libdevcore/microprofile.h>
 
 #include <secp256k1_sha256.h>
 
+#include <boost/optional.hpp>
+
+#include <map>
+
 namespace dev {
 namespace db {
 
@@ -72,6 +77,90 @@ private:
     leveldb::WriteBatch m_writeBatch;
 };
 
+// Marker of digests presence, digest of every key prefix is stored under it + prefix byte.
+// These records are not visible through DatabaseFace
+const std::string c_digestKeyPrefix =
+    "b5d9ab46d9b808fa03977c17f523080ac49a2da59aa213762e35e36e02cd322f";
+
+bool isDigestKey( leveldb::Slice const& _key ) {
+    return ( _key.size() == c_digestKeyPrefix.size() ||
+               _key.size() == c_digestKeyPrefix.size() + 1 ) &&
+           _key.starts_with( c_digestKeyPrefix );
+}
+
+std::string digestKey( unsigned char _prefix ) {
+    return c_digestKeyPrefix + char( _prefix );
+}
+
+unsigned char keyPrefix( leveldb::Slice const& _key ) {
+    return _key.empty() ? 0 : _key[0];
+}
+
+h256 recordHash( leveldb::Slice const& _key, leveldb::Slice const& _value ) {
+    secp256k1_sha256_t ctx;
+    secp256k1_sha256_initialize( &ctx );
+    // key size makes boundary between key and value unambiguous
+    h64 const keySize( static_cast< unsigned >( _key.size() ) );
+    secp256k1_sha256_write( &ctx, keySize.data(), keySize.size );
+    secp256k1_sha256_write(
+        &ctx, reinterpret_cast< unsigned char const* >( _key.data() ), _key.size() );
+    secp256k1_sha256_write(
+        &ctx, reinterpret_cast< unsigned char const* >( _value.data() ), _value.size() );
+    h256 hash;
+    secp256k1_sha256_finalize( &ctx, hash.data() );
+    return hash;
+}
+
+// Collects changes of key prefix digests made by write batch operations.
+// Digest of a prefix is a multiset hash of all its records,
+// so it does not depend on order of writes and is updated per record
+class DigestUpdater : public leveldb::WriteBatch::Handler {
+public:
+    DigestUpdater( leveldb::DB& _db, leveldb::ReadOptions const& _readOptions )
+        : m_db( _db ), m_readOptions( _readOptions ) {}
+
+    void Put( leveldb::Slice const& _key, leveldb::Slice const& _value ) override {
+        if ( isDigestKey( _key ) )
+            return;
+        remove( _key );
+        m_deltas[keyPrefix( _key )].insert( recordHash( _key, _value ) );
+        m_values[_key.ToString()] = _value.ToString();
+    }
+
+    void Delete( leveldb::Slice const& _key ) override {
+        if ( isDigestKey( _key ) )
+            return;
+        remove( _key );
+        m_values[_key.ToString()] = boost::none;
+    }
+
+    std::map< unsigned char, MultisetHash > const& deltas() const { return m_deltas; }
+
+private:
+    void remove( leveldb::Slice const& _key ) {
+        boost::optional< std::string > previous;
+        auto const pending = m_values.find( _key.ToString() );
+        if ( pending != m_values.end() )
+            previous = pending->second;
+        else {
+            std::string value;
+            auto const status = m_db.Get( m_readOptions, _key, &value );
+            if ( !status.IsNotFound() ) {
+                checkStatus( status );
+                previous = std::move( value );
+            }
+        }
+        if ( previous )
+            m_deltas[keyPrefix( _key )].erase( recordHash( _key, *previous ) );
+    }
+
+    leveldb::DB& m_db;
+    leveldb::ReadOptions const& m_readOptions;
+    // values written by preceding operations of the batch
+    std::map< std::string, boost::optional< std::string > > m_values;
+    std::map< unsigned char, MultisetHash > m_deltas;
+};
+
 void LevelDBWriteBatch::insert( Slice _key, Slice _value ) {
     MICROPROFILE_SCOPEI( "LevelDBWriteBatch", "insert", MP_LAVENDERBLUSH );
     m_writeBatch.Put( toLDBSlice( _key ), toLDBSlice( _value ) );
@@ -109,6 +198,13 @@ LevelDB::LevelDB( boost::filesystem::path const& _path, leveldb::ReadOptions _re
 
     assert( db );
     m_db.reset( db );
+
+    std::string marker;
+    auto const markerStatus = m_db->Get( m_readOptions, c_digestKeyPrefix, &marker );
+    if ( !markerStatus.IsNotFound() ) {
+        checkStatus( markerStatus );
+        m_storedDigests = true;
+    }
 }
 
 std::string LevelDB::lookup( Slice _key ) const {
@@ -136,14 +232,16 @@ bool LevelDB::exists( Slice _key ) const {
 void LevelDB::insert( Slice _key, Slice _value ) {
     leveldb::Slice const key( _key.data(), _key.size() );
     leveldb::Slice const value( _value.data(), _value.size() );
-    auto const status = m_db->Put( m_writeOptions, key, value );
-    checkStatus( status );
+    leveldb::WriteBatch batch;
+    batch.Put( key, value );
+    write( batch );
 }
 
 void LevelDB::kill( Slice _key ) {
     leveldb::Slice const key( _key.data(), _key.size() );
-    auto const status = m_db->Delete( m_writeOptions, key );
-    checkStatus( status );
+    leveldb::WriteBatch batch;
+    batch.Delete( key );
+    write( batch );
 }
 
 std::unique_ptr< WriteBatchFace > LevelDB::createWriteBatch() const {
@@ -159,8 +257,7 @@ void LevelDB::commit( std::unique_ptr< WriteBatchFace > _batch ) {
         BOOST_THROW_EXCEPTION(
             DatabaseError() << errinfo_comment( "Invalid batch type passed to LevelDB::commit" ) );
     }
-    auto const status = m_db->Write( m_writeOptions, &batchPtr->writeBatch() );
-    checkStatus( status );
+    write( batchPtr->writeBatch() );
 }
 
 void LevelDB::forEach( std::function< bool( Slice, Slice ) > f ) const {
@@ -170,6 +267,8 @@ void LevelDB::forEach( std::function< bool( Slice, Slice ) > f ) const {
     }
     auto keepIterating = true;
     for ( itr->SeekToFirst(); keepIterating && itr->Valid(); itr->Next() ) {
+        if ( isDigestKey( itr->key() ) )
+            continue;
         auto const dbKey = itr->key();
         auto const dbValue = itr->value();
         Slice const key( dbKey.data(), dbKey.size() );
@@ -179,6 +278,42 @@ void LevelDB::forEach( std::function< bool( Slice, Slice ) > f ) const {
 }
 
 h256 LevelDB::hashBase() const {
+    if ( !m_digestsEnabled )
+        return recomputeHashBase();
+    std::lock_guard< std::mutex > lock( m_writeMutex );
+    MultisetHash digest;
+    for ( auto const& prefixDigest : m_digests )
+        digest += prefixDigest;
+    return digest.hash();
+}
+
+h256 LevelDB::hashBaseWithPrefix( char _prefix ) const {
+    if ( m_digestsEnabled ) {
+        std::lock_guard< std::mutex > lock( m_writeMutex );
+        return m_digests[static_cast< unsigned char >( _prefix )].hash();
+    }
+    std::unique_ptr< leveldb::Iterator > it( m_db->NewIterator( m_readOptions ) );
+    if ( it == nullptr ) {
+        BOOST_THROW_EXCEPTION( DatabaseError() << errinfo_comment( "null iterator" ) );
+    }
+    MultisetHash digest;
+    leveldb::Slice const prefix( &_prefix, 1 );
+    for ( it->Seek( prefix ); it->Valid() && it->key().starts_with( prefix ); it->Next() ) {
+        if ( isDigestKey( it->key() ) )
+            continue;
+        digest.insert( recordHash( it->key(), it->value() ) );
+    }
+    return digest.hash();
+}
+
+h256 LevelDB::recomputeHashBase() const {
+    MultisetHash digest;
+    for ( auto const& prefixDigest : computeDigests() )
+        digest += prefixDigest;
+    return digest.hash();
+}
+
+h256 LevelDB::legacyHashBase() const {
     std::unique_ptr< leveldb::Iterator > it( m_db->NewIterator( m_readOptions ) );
     if ( it == nullptr ) {
         BOOST_THROW_EXCEPTION( DatabaseError() << errinfo_comment( "null iterator" ) );
@@ -186,38 +321,135 @@ h256 LevelDB::hashBase() const {
     secp256k1_sha256_t ctx;
     secp256k1_sha256_initialize( &ctx );
     for ( it->SeekToFirst(); it->Valid(); it->Next() ) {
-        std::string key_ = it->key().ToString();
-        std::string value_ = it->value().ToString();
-        std::string key_value = key_ + value_;
-        const std::vector< uint8_t > usc( key_value.begin(), key_value.end() );
-        bytesConstRef str_key_value( usc.data(), usc.size() );
-        secp256k1_sha256_write( &ctx, str_key_value.data(), str_key_value.size() );
+        // digests are absent in databases of nodes that don't maintain them
+        if ( isDigestKey( it->key() ) )
+            continue;
+        secp256k1_sha256_write( &ctx,
+            reinterpret_cast< unsigned char const* >( it->key().data() ), it->key().size() );
+        secp256k1_sha256_write( &ctx,
+            reinterpret_cast< unsigned char const* >( it->value().data() ), it->value().size() );
     }
     h256 hash;
     secp256k1_sha256_finalize( &ctx, hash.data() );
     return hash;
 }
 
-h256 LevelDB::hashBaseWithPrefix( char _prefix ) const {
+void LevelDB::rebuildDigests() {
+    std::lock_guard< std::mutex > lock( m_writeMutex );
+    Digests digests = computeDigests();
+
+    leveldb::WriteBatch batch;
     std::unique_ptr< leveldb::Iterator > it( m_db->NewIterator( m_readOptions ) );
     if ( it == nullptr ) {
         BOOST_THROW_EXCEPTION( DatabaseError() << errinfo_comment( "null iterator" ) );
     }
-    secp256k1_sha256_t ctx;
-    secp256k1_sha256_initialize( &ctx );
-    for ( it->SeekToFirst(); it->Valid(); it->Next() ) {
-        if ( it->key()[0] == _prefix ) {
-            std::string key_ = it->key().ToString();
-            std::string value_ = it->value().ToString();
-            std::string key_value = key_ + value_;
-            const std::vector< uint8_t > usc( key_value.begin(), key_value.end() );
-            bytesConstRef str_key_value( usc.data(), usc.size() );
-            secp256k1_sha256_write( &ctx, str_key_value.data(), str_key_value.size() );
+    for ( it->Seek( c_digestKeyPrefix ); it->Valid() && it->key().starts_with( c_digestKeyPrefix );
+          it->Next() )
+        if ( isDigestKey( it->key() ) )
+            batch.Delete( it->key() );
+    for ( size_t prefix = 0; prefix < digests.size(); ++prefix )
+        if ( !digests[prefix].empty() ) {
+            bytes const digest = digests[prefix].toBytes();
+            batch.Put( digestKey( prefix ),
+                leveldb::Slice( reinterpret_cast< char const* >( digest.data() ), digest.size() ) );
         }
+    batch.Put( c_digestKeyPrefix, leveldb::Slice() );
+    checkStatus( m_db->Write( m_writeOptions, &batch ) );
+
+    m_digests = std::move( digests );
+    m_storedDigests = true;
+    m_digestsEnabled = true;
+}
+
+void LevelDB::enableDigests() {
+    if ( !m_digestsEnabled )
+        loadDigests();
+}
+
+void LevelDB::loadDigests() {
+    m_digests.assign( c_prefixCount, MultisetHash() );
+
+    if ( !m_storedDigests ) {
+        // new database or one written without digests
+        rebuildDigests();
+        return;
     }
-    h256 hash;
-    secp256k1_sha256_finalize( &ctx, hash.data() );
-    return hash;
+
+    std::unique_ptr< leveldb::Iterator > it( m_db->NewIterator( m_readOptions ) );
+    if ( it == nullptr ) {
+        BOOST_THROW_EXCEPTION( DatabaseError() << errinfo_comment( "null iterator" ) );
+    }
+    for ( it->Seek( c_digestKeyPrefix ); it->Valid() && it->key().starts_with( c_digestKeyPrefix );
+          it->Next() ) {
+        if ( it->key().size() != c_digestKeyPrefix.size() + 1 )
+            continue;
+        if ( it->value().size() != MultisetHash::c_size ) {
+            // digests of another format
+            it.reset();
+            rebuildDigests();
+            return;
+        }
+        unsigned char const prefix = it->key()[c_digestKeyPrefix.size()];
+        m_digests[prefix] = MultisetHash( bytesConstRef(
+            reinterpret_cast< _byte_ const* >( it->value().data() ), it->value().size() ) );
+    }
+    m_digestsEnabled = true;
+}
+
+void LevelDB::write( leveldb::WriteBatch& _batch ) {
+    if ( m_digestsEnabled ) {
+        writeWithDigests( _batch );
+        return;
+    }
+    bool const dropMarker = m_storedDigests.exchange( false );
+    if ( dropMarker )
+        _batch.Delete( c_digestKeyPrefix );
+    auto const status = m_db->Write( m_writeOptions, &_batch );
+    if ( !status.ok() && dropMarker )
+        m_storedDigests = true;
+    checkStatus( status );
+}
+
+void LevelDB::writeWithDigests( leveldb::WriteBatch& _batch ) {
+    std::lock_guard< std::mutex > lock( m_writeMutex );
+
+    DigestUpdater updater( *m_db, m_readOptions );
+    checkStatus( _batch.Iterate( &updater ) );
+
+    std::map< unsigned char, MultisetHash > digests;
+    for ( auto const& prefixDelta : updater.deltas() ) {
+        MultisetHash& digest = digests[prefixDelta.first];
+        digest = m_digests[prefixDelta.first];
+        digest += prefixDelta.second;
+        if ( digest.empty() )
+            _batch.Delete( digestKey( prefixDelta.first ) );
+        else {
+            bytes const serialized = digest.toBytes();
+            _batch.Put( digestKey( prefixDelta.first ),
+                leveldb::Slice(
+                    reinterpret_cast< char const* >( serialized.data() ), serialized.size() ) );
+        }
+    }
+
+    auto const status = m_db->Write( m_writeOptions, &_batch );
+    checkStatus( status );
+
+    for ( auto const& prefixDigest : digests )
+        m_digests[prefixDigest.first] = prefixDigest.second;
+}
+
+LevelDB::Digests LevelDB::computeDigests() const {
+    std::unique_ptr< leveldb::Iterator > it( m_db->NewIterator( m_readOptions ) );
+    if ( it == nullptr ) {
+        BOOST_THROW_EXCEPTION( DatabaseError() << errinfo_comment( "null iterator" ) );
+    }
+    Digests digests( c_prefixCount );
+    for ( it->SeekToFirst(); it->Valid(); it->Next() ) {
+        if ( isDigestKey( it->key() ) )
+            continue;
+        digests[keyPrefix( it->key() )].insert( recordHash( it->key(), it->value() ) );
+    }
+    return digests;
 }
 
 }  // namespace db
@@ -19,12 +19,17 @@
 
 #pragma once
 
+#include "MultisetHash.h"
 #include "db.h"
 
 #include <leveldb/db.h>
 #include <leveldb/write_batch.h>
 #include <boost/filesystem.hpp>
 
+#include <atomic>
+#include <mutex>
+#include <vector>
+
 namespace dev {
 namespace db {
 class LevelDB : public DatabaseFace {
@@ -48,13 +53,57 @@ public:
 
     void forEach( std::function< bool( Slice, Slice ) > f ) const override;
 
+    /// Order-independent hash of all records. With digests enabled it is maintained on every
+    /// write and stored in the database itself, so no records are read here; otherwise all
+    /// records are read.
     h256 hashBase() const override;
+    /// Same as hashBase() but only for records with keys starting with @a _prefix.
     h256 hashBaseWithPrefix( char _prefix ) const;
 
+    /// Computes hashBase() by reading all records, ignoring stored digests. Doesn't write.
+    h256 recomputeHashBase() const;
+
+    /// Hash of all records in order of keys, as computed before digests were introduced.
+    /// Reads all records.
+    h256 legacyHashBase() const;
+
+    /// Makes every write from now on maintain digests of key prefixes, so that hashBase() is
+    /// cheap. Reads stored digests, or computes them by reading all records if they are missing
+    /// or stale, e.g. on first use with an existing database. Call before any writes.
+    void enableDigests();
+    bool digestsEnabled() const { return m_digestsEnabled; }
+    /// @returns true if digests were maintained by all writes so far, and so enableDigests()
+    /// needn't read the records.
+    bool hasStoredDigests() const { return m_storedDigests; }
+
+    /// Replaces stored digests with ones computed from records and enables them.
+    void rebuildDigests();
+
 private:
+    using Digests = std::vector< MultisetHash >;
+    static constexpr size_t c_prefixCount = 256;
+
+    /// Reads stored digests or computes and stores them if there are none yet.
+    void loadDigests();
+    /// Writes @a _batch, with digest changes of its operations if digests are enabled.
+    void write( leveldb::WriteBatch& _batch );
+    /// Adds digest changes of the @a _batch operations to the batch and writes it.
+    void writeWithDigests( leveldb::WriteBatch& _batch );
+    /// Scans all records computing digest of every key prefix.
+    Digests computeDigests() const;
+
     std::unique_ptr< leveldb::DB > m_db;
     leveldb::ReadOptions const m_readOptions;
     leveldb::WriteOptions const m_writeOptions;
+
+    bool m_digestsEnabled = false;
+    /// Marker of stored digests is present. Digests get stale with the first write made
+    /// without them, so that write removes the marker and they are rebuilt once enabled again.
+    std::atomic< bool > m_storedDigests{false};
+    /// Multiset hashes of records by first byte of key.
+    Digests m_digests;
+    /// Serializes writes as digests depend on previous values of records.
+    mutable std::mutex m_writeMutex;
 };
 
 }  // namespace db
@@ -1,5 +1,9 @@
 #include "ManuallyRotatingLevelDB.h"
 
+#include <libdevcore/Log.h>
+#include <libdevcore/RLP.h>
+#include <libdevcore/SHA3.h>
+
 #include <secp256k1_sha256.h>
 
 namespace dev {
@@ -10,11 +14,78 @@ namespace {
 const std::string current_piece_mark_key =
     "ead48ec575aaa7127384dee432fc1c02d9f6a22950234e5ecf59f35ed9f6e78d";
 
+// Write batch of the current piece remembering keys to be added to its filter
+class FilteredWriteBatch : public WriteBatchFace {
+public:
+    explicit FilteredWriteBatch( std::unique_ptr< WriteBatchFace > _batch )
+        : m_batch( std::move( _batch ) ) {}
+
+    void insert( Slice _key, Slice _value ) override {
+        m_batch->insert( _key, _value );
+        m_keys.emplace_back( _key.begin(), _key.end() );
+    }
+    void kill( Slice _key ) override { m_batch->kill( _key ); }
+
+    std::unique_ptr< WriteBatchFace > release() { return std::move( m_batch ); }
+    std::vector< std::string > const& keys() const { return m_keys; }
+
+private:
+    std::unique_ptr< WriteBatchFace > m_batch;
+    std::vector< std::string > m_keys;
+};
+
 }  // namespace
 
+boost::filesystem::path ManuallyRotatingLevelDB::filterPath( size_t _file_no ) const {
+    return base_path / ( std::to_string( _file_no ) + ".filter" );
+}
+
+h256 ManuallyRotatingLevelDB::pieceIdentity( Piece const& _piece ) const {
+    // without digests hashBase() reads all records, so only the piece number is bound then
+    if ( !maintain_digests )
+        return sha3( rlpList( _piece.file_no ) );
+    return sha3( rlpList( _piece.file_no, _piece.db->hashBase() ) );
+}
+
+LevelDB* ManuallyRotatingLevelDB::openPiece( const boost::filesystem::path& _path ) const {
+    std::unique_ptr< LevelDB > db( new LevelDB( _path ) );
+    if ( maintain_digests )
+        db->enableDigests();
+    return db.release();
+}
+
+void ManuallyRotatingLevelDB::dropFilters( const boost::filesystem::path& _path ) {
+    if ( !boost::filesystem::is_directory( _path ) )
+        return;
+    for ( auto const& entry : boost::filesystem::directory_iterator( _path ) )
+        if ( entry.path().extension() == ".filter" )
+            boost::filesystem::remove( entry.path() );
+}
+
+void ManuallyRotatingLevelDB::openFilter( Piece& _piece, bool _isCurrent ) {
+    boost::filesystem::path path = filterPath( _piece.file_no );
+    _piece.filter = KeyBloomFilter::load( path, pieceIdentity( _piece ) );
+
+    // current piece filter is saved on close only, so it is never stale after a crash
+    if ( _isCurrent )
+        boost::filesystem::remove( path );
+
+    if ( _piece.filter )
+        return;
+
+    _piece.filter.reset( new KeyBloomFilter );
+    _piece.db->forEach( [&_piece]( Slice _key, Slice ) -> bool {
+        _piece.filter->add( _key );
+        return true;
+    } );
+    // other pieces are not written to any more
+    if ( !_isCurrent )
+        _piece.filter->save( path, pieceIdentity( _piece ) );
+}
+
 ManuallyRotatingLevelDB::ManuallyRotatingLevelDB(
-    const boost::filesystem::path& _path, size_t _nPieces )
-    : base_path( _path ) {
+    const boost::filesystem::path& _path, size_t _nPieces, bool _maintainDigests )
+    : base_path( _path ), maintain_digests( _maintainDigests ) {
     std::unique_lock< std::shared_mutex > lock( m_mutex );
 
     size_t current_i = _nPieces;
@@ -22,9 +93,11 @@ ManuallyRotatingLevelDB::ManuallyRotatingLevelDB(
     // open and find min size
     for ( size_t i = 0; i < _nPieces; ++i ) {
         boost::filesystem::path path = base_path / ( std::to_string( i ) + ".db" );
-        DatabaseFace* db = new LevelDB( path );
+        DatabaseFace* db = openPiece( path );
 
-        pieces.emplace_back( db );
+        pieces.emplace_back( new Piece );
+        pieces.back()->db.reset( db );
+        pieces.back()->file_no = i;
 
         if ( db->exists( current_piece_mark_key ) ) {
             if ( current_i != _nPieces ) {
@@ -46,13 +119,25 @@ ManuallyRotatingLevelDB::ManuallyRotatingLevelDB(
 
     // rotate so min_i will be first
     for ( size_t i = 0; i < current_i; ++i ) {
-        std::unique_ptr< DatabaseFace > el = std::move( pieces.front() );
+        std::unique_ptr< Piece > el = std::move( pieces.front() );
         pieces.pop_front();
         pieces.push_back( std::move( el ) );
     }  // for
 
     this->current_piece = pieces.front().get();
     this->current_piece_file_no = current_i;
+
+    for ( const auto& p : pieces )
+        openFilter( *p, p.get() == current_piece );
+}
+
+ManuallyRotatingLevelDB::~ManuallyRotatingLevelDB() {
+    try {
+        current_piece->filter->save(
+            filterPath( current_piece_file_no ), pieceIdentity( *current_piece ) );
+    } catch ( const std::exception& ex ) {
+        cwarn << "Cannot save key filter of " << base_path << ": " << ex.what();
+    }
 }
 
 void ManuallyRotatingLevelDB::rotate() {
@@ -61,7 +146,10 @@ void ManuallyRotatingLevelDB::rotate() {
     assert( this->batch_cache.empty() );
     // we delete one below and make it current
 
-    current_piece->kill( current_piece_mark_key );
+    current_piece->db->kill( current_piece_mark_key );
+    // old current piece is not written to any more
+    current_piece->filter->save(
+        filterPath( current_piece_file_no ), pieceIdentity( *current_piece ) );
 
     int old_db_no = current_piece_file_no - 1;
     if ( old_db_no < 0 )
@@ -70,64 +158,92 @@ void ManuallyRotatingLevelDB::rotate() {
 
     pieces.pop_back();  // will delete here
     boost::filesystem::remove_all( old_path );
+    boost::filesystem::remove( filterPath( old_db_no ) );
 
-    DatabaseFace* new_db = new LevelDB( old_path );
-    pieces.emplace_front( new_db );
+    Piece* new_piece = new Piece;
+    new_piece->db.reset( openPiece( old_path ) );
+    new_piece->filter.reset( new KeyBloomFilter );
+    new_piece->file_no = old_db_no;
+    pieces.emplace_front( new_piece );
 
     current_piece_file_no = old_db_no;
-    current_piece = new_db;
+    current_piece = new_piece;
 
-    current_piece->insert( current_piece_mark_key, std::string( "" ) );
+    current_piece->filter->add( current_piece_mark_key );
+    current_piece->db->insert( current_piece_mark_key, std::string( "" ) );
+}
+
+bool ManuallyRotatingLevelDB::probe(
+    Slice _key, std::function< bool( DatabaseFace& ) > const& _probe ) const {
+    for ( const auto& p : pieces ) {
+        ++p->probes;
+        if ( !p->filter->mayContain( _key ) ) {
+            ++p->skipped;
+            continue;
+        }
+        if ( _probe( *p->db ) ) {
+            ++p->hits;
+            return true;
+        }
+        ++p->falsePositives;
+    }
+    return false;
 }
 
 std::string ManuallyRotatingLevelDB::lookup( Slice _key ) const {
     std::shared_lock< std::shared_mutex > lock( m_mutex );
 
-    for ( const auto& p : pieces ) {
-        const std::string& v = p->lookup( _key );
-        if ( !v.empty() )
-            return v;
-    }
-    return std::string();
+    std::string v;
+    probe( _key, [&]( DatabaseFace& _db ) {
+        v = _db.lookup( _key );
+        return !v.empty();
+    } );
+    return v;
 }
 
 bool ManuallyRotatingLevelDB::exists( Slice _key ) const {
     std::shared_lock< std::shared_mutex > lock( m_mutex );
 
-    for ( const auto& p : pieces ) {
-        if ( p->exists( _key ) )
-            return true;
-    }
-    return false;
+    return probe( _key, [&]( DatabaseFace& _db ) { return _db.exists( _key ); } );
 }
 
 void ManuallyRotatingLevelDB::insert( Slice _key, Slice _value ) {
     std::shared_lock< std::shared_mutex > lock( m_mutex );
-    current_piece->insert( _key, _value );
+    // filter first so that the key is never missed once it is written
+    current_piece->filter->add( _key );
+    current_piece->db->insert( _key, _value );
 }
 
 void ManuallyRotatingLevelDB::kill( Slice _key ) {
     std::shared_lock< std::shared_mutex > lock( m_mutex );
+    // pieces that can't contain the key need no tombstone
     for ( const auto& p : pieces )
-        p->kill( _key );
+        if ( p->filter->mayContain( _key ) )
+            p->db->kill( _key );
 }
 
 std::unique_ptr< WriteBatchFace > ManuallyRotatingLevelDB::createWriteBatch() const {
     std::shared_lock< std::shared_mutex > lock( m_mutex );
-    std::unique_ptr< WriteBatchFace > wbf = current_piece->createWriteBatch();
+    std::unique_ptr< WriteBatchFace > wbf(
+        new FilteredWriteBatch( current_piece->db->createWriteBatch() ) );
     batch_cache.insert( wbf.get() );
     return wbf;
 }
 void ManuallyRotatingLevelDB::commit( std::unique_ptr< WriteBatchFace > _batch ) {
     std::shared_lock< std::shared_mutex > lock( m_mutex );
     batch_cache.erase( _batch.get() );
-    current_piece->commit( std::move( _batch ) );
+    auto* batch = dynamic_cast< FilteredWriteBatch* >( _batch.get() );
+    if ( !batch )
+        BOOST_THROW_EXCEPTION( DatabaseError() << errinfo_comment( "invalid batch type" ) );
+    for ( const auto& key : batch->keys() )
+        current_piece->filter->add( key );
+    current_piece->db->commit( batch->release() );
 }
 
 void ManuallyRotatingLevelDB::forEach( std::function< bool( Slice, Slice ) > f ) const {
     std::shared_lock< std::shared_mutex > lock( m_mutex );
     for ( const auto& p : pieces ) {
-        p->forEach( f );
+        p->db->forEach( f );
     }
 }
 
@@ -137,7 +253,7 @@ h256 ManuallyRotatingLevelDB::hashBase() const {
     secp256k1_sha256_initialize( &ctx );
 
     for ( const auto& p : pieces ) {
-        h256 h = p->hashBase();
+        h256 h = p->db->hashBase();
         secp256k1_sha256_write( &ctx, h.data(), h.size );
     }  // for
 
@@ -146,5 +262,20 @@ h256 ManuallyRotatingLevelDB::hashBase() const {
     return hash;
 }
 
+std::vector< ManuallyRotatingLevelDB::PieceStats > ManuallyRotatingLevelDB::pieceStats() const {
+    std::shared_lock< std::shared_mutex > lock( m_mutex );
+    std::vector< PieceStats > ret;
+    for ( const auto& p : pieces ) {
+        PieceStats s;
+        s.probes = p->probes;
+        s.skipped = p->skipped;
+        s.hits = p->hits;
+        s.falsePositives = p->falsePositives;
+        s.filterKeys = p->filter->keyCount();
+        ret.push_back( s );
+    }
+    return ret;
+}
+
 }  // namespace db
 }  // namespace dev
@@ -1,8 +1,10 @@
 #ifndef ROTATINGLEVELDB_H
 #define ROTATINGLEVELDB_H
 
+#include "KeyBloomFilter.h"
 #include "LevelDB.h"
 
+#include <atomic>
 #include <deque>
 #include <set>
 #include <shared_mutex>
@@ -11,18 +13,59 @@ namespace dev {
 namespace db {
 
 class ManuallyRotatingLevelDB : public DatabaseFace {
+public:
+    /// Lookup counters of a piece since it was opened
+    struct PieceStats {
+        uint64_t probes = 0;          ///< Lookups and exists checks that reached the piece
+        uint64_t skipped = 0;         ///< Probes answered by the key filter without reading
+        uint64_t hits = 0;            ///< Probes that found the key in the piece
+        uint64_t falsePositives = 0;  ///< Probes passed by the filter that found nothing
+        size_t filterKeys = 0;        ///< Keys in the piece filter
+    };
+
 private:
+    struct Piece {
+        std::unique_ptr< DatabaseFace > db;
+        std::unique_ptr< KeyBloomFilter > filter;
+        size_t file_no;
+        std::atomic< uint64_t > probes{0};
+        std::atomic< uint64_t > skipped{0};
+        std::atomic< uint64_t > hits{0};
+        std::atomic< uint64_t > falsePositives{0};
+    };
+
     const boost::filesystem::path base_path;
-    DatabaseFace* current_piece;
+    const bool maintain_digests;
+    Piece* current_piece;
     size_t current_piece_file_no;
-    std::deque< std::unique_ptr< DatabaseFace > > pieces;
+    std::deque< std::unique_ptr< Piece > > pieces;
 
     mutable std::set< WriteBatchFace* > batch_cache;
 
     mutable std::shared_mutex m_mutex;
 
+    boost::filesystem::path filterPath( size_t _file_no ) const;
+    /// Identifies the records of the piece, a saved filter is used only if it matches
+    h256 pieceIdentity( Piece const& _piece ) const;
+    /// Opens the piece database at @a _path, maintaining digests if they are enabled
+    LevelDB* openPiece( const boost::filesystem::path& _path ) const;
+    /// Reads saved filter of the piece or builds it from the piece records
+    void openFilter( Piece& _piece, bool _isCurrent );
+    /// Checks pieces that may contain the key, calls @a _probe for each until it returns true
+    bool probe( Slice _key, std::function< bool( DatabaseFace& ) > const& _probe ) const;
+
 public:
-    ManuallyRotatingLevelDB( const boost::filesystem::path& _path, size_t _nPieces );
+    /// With @a _maintainDigests, pieces keep their hashBase() up to date on every write, see
+    /// LevelDB::enableDigests()
+    ManuallyRotatingLevelDB(
+        const boost::filesystem::path& _path, size_t _nPieces, bool _maintainDigests = false );
+    ~ManuallyRotatingLevelDB();
+
+    /// Removes saved filters of the database at @a _path so that they are rebuilt from records
+    /// on next open. Filters are not covered by snapshot hash, so this is needed after pieces
+    /// were replaced from outside, e.g. by a snapshot.
+    static void dropFilters( const boost::filesystem::path& _path );
+
     void rotate();
 
     virtual std::string lookup( Slice _key ) const;
@@ -35,6 +78,9 @@ public:
 
     virtual void forEach( std::function< bool( Slice, Slice ) > f ) const;
     virtual h256 hashBase() const;
+
+    /// Statistics of pieces from the current one to the oldest
+    std::vector< PieceStats > pieceStats() const;
 };
 
 }  // namespace db
@@ -0,0 +1,101 @@
+/*
+    Copyright (C) 2018-present, SKALE Labs
+
+    This file is part of skaled.
+
+    skaled is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skaled is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with skaled.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * @file MultisetHash.cpp
+ * @date 2020
+ */
+
+#include "MultisetHash.h"
+
+#include <secp256k1_sha256.h>
+
+#include <stdexcept>
+
+namespace dev {
+
+MultisetHash::MultisetHash( bytesConstRef _bytes ) {
+    if ( _bytes.size() != c_size )
+        throw std::invalid_argument( "Invalid size of serialized multiset hash" );
+    for ( size_t i = 0; i < c_lanes; ++i )
+        m_lanes[i] = uint16_t( _bytes[2 * i] | ( _bytes[2 * i + 1] << 8 ) );
+}
+
+MultisetHash::Lanes MultisetHash::expand( h256 const& _element ) {
+    // SHA-256 in counter mode, 16 lanes per block
+    Lanes lanes;
+    for ( uint32_t block = 0; block < c_size / h256::size; ++block ) {
+        unsigned char const counter[4] = {uint8_t( block >> 24 ), uint8_t( block >> 16 ),
+            uint8_t( block >> 8 ), uint8_t( block )};
+        secp256k1_sha256_t ctx;
+        secp256k1_sha256_initialize( &ctx );
+        secp256k1_sha256_write( &ctx, _element.data(), h256::size );
+        secp256k1_sha256_write( &ctx, counter, sizeof( counter ) );
+        h256 out;
+        secp256k1_sha256_finalize( &ctx, out.data() );
+        for ( size_t i = 0; i < h256::size / 2; ++i )
+            lanes[block * h256::size / 2 + i] = uint16_t( out[2 * i] | ( out[2 * i + 1] << 8 ) );
+    }
+    return lanes;
+}
+
+void MultisetHash::insert( h256 const& _element ) {
+    Lanes const lanes = expand( _element );
+    for ( size_t i = 0; i < c_lanes; ++i )
+        m_lanes[i] += lanes[i];
+}
+
+void MultisetHash::erase( h256 const& _element ) {
+    Lanes const lanes = expand( _element );
+    for ( size_t i = 0; i < c_lanes; ++i )
+        m_lanes[i] -= lanes[i];
+}
+
+MultisetHash& MultisetHash::operator+=( MultisetHash const& _other ) {
+    for ( size_t i = 0; i < c_lanes; ++i )
+        m_lanes[i] += _other.m_lanes[i];
+    return *this;
+}
+
+bool MultisetHash::empty() const {
+    for ( uint16_t lane : m_lanes )
+        if ( lane != 0 )
+            return false;
+    return true;
+}
+
+bytes MultisetHash::toBytes() const {
+    bytes ret( c_size );
+    for ( size_t i = 0; i < c_lanes; ++i ) {
+        ret[2 * i] = uint8_t( m_lanes[i] );
+        ret[2 * i + 1] = uint8_t( m_lanes[i] >> 8 );
+    }
+    return ret;
+}
+
+h256 MultisetHash::hash() const {
+    bytes const serialized = toBytes();
+    secp256k1_sha256_t ctx;
+    secp256k1_sha256_initialize( &ctx );
+    secp256k1_sha256_write( &ctx, serialized.data(), serialized.size() );
+    h256 ret;
+    secp256k1_sha256_finalize( &ctx, ret.data() );
+    return ret;
+}
+
+}  // namespace dev
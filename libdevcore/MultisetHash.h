@@ -0,0 +1,75 @@
+/*
+    Copyright (C) 2018-present, SKALE Labs
+
+    This file is part of skaled.
+
+    skaled is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skaled is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with skaled.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * @file MultisetHash.h
+ * @date 2020
+ */
+
+#pragma once
+
+#include "FixedHash.h"
+
+#include <array>
+
+namespace dev {
+
+/**
+ * @brief Homomorphic hash of a multiset of 256-bit elements (LtHash by Bellare and Micciancio).
+ * Every element is expanded by SHA-256 into 1024 16-bit lanes, and the state is the lane-wise
+ * sum of the expanded elements modulo 2^16. So elements can be inserted and erased in any order,
+ * and states of disjoint multisets can be added.
+ * Unlike a plain 256-bit sum of element hashes, which generalized birthday attacks can forge,
+ * finding a collision requires solving a lattice problem of about 200-bit security.
+ */
+class MultisetHash {
+public:
+    static constexpr size_t c_lanes = 1024;
+    /// Size of the serialized state.
+    static constexpr size_t c_size = c_lanes * sizeof( uint16_t );
+
+    MultisetHash() { m_lanes.fill( 0 ); }
+    /// Reads state serialized with toBytes(). Throws if @a _bytes has wrong size.
+    explicit MultisetHash( bytesConstRef _bytes );
+
+    void insert( h256 const& _element );
+    void erase( h256 const& _element );
+
+    MultisetHash& operator+=( MultisetHash const& _other );
+
+    bool operator==( MultisetHash const& _other ) const { return m_lanes == _other.m_lanes; }
+    bool operator!=( MultisetHash const& _other ) const { return m_lanes != _other.m_lanes; }
+
+    /// @returns true for the state of an empty multiset.
+    bool empty() const;
+
+    /// Little-endian lanes.
+    bytes toBytes() const;
+
+    /// SHA-256 of toBytes().
+    h256 hash() const;
+
+private:
+    using Lanes = std::array< uint16_t, c_lanes >;
+
+    static Lanes expand( h256 const& _element );
+
+    Lanes m_lanes;
+};
+
+}  // namespace dev
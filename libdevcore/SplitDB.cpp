@@ -5,6 +5,15 @@
 namespace dev {
 namespace db {
 
+namespace {
+std::string prefixedKey( char _prefix, Slice _key ) {
+    std::string key;
+    key.reserve( _key.size() + 1 );
+    key.push_back( _prefix );
+    key.append( _key.data(), _key.size() );
+    return key;
+}
+}  // namespace
 
 SplitDB::SplitDB( std::shared_ptr< DatabaseFace > _backend ) : backend( _backend ) {}
 
@@ -20,6 +29,43 @@ DatabaseFace* SplitDB::newInterface() {
     return pdb;
 }
 
+WriteBatchFace& SplitDB::WriteBatch::operator[]( DatabaseFace* _interface ) {
+    auto it = parts.find( _interface );
+    if ( it != parts.end() )
+        return *it->second;
+
+    PrefixedDB* pdb = nullptr;
+    for ( auto const& i : split.interfaces )
+        if ( i.get() == _interface )
+            pdb = static_cast< PrefixedDB* >( i.get() );
+    if ( !pdb )
+        BOOST_THROW_EXCEPTION( DatabaseError() << errinfo_comment( "foreign interface" ) );
+
+    return *parts.emplace( _interface, std::make_unique< Part >( *backend, pdb->getPrefix() ) )
+                .first->second;
+}
+
+void SplitDB::WriteBatch::Part::insert( Slice _key, Slice _value ) {
+    std::string const key = prefixedKey( prefix, _key );
+    backend.insert( Slice( key ), _value );
+}
+
+void SplitDB::WriteBatch::Part::kill( Slice _key ) {
+    std::string const key = prefixedKey( prefix, _key );
+    backend.kill( Slice( key ) );
+}
+
+std::unique_ptr< SplitDB::WriteBatch > SplitDB::createWriteBatch() {
+    std::unique_ptr< WriteBatch > batch( new WriteBatch( *this ) );
+    batch->backend = backend->createWriteBatch();
+    return batch;
+}
+
+void SplitDB::commit( std::unique_ptr< WriteBatch > _batch ) {
+    _batch->parts.clear();
+    backend->commit( std::move( _batch->backend ) );
+}
+
 SplitDB::PrefixedWriteBatchFace::PrefixedWriteBatchFace(
     std::unique_ptr< WriteBatchFace > _backend, char _prefix )
     : backend( std::move( _backend ) ), prefix( _prefix ) {}
@@ -5,12 +5,41 @@
 
 #include <boost/filesystem.hpp>
 
+#include <map>
 #include <shared_mutex>
 
 namespace dev {
 namespace db {
 
 class SplitDB {
+public:
+    /// Batch of writes into several interfaces that is committed by one write to the backend
+    class WriteBatch {
+    public:
+        /// Part of the batch writing into @a _interface, which must come from the same SplitDB
+        WriteBatchFace& operator[]( DatabaseFace* _interface );
+
+    private:
+        friend class SplitDB;
+
+        // passes writes to the backend batch with the prefix of its interface
+        struct Part : public WriteBatchFace {
+            Part( WriteBatchFace& _backend, char _prefix )
+              : backend( _backend ), prefix( _prefix ) {}
+            void insert( Slice _key, Slice _value ) override;
+            void kill( Slice _key ) override;
+
+            WriteBatchFace& backend;
+            char prefix;
+        };
+
+        explicit WriteBatch( SplitDB& _split ) : split( _split ) {}
+
+        SplitDB& split;
+        std::unique_ptr< WriteBatchFace > backend;
+        std::map< DatabaseFace*, std::unique_ptr< Part > > parts;
+    };
+
 private:
     struct PrefixedWriteBatchFace : public WriteBatchFace {
         PrefixedWriteBatchFace( std::unique_ptr< WriteBatchFace > _backend, char _prefix );
@@ -37,6 +66,8 @@ private:
         virtual void forEach( std::function< bool( Slice, Slice ) > f ) const;
         virtual h256 hashBase() const;
 
+        char getPrefix() const { return prefix; }
+
     private:
         char prefix;
         DatabaseFace* backend;
@@ -48,6 +79,10 @@ public:
     SplitDB( std::shared_ptr< DatabaseFace > _backend );
     DatabaseFace* newInterface();
 
+    std::unique_ptr< WriteBatch > createWriteBatch();
+    /// Writes the batch to the backend at once
+    void commit( std::unique_ptr< WriteBatch > _batch );
+
 private:
     std::shared_ptr< DatabaseFace > backend;
     std::vector< std::shared_ptr< DatabaseFace > > interfaces;
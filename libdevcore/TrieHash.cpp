@@ -23,11 +23,18 @@
 
 namespace dev {
 
-void hash256aux( HexMap const& _s, HexMap::const_iterator _begin, HexMap::const_iterator _end,
-    unsigned _preLen, RLPStream& _rlp );
+namespace {
+// nibble keys mapped to values referenced in place, so that they are not copied
+using HexRefMap = std::map< bytes, bytesConstRef >;
+}  // namespace
 
-void hash256rlp( HexMap const& _s, HexMap::const_iterator _begin, HexMap::const_iterator _end,
-    unsigned _preLen, RLPStream& _rlp ) {
+template < class Map >
+void hash256aux( Map const& _s, typename Map::const_iterator _begin,
+    typename Map::const_iterator _end, unsigned _preLen, RLPStream& _rlp );
+
+template < class Map >
+void hash256rlp( Map const& _s, typename Map::const_iterator _begin,
+    typename Map::const_iterator _end, unsigned _preLen, RLPStream& _rlp ) {
     if ( _begin == _end )
         _rlp << "";  // NULL
     else if ( std::next( _begin ) == _end ) {
@@ -76,8 +83,9 @@ void hash256rlp( HexMap const& _s, HexMap::const_iterator _begin, HexMap::const_
     }
 }
 
-void hash256aux( HexMap const& _s, HexMap::const_iterator _begin, HexMap::const_iterator _end,
-    unsigned _preLen, RLPStream& _rlp ) {
+template < class Map >
+void hash256aux( Map const& _s, typename Map::const_iterator _begin,
+    typename Map::const_iterator _end, unsigned _preLen, RLPStream& _rlp ) {
     RLPStream rlp;
     hash256rlp( _s, _begin, _end, _preLen, rlp );
     if ( rlp.out().size() < 32 ) {
@@ -112,11 +120,17 @@ h256 orderedTrieRoot( std::vector< bytes > const& _data ) {
 }
 
 h256 orderedTrieRoot( std::vector< bytesConstRef > const& _data ) {
-    BytesMap m;
+    if ( _data.empty() )
+        return sha3( rlp( "" ) );
+    HexRefMap hexMap;
     unsigned j = 0;
-    for ( auto i : _data )
-        m[rlp( j++ )] = i.toBytes();
-    return hash256( m );
+    for ( auto i : _data ) {
+        bytes const key = rlp( j++ );
+        hexMap[asNibbles( bytesConstRef( &key ) )] = i;
+    }
+    RLPStream s;
+    hash256rlp( hexMap, hexMap.cbegin(), hexMap.cend(), 0, s );
+    return sha3( s.out() );
 }
 
 }  // namespace dev
@@ -42,6 +42,9 @@
 
 #include <libdevcore/microprofile.h>
 
+#include <atomic>
+#include <thread>
+
 using namespace std;
 using namespace dev;
 using namespace dev::crypto;
@@ -207,6 +210,34 @@ Public dev::recover( Signature const& _sig, h256 const& _message ) {
     return Public{&serializedPubkey[1], Public::ConstructFromPointer};
 }
 
+std::vector< Public > dev::recoverBatch(
+    std::vector< std::pair< Signature, h256 > > const& _items, unsigned _threads ) {
+    MICROPROFILE_SCOPEI( "Common.cpp", "recoverBatch", MP_BROWN1 );
+
+    // smaller portions are not worth starting a thread
+    static const size_t c_minRecoveriesPerThread = 16;
+
+    std::vector< Public > keys( _items.size() );
+    if ( _threads == 0 )
+        _threads = std::max( std::thread::hardware_concurrency(), 1U );
+    size_t threads = std::min< size_t >( _threads, _items.size() / c_minRecoveriesPerThread );
+
+    std::atomic< size_t > next{0};
+    auto worker = [&]() {
+        for ( size_t i = next++; i < _items.size(); i = next++ )
+            keys[i] = recover( _items[i].first, _items[i].second );
+    };
+
+    std::vector< std::thread > pool;
+    for ( size_t i = 1; i < threads; ++i )
+        pool.emplace_back( worker );
+    worker();
+    for ( auto& t : pool )
+        t.join();
+
+    return keys;
+}
+
 static const u256 c_secp256k1n(
     "115792089237316195423570985008687907852837564279074904382605163141518161494337" );
 
@@ -134,6 +134,12 @@ inline bytesSec decryptSymNoAuth(
 /// Recovers Public key from signed message hash.
 Public recover( Signature const& _sig, h256 const& _hash );
 
+/// Recovers Public keys of many signed message hashes at once. The work is split between
+/// @a _threads threads (hardware concurrency if 0) sharing one precomputed secp256k1 context.
+/// @returns Public keys in the order of @a _items, null Public for unrecoverable signatures.
+std::vector< Public > recoverBatch(
+    std::vector< std::pair< Signature, h256 > > const& _items, unsigned _threads = 0 );
+
 /// Returns siganture of message hash.
 Signature sign( Secret const& _k, h256 const& _hash );
 
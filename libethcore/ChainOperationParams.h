@@ -23,6 +23,7 @@
 
 #pragma once
 
+#include <limits>
 #include <string>
 #include <vector>
 
@@ -129,6 +130,12 @@ public:
     bool freeContractDeployment = false;
     int emptyBlockIntervalMs = -1;
     size_t t = 1;
+    /// Snapshots from this block on are hashed with multiset hashes of databases.
+    uint64_t snapshotHashForkBlock = std::numeric_limits< uint64_t >::max();
+    /// Databases hashed in snapshots maintain digests only once the fork is configured.
+    bool snapshotHashForkConfigured() const {
+        return snapshotHashForkBlock != std::numeric_limits< uint64_t >::max();
+    }
 
     SChain() {
         name = "TestChain";
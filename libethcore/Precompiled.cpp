@@ -616,9 +616,9 @@ ETH_REGISTER_PRECOMPILED( logTextMessage )( bytesConstRef _in ) {
     try {
         if ( !g_configAccesssor )
             throw std::runtime_error( "Config accessor was not initialized" );
-        nlohmann::json joConfig = g_configAccesssor->getConfigJSON();
         bool bLoggingIsEnabledForContracts =
-            joConfig["skaleConfig"]["contractSettings"]["common"]["enableContractLogMessages"]
+            g_configAccesssor->getConfigSnapshot()
+                ->extract_at_path( "skaleConfig.contractSettings.common.enableContractLogMessages" )
                 .get< bool >();
         if ( !bLoggingIsEnabledForContracts ) {
             u256 code = 1;
@@ -791,9 +791,7 @@ ETH_REGISTER_PRECOMPILED( getConfigVariableUint256 )( bytesConstRef _in ) {
 
         if ( !g_configAccesssor )
             throw std::runtime_error( "Config accessor was not initialized" );
-        nlohmann::json joConfig = g_configAccesssor->getConfigJSON();
-        nlohmann::json joValue =
-            skutils::json_config_file_accessor::stat_extract_at_path( joConfig, rawName );
+        nlohmann::json joValue = g_configAccesssor->getConfigSnapshot()->extract_at_path( rawName );
         std::string strValue = joValue.is_string() ? joValue.get< std::string >() : joValue.dump();
         dev::u256 uValue( strValue.c_str() );
 
@@ -825,9 +823,7 @@ ETH_REGISTER_PRECOMPILED( getConfigVariableAddress )( bytesConstRef _in ) {
 
         if ( !g_configAccesssor )
             throw std::runtime_error( "Config accessor was not initialized" );
-        nlohmann::json joConfig = g_configAccesssor->getConfigJSON();
-        nlohmann::json joValue =
-            skutils::json_config_file_accessor::stat_extract_at_path( joConfig, rawName );
+        nlohmann::json joValue = g_configAccesssor->getConfigSnapshot()->extract_at_path( rawName );
         std::string strValue = joValue.is_string() ? joValue.get< std::string >() : joValue.dump();
         dev::u256 uValue( strValue.c_str() );
 
@@ -859,9 +855,7 @@ ETH_REGISTER_PRECOMPILED( getConfigVariableString )( bytesConstRef _in ) {
 
         if ( !g_configAccesssor )
             throw std::runtime_error( "Config accessor was not initialized" );
-        nlohmann::json joConfig = g_configAccesssor->getConfigJSON();
-        nlohmann::json joValue =
-            skutils::json_config_file_accessor::stat_extract_at_path( joConfig, rawName );
+        nlohmann::json joValue = g_configAccesssor->getConfigSnapshot()->extract_at_path( rawName );
         std::string strValue = joValue.is_string() ? joValue.get< std::string >() : joValue.dump();
         bytes response = stat_string_to_bytes_with_length( strValue );
         return {true, response};
@@ -934,9 +928,7 @@ ETH_REGISTER_PRECOMPILED( getConfigPermissionFlag )( bytesConstRef _in ) {
 
         if ( !g_configAccesssor )
             throw std::runtime_error( "Config accessor was not initialized" );
-        nlohmann::json joConfig = g_configAccesssor->getConfigJSON();
-        nlohmann::json joValue =
-            skutils::json_config_file_accessor::stat_extract_at_path( joConfig, rawName );
+        nlohmann::json joValue = g_configAccesssor->getConfigSnapshot()->extract_at_path( rawName );
         if ( joValue.is_object() ) {
             auto itWalk = joValue.cbegin(), itEnd = joValue.cend();
             for ( ; itWalk != itEnd; ++itWalk ) {
@@ -159,6 +159,33 @@ Address const& TransactionBase::sender() const {
     return *m_sender;
 }
 
+std::vector< bool > TransactionBase::recoverSenders(
+    std::vector< TransactionBase const* > const& _transactions, unsigned _threads ) {
+    std::vector< bool > recovered( _transactions.size(), true );
+
+    std::vector< size_t > indexes;
+    std::vector< std::pair< Signature, h256 > > items;
+    for ( size_t i = 0; i < _transactions.size(); ++i ) {
+        TransactionBase const& t = *_transactions[i];
+        if ( t.m_sender.has_value() || t.isInvalid() || !t.m_vrs || t.hasZeroSignature() )
+            continue;
+        indexes.push_back( i );
+        items.emplace_back( *t.m_vrs, t.sha3( WithoutSignature ) );
+    }
+
+    std::vector< Public > keys = recoverBatch( items, _threads );
+    for ( size_t j = 0; j < indexes.size(); ++j ) {
+        if ( !keys[j] ) {
+            recovered[indexes[j]] = false;
+            continue;
+        }
+        // same as in sender()
+        _transactions[indexes[j]]->m_sender =
+            right160( dev::sha3( bytesConstRef( keys[j].data(), sizeof( keys[j] ) ) ) );
+    }
+    return recovered;
+}
+
 SignatureStruct const& TransactionBase::signature() const {
     if ( isInvalid() || !m_vrs )
         BOOST_THROW_EXCEPTION( TransactionIsUnsigned() );
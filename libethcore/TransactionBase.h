@@ -122,6 +122,12 @@ public:
     /// Force the sender to a particular value. This will result in an invalid transaction RLP.
     void forceSender( Address const& _a ) { m_sender = _a; }
 
+    /// Recover senders of @a _transactions at once with dev::recoverBatch() and cache them.
+    /// Transactions with known sender, zero or no signature are left as is.
+    /// @returns false for each transaction which signature could not be recovered.
+    static std::vector< bool > recoverSenders(
+        std::vector< TransactionBase const* > const& _transactions, unsigned _threads = 0 );
+
     /// @throws TransactionIsUnsigned if signature was not initialized
     /// @throws InvalidSValue if the signature has an invalid S value.
     void checkLowS() const;
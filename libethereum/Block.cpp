@@ -37,7 +37,9 @@
 #include <libevm/VMFactory.h>
 #include <boost/filesystem.hpp>
 #include <boost/timer.hpp>
+#include <atomic>
 #include <ctime>
+#include <thread>
 
 #include <libdevcore/microprofile.h>
 
@@ -63,6 +65,14 @@ public:
     void clear() override {}
 };
 
+// references to the items of an RLP list, without copying them
+std::vector< bytesConstRef > itemsOf( bytes const& _list ) {
+    std::vector< bytesConstRef > ret;
+    for ( auto const& item : RLP( _list ) )
+        ret.push_back( item.data() );
+    return ret;
+}
+
 }  // namespace
 
 Block::Block( BlockChain const& _bc, boost::filesystem::path const& _dbPath,
@@ -112,12 +122,15 @@ Block::Block( Block const& _s )
       m_transactions( _s.m_transactions ),
       m_receipts( _s.m_receipts ),
       m_transactionSet( _s.m_transactionSet ),
-      m_precommit( _s.m_state ),
+      // m_precommit is only read after commitToSeal() has set it again
+      m_precommit( _s.m_state.startOverlay() ),
       m_previousBlock( _s.m_previousBlock ),
       m_currentBlock( _s.m_currentBlock ),
       m_currentBytes( _s.m_currentBytes ),
+      m_currentReceipts( _s.m_currentReceipts ),
       m_author( _s.m_author ),
-      m_sealEngine( _s.m_sealEngine ) {
+      m_sealEngine( _s.m_sealEngine ),
+      m_speculationStats( _s.m_speculationStats ) {
     m_committedToSeal = false;
 }
 
@@ -132,10 +145,12 @@ Block& Block::operator=( Block const& _s ) {
     m_previousBlock = _s.m_previousBlock;
     m_currentBlock = _s.m_currentBlock;
     m_currentBytes = _s.m_currentBytes;
+    m_currentReceipts = _s.m_currentReceipts;
     m_author = _s.m_author;
     m_sealEngine = _s.m_sealEngine;
+    m_speculationStats = _s.m_speculationStats;
 
-    m_precommit = m_state;
+    m_precommit = m_state.startOverlay();
     m_committedToSeal = false;
     return *this;
 }
@@ -149,6 +164,7 @@ void Block::resetCurrent( int64_t _timestamp ) {
     m_currentBlock.setTimestamp( _timestamp );  // max( m_previousBlock.timestamp() + 1, _timestamp
                                                 // ) );
     m_currentBytes.clear();
+    m_currentReceipts.clear();
     sealEngine()->populateFromParent( m_currentBlock, m_previousBlock );
 
     // TODO: check.
@@ -423,8 +439,9 @@ pair< TransactionReceipts, bool > Block::sync(
     return ret;
 }
 
-tuple< TransactionReceipts, unsigned > Block::syncEveryone(
-    BlockChain const& _bc, const Transactions _transactions, uint64_t _timestamp, u256 _gasPrice ) {
+tuple< TransactionReceipts, unsigned > Block::syncEveryone( BlockChain const& _bc,
+    const Transactions _transactions, uint64_t _timestamp, u256 _gasPrice,
+    unsigned _executionThreads ) {
     if ( isSealed() )
         BOOST_THROW_EXCEPTION( InvalidOperationOnSealedBlock() );
 
@@ -440,9 +457,18 @@ tuple< TransactionReceipts, unsigned > Block::syncEveryone(
 
     m_state = m_state.delegateWrite();  // mainly for debugging
 
-    unsigned i = 0;
+    m_speculationStats = SpeculationStats();
+    std::vector< std::unique_ptr< SpeculativeExecution > > speculative;
+    if ( _executionThreads > 1 && _transactions.size() > 1 ) {
+        speculative = executeSpeculatively(
+            _bc.lastBlockHashes(), _transactions, _gasPrice, _executionThreads );
+        // collect changes of the block to find out which speculative results became stale
+        m_state.setAccessLog( make_shared< skale::StateAccessLog >() );
+    }
+
     unsigned count_bad = 0;
-    for ( Transaction const& tr : _transactions ) {
+    for ( unsigned i = 0; i < _transactions.size(); ++i ) {
+        Transaction const& tr = _transactions[i];
         try {
             // TODO Move this checking logic into some single place - not in execute, of course
             if ( !tr.isInvalid() && !tr.hasExternalGas() && tr.gasPrice() < _gasPrice ) {
@@ -468,7 +494,10 @@ tuple< TransactionReceipts, unsigned > Block::syncEveryone(
                 continue;
             }
 
-            ExecutionResult res = execute( _bc.lastBlockHashes(), tr, Permanence::Committed );
+            ExecutionResult res =
+                speculative.empty() ?
+                    execute( _bc.lastBlockHashes(), tr, Permanence::Committed ) :
+                    executeOrMerge( _bc.lastBlockHashes(), tr, speculative[i] );
             receipts.push_back( m_receipts.back() );
 
             if ( res.excepted == TransactionException::WouldNotBeInBlock )
@@ -480,12 +509,91 @@ tuple< TransactionReceipts, unsigned > Block::syncEveryone(
             // just ignore invalid transactions
             clog( VerbosityError, "block" ) << "FAILED transaction after consensus! " << ex.what();
         }
-        ++i;
     }
+    m_state.setAccessLog( nullptr );
     m_state.stopWrite();
     return make_tuple( receipts, receipts.size() - count_bad );
 }
 
+std::vector< std::unique_ptr< Block::SpeculativeExecution > > Block::executeSpeculatively(
+    LastBlockHashesFace const& _lh, Transactions const& _transactions, u256 const& _gasPrice,
+    unsigned _threads ) const {
+    MICROPROFILE_SCOPEI( "Block", "executeSpeculatively", MP_CORNFLOWERBLUE );
+
+    std::vector< std::unique_ptr< SpeculativeExecution > > results( _transactions.size() );
+    std::atomic< size_t > next( 0 );
+
+    auto worker = [&]() {
+        for ( size_t i = next++; i < _transactions.size(); i = next++ ) {
+            Transaction const& tr = _transactions[i];
+            if ( tr.isInvalid() || ( !tr.hasExternalGas() && tr.gasPrice() < _gasPrice ) )
+                continue;
+
+            // gasUsed is 0 as nothing is known about preceding transactions;
+            // receipt is adjusted later
+            EnvInfo envInfo( info(), _lh, 0, m_sealEngine->chainParams().chainID );
+            try {
+                State state = m_state.startSpeculative();
+                auto resultReceipt =
+                    state.execute( envInfo, *m_sealEngine, tr, Permanence::Speculative );
+                results[i].reset( new SpeculativeExecution{
+                    std::move( state ), resultReceipt.first, resultReceipt.second} );
+            } catch ( ... ) {
+                // will be executed serially with proper error handling
+            }
+        }
+    };
+
+    std::vector< std::thread > threads;
+    for ( unsigned i = 1; i < min< size_t >( _threads, _transactions.size() ); ++i )
+        threads.emplace_back( worker );
+    worker();
+    for ( auto& thread : threads )
+        thread.join();
+
+    return results;
+}
+
+ExecutionResult Block::executeOrMerge( LastBlockHashesFace const& _lh, Transaction const& _t,
+    std::unique_ptr< SpeculativeExecution > const& _speculative ) {
+    // block gas limit check in Executive::initialize() depends on preceding transactions
+    if ( !_speculative )
+        return execute( _lh, _t, Permanence::Committed );
+    if ( gasUsed() + _t.gas() > info().gasLimit() ||
+         !m_state.canMergeSpeculative( _speculative->state ) ) {
+        ++m_speculationStats.reexecuted;
+        return execute( _lh, _t, Permanence::Committed );
+    }
+
+    MICROPROFILE_SCOPEI( "Block", "merge speculative transaction", MP_CORNFLOWERBLUE );
+
+    uncommitToSeal();
+
+    State stateSnapshot = m_state.delegateWrite();
+    bool removeEmptyAccounts = info().number() >= m_sealEngine->chainParams().EIP158ForkBlock;
+    stateSnapshot.mergeSpeculative( _speculative->state, _t, info().author(),
+        removeEmptyAccounts ? State::CommitBehaviour::RemoveEmptyAccounts :
+                              State::CommitBehaviour::KeepEmptyAccounts );
+
+    TransactionReceipt const& speculativeReceipt = _speculative->receipt;
+    u256 const cumulativeGasUsed = gasUsed() + speculativeReceipt.cumulativeGasUsed();
+    TransactionReceipt receipt =
+        speculativeReceipt.hasStatusCode() ?
+            TransactionReceipt(
+                speculativeReceipt.statusCode(), cumulativeGasUsed, speculativeReceipt.log() ) :
+            TransactionReceipt( EmptyTrie, cumulativeGasUsed, speculativeReceipt.log() );
+    receipt.setRevertReason( speculativeReceipt.getRevertReason() );
+
+    // Add to the user-originated transactions that we've executed.
+    m_transactions.push_back( _t );
+    m_receipts.push_back( receipt );
+    m_transactionSet.insert( _t.sha3() );
+    m_state = stateSnapshot.delegateWrite();
+    ++m_speculationStats.merged;
+
+    return _speculative->result;
+}
+
 u256 Block::enactOn( VerifiedBlockRef const& _block, BlockChain const& _bc ) {
     MICROPROFILE_SCOPEI( "Block", "enactOn", MP_INDIANRED );
 
@@ -871,28 +979,17 @@ void Block::commitToSeal(
     // here was code to handle 6 generations of uncles
     // it was wtiting its results in two variables above
 
-    BytesMap transactionsMap;
-    BytesMap receiptsMap;
-
-    RLPStream txs;
-    txs.appendList( m_transactions.size() );
-
+    // every transaction and receipt is encoded once, right into the block body and the receipts
+    // stored with it; the tries are built over references into them
+    RLPStream txs( m_transactions.size() );
+    RLPStream receipts( m_transactions.size() );
     for ( unsigned i = 0; i < m_transactions.size(); ++i ) {
-        RLPStream k;
-        k << i;
-
-        RLPStream receiptrlp;
-        receipt( i ).streamRLP( receiptrlp );
-        receiptsMap.insert( std::make_pair( k.out(), receiptrlp.out() ) );
-
-        RLPStream txrlp;
-        m_transactions[i].streamRLP( txrlp );
-        transactionsMap.insert( std::make_pair( k.out(), txrlp.out() ) );
-
-        txs.appendRaw( txrlp.out() );
+        m_transactions[i].streamRLP( txs );
+        receipt( i ).streamRLP( receipts );
     }
 
     txs.swapOut( m_currentTxs );
+    receipts.swapOut( m_currentReceipts );
 
     RLPStream( unclesCount ).appendRaw( unclesData.out(), unclesCount ).swapOut( m_currentUncles );
 
@@ -915,8 +1012,9 @@ void Block::commitToSeal(
 
     m_currentBlock.setLogBloom( logBloom() );
     m_currentBlock.setGasUsed( gasUsed() );
-    m_currentBlock.setRoots( hash256( transactionsMap ), hash256( receiptsMap ),
-        sha3( m_currentUncles ), _stateRootHash );
+    m_currentBlock.setRoots( orderedTrieRoot( itemsOf( m_currentTxs ) ),
+        orderedTrieRoot( itemsOf( m_currentReceipts ) ), sha3( m_currentUncles ),
+        _stateRootHash );
 
     m_currentBlock.setParentHash( m_previousBlock.hash() );
     m_currentBlock.setExtraData( _extraData );
@@ -940,8 +1038,8 @@ bool Block::sealBlock( bytesConstRef _header ) {
     if ( !m_committedToSeal )
         return false;
 
-    if ( BlockHeader( _header, HeaderData ).hash( WithoutSeal ) !=
-         m_currentBlock.hash( WithoutSeal ) )
+    BlockHeader sealed( _header, HeaderData );
+    if ( sealed.hash( WithoutSeal ) != m_currentBlock.hash( WithoutSeal ) )
         return false;
 
     // Compile block:
@@ -951,7 +1049,7 @@ bool Block::sealBlock( bytesConstRef _header ) {
     ret.appendRaw( m_currentTxs );
     ret.appendRaw( m_currentUncles );
     ret.swapOut( m_currentBytes );
-    m_currentBlock = BlockHeader( _header, HeaderData );
+    m_currentBlock = std::move( sealed );
     //	cnote << "Mined " << m_currentBlock.hash() << "(parent: " << m_currentBlock.parentHash() <<
     //")";
     // TODO: move into SealEngine
@@ -24,6 +24,7 @@
 #pragma once
 
 #include <array>
+#include <memory>
 #include <unordered_map>
 
 #include <libdevcore/Common.h>
@@ -186,6 +187,9 @@ public:
     /// Get the transaction receipt for the transaction of the given index.
     TransactionReceipt const& receipt( unsigned _i ) const { return m_receipts.at( _i ); }
 
+    /// Get the receipts of pending transactions.
+    TransactionReceipts const& receipts() const { return m_receipts; }
+
     /// Get the list of pending transactions.
     LogEntries const& log( unsigned _i ) const { return receipt( _i ).log(); }
 
@@ -232,8 +236,20 @@ public:
         BlockChain const& _bc, h256 const& _blockHash, BlockHeader const& _bi = BlockHeader() );
 
     /// Sync all transactions unconditionally
+    /// With @a _executionThreads > 1 transactions are executed speculatively in parallel
+    /// beforehand; receipts and resulting state are the same as with serial execution.
     std::tuple< TransactionReceipts, unsigned > syncEveryone( BlockChain const& _bc,
-        const Transactions _transactions, uint64_t _timestamp, u256 _gasPrice );
+        const Transactions _transactions, uint64_t _timestamp, u256 _gasPrice,
+        unsigned _executionThreads = 0 );
+
+    /// Speculative results of the last syncEveryone() call that were merged or found stale
+    /// and executed again.
+    struct SpeculationStats {
+        unsigned merged = 0;
+        unsigned reexecuted = 0;
+    };
+
+    SpeculationStats const& speculationStats() const { return m_speculationStats; }
 
     /// Execute all transactions within a given block.
     /// @returns the additional total difficulty.
@@ -282,6 +298,10 @@ public:
     /// Only valid when isSealed() is true.
     bytes const& blockData() const { return m_currentBytes; }
 
+    /// Get the RLP list of receipts of the current block, encoded when it was committed to seal.
+    /// Only valid when isSealed() is true.
+    bytes const& receiptsData() const { return m_currentReceipts; }
+
     /// Get the header information on the present block.
     BlockHeader const& info() const { return m_currentBlock; }
 
@@ -297,6 +317,24 @@ private:
     /// Throws on failure.
     u256 enact( VerifiedBlockRef const& _block, BlockChain const& _bc );
 
+    /// Transaction executed against the state before the block, see syncEveryone().
+    struct SpeculativeExecution {
+        skale::State state;
+        ExecutionResult result;
+        TransactionReceipt receipt;
+    };
+
+    /// Execute @a _transactions with gas price not less than @a _gasPrice against m_state
+    /// in @a _threads threads. Results are nullptr for transactions that were not executed.
+    std::vector< std::unique_ptr< SpeculativeExecution > > executeSpeculatively(
+        LastBlockHashesFace const& _lh, Transactions const& _transactions, u256 const& _gasPrice,
+        unsigned _threads ) const;
+
+    /// Commit result of @a _speculative execution of @a _t if it's still valid,
+    /// otherwise execute @a _t with Permanence::Committed.
+    ExecutionResult executeOrMerge( LastBlockHashesFace const& _lh, Transaction const& _t,
+        std::unique_ptr< SpeculativeExecution > const& _speculative );
+
     /// Finalise the block, applying the earned rewards.
     void applyRewards(
         std::vector< BlockHeader > const& _uncleBlockHeaders, u256 const& _blockReward );
@@ -320,6 +358,7 @@ private:
     BlockHeader m_previousBlock;     ///< The previous block's information.
     BlockHeader m_currentBlock;      ///< The current block's information.
     bytes m_currentBytes;            ///< The current block's bytes.
+    bytes m_currentReceipts;         ///< The RLP-encoded receipts of the sealed block.
     bool m_committedToSeal = false;  ///< Have we committed to mine on the present m_currentBlock?
 
     bytes m_currentTxs;     ///< The RLP-encoded block of transactions.
@@ -329,6 +368,8 @@ private:
 
     SealEngineFace* m_sealEngine = nullptr;  ///< The chain's seal engine.
 
+    SpeculationStats m_speculationStats;
+
     Logger m_logger{createLogger( VerbosityDebug, "block" )};
     Logger m_loggerDetailed{createLogger( VerbosityTrace, "block" )};
 };
@@ -237,10 +237,16 @@ unsigned BlockChain::open( fs::path const& _path, WithExisting _we ) {
     try {
         fs::create_directories( chainPath / fs::path( "blocks_and_extras" ) );
         m_rotating_db = std::make_shared< db::ManuallyRotatingLevelDB >(
-            chainPath / fs::path( "blocks_and_extras" ), 5 );
+            chainPath / fs::path( "blocks_and_extras" ), 5,
+            m_params.sChain.snapshotHashForkConfigured() );
         m_split_db = std::make_unique< db::SplitDB >( m_rotating_db );
         m_blocksDB = m_split_db->newInterface();
         m_extrasDB = m_split_db->newInterface();
+        // the index differs between nodes, so it is kept out of blocks_and_extras
+        fs::create_directories( chainPath / fs::path( "log_index" ) );
+        m_logIndexDB = std::make_unique< db::ManuallyRotatingLevelDB >(
+            chainPath / fs::path( "log_index" ), 5 );
+        m_logIndex = std::make_unique< LogIndex >( m_logIndexDB.get() );
         // m_blocksDB.reset( new db::DBImpl( chainPath / fs::path( "blocks" ) ) );
         // m_extrasDB.reset( new db::DBImpl( extrasPath / fs::path( "extras" ) ) );
     } catch ( db::DatabaseError const& ex ) {
@@ -282,6 +288,13 @@ unsigned BlockChain::open( fs::path const& _path, WithExisting _we ) {
     m_lastBlockHash = l.empty() ? m_genesisHash : h256( l, h256::FromBinary );
 
     m_lastBlockNumber = number( m_lastBlockHash );
+    m_logIndex->open( m_lastBlockNumber + 1 );
+    // the index is written after the block, catch up if it was not
+    for ( unsigned n = m_logIndex->nextBlock(); n <= m_lastBlockNumber; ++n ) {
+        h256 const hash = numberHash( n );
+        if ( hash )
+            m_logIndex->insert( n, receipts( hash ).receipts );
+    }
 
     ctrace << cc::info( "Opened blockchain DB. Latest: " ) << currentHash() << ' '
            << m_lastBlockNumber << ' '
@@ -300,6 +313,8 @@ void BlockChain::reopen( ChainParams const& _p, WithExisting _we ) {
 void BlockChain::close() {
     ctrace << "Closing blockchain DB";
     // Not thread safe...
+    m_logIndex.reset();
+    m_logIndexDB.reset();
     m_extrasDB = nullptr;
     m_blocksDB = nullptr;
     m_split_db.reset();
@@ -477,8 +492,9 @@ void BlockChain::insert( VerifiedBlockRef _block, bytesConstRef _receipts, bool
     verifyBlock( _block.block, m_onBad, ImportRequirements::InOrderChecks );
 
     // OK - we're happy. Insert into database.
-    std::unique_ptr< db::WriteBatchFace > blocksWriteBatch = m_blocksDB->createWriteBatch();
-    std::unique_ptr< db::WriteBatchFace > extrasWriteBatch = m_extrasDB->createWriteBatch();
+    std::unique_ptr< db::SplitDB::WriteBatch > writeBatch = m_split_db->createWriteBatch();
+    db::WriteBatchFace& blocksWriteBatch = ( *writeBatch )[m_blocksDB];
+    db::WriteBatchFace& extrasWriteBatch = ( *writeBatch )[m_extrasDB];
 
     BlockLogBlooms blb;
     for ( auto i : RLP( _receipts ) )
@@ -495,9 +511,9 @@ void BlockChain::insert( VerifiedBlockRef _block, bytesConstRef _receipts, bool
             m_details[_block.info.parentHash()].children.push_back( _block.info.hash() );
     }
 
-    blocksWriteBatch->insert( toSlice( _block.info.hash() ), db::Slice( _block.block ) );
+    blocksWriteBatch.insert( toSlice( _block.info.hash() ), db::Slice( _block.block ) );
     DEV_READ_GUARDED( x_details )
-    extrasWriteBatch->insert( toSlice( _block.info.parentHash(), ExtraDetails ),
+    extrasWriteBatch.insert( toSlice( _block.info.parentHash(), ExtraDetails ),
         ( db::Slice ) dev::ref( m_details[_block.info.parentHash()].rlp() ) );
 
     BlockDetails bd( ( unsigned ) pd.number + 1, pd.totalDifficulty + _block.info.difficulty(),
@@ -505,28 +521,20 @@ void BlockChain::insert( VerifiedBlockRef _block, bytesConstRef _receipts, bool
     bytes bd_rlp = bd.rlp();
     bd.size = bd_rlp.size();
 
-    extrasWriteBatch->insert(
+    extrasWriteBatch.insert(
         toSlice( _block.info.hash(), ExtraDetails ), ( db::Slice ) dev::ref( bd_rlp ) );
-    extrasWriteBatch->insert(
+    extrasWriteBatch.insert(
         toSlice( _block.info.hash(), ExtraLogBlooms ), ( db::Slice ) dev::ref( blb.rlp() ) );
-    extrasWriteBatch->insert(
+    extrasWriteBatch.insert(
         toSlice( _block.info.hash(), ExtraReceipts ), ( db::Slice ) _receipts );
 
     try {
-        m_blocksDB->commit( std::move( blocksWriteBatch ) );
+        m_split_db->commit( std::move( writeBatch ) );
     } catch ( boost::exception const& ex ) {
         cwarn << "Error writing to blockchain database: " << boost::diagnostic_information( ex );
         cwarn << "Fail writing to blockchain database. Bombing out.";
         exit( -1 );
     }
-
-    try {
-        m_extrasDB->commit( std::move( extrasWriteBatch ) );
-    } catch ( boost::exception const& ex ) {
-        cwarn << "Error writing to extras database: " << boost::diagnostic_information( ex );
-        cwarn << "Fail writing to extras database. Bombing out.";
-        exit( -1 );
-    }
 }
 
 ImportRoute BlockChain::import( VerifiedBlockRef const& _block, State& _state, bool _mustBeNew ) {
@@ -610,27 +618,35 @@ ImportRoute BlockChain::import( VerifiedBlockRef const& _block, State& _state, b
 
     // All ok - insert into DB
     bytes const receipts = blockReceipts.rlp();
-    return insertBlockAndExtras( _block, ref( receipts ), totalDifficulty, performanceLogger );
+    performanceLogger.onStageFinished( "receiptsEncoding" );
+    return insertBlockAndExtras( _block, ref( receipts ), totalDifficulty, performanceLogger,
+        &blockReceipts.receipts );
 }
 
 ImportRoute BlockChain::import( const Block& _block ) {
     assert( _block.isSealed() );
 
+    ImportPerformanceLogger performanceLogger;
+
     VerifiedBlockRef verifiedBlock;
     verifiedBlock.info = _block.info();
     verifiedBlock.block = ref( _block.blockData() );
     verifiedBlock.transactions = _block.pending();
     //    verifyBlock( ref( _block.blockData() ), m_onBad, ImportRequirements::OutOfOrderChecks );
 
-    BlockReceipts blockReceipts;
-    for ( unsigned i = 0; i < _block.pending().size(); ++i )
-        blockReceipts.receipts.push_back( _block.receipt( i ) );
-    bytes const receipts = blockReceipts.rlp();
-
-    ImportPerformanceLogger performanceLogger;
+    // receipts were encoded once when the block was committed to seal
+    bytes encodedReceipts;
+    if ( _block.receiptsData().empty() ) {
+        BlockReceipts blockReceipts;
+        blockReceipts.receipts = _block.receipts();
+        encodedReceipts = blockReceipts.rlp();
+    }
+    bytesConstRef const receipts =
+        encodedReceipts.empty() ? ref( _block.receiptsData() ) : ref( encodedReceipts );
+    performanceLogger.onStageFinished( "receiptsEncoding" );
 
-    return insertBlockAndExtras(
-        verifiedBlock, ref( receipts ), _block.info().difficulty(), performanceLogger );
+    return insertBlockAndExtras( verifiedBlock, receipts, _block.info().difficulty(),
+        performanceLogger, &_block.receipts() );
 }
 
 ImportRoute BlockChain::insertWithoutParent(
@@ -675,25 +691,30 @@ void BlockChain::rotateDBIfNeeded() {
 
         clearCaches();
         this->m_rotating_db->rotate();
+        m_logIndexDB->rotate();
 
         // re-insert genesis
         auto r = details.rlp();
         m_details[m_genesisHash] = details;
         m_extrasDB->insert( toSlice( m_genesisHash, ExtraDetails ), ( db::Slice ) dev::ref( r ) );
+        m_logIndex->onRotated();
     }
 }
 
 ImportRoute BlockChain::insertBlockAndExtras( VerifiedBlockRef const& _block,
     bytesConstRef _receipts, u256 const& _totalDifficulty,
-    ImportPerformanceLogger& _performanceLogger ) {
+    ImportPerformanceLogger& _performanceLogger, TransactionReceipts const* _decodedReceipts ) {
     MICROPROFILE_SCOPEI( "BlockChain", "insertBlockAndExtras", MP_YELLOWGREEN );
 
     rotateDBIfNeeded();
 
-    std::unique_ptr< db::WriteBatchFace > blocksWriteBatch = m_blocksDB->createWriteBatch();
-    std::unique_ptr< db::WriteBatchFace > extrasWriteBatch = m_extrasDB->createWriteBatch();
+    // block, its extras and the best block pointer are written at once
+    std::unique_ptr< db::SplitDB::WriteBatch > writeBatch = m_split_db->createWriteBatch();
+    db::WriteBatchFace& blocksWriteBatch = ( *writeBatch )[m_blocksDB];
+    db::WriteBatchFace& extrasWriteBatch = ( *writeBatch )[m_extrasDB];
     h256 newLastBlockHash = currentHash();
     unsigned newLastBlockNumber = number();
+    TransactionReceipts decoded;
 
     try {
         MICROPROFILE_SCOPEI( "BlockChain", "write", MP_DARKKHAKI );
@@ -709,26 +730,32 @@ ImportRoute BlockChain::insertBlockAndExtras( VerifiedBlockRef const& _block,
 
         _performanceLogger.onStageFinished( "collation" );
 
-        blocksWriteBatch->insert( toSlice( _block.info.hash() ), db::Slice( _block.block ) );
+        blocksWriteBatch.insert( toSlice( _block.info.hash() ), db::Slice( _block.block ) );
 
         DEV_READ_GUARDED( x_details )
-        extrasWriteBatch->insert( toSlice( _block.info.parentHash(), ExtraDetails ),
+        extrasWriteBatch.insert( toSlice( _block.info.parentHash(), ExtraDetails ),
             ( db::Slice ) dev::ref( m_details[_block.info.parentHash()].rlp() ) );
 
         BlockDetails details(
             ( unsigned ) _block.info.number(), _totalDifficulty, _block.info.parentHash(), {} );
         bytes details_rlp = details.rlp();
         details.size = details_rlp.size();
-        extrasWriteBatch->insert(
+        extrasWriteBatch.insert(
             toSlice( _block.info.hash(), ExtraDetails ), ( db::Slice ) dev::ref( details_rlp ) );
 
+        if ( !_decodedReceipts ) {
+            for ( auto i : RLP( _receipts ) )
+                decoded.emplace_back( i.data() );
+            _decodedReceipts = &decoded;
+        }
+
         BlockLogBlooms blb;
-        for ( auto i : RLP( _receipts ) )
-            blb.blooms.push_back( TransactionReceipt( i.data() ).bloom() );
-        extrasWriteBatch->insert(
+        for ( TransactionReceipt const& r : *_decodedReceipts )
+            blb.blooms.push_back( r.bloom() );
+        extrasWriteBatch.insert(
             toSlice( _block.info.hash(), ExtraLogBlooms ), ( db::Slice ) dev::ref( blb.rlp() ) );
 
-        extrasWriteBatch->insert(
+        extrasWriteBatch.insert(
             toSlice( _block.info.hash(), ExtraReceipts ), ( db::Slice ) _receipts );
 
         _performanceLogger.onStageFinished( "writing" );
@@ -812,7 +839,7 @@ ImportRoute BlockChain::insertBlockAndExtras( VerifiedBlockRef const& _block,
             for ( RLP::iterator it = txns_rlp.begin(); it != txns_rlp.end(); ++it ) {
                 MICROPROFILE_SCOPEI( "insertBlockAndExtras", "for2", MP_HONEYDEW );
 
-                extrasWriteBatch->insert(
+                extrasWriteBatch.insert(
                     toSlice( sha3( ( *it ).data() ), ExtraTransactionAddress ),
                     ( db::Slice ) dev::ref( ta.rlp() ) );
                 ++ta.index;
@@ -826,9 +853,9 @@ ImportRoute BlockChain::insertBlockAndExtras( VerifiedBlockRef const& _block,
             MICROPROFILE_SCOPEI( "insertBlockAndExtras", "insert_to_extras", MP_LIGHTSKYBLUE );
 
             for ( auto const& h : alteredBlooms )
-                extrasWriteBatch->insert( toSlice( h, ExtraBlocksBlooms ),
+                extrasWriteBatch.insert( toSlice( h, ExtraBlocksBlooms ),
                     ( db::Slice ) dev::ref( m_blocksBlooms[h].rlp() ) );
-            extrasWriteBatch->insert( toSlice( h256( tbi.number() ), ExtraBlockHash ),
+            extrasWriteBatch.insert( toSlice( h256( tbi.number() ), ExtraBlockHash ),
                 ( db::Slice ) dev::ref( BlockHash( tbi.hash() ).rlp() ) );
         }
     }
@@ -846,9 +873,13 @@ ImportRoute BlockChain::insertBlockAndExtras( VerifiedBlockRef const& _block,
                     << ( details( _block.info.parentHash() ).children.size() - 1 )
                     << cc::debug( " siblings. Route: " ) << route;
 
+    if ( m_lastBlockHash != newLastBlockHash )
+        extrasWriteBatch.insert(
+            db::Slice( "best" ), db::Slice( ( char const* ) &newLastBlockHash, 32 ) );
+
     try {
-        MICROPROFILE_SCOPEI( "m_blocksDB", "commit", MP_PLUM );
-        m_blocksDB->commit( std::move( blocksWriteBatch ) );
+        MICROPROFILE_SCOPEI( "m_split_db", "commit", MP_PLUM );
+        m_split_db->commit( std::move( writeBatch ) );
     } catch ( boost::exception& ex ) {
         cwarn << cc::error( "Error writing to blockchain database: " )
               << cc::warn( boost::diagnostic_information( ex ) );
@@ -857,13 +888,12 @@ ImportRoute BlockChain::insertBlockAndExtras( VerifiedBlockRef const& _block,
     }
 
     try {
-        MICROPROFILE_SCOPEI( "m_extrasDB", "commit", MP_PLUM );
-        m_extrasDB->commit( std::move( extrasWriteBatch ) );
+        MICROPROFILE_SCOPEI( "m_logIndex", "insert", MP_PLUM );
+        m_logIndex->insert( ( unsigned ) _block.info.number(), *_decodedReceipts );
     } catch ( boost::exception& ex ) {
-        cwarn << cc::error( "Error writing to extras database: " )
+        // logs of the block are still found, just without the index
+        cwarn << cc::error( "Error writing to logs index: " )
               << cc::warn( boost::diagnostic_information( ex ) );
-        cwarn << cc::error( "Fail writing to extras database. Bombing out." );
-        exit( -1 );
     }
 
 #if ETH_PARANOIA
@@ -891,17 +921,6 @@ ImportRoute BlockChain::insertBlockAndExtras( VerifiedBlockRef const& _block,
 
             m_lastBlockHash = newLastBlockHash;
             m_lastBlockNumber = newLastBlockNumber;
-            try {
-                m_extrasDB->insert(
-                    db::Slice( "best" ), db::Slice( ( char const* ) &m_lastBlockHash, 32 ) );
-            } catch ( boost::exception const& ex ) {
-                cwarn << "Error writing to extras database: "
-                      << boost::diagnostic_information( ex );
-                cout << "Put" << toHex( bytesConstRef( db::Slice( "best" ) ) ) << "=>"
-                     << toHex( bytesConstRef( db::Slice( ( char const* ) &m_lastBlockHash, 32 ) ) );
-                cwarn << "Fail writing to extras database. Bombing out.";
-                exit( -1 );
-            }
         }
 
 #if ETH_PARANOIA
@@ -44,6 +44,7 @@
 #include "BlockQueue.h"
 #include "ChainParams.h"
 #include "LastBlockHashesFace.h"
+#include "LogIndex.h"
 #include "Transaction.h"
 #include "VerifiedBlock.h"
 
@@ -96,7 +97,8 @@ enum {
     ExtraTransactionAddress,
     ExtraLogBlooms,
     ExtraReceipts,
-    ExtraBlocksBlooms
+    ExtraBlocksBlooms,
+    ExtraLogIndex
 };
 
 class VersionChecker {
@@ -283,6 +285,9 @@ public:
     std::vector< unsigned > withBlockBloom( LogBloom const& _b, unsigned _earliest,
         unsigned _latest, unsigned _topLevel, unsigned _index ) const;
 
+    /// Address and topic index of the logs of blocks from logIndex().firstBlock() on.
+    LogIndex const& logIndex() const { return *m_logIndex; }
+
     /// Returns true if transaction is known. Thread-safe
     bool isKnownTransaction( h256 const& _transactionHash ) const {
         TransactionAddress ta =
@@ -343,6 +348,11 @@ public:
     /// Get the hash of the genesis block. Thread-safe.
     h256 genesisHash() const { return m_genesisHash; }
 
+    /// Get the rotating database of blocks and extras, e.g. for its statistics.
+    std::shared_ptr< db::ManuallyRotatingLevelDB const > rotatingDB() const {
+        return m_rotating_db;
+    }
+
     /// Get all blocks not allowed as uncles given a parent (i.e. featured as uncles/main in parent,
     /// parent + 1, ... parent + @a _generations).
     /// @returns set including the header-hash of every parent (including @a _parent) up to and
@@ -456,8 +466,11 @@ private:
 
     void rotateDBIfNeeded();
 
+    /// @a _decodedReceipts, if given, are the receipts of @a _receipts, so that they are not
+    /// decoded again for blooms and the log index.
     ImportRoute insertBlockAndExtras( VerifiedBlockRef const& _block, bytesConstRef _receipts,
-        u256 const& _totalDifficulty, ImportPerformanceLogger& _performanceLogger );
+        u256 const& _totalDifficulty, ImportPerformanceLogger& _performanceLogger,
+        TransactionReceipts const* _decodedReceipts = nullptr );
     void checkBlockIsNew( VerifiedBlockRef const& _block ) const;
     void checkBlockTimestamp( BlockHeader const& _header ) const;
 
@@ -533,6 +546,8 @@ private:
     std::shared_ptr< db::ManuallyRotatingLevelDB > m_rotating_db;
     db::DatabaseFace* m_blocksDB;
     db::DatabaseFace* m_extrasDB;
+    std::unique_ptr< db::ManuallyRotatingLevelDB > m_logIndexDB;
+    std::unique_ptr< LogIndex > m_logIndex;
 
     /// Hash of the last (valid) block on the longest chain.
     mutable boost::shared_mutex x_lastBlockHash;  // should protect both m_lastBlockHash and
@@ -0,0 +1,109 @@
+/*
+    Copyright (C) 2018-present, SKALE Labs
+
+    This file is part of skaled.
+
+    skaled is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skaled is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with skaled.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * @file CallCache.cpp
+ * @date 2026
+ */
+
+#include "CallCache.h"
+
+#include <libdevcore/SHA3.h>
+
+using namespace std;
+using namespace dev;
+using namespace dev::eth;
+
+CallCache::CallCache( size_t _capacity ) : m_results( max< size_t >( _capacity, 1 ) ) {}
+
+h256 CallCache::key( h256 const& _block, Address const& _from, Address const& _dest,
+    u256 const& _value, bytes const& _data, u256 const& _gas, u256 const& _gasPrice,
+    bool _lenient ) {
+    RLPStream s( 8 );
+    s << _block << _from << _dest << _value << sha3( _data ) << _gas << _gasPrice
+      << ( _lenient ? 1 : 0 );
+    return sha3( s.out() );
+}
+
+ExecutionResult CallCache::get(
+    h256 const& _key, std::function< ExecutionResult() > const& _execute ) {
+    promise< ExecutionResult > executed;
+    uint64_t generation;
+    {
+        unique_lock< mutex > lock( m_mutex );
+        if ( ExecutionResult const* r = m_results.find( _key ) ) {
+            ++m_hits;
+            return *r;
+        }
+        auto it = m_inFlight.find( _key );
+        if ( it != m_inFlight.end() ) {
+            shared_future< ExecutionResult > f = it->second;
+            lock.unlock();
+            ++m_joined;
+            return f.get();
+        }
+        ++m_misses;
+        m_inFlight.emplace( _key, executed.get_future().share() );
+        generation = m_generation;
+    }
+
+    ExecutionResult ret;
+    try {
+        ret = _execute();
+    } catch ( ... ) {
+        {
+            lock_guard< mutex > lock( m_mutex );
+            m_inFlight.erase( _key );
+        }
+        executed.set_exception( current_exception() );
+        throw;
+    }
+
+    {
+        lock_guard< mutex > lock( m_mutex );
+        m_inFlight.erase( _key );
+        if ( generation == m_generation ) {
+            if ( m_results.size() == m_results.capacity() )
+                ++m_evictions;
+            m_results.insert( _key, ret );
+        }
+    }
+    executed.set_value( ret );
+    return ret;
+}
+
+void CallCache::invalidate() {
+    lock_guard< mutex > lock( m_mutex );
+    m_results.clear();
+    ++m_generation;
+    ++m_invalidations;
+}
+
+CallCache::Stats CallCache::stats() const {
+    Stats stats;
+    stats.hits = m_hits;
+    stats.misses = m_misses;
+    stats.joined = m_joined;
+    stats.bypassed = m_bypassed;
+    stats.evictions = m_evictions;
+    stats.invalidations = m_invalidations;
+    lock_guard< mutex > lock( m_mutex );
+    stats.size = m_results.size();
+    stats.capacity = m_results.capacity();
+    return stats;
+}
@@ -0,0 +1,95 @@
+/*
+    Copyright (C) 2018-present, SKALE Labs
+
+    This file is part of skaled.
+
+    skaled is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skaled is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with skaled.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * @file CallCache.h
+ * @date 2026
+ */
+
+#pragma once
+
+#include "Transaction.h"
+
+#include <libdevcore/LruCache.h>
+
+#include <atomic>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <unordered_map>
+
+namespace dev {
+namespace eth {
+
+/**
+ * @brief Bounded cache of eth_call results for the latest block.
+ * Keys cover the block hash and everything that goes into the executed transaction, so an entry
+ * can only be served for the state it was computed on. Identical calls that arrive while one is
+ * executing wait for its result instead of executing again.
+ * @threadsafe
+ */
+class CallCache {
+public:
+    struct Stats {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t joined = 0;    ///< Calls that waited for an identical call in flight
+        uint64_t bypassed = 0;  ///< Calls on pending state, not cached
+        uint64_t evictions = 0;
+        uint64_t invalidations = 0;
+        size_t size = 0;
+        size_t capacity = 0;
+    };
+
+    static constexpr size_t c_defaultCapacity = 4096;
+
+    explicit CallCache( size_t _capacity );
+
+    /// @returns key of a call executed on block @a _block.
+    static h256 key( h256 const& _block, Address const& _from, Address const& _dest,
+        u256 const& _value, bytes const& _data, u256 const& _gas, u256 const& _gasPrice,
+        bool _lenient );
+
+    /// @returns cached result for @a _key, or runs @a _execute and caches what it returns.
+    /// Exceptions of @a _execute are passed to every caller waiting for it and are not cached.
+    ExecutionResult get( h256 const& _key, std::function< ExecutionResult() > const& _execute );
+
+    /// Counts a call that was executed without the cache.
+    void bypass() { ++m_bypassed; }
+
+    /// Drops all results, e.g. when a new block is imported. Calls in flight are not cached.
+    void invalidate();
+
+    Stats stats() const;
+
+private:
+    mutable std::mutex m_mutex;
+    LruCache< h256, ExecutionResult > m_results;
+    std::unordered_map< h256, std::shared_future< ExecutionResult > > m_inFlight;
+    uint64_t m_generation = 0;  ///< incremented by invalidate()
+
+    std::atomic< uint64_t > m_hits{0};
+    std::atomic< uint64_t > m_misses{0};
+    std::atomic< uint64_t > m_joined{0};
+    std::atomic< uint64_t > m_bypassed{0};
+    std::atomic< uint64_t > m_evictions{0};
+    std::atomic< uint64_t > m_invalidations{0};
+};
+
+}  // namespace eth
+}  // namespace dev
@@ -136,6 +136,28 @@ ChainParams ChainParams::loadConfig(
         if ( cp.rotateAfterBlock_ < 0 )
             cp.rotateAfterBlock_ = 0;
 
+        try {
+            cp.executionThreads_ = infoObj.at( "executionThreads" ).get_int();
+        } catch ( ... ) {
+        }
+        if ( cp.executionThreads_ < 0 )
+            cp.executionThreads_ = 0;
+
+        try {
+            cp.broadcastBatchSize_ = infoObj.at( "broadcastBatchSize" ).get_int();
+        } catch ( ... ) {
+        }
+        if ( cp.broadcastBatchSize_ < 1 )
+            cp.broadcastBatchSize_ = 1;
+
+        try {
+            cp.broadcastBatchLatencyMicroseconds_ =
+                infoObj.at( "broadcastBatchLatencyMicroseconds" ).get_int();
+        } catch ( ... ) {
+        }
+        if ( cp.broadcastBatchLatencyMicroseconds_ < 0 )
+            cp.broadcastBatchLatencyMicroseconds_ = 0;
+
         std::string ecdsaKeyName;
         try {
             ecdsaKeyName = infoObj.at( "ecdsaKeyName" ).get_str();
@@ -196,6 +218,9 @@ ChainParams ChainParams::loadConfig(
         if ( sChainObj.count( "freeContractDeployment" ) )
             s.freeContractDeployment = sChainObj.at( "freeContractDeployment" ).get_bool();
 
+        if ( sChainObj.count( "snapshotHashForkBlock" ) )
+            s.snapshotHashForkBlock = sChainObj.at( "snapshotHashForkBlock" ).get_uint64();
+
         for ( auto nodeConf : sChainObj.at( "nodes" ).get_array() ) {
             auto nodeConfObj = nodeConf.get_obj();
             sChainNode node{};
@@ -49,6 +49,14 @@ struct ChainParams : public ChainOperationParams {
 
     int rotateAfterBlock_ = 64;
 
+    /// Threads for speculative parallel execution of block transactions, 0 or 1 - serial.
+    int executionThreads_ = 0;
+
+    /// Max number of transactions broadcasted to other nodes in one message, 1 - no batching.
+    int broadcastBatchSize_ = 1;
+    /// Time to wait for more transactions if batch is not full.
+    int broadcastBatchLatencyMicroseconds_ = 0;
+
     /// Genesis params.
     h256 parentHash = h256();
     Address author = Address();
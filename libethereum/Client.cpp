@@ -106,6 +106,8 @@ Client::Client( ChainParams const& _params, int _networkID,
     : Worker( "Client", 0 ),
       m_bc( _params, _dbPath, _forceAction ),
       m_tq( _l ),
+      m_verifiedTransactions( _l.current + _l.future ),
+      m_callCache( CallCache::c_defaultCapacity ),
       m_gp( _gpForAdoption ? _gpForAdoption : make_shared< TrivialGasPricer >() ),
       m_preSeal( chainParams().accountStartNonce ),
       m_postSeal( chainParams().accountStartNonce ),
@@ -160,7 +162,7 @@ void Client::init( WithExisting _forceAction, u256 _networkId ) {
     // blockchain database until after the construction.
     m_state = State( chainParams().accountStartNonce, m_dbPath, bc().genesisHash(),
         BaseState::PreExisting, chainParams().accountInitialFunds,
-        chainParams().sChain.storageLimit );
+        chainParams().sChain.storageLimit, chainParams().sChain.snapshotHashForkConfigured() );
 
     if ( m_state.empty() ) {
         m_state.startWrite().populateFrom( bc().chainParams().genesisState );
@@ -444,6 +446,12 @@ size_t Client::importTransactionsAsBlock(
         size_t n_succeeded = syncTransactions( _transactions, _gasPrice, _timestamp );
         sealUnconditionally( false );
         importWorkingBlock();
+        // results of calls are keyed by the previous block
+        m_callCache.invalidate();
+
+        // transactions of the block won't be seen again
+        for ( auto const& t : _transactions )
+            m_verifiedTransactions.remove( t.sha3() );
 
         if ( m_instanceMonitor->isTimeToRotate( _timestamp ) ) {
             m_instanceMonitor->performRotation();
@@ -480,7 +488,8 @@ size_t Client::syncTransactions(
 
         //        assert(m_state.m_db_write_lock.has_value());
         tie( newPendingReceipts, goodReceipts ) =
-            m_working.syncEveryone( bc(), _transactions, _timestamp, _gasPrice );
+            m_working.syncEveryone( bc(), _transactions, _timestamp, _gasPrice,
+                bc().chainParams().executionThreads_ );
         m_state = m_state.startNew();
     }
 
@@ -725,12 +734,12 @@ void Client::sealUnconditionally( bool submitToBlockChain ) {
     }
 
 
-    // TODO Remove unnecessary de/serializations
+    // the header is encoded once, sealBlock() decodes it once to check and keep it
     RLPStream headerRlp;
     m_sealingInfo.streamRLP( headerRlp );
     const bytes& header = headerRlp.out();
     LOG( m_logger ) << cc::success( "Block sealed" ) << " " << cc::warn( "#" )
-                    << cc::num10( BlockHeader( header, HeaderData ).number() );
+                    << cc::num10( m_sealingInfo.number() );
     if ( submitToBlockChain ) {
         if ( this->submitSealed( header ) )
             m_onBlockSealed( header );
@@ -868,7 +877,9 @@ void Client::prepareForTransaction() {
 Block Client::latestBlock() const {
     // TODO Why it returns not-filled block??! (see Block ctor)
     try {
-        DEV_GUARDED( m_blockImportMutex ) { return Block( bc(), bc().currentHash(), m_state ); }
+        DEV_GUARDED( m_blockImportMutex ) {
+            return Block( bc(), bc().currentHash(), m_state.startOverlay() );
+        }
         assert( false );
         return Block( bc() );
     } catch ( Exception& ex ) {
@@ -978,28 +989,73 @@ h256 Client::importTransaction( Transaction const& _t ) {
         BOOST_THROW_EXCEPTION( UnknownTransactionValidationError() );
     }
 
+    m_verifiedTransactions.insert( _t );
     m_new_pending_transaction_watch.invoke( _t );
 
     return _t.sha3();
 }
 
+std::vector< ImportResult > Client::importTransactions( Transactions const& _transactions ) {
+    prepareForTransaction();
+
+    // same checks as in importTransaction() made by verifier threads of m_tq
+    auto verifier = [this]( Transaction const& _t ) {
+        const_cast< Transaction& >( _t ).checkOutExternalGas( chainParams().externalGasDifficulty );
+
+        State state;
+        u256 gasBidPrice;
+
+        DEV_GUARDED( m_blockImportMutex ) {
+            state = this->state().startRead();
+            gasBidPrice = this->gasBidPrice();
+        }
+
+        Executive::verifyTransaction( _t,
+            bc().number() ? this->blockInfo( bc().currentHash() ) : bc().genesis(), state,
+            *bc().sealEngine(), 0, gasBidPrice );
+    };
+
+    std::vector< ImportResult > results = m_tq.importBatch( _transactions, verifier );
+
+    for ( size_t i = 0; i < _transactions.size(); ++i )
+        if ( results[i] == ImportResult::Success ) {
+            m_verifiedTransactions.insert( _transactions[i] );
+            m_new_pending_transaction_watch.invoke( _transactions[i] );
+        }
+
+    return results;
+}
+
 // TODO: remove try/catch, allow exceptions
 ExecutionResult Client::call( Address const& _from, u256 _value, Address _dest, bytes const& _data,
     u256 _gas, u256 _gasPrice, FudgeFactor _ff ) {
-    ExecutionResult ret;
     try {
-        Block temp = latestBlock();
-        // TODO there can be race conditions between prev and next line!
-        State readStateForLock = temp.mutableState().startRead();
-        u256 nonce = max< u256 >( temp.transactionsFrom( _from ), m_tq.maxNonce( _from ) );
+        u256 queuedNonce = m_tq.maxNonce( _from );
         u256 gas = _gas == Invalid256 ? gasLimitRemaining() : _gas;
         u256 gasPrice = _gasPrice == Invalid256 ? gasBidPrice() : _gasPrice;
-        Transaction t( _value, gasPrice, gas, _dest, _data, nonce );
-        t.forceSender( _from );
-        t.checkOutExternalGas( ~u256( 0 ) );
-        if ( _ff == FudgeFactor::Lenient )
-            temp.mutableState().addBalance( _from, ( u256 )( t.gas() * t.gasPrice() + t.value() ) );
-        ret = temp.execute( bc().lastBlockHashes(), t, Permanence::Reverted );
+        auto execute = [&]() {
+            Block temp = latestBlock();
+            // reads the latest committed state even if a block was imported meanwhile
+            temp.startReadState();
+            u256 nonce = max< u256 >( temp.transactionsFrom( _from ), queuedNonce );
+            Transaction t( _value, gasPrice, gas, _dest, _data, nonce );
+            t.forceSender( _from );
+            t.checkOutExternalGas( ~u256( 0 ) );
+            if ( _ff == FudgeFactor::Lenient )
+                temp.mutableState().addBalance(
+                    _from, ( u256 )( t.gas() * t.gasPrice() + t.value() ) );
+            return temp.execute( bc().lastBlockHashes(), t, Permanence::Reverted );
+        };
+
+        // sender with queued transactions calls with its pending nonce,
+        // i.e. on the pending block, which is never cached
+        if ( queuedNonce != 0 ) {
+            m_callCache.bypass();
+            return execute();
+        }
+        return m_callCache.get( CallCache::key( bc().currentHash(), _from, _dest, _value, _data,
+                                    gas, gasPrice, _ff == FudgeFactor::Lenient ),
+            execute );
     } catch ( InvalidNonce const& in ) {
         std::cout << "exception in client call(1):"
                   << boost::current_exception_diagnostic_information() << std::endl;
@@ -1009,7 +1065,6 @@ ExecutionResult Client::call( Address const& _from, u256 _value, Address _dest,
                   << boost::current_exception_diagnostic_information() << std::endl;
         throw;
     }
-    return ret;
 }
 
 void Client::updateHashes() {
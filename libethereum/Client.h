@@ -47,12 +47,14 @@
 #include "Block.h"
 #include "BlockChain.h"
 #include "BlockChainImporter.h"
+#include "CallCache.h"
 #include "ClientBase.h"
 #include "CommonNet.h"
 #include "InstanceMonitor.h"
 #include "SkaleHost.h"
 #include "StateImporter.h"
 #include "ThreadSafeQueue.h"
+#include "VerifiedTransactionCache.h"
 
 #include <skutils/atomic_shared_ptr.h>
 #include <skutils/multithreading.h>
@@ -106,6 +108,10 @@ public:
     /// Imports the given transaction into the transaction queue
     h256 importTransaction( Transaction const& _t ) override;
 
+    /// Imports the given transactions into the transaction queue verifying them in parallel
+    /// @returns import result for each transaction, does not throw on invalid ones
+    std::vector< ImportResult > importTransactions( Transactions const& _transactions );
+
     /// Makes the given call. Nothing is recorded into the state.
     ExecutionResult call( Address const& _secret, u256 _value, Address _dest, bytes const& _data,
         u256 _gas, u256 _gasPrice, FudgeFactor _ff = FudgeFactor::Strict ) override;
@@ -150,6 +156,13 @@ public:
     TransactionQueue::Status transactionQueueStatus() const { return m_tq.status(); }
     TransactionQueue::Limits transactionQueueLimits() const { return m_tq.limits(); }
     TransactionQueue* debugGetTransactionQueue() { return &m_tq; }
+    /// Get the cache of transactions with recovered senders.
+    VerifiedTransactionCache& verifiedTransactionCache() { return m_verifiedTransactions; }
+    VerifiedTransactionCache::Stats verifiedTransactionCacheStats() const {
+        return m_verifiedTransactions.stats();
+    }
+    /// Get statistics of the cache of eth_call results.
+    CallCache::Stats callCacheStats() const { return m_callCache.stats(); }
 
     /// Freeze worker thread and sync some of the block queue.
     std::tuple< ImportRoute, bool, unsigned > syncQueue( unsigned _max = 1 );
@@ -396,6 +409,10 @@ protected:
                       ///< imported).
     TransactionQueue m_tq;  ///< Maintains a list of incoming transactions not yet in a block on the
                             ///< blockchain.
+    VerifiedTransactionCache m_verifiedTransactions;  ///< Transactions verified on their way to a
+                                                      ///< block, dropped once it is imported.
+    CallCache m_callCache;  ///< Results of calls on the latest block, dropped once a new one is
+                            ///< imported.
 
     std::shared_ptr< GasPricer > m_gp;  ///< The gas pricer.
 
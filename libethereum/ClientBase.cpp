@@ -25,11 +25,15 @@
 #include "ClientBase.h"
 
 #include <algorithm>
+#include <functional>
+#include <limits>
 #include <utility>
 
 #include "BlockChain.h"
 #include "Executive.h"
 
+#include <libevm/LegacyVM.h>
+
 using namespace std;
 using std::make_pair;
 using std::pair;
@@ -40,6 +44,146 @@ using skale::Permanence;
 using skale::State;
 
 static const int64_t c_maxGasEstimate = 50000000;
+/// Rounds of the iterative search for the gas limit when the trace gives no answer.
+static const int c_maxEstimateRounds = 32;
+
+namespace {
+
+bool isCallInstruction( Instruction _inst ) {
+    return _inst == Instruction::CALL || _inst == Instruction::CALLCODE ||
+           _inst == Instruction::DELEGATECALL || _inst == Instruction::STATICCALL;
+}
+
+/// Gas a caller may lose when a callee capped by the 63/64 rule may lose @a _calleeSlack.
+int64_t callerSlack( int64_t _calleeSlack ) {
+    return _calleeSlack <= 0 ? 0 : max< int64_t >( _calleeSlack * 64 / 63 - 1, 0 );
+}
+
+/**
+ * @brief Derives from one execution how much lower its gas limit could have been without
+ * changing the execution.
+ * Every frame must still afford each of its operations, and a callee whose gas was capped by
+ * the 63/64 rule gets 63/64 of any loss of its caller, so its slack weighs 64/63 in the caller.
+ * Executions reading the gas left for anything but a call give no answer, just as other VMs
+ * than the legacy interpreter, which do not report operations.
+ */
+class GasRequirementTracer {
+public:
+    void operator()( uint64_t, uint64_t, Instruction _inst, bigint, bigint, bigint _gas,
+        VMFace const* _vm, ExtVMFace const* _ext ) {
+        if ( m_inconclusive )
+            return;
+        int64_t const gas = int64_t( _gas );
+        size_t const depth = _ext->depth;
+        if ( depth == m_frames.size() ) {
+            if ( !m_frames.empty() ) {
+                if ( !m_frames.back().calling ) {
+                    m_inconclusive = true;
+                    return;
+                }
+                m_frames.back().calleeSeen = true;
+                m_frames.back().calleeGas = gas;
+            }
+            m_frames.emplace_back();
+        } else if ( depth < m_frames.size() ) {
+            while ( m_frames.size() > depth + 1 )
+                popFrame();
+            Frame& f = m_frames.back();
+            if ( f.calling )
+                returned( f, gas );
+            else
+                f.slack = min( f.slack, gas );  // gas left by the previous operation
+            if ( f.gasRead && !isCallInstruction( _inst ) ) {
+                m_inconclusive = true;
+                return;
+            }
+        } else {
+            m_inconclusive = true;
+            return;
+        }
+
+        Frame& f = m_frames.back();
+        f.gas = gas;
+        f.gasRead = _inst == Instruction::GAS;
+        f.create = _inst == Instruction::CREATE || _inst == Instruction::CREATE2;
+        f.calling = f.create || isCallInstruction( _inst );
+        f.calleeSeen = false;
+        if ( f.calling && !f.create ) {
+            auto vm = dynamic_cast< LegacyVM const* >( _vm );
+            if ( !vm ) {
+                m_inconclusive = true;
+                return;
+            }
+            u256s const stack = vm->stack();
+            u256 const requested = stack.back();
+            f.requested = requested > gas ? gas : int64_t( requested );
+            bool const transfers =
+                ( _inst == Instruction::CALL || _inst == Instruction::CALLCODE ) &&
+                stack[stack.size() - 3] != 0;
+            f.stipend = transfers ? _ext->evmSchedule().callStipend : 0;
+        }
+    }
+
+    /// @returns gas the execution could have started with less, given the gas
+    /// @a _leftover after it, or -1 if the trace gives no answer.
+    int64_t slack( int64_t _leftover ) {
+        if ( m_inconclusive || m_frames.empty() )
+            return -1;
+        while ( m_frames.size() > 1 )
+            popFrame();
+        Frame& root = m_frames.back();
+        if ( root.calling )
+            returned( root, _leftover );
+        return max< int64_t >( min( root.slack, _leftover ), 0 );
+    }
+
+private:
+    struct Frame {
+        int64_t gas = 0;  ///< gas before the latest operation
+        int64_t slack = std::numeric_limits< int64_t >::max();
+        bool gasRead = false;  ///< the latest operation was GAS
+        // the latest operation was a call or create that has not returned yet
+        bool calling = false;
+        bool create = false;
+        int64_t requested = 0;
+        int64_t stipend = 0;
+        bool calleeSeen = false;
+        int64_t calleeGas = 0;
+        int64_t calleeSlack = 0;
+        int64_t calleeLeftover = 0;
+    };
+
+    void popFrame() {
+        Frame const callee = m_frames.back();
+        m_frames.pop_back();
+        // the gas before the last operation stands in for the gas left by it
+        m_frames.back().calleeSlack = min( callee.slack, callee.gas );
+        m_frames.back().calleeLeftover = callee.gas;
+    }
+
+    void returned( Frame& _f, int64_t _gas ) {
+        int64_t s;
+        bool const capped = _f.create || ( _f.calleeSeen ?
+                                                 _f.calleeGas - _f.stipend < _f.requested :
+                                                 _f.requested > _f.gas - _f.gas / 64 );
+        if ( capped )
+            s = callerSlack( _f.calleeSeen ? _f.calleeSlack : _gas - _f.gas / 64 - 1 );
+        else {
+            // the caller keeps what it did not pass and must still pass the requested gas
+            // without the cap taking effect
+            int64_t const leftover =
+                _f.calleeSeen ? _f.calleeLeftover : _f.requested + _f.stipend;
+            s = _gas - leftover - ( _f.requested + 62 ) / 63;
+        }
+        _f.slack = min( _f.slack, max< int64_t >( s, 0 ) );
+        _f.calling = false;
+    }
+
+    std::vector< Frame > m_frames;  ///< by depth
+    bool m_inconclusive = false;
+};
+
+}  // namespace
 
 ClientWatch::ClientWatch() : lastPoll( std::chrono::system_clock::now() ) {}
 
@@ -78,10 +222,11 @@ void ClientWatch::append_changes( const LocalisedLogEntry& entry ) {
         fnOnNewChanges_( iw_ );
 }
 
-std::pair< bool, ExecutionResult > ClientBase::estimateGasStep( int64_t _gas, Block& _latestBlock,
-    Address const& _from, Address const& _destination, u256 const& _value, u256 const& _gasPrice,
-    bytes const& _data ) {
-    u256 nonce = _latestBlock.transactionsFrom( _from );
+std::pair< bool, ExecutionResult > ClientBase::estimateGasStep( int64_t _gas,
+    Block const& _latestBlock, State const& _state, Address const& _from,
+    Address const& _destination, u256 const& _value, u256 const& _gasPrice, bytes const& _data,
+    OnOpFunc const& _onOp ) {
+    u256 nonce = _state.getNonce( _from );
     Transaction t;
     if ( _destination )
         t = Transaction( _value, _gasPrice, _gas, _destination, _data, nonce );
@@ -90,10 +235,12 @@ std::pair< bool, ExecutionResult > ClientBase::estimateGasStep( int64_t _gas, Bl
     t.forceSender( _from );
     t.checkOutExternalGas( ~u256( 0 ) );
     EnvInfo const env( _latestBlock.info(), bc().lastBlockHashes(), 0, _gas );
-    State& tempState = _latestBlock.mutableState();
-    tempState.addBalance( _from, ( u256 )( t.gas() * t.gasPrice() + t.value() ) );
+    // execute on an overlay so that _state stays untouched for the next step and its cache is
+    // not copied, the sender is topped up to pay for the gas limit tried
+    State tempState = _state.startOverlay();
+    tempState.addBalance( _from, u256( _gas ) * _gasPrice + _value );
     ExecutionResult executionResult =
-        tempState.execute( env, *bc().sealEngine(), t, Permanence::Reverted ).first;
+        tempState.execute( env, *bc().sealEngine(), t, Permanence::Reverted, _onOp ).first;
     if ( executionResult.excepted == TransactionException::OutOfGas ||
          executionResult.excepted == TransactionException::OutOfGasBase ||
          executionResult.excepted == TransactionException::OutOfGasIntrinsic ||
@@ -120,28 +267,67 @@ std::pair< u256, ExecutionResult > ClientBase::estimateGas( Address const& _from
         }
         u256 gasPrice = _gasPrice == Invalid256 ? gasBidPrice() : _gasPrice;
 
-        // We execute transaction with maximum gas limit
-        // to calculate how many of gas will be used.
-        // Then we execute transaction with this gas limit
+        // Every step runs on an overlay of this state.
+        State const& base = bk.state();
+
+        // We execute transaction with maximum gas limit once, recording how much gas
+        // every call frame really needed, and derive the gas limit from that.
+        // If the trace says nothing or its gas limit is not enough we search iteratively.
+        GasRequirementTracer tracer;
+        auto step = estimateGasStep(
+            upperBound, bk, base, _from, _dest, _value, gasPrice, _data, std::ref( tracer ) );
+        if ( !step.first )
+            return make_pair( upperBound, step.second );
+
+        ExecutionResult goodResult = step.second;
+        int64_t goodGas = upperBound;
+
+        // refunds are capped by half of the gas used
+        int64_t const gasUsed = step.second.gasUsed.convert_to< int64_t >();
+        int64_t const gasUsedBeforeRefunds =
+            min( gasUsed + min( step.second.gasRefunded, u256( gasUsed ) ).convert_to< int64_t >(),
+                2 * gasUsed );
+        int64_t const slack = tracer.slack( upperBound - gasUsedBeforeRefunds );
+        if ( slack >= 0 ) {
+            int64_t const tracedGas = max( upperBound - slack, lowerBound );
+            if ( tracedGas >= upperBound )
+                return make_pair( goodGas, goodResult );
+            step = estimateGasStep( tracedGas, bk, base, _from, _dest, _value, gasPrice, _data );
+            if ( step.first ) {
+                if ( _callback ) {
+                    _callback( GasEstimationProgress{tracedGas, tracedGas} );
+                }
+                return make_pair( tracedGas, step.second );
+            }
+            lowerBound = max( lowerBound, tracedGas );
+            if ( _callback ) {
+                _callback( GasEstimationProgress{lowerBound, upperBound} );
+            }
+        }
+
+        // Then we execute transaction with the gas used
         // and check if it will be enough.
-        // If not repeat process iteratively.
-        ExecutionResult goodResult;
-        int64_t goodGas = c_maxGasEstimate;
-        bool haveGoodResult = false;
-        while ( lowerBound + 1 < upperBound ) {
-            auto step = estimateGasStep( upperBound, bk, _from, _dest, _value, gasPrice, _data );
+        // If not repeat process iteratively, reusing the execution
+        // with maximum gas limit in the first round.
+        bool haveUpperResult = true;
+        for ( int round = 0; round < c_maxEstimateRounds && lowerBound + 1 < upperBound;
+              ++round ) {
+            if ( haveUpperResult )
+                step = make_pair( true, goodResult );
+            else
+                step = estimateGasStep(
+                    upperBound, bk, base, _from, _dest, _value, gasPrice, _data );
+            haveUpperResult = false;
             if ( step.first ) {
-                if ( !haveGoodResult || goodGas > upperBound ) {
-                    haveGoodResult = true;
+                if ( goodGas > upperBound ) {
                     goodResult = step.second;
                     goodGas = upperBound;
                 }
                 int64_t gasUsed = step.second.gasUsed.convert_to< int64_t >();
 
-                step = estimateGasStep( gasUsed, bk, _from, _dest, _value, gasPrice, _data );
+                step = estimateGasStep( gasUsed, bk, base, _from, _dest, _value, gasPrice, _data );
                 if ( step.first ) {
-                    if ( !haveGoodResult || goodGas > gasUsed ) {
-                        haveGoodResult = true;
+                    if ( goodGas > gasUsed ) {
                         goodResult = step.second;
                         goodGas = gasUsed;
                     }
@@ -164,12 +350,7 @@ std::pair< u256, ExecutionResult > ClientBase::estimateGas( Address const& _from
             }
         }
 
-        if ( haveGoodResult ) {
-            return make_pair( goodGas, goodResult );
-        } else {
-            return make_pair( upperBound,
-                estimateGasStep( upperBound, bk, _from, _dest, _value, gasPrice, _data ).second );
-        }
+        return make_pair( goodGas, goodResult );
     } catch ( ... ) {
         // TODO: Some sort of notification of failure.
         return make_pair( u256(), ExecutionResult() );
@@ -221,48 +402,122 @@ LocalisedLogEntries ClientBase::logs( LogFilter const& _f ) const {
     unsigned begin = min( bc().number() + 1, ( unsigned ) _f.latest() );
     unsigned end = min( bc().number(), min( begin, ( unsigned ) _f.earliest() ) );
 
-    // Handle pending transactions differently as they're not on the block chain.
-    if ( begin > bc().number() ) {
+    // one entry over the cap is enough to tell that the response would be too large
+    size_t const wanted = min( _f.limit(), c_maxLogsPerResponse + 1 );
+    size_t skip = _f.offset();
+    // nothing is kept before the offset is reached, so entries to skip are always at the front
+    auto const fnSkip = [&]() {
+        size_t const n = min( skip, ret.size() );
+        ret.erase( ret.begin(), ret.begin() + n );
+        skip -= n;
+    };
+
+    // pending transactions are not on the block chain, their logs go last
+    bool const withPending = begin > bc().number();
+    if ( withPending )
+        begin = bc().number();
+
+    // Handle blocks from main chain
+    if ( _f.isRangeFilter() ) {
+        // if it is a range filter, we want to get all logs from all blocks in given range
+        for ( unsigned n = end; n <= begin && ret.size() < wanted; n++ ) {
+            appendLogsFromBlock( _f, bc().numberHash( n ), BlockPolarity::Live, ret );
+            fnSkip();
+        }
+    } else {
+        // blocks imported before the logs index appeared are found with blooms
+        unsigned const indexed = max( end, bc().logIndex().firstBlock() );
+        if ( end < indexed ) {
+            set< unsigned > matchingBlocks;
+            for ( auto const& i : _f.bloomPossibilities() )
+                for ( auto u : bc().withBlockBloom( i, end, min( begin, indexed - 1 ) ) )
+                    matchingBlocks.insert( u );
+            for ( auto n : matchingBlocks ) {
+                if ( ret.size() >= wanted )
+                    break;
+                appendLogsFromBlock( _f, bc().numberHash( n ), BlockPolarity::Live, ret );
+                fnSkip();
+            }
+        }
+        if ( indexed <= begin && ret.size() < wanted ) {
+            // skipped entries are dropped as positions, before any receipt is read
+            size_t const rest = wanted - ret.size();
+            size_t const count = skip > numeric_limits< size_t >::max() - rest ?
+                                     numeric_limits< size_t >::max() :
+                                     skip + rest;
+            LogPositions positions = bc().logIndex().find( _f, indexed, begin, count );
+            size_t const n = min( skip, positions.size() );
+            positions.erase( positions.begin(), positions.begin() + n );
+            skip -= n;
+            appendLogsAt( positions, ret );
+        }
+    }
+
+    if ( withPending && ret.size() < wanted ) {
         Block temp = postSeal();
         for ( unsigned i = 0; i < temp.pending().size(); ++i ) {
             // Might have a transaction that contains a matching log.
             TransactionReceipt const& tr = temp.receipt( i );
-            LogEntries le = _f.matches( tr );
-            for ( unsigned j = 0; j < le.size(); ++j )
-                ret.insert( ret.begin(), LocalisedLogEntry( le[j] ) );
+            for ( LogEntry const& e : _f.matches( tr ) )
+                ret.push_back( LocalisedLogEntry( e ) );
         }
-        begin = bc().number();
+        fnSkip();
     }
 
-    // Handle blocks from main chain
-    set< unsigned > matchingBlocks;
-    if ( !_f.isRangeFilter() )
-        for ( auto const& i : _f.bloomPossibilities() )
-            for ( auto u : bc().withBlockBloom( i, end, begin ) )
-                matchingBlocks.insert( u );
-    else
-        // if it is a range filter, we want to get all logs from all blocks in given range
-        for ( unsigned i = end; i <= begin; i++ )
-            matchingBlocks.insert( i );
-
-    for ( auto n : matchingBlocks )
-        prependLogsFromBlock( _f, bc().numberHash( n ), BlockPolarity::Live, ret );
-
-    reverse( ret.begin(), ret.end() );
+    if ( ret.size() > _f.limit() )
+        ret.resize( _f.limit() );
+    if ( ret.size() > c_maxLogsPerResponse )
+        BOOST_THROW_EXCEPTION( TooManyLogs() );
     return ret;
 }
 
-void ClientBase::prependLogsFromBlock( LogFilter const& _f, h256 const& _blockHash,
+void ClientBase::appendLogsFromBlock( LogFilter const& _f, h256 const& _blockHash,
     BlockPolarity _polarity, LocalisedLogEntries& io_logs ) const {
     auto receipts = bc().receipts( _blockHash ).receipts;
+    // the block is decoded for transaction hashes only if something matched
+    TransactionHashes hashes;
+    BlockNumber number = 0;
     for ( size_t i = 0; i < receipts.size(); i++ ) {
-        TransactionReceipt receipt = receipts[i];
-        auto th = transaction( _blockHash, i ).sha3();
-        LogEntries le = _f.matches( receipt );
+        LogEntries le = _f.matches( receipts[i] );
+        if ( le.empty() )
+            continue;
+        if ( hashes.empty() ) {
+            hashes = bc().transactionHashes( _blockHash );
+            number = ( BlockNumber ) bc().number( _blockHash );
+        }
+        h256 const th = i < hashes.size() ? hashes[i] : h256();
         for ( unsigned j = 0; j < le.size(); ++j )
-            io_logs.insert( io_logs.begin(),
-                LocalisedLogEntry( le[j], _blockHash, ( BlockNumber ) bc().number( _blockHash ), th,
-                    i, 0, _polarity ) );
+            io_logs.push_back(
+                LocalisedLogEntry( le[j], _blockHash, number, th, i, 0, _polarity ) );
+    }
+}
+
+void ClientBase::appendLogsAt(
+    LogPositions const& _positions, LocalisedLogEntries& io_logs ) const {
+    for ( auto it = _positions.begin(); it != _positions.end(); ) {
+        unsigned const number = it->block;
+        auto const blockEnd = find_if( it, _positions.end(),
+            [number]( LogPosition const& _p ) { return _p.block != number; } );
+
+        // blocks in rotated away database pieces are gone together with their receipts
+        h256 const hash = bc().numberHash( number );
+        TransactionReceipts receipts;
+        TransactionHashes hashes;
+        if ( hash ) {
+            receipts = bc().receipts( hash ).receipts;
+            if ( !receipts.empty() )
+                hashes = bc().transactionHashes( hash );
+        }
+
+        for ( ; it != blockEnd; ++it ) {
+            if ( it->transaction >= receipts.size() || it->transaction >= hashes.size() )
+                continue;
+            LogEntries const& le = receipts[it->transaction].log();
+            if ( it->log >= le.size() )
+                continue;
+            io_logs.push_back( LocalisedLogEntry( le[it->log], hash, number,
+                hashes[it->transaction], it->transaction, 0, BlockPolarity::Live ) );
+        }
     }
 }
 
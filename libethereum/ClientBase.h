@@ -28,6 +28,7 @@
 #include "CommonNet.h"
 #include "Interface.h"
 #include "LogFilter.h"
+#include "LogIndex.h"
 #include "TransactionQueue.h"
 #include <chrono>
 
@@ -44,6 +45,12 @@ struct InstalledFilter {
 static const h256 PendingChangedFilter = u256( 0 );
 static const h256 ChainChangedFilter = u256( 1 );
 
+/// Logs queries matching more entries fail instead of building huge responses; callers have to
+/// narrow the block range or page through the result with LogFilter::withLimit().
+static const size_t c_maxLogsPerResponse = 10000;
+
+DEV_SIMPLE_EXCEPTION( TooManyLogs );
+
 static const LogEntry SpecialLogEntry = LogEntry( Address(), h256s(), bytes() );
 static const LocalisedLogEntry InitialChange( SpecialLogEntry );
 
@@ -103,8 +110,10 @@ public:
 
     LocalisedLogEntries logs( unsigned _watchId ) const override;
     LocalisedLogEntries logs( LogFilter const& _filter ) const override;
-    virtual void prependLogsFromBlock( LogFilter const& _filter, h256 const& _blockHash,
+    virtual void appendLogsFromBlock( LogFilter const& _filter, h256 const& _blockHash,
         BlockPolarity _polarity, LocalisedLogEntries& io_logs ) const;
+    /// Appends logs at @a _positions, which must be sorted, skipping blocks no longer stored.
+    void appendLogsAt( LogPositions const& _positions, LocalisedLogEntries& io_logs ) const;
 
     /// Install, uninstall and query watches.
     unsigned installWatch( LogFilter const& _filter, Reaping _r = Reaping::Automatic,
@@ -216,9 +225,12 @@ protected:
     Logger m_loggerWatch{createLogger( VerbosityDebug, "watch" )};
 
 private:
-    std::pair< bool, ExecutionResult > estimateGasStep( int64_t _gas, Block& _latestBlock,
-        Address const& _from, Address const& _destination, u256 const& _value,
-        u256 const& _gasPrice, bytes const& _data );
+    /// Executes the call with gas limit @a _gas on an overlay of committed @a _state.
+    /// @returns whether the gas limit was enough and the result of the execution.
+    std::pair< bool, ExecutionResult > estimateGasStep( int64_t _gas, Block const& _latestBlock,
+        skale::State const& _state, Address const& _from, Address const& _destination,
+        u256 const& _value, u256 const& _gasPrice, bytes const& _data,
+        OnOpFunc const& _onOp = OnOpFunc() );
 };
 
 }  // namespace eth
@@ -41,6 +41,9 @@ using namespace dev::eth;
 using skale::State;
 
 namespace {
+/// Precompiled contracts up to this address come from Ethereum and depend only on input.
+Address const c_lastPurePrecompiled( 8 );
+
 std::string dumpStackAndMemory( LegacyVM const& _vm ) {
     ostringstream o;
     o << "\n    STACK\n";
@@ -312,6 +315,13 @@ bool Executive::call( CallParameters const& _p, u256 const& _gasPrice, Address c
 
             return true;  // true actually means "all finished - nothing more to be done regarding
                           // go().
+        } else if ( m_s.isSpeculative() && _p.codeAddress > c_lastPurePrecompiled ) {
+            // SKALE precompiled contracts work with files and config outside of the state,
+            // so they are executed only for real
+            m_s.abandonSpeculation();
+            m_gas = 0;
+            m_excepted = TransactionException::OutOfGas;
+            return true;
         } else {
             m_gas = ( u256 )( _p.gas - g );
             bytes output;
@@ -545,7 +555,7 @@ bool Executive::finalize() {
         m_s.addBalance( m_t.sender(), m_gas * m_t.gasPrice() );
 
         u256 feesEarned = ( m_t.gas() - m_gas ) * m_t.gasPrice();
-        m_s.addBalance( m_envInfo.author(), feesEarned );
+        m_s.addAuthorFees( m_envInfo.author(), feesEarned );
     }
 
     // Suicides...
@@ -42,7 +42,7 @@ public:
         bytesConstRef _data, bytesConstRef _code, h256 const& _codeHash, u256 const& _version,
         unsigned _depth, bool _isCreate, bool _staticCall, bool _readOnly = true )
         : ExtVMFace( _envInfo, _myAddress, _caller, _origin, _value, _gasPrice, _data,
-              _code.toBytes(), _codeHash, _version, _depth, _isCreate, _staticCall ),
+              _code, _codeHash, _version, _depth, _isCreate, _staticCall ),
           m_s( _s ),
           m_sealEngine( _sealEngine ),
           m_evmSchedule( initEvmSchedule( envInfo().number(), _version ) ),
@@ -27,6 +27,7 @@
 #include <libdevcore/Common.h>
 #include <libdevcore/RLP.h>
 #include <libethcore/Common.h>
+#include <limits>
 
 #ifdef __INTEL_COMPILER
 #pragma warning( disable : 1098 )  // the qualifier on this friend declaration is ignored
@@ -61,6 +62,15 @@ public:
     /// hash of latest block which should be filtered
     BlockNumber latest() const { return m_latest; }
 
+    AddressHash const& addresses() const { return m_addresses; }
+    std::array< h256Hash, 4 > const& topics() const { return m_topics; }
+
+    /// number of matching entries to skip, for paging through large results
+    size_t offset() const { return m_offset; }
+
+    /// maximal number of entries to return
+    size_t limit() const { return m_limit; }
+
     /// Range filter is a filter which doesn't care about addresses or topics
     /// Matches are all entries from earliest to latest
     /// @returns true if addresses and topics are unspecified
@@ -72,6 +82,8 @@ public:
     bool matches( LogBloom _bloom ) const;
     bool matches( Block const& _b, unsigned _i ) const;
     LogEntries matches( TransactionReceipt const& _r ) const;
+    /// @returns true if addresses and topics of @a _e match, block range is not checked
+    bool matches( LogEntry const& _e ) const;
 
     LogFilter address( Address _a ) {
         m_addresses.insert( _a );
@@ -90,6 +102,14 @@ public:
         m_latest = _e;
         return *this;
     }
+    LogFilter withOffset( size_t _offset ) {
+        m_offset = _offset;
+        return *this;
+    }
+    LogFilter withLimit( size_t _limit ) {
+        m_limit = _limit;
+        return *this;
+    }
 
     friend std::ostream& dev::eth::operator<<( std::ostream& _out, dev::eth::LogFilter const& _s );
 
@@ -98,6 +118,9 @@ private:
     std::array< h256Hash, 4 > m_topics;
     BlockNumber m_earliest = 0;
     BlockNumber m_latest = PendingBlock;
+    // paging does not change which entries match, so it is not a part of streamRLP()
+    size_t m_offset = 0;
+    size_t m_limit = std::numeric_limits< size_t >::max();
 };
 
 }  // namespace eth
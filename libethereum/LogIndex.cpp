@@ -0,0 +1,217 @@
+/*
+    Copyright (C) 2018-present, SKALE Labs
+
+    This file is part of skaled.
+
+    skaled is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skaled is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with skaled.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * @file LogIndex.cpp
+ * @date 2026
+ */
+
+#include "LogIndex.h"
+#include "BlockChain.h"
+
+#include <libdevcore/SHA3.h>
+
+#include <algorithm>
+#include <iterator>
+#include <map>
+
+using namespace std;
+using namespace dev;
+using namespace dev::eth;
+
+namespace {
+db::Slice const c_sliceFirstBlock( "logIndexStart" );
+db::Slice const c_sliceNextBlock( "logIndexNext" );
+
+// a posting is stored as three big-endian 32-bit numbers, so records grow by plain appends
+size_t const c_postingSize = 12;
+
+void putBigEndian( uint32_t _n, uint8_t* o_bytes ) {
+    for ( int i = 3; i >= 0; --i, _n >>= 8 )
+        o_bytes[i] = uint8_t( _n );
+}
+
+uint32_t getBigEndian( uint8_t const* _bytes ) {
+    return ( uint32_t( _bytes[0] ) << 24 ) | ( uint32_t( _bytes[1] ) << 16 ) |
+           ( uint32_t( _bytes[2] ) << 8 ) | uint32_t( _bytes[3] );
+}
+}  // namespace
+
+LogIndex::LogIndex( db::DatabaseFace* _db ) : m_db( _db ) {}
+
+void LogIndex::open( unsigned _nextBlock ) {
+    std::lock_guard< std::mutex > lock( m_mutex );
+    string const first = m_db->lookup( c_sliceFirstBlock );
+    if ( !first.empty() ) {
+        m_firstBlock = RLP( first ).toInt< unsigned >();
+        string const next = m_db->lookup( c_sliceNextBlock );
+        m_nextBlock = next.empty() ? m_firstBlock : RLP( next ).toInt< unsigned >();
+        return;
+    }
+    m_firstBlock = _nextBlock;
+    m_nextBlock = _nextBlock;
+    auto batch = m_db->createWriteBatch();
+    writeBounds( *batch );
+    m_db->commit( std::move( batch ) );
+}
+
+void LogIndex::onRotated() {
+    std::lock_guard< std::mutex > lock( m_mutex );
+    auto batch = m_db->createWriteBatch();
+    writeBounds( *batch );
+    m_db->commit( std::move( batch ) );
+}
+
+void LogIndex::writeBounds( db::WriteBatchFace& _batch ) const {
+    _batch.insert( c_sliceFirstBlock, ( db::Slice ) dev::ref( rlp( m_firstBlock ) ) );
+    _batch.insert( c_sliceNextBlock, ( db::Slice ) dev::ref( rlp( unsigned( m_nextBlock ) ) ) );
+}
+
+h256 LogIndex::recordKey( uint8_t _slot, bytesConstRef _term, unsigned _bucket ) {
+    bytes b( 1 + _term.size() + 4 );
+    b[0] = _slot;
+    _term.copyTo( bytesRef( b.data() + 1, _term.size() ) );
+    putBigEndian( _bucket, b.data() + 1 + _term.size() );
+    return sha3( b );
+}
+
+void LogIndex::appendPosting( string& io_record, LogPosition const& _position ) {
+    uint8_t b[c_postingSize];
+    putBigEndian( _position.block, b );
+    putBigEndian( _position.transaction, b + 4 );
+    putBigEndian( _position.log, b + 8 );
+    io_record.append( reinterpret_cast< char const* >( b ), c_postingSize );
+}
+
+LogPositions LogIndex::readPostings( string const& _record ) {
+    LogPositions ret( _record.size() / c_postingSize );
+    uint8_t const* p = reinterpret_cast< uint8_t const* >( _record.data() );
+    for ( auto& position : ret ) {
+        position.block = getBigEndian( p );
+        position.transaction = getBigEndian( p + 4 );
+        position.log = getBigEndian( p + 8 );
+        p += c_postingSize;
+    }
+    return ret;
+}
+
+void LogIndex::insert( unsigned _number, bytesConstRef _receipts ) {
+    TransactionReceipts receipts;
+    for ( auto const& r : RLP( _receipts ) )
+        receipts.emplace_back( r.data() );
+    insert( _number, receipts );
+}
+
+void LogIndex::insert( unsigned _number, TransactionReceipts const& _receipts ) {
+    if ( _number < m_nextBlock )
+        return;
+
+    // collect the block's postings per record first so that every record is written once
+    map< h256, string > added;
+    unsigned const bucket = _number / c_bucketBlocks;
+    LogPosition position;
+    position.block = _number;
+    for ( TransactionReceipt const& receipt : _receipts ) {
+        position.log = 0;
+        for ( LogEntry const& e : receipt.log() ) {
+            appendPosting( added[recordKey( c_addressSlot, e.address.ref(), bucket )], position );
+            for ( size_t i = 0; i < e.topics.size() && i < 4; ++i )
+                appendPosting( added[recordKey( uint8_t( c_addressSlot + 1 + i ),
+                                   e.topics[i].ref(), bucket )],
+                    position );
+            ++position.log;
+        }
+        ++position.transaction;
+    }
+
+    std::lock_guard< std::mutex > lock( m_mutex );
+    if ( _number < m_nextBlock )
+        return;
+    if ( bucket != m_cachedBucket || m_cachedRecords.size() > c_maxCachedRecords ) {
+        m_cachedRecords.clear();
+        m_cachedBucket = bucket;
+    }
+    auto batch = m_db->createWriteBatch();
+    for ( auto& a : added ) {
+        auto it = m_cachedRecords.find( a.first );
+        if ( it == m_cachedRecords.end() )
+            it = m_cachedRecords
+                     .emplace( a.first, m_db->lookup( toSlice( a.first, ExtraLogIndex ) ) )
+                     .first;
+        it->second += a.second;
+        batch->insert( toSlice( a.first, ExtraLogIndex ), db::Slice( it->second ) );
+    }
+    m_nextBlock = _number + 1;
+    writeBounds( *batch );
+    m_db->commit( std::move( batch ) );
+}
+
+template < class T >
+LogPositions LogIndex::termPostings( uint8_t _slot, T const& _terms, unsigned _bucket ) const {
+    LogPositions ret;
+    for ( auto const& t : _terms ) {
+        LogPositions p =
+            readPostings( m_db->lookup( toSlice( recordKey( _slot, t.ref(), _bucket ),
+                ExtraLogIndex ) ) );
+        ret.insert( ret.end(), p.begin(), p.end() );
+    }
+    sort( ret.begin(), ret.end() );
+    return ret;
+}
+
+LogPositions LogIndex::find(
+    LogFilter const& _filter, unsigned _earliest, unsigned _latest, size_t _limit ) const {
+    assert( !_filter.isRangeFilter() );
+    LogPositions ret;
+    if ( _earliest > _latest )
+        return ret;
+
+    for ( unsigned bucket = _earliest / c_bucketBlocks;
+          bucket <= _latest / c_bucketBlocks && ret.size() < _limit; ++bucket ) {
+        // intersect the postings of all constrained slots, stopping once nothing is left
+        LogPositions matched;
+        bool constrained = false;
+        auto const narrow = [&]( LogPositions&& _p ) {
+            if ( !constrained ) {
+                matched = std::move( _p );
+                constrained = true;
+                return;
+            }
+            LogPositions both;
+            set_intersection( matched.begin(), matched.end(), _p.begin(), _p.end(),
+                back_inserter( both ) );
+            matched.swap( both );
+        };
+
+        if ( !_filter.addresses().empty() )
+            narrow( termPostings( c_addressSlot, _filter.addresses(), bucket ) );
+        for ( unsigned i = 0; i < 4 && ( !constrained || !matched.empty() ); ++i )
+            if ( !_filter.topics()[i].empty() )
+                narrow( termPostings(
+                    uint8_t( c_addressSlot + 1 + i ), _filter.topics()[i], bucket ) );
+
+        for ( auto const& p : matched ) {
+            if ( p.block < _earliest || p.block > _latest )
+                continue;
+            if ( ret.size() >= _limit )
+                break;
+            ret.push_back( p );
+        }
+    }
+    return ret;
+}
@@ -0,0 +1,123 @@
+/*
+    Copyright (C) 2018-present, SKALE Labs
+
+    This file is part of skaled.
+
+    skaled is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skaled is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with skaled.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * @file LogIndex.h
+ * @date 2026
+ */
+
+#pragma once
+
+#include "LogFilter.h"
+
+#include <libdevcore/db.h>
+
+#include <atomic>
+#include <mutex>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+namespace dev {
+namespace eth {
+
+/// Position of a log entry on the chain.
+struct LogPosition {
+    unsigned block = 0;
+    unsigned transaction = 0;  ///< index of the receipt in the block
+    unsigned log = 0;          ///< index of the entry in the receipt
+
+    bool operator<( LogPosition const& _other ) const {
+        return std::tie( block, transaction, log ) <
+               std::tie( _other.block, _other.transaction, _other.log );
+    }
+    bool operator==( LogPosition const& _other ) const {
+        return block == _other.block && transaction == _other.transaction && log == _other.log;
+    }
+};
+
+using LogPositions = std::vector< LogPosition >;
+
+/**
+ * @brief Inverted index of logs kept in its own database under ExtraLogIndex.
+ * Every address, and every topic together with its slot, maps to the positions of the logs
+ * carrying it. Postings are grouped into records of c_bucketBlocks consecutive blocks, so that
+ * a range query reads one record per term and bucket instead of touching every block.
+ * The index depends on when a node started to keep it, so it must stay out of the databases
+ * covered by snapshot hash. It is written after the block is committed and may lag behind
+ * the chain after a crash, see nextBlock().
+ */
+class LogIndex {
+public:
+    /// Blocks per record. Records of the latest bucket are rewritten with every block that
+    /// adds to them, so larger buckets make queries cheaper and imports more expensive.
+    static constexpr unsigned c_bucketBlocks = 64;
+
+    explicit LogIndex( db::DatabaseFace* _db );
+
+    /// Reads the first indexed block, marking @a _nextBlock as such if the database is empty.
+    void open( unsigned _nextBlock );
+
+    /// Blocks below this number were imported without the index.
+    unsigned firstBlock() const { return m_firstBlock; }
+    /// Blocks from this number on are not indexed yet.
+    unsigned nextBlock() const { return m_nextBlock; }
+
+    /// Writes the first and next indexed blocks into the fresh database piece after a rotation.
+    void onRotated();
+
+    /// Writes postings for the logs in @a _receipts of block @a _number.
+    /// Blocks must be inserted in ascending order, blocks below nextBlock() are skipped so that
+    /// a block imported again after a restart is not indexed twice.
+    void insert( unsigned _number, bytesConstRef _receipts );
+    /// Same for receipts that are already decoded.
+    void insert( unsigned _number, TransactionReceipts const& _receipts );
+
+    /// @returns positions of logs in blocks [@a _earliest, @a _latest] that match the addresses
+    /// and topics of @a _filter, in chain order and at most @a _limit of them.
+    /// @a _filter must not be a range filter.
+    LogPositions find(
+        LogFilter const& _filter, unsigned _earliest, unsigned _latest, size_t _limit ) const;
+
+private:
+    /// Term slot of log addresses; topic slots follow it.
+    static constexpr uint8_t c_addressSlot = 0;
+    /// Records of the latest bucket kept in memory at most.
+    static constexpr size_t c_maxCachedRecords = 64 * 1024;
+
+    static h256 recordKey( uint8_t _slot, bytesConstRef _term, unsigned _bucket );
+    static void appendPosting( std::string& io_record, LogPosition const& _position );
+    static LogPositions readPostings( std::string const& _record );
+
+    /// Sorted union of the postings of @a _terms in @a _bucket.
+    template < class T >
+    LogPositions termPostings( uint8_t _slot, T const& _terms, unsigned _bucket ) const;
+
+    void writeBounds( db::WriteBatchFace& _batch ) const;
+
+    db::DatabaseFace* m_db;
+    unsigned m_firstBlock = 0;
+    std::atomic< unsigned > m_nextBlock{0};
+
+    std::mutex m_mutex;  ///< guards inserts and the records below
+    unsigned m_cachedBucket = 0;
+    std::unordered_map< h256, std::string > m_cachedRecords;  ///< latest bucket, by record key
+};
+
+}  // namespace eth
+}  // namespace dev
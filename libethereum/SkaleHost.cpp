@@ -60,6 +60,32 @@ using namespace dev::eth;
 
 const int SkaleHost::EXIT_FORCEFULLTY_SECONDS = 20;
 
+namespace {
+namespace performance = skutils::task::performance;
+
+const performance::trace_point c_traceTracepoint{"trace", "tracepoint", "name", {"count"}};
+const performance::trace_point c_traceReceiveTransaction{
+    "bc/receive_transaction", "receive", nullptr, {"hash"}};
+const performance::trace_point c_traceFetchTransactions{
+    "bc/fetch_transactions", "fetch", nullptr, {"limit", "stateRoot"}};
+const performance::trace_point c_traceDropBadTransactions{
+    "bc/fetch_transactions", "drop", nullptr, {"dropped"}};
+const performance::trace_point c_traceCreateBlock{
+    "bc/create_block", "b-create", nullptr, {"blockID", "timeStamp", "transactions"}};
+const performance::trace_point c_traceImportBlock{
+    "bc/import_block", "b-import", nullptr, {"blockID", "transactions", "succeeded"}};
+const performance::trace_point c_traceBroadcast{
+    "bc/broadcast", "broadcast", nullptr, {"transactions", "hash"}};
+
+// first 8 bytes of a hash, enough to find it among traced events
+uint64_t hashPrefix( h256 const& _hash ) {
+    uint64_t ret = 0;
+    for ( size_t i = 0; i < sizeof( ret ); ++i )
+        ret = ( ret << 8 ) | _hash[i];
+    return ret;
+}
+}  // namespace
+
 #ifndef CONSENSUS
 #define CONSENSUS 1
 #endif
@@ -177,13 +203,16 @@ void ConsensusExtImpl::terminateApplication() {
 }
 
 SkaleHost::SkaleHost( dev::eth::Client& _client, const ConsensusFactory* _consFactory ) try
-    : m_client( _client ),
+    : m_proposed( _client.transactionQueueLimits().current +
+                  _client.transactionQueueLimits().future ),
+      m_client( _client ),
       m_tq( _client.m_tq ),
       total_sent( 0 ),
       total_arrived( 0 ) {
     m_debugTracer.call_on_tracepoint( [this]( const std::string& name ) {
-        skutils::task::performance::action action(
-            "trace/" + name, std::to_string( m_debugTracer.get_tracepoint_count( name ) ) );
+        performance::trace_scope trace( c_traceTracepoint, name );
+        if ( trace.is_active() )
+            trace.set_arg( 0, m_debugTracer.get_tracepoint_count( name ) );
 
         // HACK reduce TRACEPOINT log output
         static uint64_t last_block_when_log = -1;
@@ -225,24 +254,26 @@ SkaleHost::~SkaleHost() {}
 void SkaleHost::logState() {
     LOG( m_debugLogger ) << cc::debug( " sent_to_consensus = " ) << total_sent
                          << cc::debug( " got_from_consensus = " ) << total_arrived
-                         << cc::debug( " m_transaction_cache = " ) << m_m_transaction_cache.size()
+                         << cc::debug( " m_proposed = " ) << m_proposed.size()
                          << cc::debug( " m_tq = " ) << m_tq.status().current
                          << cc::debug( " m_bcast_counter = " ) << m_bcast_counter;
 }
 
+Transaction SkaleHost::decodeTransaction( bytesConstRef _rlp ) {
+    if ( auto cached = m_client.verifiedTransactionCache().find( sha3( _rlp ) ) )
+        return *cached;
+    return Transaction( _rlp, CheckTransaction::None );
+}
+
 h256 SkaleHost::receiveTransaction( std::string _rlp ) {
-    Transaction transaction( jsToBytes( _rlp, OnFailed::Throw ), CheckTransaction::None );
+    bytes rlp = jsToBytes( _rlp, OnFailed::Throw );
+    Transaction transaction = decodeTransaction( &rlp );
 
     h256 sha = transaction.sha3();
 
-    //
-    static std::atomic_size_t g_nReceiveTransactionsTaskNumber = 0;
-    size_t nReceiveTransactionsTaskNumber = g_nReceiveTransactionsTaskNumber++;
-    std::string strPerformanceQueueName = "bc/receive_transaction";
-    std::string strPerformanceActionName =
-        skutils::tools::format( "receive task %zu", nReceiveTransactionsTaskNumber );
-    skutils::task::performance::action a( strPerformanceQueueName, strPerformanceActionName );
-    //
+    performance::trace_scope trace( c_traceReceiveTransaction );
+    if ( trace.is_active() )
+        trace.set_arg( 0, hashPrefix( sha ) );
     m_debugTracer.tracepoint( "receive_transaction" );
     {
         std::lock_guard< std::mutex > localGuard( m_receivedMutex );
@@ -264,6 +295,39 @@ h256 SkaleHost::receiveTransaction( std::string _rlp ) {
     return sha;
 }
 
+size_t SkaleHost::receiveTransactions( bytesConstRef _rlpList ) {
+    MICROPROFILE_SCOPEI( "SkaleHost", "receiveTransactions", MP_BISQUE );
+
+    Transactions transactions;
+    for ( const auto& item : RLP( _rlpList ) )
+        transactions.push_back( decodeTransaction( item.data() ) );
+
+    m_debugTracer.tracepoint( "receive_transactions" );
+    {
+        std::lock_guard< std::mutex > localGuard( m_receivedMutex );
+        for ( const Transaction& transaction : transactions )
+            m_received.insert( transaction.sha3() );
+        LOG( m_debugLogger ) << "m_received = " << m_received.size() << std::endl;
+    }
+
+    ++m_receivedBatches;
+    m_receivedTransactions += transactions.size();
+
+    // one bad transaction should not prevent import of others
+    std::vector< ImportResult > results = m_client.importTransactions( transactions );
+    size_t imported = 0;
+    for ( size_t i = 0; i < results.size(); ++i ) {
+        if ( results[i] == ImportResult::Success ) {
+            m_debugTracer.tracepoint( "receive_transaction_success" );
+            ++imported;
+        } else
+            clog( VerbosityInfo, "skale-host" )
+                << "Received bad transaction through broadcast: " << transactions[i].sha3()
+                << " import result " << static_cast< int >( results[i] );
+    }
+    return imported;
+}
+
 // keeps mutex unlocked when exists
 template < class M >
 class unlock_guard {
@@ -310,19 +374,9 @@ ConsensusExtFace::transactions_vector SkaleHost::pendingTransactions(
 
     h256Hash to_delete;
 
-    //
-    static std::atomic_size_t g_nFetchTransactionsTaskNumber = 0;
-    size_t nFetchTransactionsTaskNumber = g_nFetchTransactionsTaskNumber++;
-    std::string strPerformanceQueueName_fetch_transactions = "bc/fetch_transactions";
-    std::string strPerformanceActionName_fetch_transactions =
-        skutils::tools::format( "fetch task %zu", nFetchTransactionsTaskNumber );
-    skutils::task::performance::json jsn = skutils::task::performance::json::object();
-    jsn["limit"] = toJS( _limit );
-    jsn["stateRoot"] = toJS( _stateRoot );
-    skutils::task::performance::action a_fetch_transactions(
-        strPerformanceQueueName_fetch_transactions, strPerformanceActionName_fetch_transactions,
-        jsn );
-    //
+    performance::trace_scope traceFetch( c_traceFetchTransactions, _limit );
+    if ( traceFetch.is_active() )
+        traceFetch.set_arg( 1, hashPrefix( h256( _stateRoot ) ) );
     m_debugTracer.tracepoint( "fetch_transactions" );
 
     int counter = 0;
@@ -354,9 +408,7 @@ ConsensusExtFace::transactions_vector SkaleHost::pendingTransactions(
         } );
 
 
-    //
-    a_fetch_transactions.finish();
-    //
+    traceFetch.finish();
 
     if ( counter++ == 0 )
         m_pending_createMutex.lock();
@@ -367,23 +419,7 @@ ConsensusExtFace::transactions_vector SkaleHost::pendingTransactions(
 
     {
         std::lock_guard< std::mutex > localGuard( m_receivedMutex );
-        //
-        static std::atomic_size_t g_nDropBadTransactionsTaskNumber = 0;
-        size_t nDropBadTransactionsTaskNumber = g_nDropBadTransactionsTaskNumber++;
-        std::string strPerformanceQueueName_drop_bad_transactions = "bc/fetch_transactions";
-        std::string strPerformanceActionName_drop_bad_transactions =
-            skutils::tools::format( "fetch task %zu", nDropBadTransactionsTaskNumber );
-        skutils::task::performance::json jsn = skutils::task::performance::json::object();
-        skutils::task::performance::json jarrDroppedTransactions =
-            skutils::task::performance::json::array();
-        for ( auto sha : to_delete ) {
-            jarrDroppedTransactions.push_back( toJS( sha ) );
-        }
-        jsn["droppedTransactions"] = jarrDroppedTransactions;
-        skutils::task::performance::action a_drop_bad_transactions(
-            strPerformanceQueueName_drop_bad_transactions,
-            strPerformanceActionName_drop_bad_transactions, jsn );
-        //
+        performance::trace_scope trace( c_traceDropBadTransactions, to_delete.size() );
         for ( auto sha : to_delete ) {
             m_debugTracer.tracepoint( "drop_bad" );
             m_tq.drop( sha );
@@ -405,11 +441,12 @@ ConsensusExtFace::transactions_vector SkaleHost::pendingTransactions(
 
             h256 sha = txn.sha3();
 
-            if ( m_m_transaction_cache.find( sha.asArray() ) != m_m_transaction_cache.cend() )
+            if ( m_proposed.contains( sha ) )
                 m_debugTracer.tracepoint( "sent_txn_again" );
             else {
                 m_debugTracer.tracepoint( "sent_txn_new" );
-                m_m_transaction_cache[sha.asArray()] = txn;
+                m_proposed.insert( sha, true );
+                m_client.verifiedTransactionCache().insert( txn );
             }
 
             out_vector.push_back( txn.rlp() );
@@ -449,27 +486,8 @@ ConsensusExtFace::transactions_vector SkaleHost::pendingTransactions(
 
 void SkaleHost::createBlock( const ConsensusExtFace::transactions_vector& _approvedTransactions,
     uint64_t _timeStamp, uint64_t _blockID, u256 _gasPrice, u256 _stateRoot ) try {
-    //
-    static std::atomic_size_t g_nCreateBlockTaskNumber = 0;
-    size_t nCreateBlockTaskNumber = g_nCreateBlockTaskNumber++;
-    std::string strPerformanceQueueName_create_block = "bc/create_block";
-    std::string strPerformanceActionName_create_block =
-        skutils::tools::format( "b-create %zu", nCreateBlockTaskNumber );
-    skutils::task::performance::json jsn_create_block = skutils::task::performance::json::object();
-    jsn_create_block["blockID"] = toJS( _blockID );
-    jsn_create_block["timeStamp"] = toJS( _timeStamp );
-    jsn_create_block["gasPrice"] = toJS( _gasPrice );
-    jsn_create_block["stateRoot"] = toJS( _stateRoot );
-    skutils::task::performance::json jarrApprovedTransactions =
-        skutils::task::performance::json::array();
-    for ( auto it = _approvedTransactions.begin(); it != _approvedTransactions.end(); ++it ) {
-        const bytes& data = *it;
-        h256 sha = sha3( data );
-        jarrApprovedTransactions.push_back( toJS( sha ) );
-    }
-    jsn_create_block["approvedTransactions"] = jarrApprovedTransactions;
-    skutils::task::performance::action a_create_block( strPerformanceQueueName_create_block,
-        strPerformanceActionName_create_block, jsn_create_block );
+    performance::trace_scope traceCreate(
+        c_traceCreateBlock, _blockID, _timeStamp, _approvedTransactions.size() );
 
     LOG( m_traceLogger ) << cc::debug( "createBlock " ) << cc::notice( "ID" ) << cc::debug( " = " )
                          << cc::warn( "#" ) << cc::num10( _blockID ) << std::endl;
@@ -502,45 +520,52 @@ void SkaleHost::createBlock( const ConsensusExtFace::transactions_vector& _appro
     }
 
     std::vector< Transaction > out_txns;  // resultant Transaction vector
+    std::vector< size_t > bornIndexes;    // decoded consensus-born transactions in out_txns
 
     std::atomic_bool have_consensus_born = false;  // means we need to re-verify old txns
 
     m_debugTracer.tracepoint( "drop_good_transactions" );
 
-    skutils::task::performance::json jarrProcessedTxns = skutils::task::performance::json::array();
-
     for ( auto it = _approvedTransactions.begin(); it != _approvedTransactions.end(); ++it ) {
         const bytes& data = *it;
         h256 sha = sha3( data );
         LOG( m_traceLogger ) << cc::debug( "Arrived txn: " ) << sha << std::endl;
-        jarrProcessedTxns.push_back( toJS( sha ) );
 #ifdef DEBUG_TX_BALANCE
-        if ( sent.count( sha ) != m_transaction_cache.count( sha.asArray() ) ) {
+        if ( sent.count( sha ) != m_proposed.contains( sha ) ) {
             std::cerr << cc::error( "createBlock assert" ) << std::endl;
             //            sleep(200);
-            assert( sent.count( sha ) == m_transaction_cache.count( sha.asArray() ) );
+            assert( sent.count( sha ) == m_proposed.contains( sha ) );
         }
         assert( arrived.count( sha ) == 0 );
         arrived.insert( sha );
 #endif
 
+        boost::optional< Transaction > cached = m_client.verifiedTransactionCache().find( sha );
+
         // if already known
-        // TODO clear occasionally this cache?!
-        if ( m_m_transaction_cache.find( sha.asArray() ) != m_m_transaction_cache.cend() ) {
-            Transaction t = m_m_transaction_cache.at( sha.asArray() );
+        if ( m_proposed.contains( sha ) ) {
+            Transaction t =
+                cached ? *cached : Transaction( data, CheckTransaction::Everything, true );
+            t.checkOutExternalGas( m_client.chainParams().externalGasDifficulty );
             out_txns.push_back( t );
             LOG( m_debugLogger ) << "Dropping good txn " << sha << std::endl;
             m_debugTracer.tracepoint( "drop_good" );
             m_tq.dropGood( t );
             MICROPROFILE_SCOPEI( "SkaleHost", "erase from caches", MP_GAINSBORO );
-            m_m_transaction_cache.erase( sha.asArray() );
+            m_proposed.remove( sha );
             std::lock_guard< std::mutex > localGuard( m_receivedMutex );
             m_received.erase( sha );
             LOG( m_debugLogger ) << "m_received = " << m_received.size() << std::endl;
         } else {
-            Transaction t( data, CheckTransaction::Everything, true );
-            t.checkOutExternalGas( m_client.chainParams().externalGasDifficulty );
-            out_txns.push_back( t );
+            if ( cached ) {
+                cached->checkOutExternalGas( m_client.chainParams().externalGasDifficulty );
+                out_txns.push_back( *cached );
+            } else {
+                // sender is recovered below for all such transactions at once
+                Transaction t( data, CheckTransaction::Cheap, true );
+                bornIndexes.push_back( out_txns.size() );
+                out_txns.push_back( t );
+            }
             LOG( m_debugLogger ) << "Will import consensus-born txn!";
             m_debugTracer.tracepoint( "import_consensus_born" );
             have_consensus_born = true;
@@ -553,28 +578,33 @@ void SkaleHost::createBlock( const ConsensusExtFace::transactions_vector& _appro
         }
 
     }  // for
-    // TODO Monitor somehow m_transaction_cache and delete long-lasting elements?
+
+    if ( !bornIndexes.empty() ) {
+        MICROPROFILE_SCOPEI( "SkaleHost", "recover senders", MP_GAINSBORO );
+        std::vector< TransactionBase const* > born;
+        for ( size_t i : bornIndexes )
+            born.push_back( &out_txns[i] );
+        std::vector< bool > recovered = TransactionBase::recoverSenders( born );
+        for ( size_t j = 0; j < bornIndexes.size(); ++j ) {
+            Transaction& t = out_txns[bornIndexes[j]];
+            // full check marks transaction as invalid exactly as before
+            if ( !recovered[j] )
+                t = Transaction(
+                    _approvedTransactions[bornIndexes[j]], CheckTransaction::Everything, true );
+            t.checkOutExternalGas( m_client.chainParams().externalGasDifficulty );
+        }
+    }
 
     total_arrived += out_txns.size();
 
     assert( _blockID == m_client.number() + 1 );
 
-    //
-    a_create_block.finish();
-    //
-    static std::atomic_size_t g_nImportBlockTaskNumber = 0;
-    size_t nImportBlockTaskNumber = g_nImportBlockTaskNumber++;
-    std::string strPerformanceQueueName_import_block = "bc/import_block";
-    std::string strPerformanceActionName_import_block =
-        skutils::tools::format( "b-import %zu", nImportBlockTaskNumber );
-    skutils::task::performance::json jsn_import_block = skutils::task::performance::json::object();
-    jsn_import_block["txns"] = jarrProcessedTxns;
-    skutils::task::performance::action a_import_block( strPerformanceQueueName_import_block,
-        strPerformanceActionName_import_block, jsn_import_block );
-    //
+    traceCreate.finish();
+    performance::trace_scope traceImport( c_traceImportBlock, _blockID, out_txns.size() );
     m_debugTracer.tracepoint( "import_block" );
 
     size_t n_succeeded = m_client.importTransactionsAsBlock( out_txns, _gasPrice, _timeStamp );
+    traceImport.set_arg( 2, n_succeeded );
     if ( n_succeeded != out_txns.size() )
         penalizePeer();
 
@@ -693,50 +723,72 @@ void SkaleHost::stopWorking() {
 
 void SkaleHost::broadcastFunc() {
     dev::setThreadName( "broadcastFunc" );
-    size_t nBroadcastTaskNumber = 0;
+
+    const unsigned batchSize = m_client.chainParams().broadcastBatchSize_;
+    const std::chrono::microseconds batchLatency(
+        m_client.chainParams().broadcastBatchLatencyMicroseconds_ );
+
     while ( !m_exitNeeded ) {
         try {
             m_broadcaster->broadcast( "" );  // HACK this is just to initialize sockets
 
-            dev::eth::Transactions txns = m_tq.topTransactionsSync( 1, 0, 1 );
+            dev::eth::Transactions txns = m_tq.topTransactionsSync( batchSize, 0, 1 );
             if ( txns.empty() )  // means timeout
                 continue;
 
+            auto batchStart = std::chrono::steady_clock::now();
+
+            // give the batch a chance to fill up, but flush as soon as it is full
+            if ( txns.size() < batchSize && batchLatency.count() > 0 ) {
+                auto deadline = boost::chrono::steady_clock::now() +
+                                boost::chrono::microseconds( batchLatency.count() );
+                while ( txns.size() < batchSize ) {
+                    dev::eth::Transactions more =
+                        m_tq.topTransactionsUntil( batchSize - txns.size(), deadline, 0, 1 );
+                    if ( more.empty() )  // means timeout
+                        break;
+                    txns.insert( txns.end(), more.begin(), more.end() );
+                }
+            }
+
             this->logState();
 
             MICROPROFILE_SCOPEI( "SkaleHost", "broadcastFunc", MP_BISQUE );
 
-            assert( txns.size() == 1 );
-            Transaction& txn = txns[0];
-            h256 sha = txn.sha3();
-
             // TODO XXX such blocks are bad :(
-            size_t received;
+            dev::eth::Transactions toBroadcast;
             {
                 std::lock_guard< std::mutex > lock( m_receivedMutex );
-                received = m_received.count( sha );
+                for ( Transaction& txn : txns ) {
+                    if ( m_received.count( txn.sha3() ) == 0 )
+                        toBroadcast.push_back( std::move( txn ) );
+                    else
+                        m_debugTracer.tracepoint( "broadcast_already_have" );
+                }
             }
 
-            if ( received == 0 ) {
+            if ( !toBroadcast.empty() ) {
                 try {
                     if ( !m_broadcastPauseFlag ) {
                         MICROPROFILE_SCOPEI(
                             "SkaleHost", "broadcastFunc.broadcast", MP_CHARTREUSE1 );
-                        std::string rlp = toJS( txn.rlp() );
-                        std::string h = toJS( txn.sha3() );
-                        //
-                        std::string strPerformanceQueueName = "bc/broadcast";
-                        std::string strPerformanceActionName =
-                            skutils::tools::format( "broadcast %zu", nBroadcastTaskNumber++ );
-                        skutils::task::performance::json jsn =
-                            skutils::task::performance::json::object();
-                        jsn["rlp"] = rlp;
-                        jsn["hash"] = h;
-                        skutils::task::performance::action a(
-                            strPerformanceQueueName, strPerformanceActionName, jsn );
-                        //
-                        m_debugTracer.tracepoint( "broadcast" );
-                        m_broadcaster->broadcast( rlp );
+                        performance::trace_scope trace( c_traceBroadcast, toBroadcast.size() );
+                        if ( trace.is_active() )
+                            trace.set_arg( 1, hashPrefix( toBroadcast[0].sha3() ) );
+
+                        if ( batchSize == 1 ) {
+                            m_debugTracer.tracepoint( "broadcast" );
+                            m_broadcaster->broadcast( toJS( toBroadcast[0].rlp() ) );
+                        } else {
+                            RLPStream rlpList( toBroadcast.size() );
+                            for ( const Transaction& txn : toBroadcast ) {
+                                rlpList.appendRaw( txn.rlp() );
+                                m_debugTracer.tracepoint( "broadcast" );
+                            }
+                            m_broadcaster->broadcastBatch( rlpList.out() );
+                        }
+
+                        noteBroadcastedBatch( toBroadcast.size(), batchStart );
                     }
                 } catch ( const std::exception& ex ) {
                     cwarn << "BROADCAST EXCEPTION CAUGHT" << endl;
@@ -744,10 +796,8 @@ void SkaleHost::broadcastFunc() {
                 }  // catch
 
             }  // if
-            else
-                m_debugTracer.tracepoint( "broadcast_already_have" );
 
-            ++m_bcast_counter;
+            m_bcast_counter += txns.size();
 
             logState();
         } catch ( const std::exception& ex ) {
@@ -764,6 +814,33 @@ void SkaleHost::broadcastFunc() {
     m_broadcaster->stopService();
 }
 
+void SkaleHost::noteBroadcastedBatch(
+    size_t _size, std::chrono::steady_clock::time_point _start ) {
+    uint64_t latency = std::chrono::duration_cast< std::chrono::microseconds >(
+        std::chrono::steady_clock::now() - _start )
+                           .count();
+    ++m_sentBatches;
+    m_sentTransactions += _size;
+    m_totalBroadcastLatency += latency;
+    // only broadcast thread writes these
+    if ( _size > m_maxBatchSize )
+        m_maxBatchSize = _size;
+    if ( latency > m_maxBroadcastLatency )
+        m_maxBroadcastLatency = latency;
+}
+
+SkaleHost::BroadcastStats SkaleHost::broadcastStats() const {
+    BroadcastStats stats;
+    stats.sentBatches = m_sentBatches;
+    stats.sentTransactions = m_sentTransactions;
+    stats.maxBatchSize = m_maxBatchSize;
+    stats.totalLatencyMicroseconds = m_totalBroadcastLatency;
+    stats.maxLatencyMicroseconds = m_maxBroadcastLatency;
+    stats.receivedBatches = m_receivedBatches;
+    stats.receivedTransactions = m_receivedTransactions;
+    return stats;
+}
+
 u256 SkaleHost::getGasPrice() const {
     return m_consensus->getPriceForBlockId( m_client.number() );
 }
@@ -32,6 +32,7 @@
 #include <libdevcore/Common.h>
 #include <libdevcore/HashingThreadSafeQueue.h>
 #include <libdevcore/Log.h>
+#include <libdevcore/LruCache.h>
 #include <libdevcore/Worker.h>
 #include <libethcore/ChainOperationParams.h>
 #include <libethcore/Common.h>
@@ -41,6 +42,7 @@
 #include <jsonrpccpp/client/client.h>
 
 #include <atomic>
+#include <chrono>
 #include <map>
 #include <memory>
 #include <mutex>
@@ -116,6 +118,19 @@ public:
     void onBlockImported( dev::eth::BlockHeader const& _info );
 
     dev::h256 receiveTransaction( std::string );
+    // imports RLP list of transactions broadcasted by other node
+    size_t receiveTransactions( dev::bytesConstRef _rlpList );
+
+    struct BroadcastStats {
+        uint64_t sentBatches = 0;
+        uint64_t sentTransactions = 0;
+        uint64_t maxBatchSize = 0;
+        uint64_t totalLatencyMicroseconds = 0;  // from getting batch from queue till sending
+        uint64_t maxLatencyMicroseconds = 0;
+        uint64_t receivedBatches = 0;
+        uint64_t receivedTransactions = 0;
+    };
+    BroadcastStats broadcastStats() const;
 
     dev::u256 getGasPrice() const;
 
@@ -151,6 +166,8 @@ private:
 
     std::thread m_broadcastThread;
     void broadcastFunc();
+    // takes transaction with known sender from the client's cache if possible
+    dev::eth::Transaction decodeTransaction( dev::bytesConstRef _rlp );
     dev::h256Hash m_received;
     std::mutex m_receivedMutex;
 
@@ -162,6 +179,15 @@ private:
 
     std::atomic_int m_bcast_counter = 0;
 
+    void noteBroadcastedBatch( size_t _size, std::chrono::steady_clock::time_point _start );
+    std::atomic_uint64_t m_sentBatches = 0;
+    std::atomic_uint64_t m_sentTransactions = 0;
+    std::atomic_uint64_t m_maxBatchSize = 0;
+    std::atomic_uint64_t m_totalBroadcastLatency = 0;
+    std::atomic_uint64_t m_maxBroadcastLatency = 0;
+    std::atomic_uint64_t m_receivedBatches = 0;
+    std::atomic_uint64_t m_receivedTransactions = 0;
+
     void penalizePeer(){};  // fake function for now
 
     int64_t m_lastBlockWithBornTransactions = -1;  // to track txns need re-verification
@@ -174,9 +200,9 @@ private:
     std::atomic_bool m_consensusPaused = false;
     std::atomic_bool m_broadcastPauseFlag = false;  // not pause - just ignore
 
-    std::map< std::array< uint8_t, 32 >, dev::eth::Transaction >
-        m_m_transaction_cache;  // used to find Transaction objects when
-                                // creating block
+    // hashes of transactions sent to consensus, the transactions themselves are found in
+    // Client::verifiedTransactionCache() when creating block
+    dev::LruCache< dev::h256, bool > m_proposed;
     dev::eth::Client& m_client;
     dev::eth::TransactionQueue& m_tq;  // transactions ready to go to consensus
 
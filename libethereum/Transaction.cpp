@@ -203,6 +203,15 @@ void Transaction::checkOutExternalGas( u256 const& _difficulty ) {
     }
 }
 
+std::vector< bool > dev::eth::recoverSenders(
+    Transactions const& _transactions, unsigned _threads ) {
+    std::vector< TransactionBase const* > bases;
+    bases.reserve( _transactions.size() );
+    for ( auto const& t : _transactions )
+        bases.push_back( &t );
+    return TransactionBase::recoverSenders( bases, _threads );
+}
+
 LocalisedTransaction::LocalisedTransaction( const Transaction& _t, const h256& _blockHash,
     unsigned _transactionIndex, BlockNumber _blockNumber )
     : Transaction( _t ),
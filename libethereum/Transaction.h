@@ -132,6 +132,9 @@ private:
 /// Nice name for vector of Transaction.
 using Transactions = std::vector< Transaction >;
 
+/// Recover senders of @a _transactions at once, see TransactionBase::recoverSenders().
+std::vector< bool > recoverSenders( Transactions const& _transactions, unsigned _threads = 0 );
+
 class LocalisedTransaction : public Transaction {
 public:
     LocalisedTransaction( Transaction const& _t, h256 const& _blockHash, unsigned _transactionIndex,
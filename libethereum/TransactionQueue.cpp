@@ -27,6 +27,7 @@
 #include <libdevcore/Log.h>
 #include <libethcore/Exceptions.h>
 
+#include <algorithm>
 #include <list>
 #include <thread>
 #include <vector>
@@ -38,9 +39,11 @@ using namespace dev::eth;
 namespace {
 constexpr size_t c_maxVerificationQueueSize = 8192;
 constexpr size_t c_maxDroppedTransactionCount = 1024;
+constexpr size_t c_maxVerificationBatchSize = 64;  ///< Transactions taken by a verifier at once
 }  // namespace
 
-TransactionQueue::TransactionQueue( unsigned _limit, unsigned _futureLimit )
+TransactionQueue::TransactionQueue(
+    unsigned _limit, unsigned _futureLimit, unsigned _verifierThreads )
     : m_dropped{c_maxDroppedTransactionCount},
       m_current( PriorityCompare{*this} ),
       m_limit( _limit ),
@@ -51,8 +54,7 @@ TransactionQueue::TransactionQueue( unsigned _limit, unsigned _futureLimit )
         return;
     } );
 
-    unsigned verifierThreads = 0;  // std::max( thread::hardware_concurrency(), 3U ) - 2U;
-    for ( unsigned i = 0; i < verifierThreads; ++i )
+    for ( unsigned i = 0; i < _verifierThreads; ++i )
         m_verifiers.emplace_back( [this, i]() {
             setThreadName( "txcheck" + toString( i ) );
             this->verifierBody();
@@ -63,6 +65,10 @@ TransactionQueue::~TransactionQueue() {
     HandleDestruction();
 }
 
+unsigned TransactionQueue::defaultVerifierThreads() {
+    return std::max( thread::hardware_concurrency(), 3U ) - 2U;
+}
+
 void TransactionQueue::HandleDestruction() {
     std::list< std::thread > listAwait;
     {
@@ -131,6 +137,118 @@ ImportResult TransactionQueue::import( Transaction const& _transaction, IfDroppe
     return ret;
 }
 
+std::vector< ImportResult > TransactionQueue::importBatch(
+    Transactions const& _transactions, Verifier const& _verifier, IfDropped _ik ) {
+    auto batch = std::make_shared< VerificationBatch >( _transactions, _verifier );
+
+    // let verifier threads help, this thread verifies transactions too
+    bool parallel = !m_verifiers.empty() && _transactions.size() > 1;
+    if ( m_verifiers.empty() )
+        recoverSenders( _transactions );
+    if ( parallel ) {
+        {
+            Guard l( x_queue );
+            m_batches.push_back( batch );
+        }
+        m_queueReady.notify_all();
+    }
+
+    verifyBatch( *batch );
+
+    if ( parallel ) {
+        unique_lock< Mutex > l( x_queue );
+        m_batchVerified.wait( l, [&]() { return batch->done == batch->count; } );
+        auto it = std::find( m_batches.begin(), m_batches.end(), batch );
+        if ( it != m_batches.end() )
+            m_batches.erase( it );
+    }
+
+    return importVerified( _transactions, batch->valid, _ik );
+}
+
+bool TransactionQueue::verify( Transaction const& _transaction, Verifier const& _verifier ) {
+    // zero signature is reported by importVerified()
+    if ( _transaction.hasZeroSignature() )
+        return true;
+    try {
+        _transaction.sender();  // EC recovery, throws on invalid signature
+        if ( _verifier )
+            _verifier( _transaction );
+        return true;
+    } catch ( Exception const& _e ) {
+        LOG( m_loggerDetail ) << "Ignoring invalid transaction " << _transaction.sha3() << ": "
+                              << _e.what();
+    } catch ( std::exception const& _e ) {
+        LOG( m_loggerDetail ) << "Ignoring invalid transaction " << _transaction.sha3() << ": "
+                              << _e.what();
+    }
+    return false;
+}
+
+void TransactionQueue::verifyBatch( VerificationBatch& _batch ) {
+    // the caller may have returned already, don't touch its data unless an index is claimed
+    for ( size_t i = _batch.next++; i < _batch.count; i = _batch.next++ ) {
+        _batch.valid[i] = verify( _batch.transactions[i], _batch.verifier );
+        if ( ++_batch.done == _batch.count ) {
+            Guard l( x_queue );
+            m_batchVerified.notify_all();
+        }
+    }
+}
+
+std::vector< ImportResult > TransactionQueue::importVerified(
+    Transactions const& _transactions, std::vector< char > const& _valid, IfDropped _ik ) {
+    std::vector< ImportResult > results;
+    results.reserve( _transactions.size() );
+
+    MICROPROFILE_SCOPEI( "TransactionQueue", "importVerified", MP_THISTLE );
+    WriteGuard l( m_lock );
+    for ( size_t i = 0; i < _transactions.size(); ++i ) {
+        Transaction const& t = _transactions[i];
+        if ( t.hasZeroSignature() ) {
+            results.push_back( ImportResult::ZeroSignature );
+            continue;
+        }
+        if ( !_valid[i] ) {
+            results.push_back( ImportResult::Malformed );
+            continue;
+        }
+        h256 h = t.sha3( WithSignature );
+        ImportResult ir = check_WITH_LOCK( h, _ik );
+        if ( ir == ImportResult::Success )
+            ir = manageImport_WITH_LOCK( h, t );
+        results.push_back( ir );
+    }
+    return results;
+}
+
+void TransactionQueue::importUnverified( std::vector< UnverifiedTransaction >& _work ) {
+    Transactions transactions;
+    std::vector< h512 > nodeIds;
+    transactions.reserve( _work.size() );
+    nodeIds.reserve( _work.size() );
+    for ( auto& w : _work ) {
+        try {
+            // signature is checked by verify()
+            transactions.emplace_back( w.transaction, CheckTransaction::Cheap );
+            nodeIds.push_back( w.nodeId );
+        } catch ( Exception const& ) {
+            m_onImport( ImportResult::Malformed, sha3( w.transaction ), w.nodeId );
+        }
+    }
+
+    // verifier threads already run in parallel, so recover in this thread only
+    recoverSenders( transactions, m_verifiers.empty() ? 0 : 1 );
+    std::vector< char > valid( transactions.size() );
+    for ( size_t i = 0; i < transactions.size(); ++i )
+        valid[i] = verify( transactions[i], Verifier() );
+
+    std::vector< ImportResult > results =
+        importVerified( transactions, valid, IfDropped::Ignore );
+    for ( size_t i = 0; i < transactions.size(); ++i )
+        m_onImport( results[i], transactions[i].sha3(), nodeIds[i] );
+}
+
 Transactions TransactionQueue::topTransactions( unsigned _limit, h256Hash const& _avoid ) const {
     return topTransactions(
         _limit, [&]( const Transaction& t ) -> bool { return _avoid.count( t.sha3() ) == 0; } );
@@ -402,6 +520,14 @@ void TransactionQueue::clear() {
 }
 
 void TransactionQueue::enqueue( RLP const& _data, h512 const& _nodeId ) {
+    if ( m_verifiers.empty() ) {
+        std::vector< UnverifiedTransaction > work;
+        for ( unsigned i = 0; i < _data.itemCount(); ++i )
+            work.emplace_back( _data[i].data(), _nodeId );
+        importUnverified( work );
+        return;
+    }
+
     bool queued = false;
     {
         Guard l( x_queue );
@@ -422,32 +548,45 @@ void TransactionQueue::enqueue( RLP const& _data, h512 const& _nodeId ) {
 
 void TransactionQueue::verifierBody() {
     while ( !m_aborting ) {
-        UnverifiedTransaction work;
+        std::vector< UnverifiedTransaction > work;
+        std::shared_ptr< VerificationBatch > batch;
 
         {  // block
             MICROPROFILE_SCOPEI( "TransactionQueue", "unique_lock<Mutex> l(x_queue)", MP_DIMGRAY );
             unique_lock< Mutex > l( x_queue );
             {
                 MICROPROFILE_SCOPEI( "TransactionQueue", "m_queueReady.wait", MP_DIMGRAY );
-                m_queueReady.wait(
-                    l, [&]() { return bool( m_aborting ) || ( !m_unverified.empty() ); } );
+                m_queueReady.wait( l, [&]() {
+                    return bool( m_aborting ) || !m_batches.empty() || !m_unverified.empty();
+                } );
             }
             if ( m_aborting )
                 return;
-            MICROPROFILE_ENTERI(
-                "TransactionQueue", "verifierBody while", MP_LIGHTGOLDENRODYELLOW );
-            work = move( m_unverified.front() );
-            m_unverified.pop_front();
+            // synchronous batches first as their callers are waiting
+            if ( !m_batches.empty() )
+                batch = m_batches.front();
+            else
+                while ( !m_unverified.empty() && work.size() < c_maxVerificationBatchSize ) {
+                    work.push_back( move( m_unverified.front() ) );
+                    m_unverified.pop_front();
+                }
         }  // block
 
-        try {
-            Transaction t( work.transaction, CheckTransaction::Cheap );  // Signature will be
-                                                                         // checked later
-            ImportResult ir = import( t );
-            m_onImport( ir, t.sha3(), work.nodeId );
-        } catch ( ... ) {
-            // should not happen as exceptions are handled in import.
-            cwarn << "Bad transaction:" << boost::current_exception_diagnostic_information();
+        MICROPROFILE_ENTERI( "TransactionQueue", "verifierBody while", MP_LIGHTGOLDENRODYELLOW );
+        if ( batch ) {
+            verifyBatch( *batch );
+            // nothing left to take, don't let other verifiers pick it
+            Guard l( x_queue );
+            auto it = std::find( m_batches.begin(), m_batches.end(), batch );
+            if ( it != m_batches.end() )
+                m_batches.erase( it );
+        } else {
+            try {
+                importUnverified( work );
+            } catch ( ... ) {
+                // should not happen as exceptions are handled in verify.
+                cwarn << "Bad transaction:" << boost::current_exception_diagnostic_information();
+            }
         }
         MICROPROFILE_LEAVE();
     }
@@ -38,8 +38,10 @@
 #include <condition_variable>
 #include <deque>
 #include <functional>
+#include <memory>
 #include <mutex>
 #include <thread>
+#include <vector>
 
 namespace dev {
 namespace eth {
@@ -59,7 +61,9 @@ public:
     /// @brief TransactionQueue
     /// @param _limit Maximum number of pending transactions in the queue.
     /// @param _futureLimit Maximum number of future nonce transactions.
-    TransactionQueue( unsigned _limit = 1024, unsigned _futureLimit = 1024 );
+    /// @param _verifierThreads Number of threads verifying transaction signatures.
+    TransactionQueue( unsigned _limit = 1024, unsigned _futureLimit = 1024,
+        unsigned _verifierThreads = defaultVerifierThreads() );
     TransactionQueue( Limits const& _l ) : TransactionQueue( _l.current, _l.future ) {}
     ~TransactionQueue();
     void HandleDestruction();
@@ -82,6 +86,19 @@ public:
     /// @returns Import result code.
     ImportResult import( Transaction const& _tx, IfDropped _ik = IfDropped::Ignore );
 
+    /// Additional check of a transaction made by verifier threads. Throws if it is invalid.
+    using Verifier = std::function< void( Transaction const& ) >;
+
+    /// Verify and add transactions to the queue synchronously. Senders are recovered and
+    /// @a _verifier is called in verifier threads, then all transactions are imported under
+    /// a single lock in the original order.
+    /// @returns Import result code for each transaction, Malformed if verification failed.
+    std::vector< ImportResult > importBatch( Transactions const& _transactions,
+        Verifier const& _verifier = Verifier(), IfDropped _ik = IfDropped::Ignore );
+
+    /// Number of verifier threads used by default.
+    static unsigned defaultVerifierThreads();
+
     /// Remove transaction from the queue
     /// @param _txHash Trasnaction hash
     void drop( h256 const& _txHash );
@@ -112,6 +129,12 @@ public:
     template < class... Args >
     Transactions topTransactionsSync( unsigned _limit, Args... args );
 
+    /// Like topTransactionsSync() but waits for new transactions until @a _deadline.
+    /// @returns as soon as any transaction is available, empty on timeout.
+    template < class... Args >
+    Transactions topTransactionsUntil(
+        unsigned _limit, boost::chrono::steady_clock::time_point _deadline, Args... args );
+
     /// Get a hash set of transactions in the queue
     /// @returns A hash set of all transactions in the queue
     const h256Hash knownTransactions() const;
@@ -247,10 +270,38 @@ private:
     // account min account nonce. Updating it does not affect the order.
     using PriorityQueue = boost::container::multiset< VerifiedTransaction, PriorityCompare >;
 
+    /// Transactions of importBatch() shared between the caller and verifier threads.
+    /// A verifier may still hold the batch after importBatch() has returned, so the references
+    /// are only valid for an index taken from next that is below count.
+    struct VerificationBatch {
+        VerificationBatch( Transactions const& _transactions, Verifier const& _verifier )
+            : transactions( _transactions ),
+              verifier( _verifier ),
+              count( _transactions.size() ),
+              valid( _transactions.size() ) {}
+
+        Transactions const& transactions;  ///< Owned by the caller of importBatch()
+        Verifier const& verifier;          ///< Owned by the caller of importBatch()
+        size_t const count;                ///< Number of transactions, safe to read any time
+        std::vector< char > valid;       ///< Verification result for each transaction
+        std::atomic< size_t > next{0};   ///< Next transaction to be taken for verification
+        std::atomic< size_t > done{0};   ///< Number of verified transactions
+    };
+
     ImportResult import( bytesConstRef _tx, IfDropped _ik = IfDropped::Ignore );
     ImportResult check_WITH_LOCK( h256 const& _h, IfDropped _ik );
     ImportResult manageImport_WITH_LOCK( h256 const& _h, Transaction const& _transaction );
 
+    /// Recover sender and run @a _verifier. @returns false if transaction is invalid.
+    bool verify( Transaction const& _transaction, Verifier const& _verifier );
+    /// Verify transactions of @a _batch until there are none left to take.
+    void verifyBatch( VerificationBatch& _batch );
+    /// Import transactions verified beforehand taking m_lock once.
+    std::vector< ImportResult > importVerified(
+        Transactions const& _transactions, std::vector< char > const& _valid, IfDropped _ik );
+    /// Decode, verify and import transactions received by enqueue().
+    void importUnverified( std::vector< UnverifiedTransaction >& _work );
+
     Transactions topTransactions_WITH_LOCK(
         unsigned _limit, h256Hash const& _avoid = h256Hash() ) const;
     template < class Pred >
@@ -296,9 +347,13 @@ private:
     unsigned m_futureLimit;              ///< Max number of future transactions
     unsigned m_futureSize = 0;           ///< Current number of future transactions
 
-    std::condition_variable m_queueReady;  ///< Signaled when m_unverified has a new entry.
+    std::condition_variable m_queueReady;  ///< Signaled when m_unverified or m_batches has a
+                                           ///< new entry.
+    std::condition_variable m_batchVerified;  ///< Signaled when a batch is fully verified.
     std::vector< std::thread > m_verifiers;
     std::deque< UnverifiedTransaction > m_unverified;  ///< Pending verification queue
+    std::deque< std::shared_ptr< VerificationBatch > > m_batches;  ///< Batches of importBatch()
+                                                                   ///< being verified
     mutable Mutex x_queue;                             ///< Verification queue mutex
     std::atomic_bool m_aborting;                       ///< Exit condition for verifier.
 
@@ -344,6 +399,22 @@ Transactions TransactionQueue::topTransactionsSync( unsigned _limit, Args... arg
     return res;
 }
 
+template < class... Args >
+Transactions TransactionQueue::topTransactionsUntil(
+    unsigned _limit, boost::chrono::steady_clock::time_point _deadline, Args... args ) {
+    UpgradableGuard rGuard( m_lock );
+    Transactions res = topTransactions_WITH_LOCK( _limit, args... );
+    if ( !res.empty() )
+        return res;
+
+    UpgradeGuard wGuard( rGuard );
+    MICROPROFILE_SCOPEI( "TransactionQueue", "wait_until txns", MP_DIMGRAY );
+    while ( res.empty() &&
+            m_cond.wait_until( *wGuard.mutex(), _deadline ) == boost::cv_status::no_timeout )
+        res = topTransactions_WITH_LOCK( _limit, args... );
+    return res;
+}
+
 template < class Pred >
 Transactions TransactionQueue::topTransactions( unsigned _limit, Pred _pred ) const {
     ReadGuard l( m_lock );
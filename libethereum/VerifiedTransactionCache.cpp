@@ -0,0 +1,94 @@
+/*
+    Copyright (C) 2018-present, SKALE Labs
+
+    This file is part of skaled.
+
+    skaled is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skaled is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with skaled.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * @file VerifiedTransactionCache.cpp
+ * @date 2020
+ */
+
+#include "VerifiedTransactionCache.h"
+
+using namespace std;
+using namespace dev;
+using namespace dev::eth;
+
+VerifiedTransactionCache::VerifiedTransactionCache( size_t _capacity )
+    : m_capacity( max< size_t >( _capacity, c_shardCount ) ) {
+    for ( auto& s : m_shards )
+        s.reset( new Shard( m_capacity / c_shardCount ) );
+}
+
+void VerifiedTransactionCache::insert( Transaction const& _t ) {
+    if ( _t.isInvalid() || _t.hasZeroSignature() )
+        return;
+    try {
+        _t.sender();  // recover outside of the lock
+    } catch ( ... ) {
+        return;
+    }
+
+    h256 hash = _t.sha3();
+    Shard& s = shard( hash );
+    lock_guard< mutex > lock( s.mutex );
+    if ( s.cache.contains( hash ) ) {
+        s.cache.touch( hash );
+        return;
+    }
+    if ( s.cache.size() == s.cache.capacity() )
+        ++m_evictions;
+    s.cache.insert( hash, _t );
+    ++m_insertions;
+}
+
+boost::optional< Transaction > VerifiedTransactionCache::find( h256 const& _hash ) {
+    Shard& s = shard( _hash );
+    lock_guard< mutex > lock( s.mutex );
+    if ( Transaction const* t = s.cache.find( _hash ) ) {
+        ++m_hits;
+        return *t;
+    }
+    ++m_misses;
+    return boost::none;
+}
+
+void VerifiedTransactionCache::remove( h256 const& _hash ) {
+    Shard& s = shard( _hash );
+    lock_guard< mutex > lock( s.mutex );
+    s.cache.remove( _hash );
+}
+
+VerifiedTransactionCache::Stats VerifiedTransactionCache::stats() const {
+    Stats ret;
+    ret.hits = m_hits;
+    ret.misses = m_misses;
+    ret.insertions = m_insertions;
+    ret.evictions = m_evictions;
+    ret.capacity = m_capacity;
+    for ( auto const& s : m_shards ) {
+        lock_guard< mutex > lock( s->mutex );
+        ret.size += s->cache.size();
+    }
+    return ret;
+}
+
+void VerifiedTransactionCache::clear() {
+    for ( auto& s : m_shards ) {
+        lock_guard< mutex > lock( s->mutex );
+        s->cache.clear();
+    }
+}
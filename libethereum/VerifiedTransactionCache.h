@@ -0,0 +1,92 @@
+/*
+    Copyright (C) 2018-present, SKALE Labs
+
+    This file is part of skaled.
+
+    skaled is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skaled is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with skaled.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * @file VerifiedTransactionCache.h
+ * @date 2020
+ */
+
+#pragma once
+
+#include "Transaction.h"
+
+#include <libdevcore/LruCache.h>
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <mutex>
+
+namespace dev {
+namespace eth {
+
+/**
+ * @brief Bounded cache of parsed transactions with recovered senders keyed by transaction hash.
+ * Lets a transaction verified once (RPC, broadcast, proposal) skip decoding and sender recovery
+ * when it is seen again. Split into independently locked shards.
+ * @threadsafe
+ */
+class VerifiedTransactionCache {
+public:
+    struct Stats {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t insertions = 0;
+        uint64_t evictions = 0;  ///< Entries pushed out because the cache was full
+        size_t size = 0;
+        size_t capacity = 0;
+    };
+
+    explicit VerifiedTransactionCache( size_t _capacity );
+
+    /// Remember transaction, recovers its sender if it is not known yet.
+    /// Invalid transactions and ones with bad signature are ignored.
+    void insert( Transaction const& _t );
+
+    /// @returns cached transaction with sender or nothing.
+    boost::optional< Transaction > find( h256 const& _hash );
+
+    /// Forget transaction, e.g. when it was included into a block.
+    void remove( h256 const& _hash );
+
+    Stats stats() const;
+
+    void clear();
+
+private:
+    static constexpr size_t c_shardCount = 16;
+
+    struct Shard {
+        explicit Shard( size_t _capacity ) : cache( _capacity ) {}
+        mutable std::mutex mutex;
+        LruCache< h256, Transaction > cache;
+    };
+
+    Shard& shard( h256 const& _hash ) { return *m_shards[_hash[0] % c_shardCount]; }
+
+    std::array< std::unique_ptr< Shard >, c_shardCount > m_shards;
+    size_t m_capacity;
+
+    std::atomic< uint64_t > m_hits{0};
+    std::atomic< uint64_t > m_misses{0};
+    std::atomic< uint64_t > m_insertions{0};
+    std::atomic< uint64_t > m_evictions{0};
+};
+
+}  // namespace eth
+}  // namespace dev
@@ -0,0 +1,216 @@
+/*
+    Copyright (C) 2018-present, SKALE Labs
+
+    This file is part of skaled.
+
+    skaled is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skaled is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with skaled.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * @file CodeCache.cpp
+ * @date 2026
+ */
+
+#include "CodeCache.h"
+#include "Instruction.h"
+#include "LegacyVMConfig.h"
+
+using namespace dev;
+using namespace dev::eth;
+using byte = _byte_;
+
+AnalyzedCode::AnalyzedCode( h256 const& _hash, bytesConstRef _code )
+    : m_hash( _hash ), m_code( _code.toBytes() ), m_jumpDests( _code.size() ) {
+    // Copy code so that it can be safely modified and extend it by zero bytes
+    m_executable.reserve( m_code.size() + c_padding );
+    m_executable = m_code;
+    m_executable.resize( m_code.size() + c_padding );
+
+    size_t const nBytes = m_code.size();
+
+    // build a table of jump destinations for use in verifyJumpDest
+
+    TRACE_STR( 1, "Build JUMPDEST table" )
+    for ( size_t pc = 0; pc < nBytes; ++pc ) {
+        Instruction op = Instruction( m_executable[pc] );
+        TRACE_OP( 2, pc, op );
+
+        // make synthetic ops in user code trigger invalid instruction if run
+        if ( op == Instruction::PUSHC || op == Instruction::JUMPC || op == Instruction::JUMPCI ) {
+            TRACE_OP( 1, pc, op );
+            m_executable[pc] = ( _byte_ ) Instruction::INVALID;
+        }
+
+        if ( op == Instruction::JUMPDEST ) {
+            m_jumpDests[pc] = true;
+        } else if ( ( byte ) Instruction::PUSH1 <= ( byte ) op &&
+                    ( byte ) op <= ( byte ) Instruction::PUSH32 ) {
+            pc += ( _byte_ ) op - ( _byte_ ) Instruction::PUSH1 + 1;
+        }
+#if EIP_615
+        else if ( op == Instruction::JUMPTO || op == Instruction::JUMPIF ||
+                  op == Instruction::JUMPSUB ) {
+            ++pc;
+            pc += 4;
+        } else if ( op == Instruction::JUMPV || op == Instruction::JUMPSUBV ) {
+            ++pc;
+            pc += 4 * m_executable[pc];  // number of 4-byte dests followed by table
+        } else if ( op == Instruction::BEGINSUB ) {
+            m_beginSubs.push_back( pc );
+        } else if ( op == Instruction::BEGINDATA ) {
+            break;
+        }
+#endif
+    }
+
+#ifdef EVM_DO_FIRST_PASS_OPTIMIZATION
+
+    TRACE_STR( 1, "Do first pass optimizations" )
+    for ( size_t pc = 0; pc < nBytes; ++pc ) {
+        u256 val = 0;
+        Instruction op = Instruction( m_executable[pc] );
+
+        if ( ( byte ) Instruction::PUSH1 <= ( byte ) op &&
+             ( byte ) op <= ( byte ) Instruction::PUSH32 ) {
+            byte nPush = ( byte ) op - ( byte ) Instruction::PUSH1 + 1;
+
+            // decode pushed bytes to integral value
+            val = m_executable[pc + 1];
+            for ( uint64_t i = pc + 2, n = nPush; --n; ++i ) {
+                val = ( val << 8 ) | m_executable[i];
+            }
+
+#if EVM_USE_CONSTANT_POOL
+
+            // add value to constant pool and replace PUSHn with PUSHC
+            // place offset in code as 2 bytes MSB-first
+            // followed by one byte count of remaining pushed bytes
+            if ( 5 < nPush ) {
+                uint16_t pool_off = m_pool.size();
+                TRACE_VAL( 1, "stash", val );
+                TRACE_VAL( 1, "... in pool at offset", pool_off );
+                m_pool.push_back( val );
+
+                TRACE_PRE_OPT( 1, pc, op );
+                m_executable[pc] = byte( op = Instruction::PUSHC );
+                m_executable[pc + 3] = nPush - 2;
+                m_executable[pc + 2] = pool_off & 0xff;
+                m_executable[pc + 1] = pool_off >> 8;
+                TRACE_POST_OPT( 1, pc, op );
+            }
+
+#endif
+
+#if EVM_REPLACE_CONST_JUMP
+            // replace JUMP or JUMPI to constant location with JUMPC or JUMPCI
+            size_t i = pc + nPush + 1;
+            op = Instruction( m_executable[i] );
+            bool const constDest = val <= 0x7FFFFFFFFFFFFFFF && isJumpDest( uint64_t( val ) );
+            if ( op == Instruction::JUMP ) {
+                TRACE_VAL( 1, "Replace const JUMP with JUMPC to", val )
+                TRACE_PRE_OPT( 1, i, op );
+
+                if ( constDest )
+                    m_executable[i] = _byte_( op = Instruction::JUMPC );
+
+                TRACE_POST_OPT( 1, i, op );
+            } else if ( op == Instruction::JUMPI ) {
+                TRACE_VAL( 1, "Replace const JUMPI with JUMPCI to", val )
+                TRACE_PRE_OPT( 1, i, op );
+
+                if ( constDest )
+                    m_executable[i] = _byte_( op = Instruction::JUMPCI );
+
+                TRACE_POST_OPT( 1, i, op );
+            }
+#endif
+
+            pc += nPush;
+        }
+    }
+    TRACE_STR( 1, "Finished optimizations" )
+#endif
+}
+
+size_t AnalyzedCode::memoryUsage() const {
+    return sizeof( *this ) + m_code.capacity() + m_executable.capacity() +
+           m_jumpDests.capacity() / 8 + m_pool.capacity() * sizeof( u256 );
+}
+
+CodeCache::CodeCache( size_t _capacityBytes )
+    : m_capacity( _capacityBytes ), m_shardCapacity( _capacityBytes / c_shards ) {}
+
+std::shared_ptr< AnalyzedCode const > CodeCache::get( h256 const& _hash, bytesConstRef _code ) {
+    Shard& shard = shardFor( _hash );
+    {
+        std::lock_guard< std::mutex > lock( shard.mutex );
+        auto it = shard.index.find( _hash );
+        if ( it != shard.index.end() ) {
+            shard.lru.splice( shard.lru.begin(), shard.lru, it->second );
+            ++m_hits;
+            return *it->second;
+        }
+    }
+    ++m_misses;
+
+    // analyze outside the lock; a concurrent miss on the same code keeps the first result
+    auto analyzed = std::make_shared< AnalyzedCode const >( _hash, _code );
+    size_t const bytes = analyzed->memoryUsage();
+    if ( bytes > m_shardCapacity )
+        return analyzed;
+
+    std::lock_guard< std::mutex > lock( shard.mutex );
+    auto it = shard.index.find( _hash );
+    if ( it != shard.index.end() )
+        return *it->second;
+    shard.lru.push_front( analyzed );
+    shard.index.emplace( _hash, shard.lru.begin() );
+    shard.bytes += bytes;
+    while ( shard.bytes > m_shardCapacity ) {
+        shard.bytes -= shard.lru.back()->memoryUsage();
+        shard.index.erase( shard.lru.back()->hash() );
+        shard.lru.pop_back();
+        ++m_evictions;
+    }
+    return analyzed;
+}
+
+std::shared_ptr< AnalyzedCode const > CodeCache::find( h256 const& _hash ) const {
+    Shard& shard = shardFor( _hash );
+    std::lock_guard< std::mutex > lock( shard.mutex );
+    auto it = shard.index.find( _hash );
+    return it != shard.index.end() ? *it->second : nullptr;
+}
+
+void CodeCache::clear() {
+    for ( Shard& shard : m_shards ) {
+        std::lock_guard< std::mutex > lock( shard.mutex );
+        shard.index.clear();
+        shard.lru.clear();
+        shard.bytes = 0;
+    }
+}
+
+CodeCache::Stats CodeCache::stats() const {
+    Stats stats;
+    stats.hits = m_hits;
+    stats.misses = m_misses;
+    stats.evictions = m_evictions;
+    stats.capacity = m_capacity;
+    for ( Shard const& shard : m_shards ) {
+        std::lock_guard< std::mutex > lock( shard.mutex );
+        stats.entries += shard.index.size();
+        stats.bytes += shard.bytes;
+    }
+    return stats;
+}
@@ -0,0 +1,137 @@
+/*
+    Copyright (C) 2018-present, SKALE Labs
+
+    This file is part of skaled.
+
+    skaled is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skaled is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with skaled.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * @file CodeCache.h
+ * @date 2026
+ */
+
+#pragma once
+
+#include <libdevcore/Common.h>
+#include <libdevcore/FixedHash.h>
+
+#include <array>
+#include <atomic>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+namespace dev {
+namespace eth {
+
+/**
+ * @brief Immutable contract code together with its jump destination analysis.
+ * Every frame running the same code borrows one instance instead of copying and rescanning it.
+ */
+class AnalyzedCode {
+public:
+    /// Zero bytes appended to the executable code so that PUSHn at the end can be read
+    /// without bounds checks.
+    static constexpr size_t c_padding = 33;
+
+    AnalyzedCode( h256 const& _hash, bytesConstRef _code );
+
+    h256 const& hash() const { return m_hash; }
+    /// The code as deployed.
+    bytes const& code() const { return m_code; }
+    size_t size() const { return m_code.size(); }
+
+    /// The code padded with c_padding zero bytes, with synthetic instructions replaced by
+    /// INVALID and, if EVM_DO_FIRST_PASS_OPTIMIZATION is on, with first pass optimizations.
+    bytes const& executable() const { return m_executable; }
+    /// Constant pool referred to by PUSHC in executable().
+    std::vector< u256 > const& pool() const { return m_pool; }
+    /// BEGINSUB positions, collected only when EIP_615 is enabled.
+    std::vector< uint64_t > const& beginSubs() const { return m_beginSubs; }
+
+    bool isJumpDest( uint64_t _pc ) const { return _pc < m_jumpDests.size() && m_jumpDests[_pc]; }
+
+    /// Memory used by this object, for cache accounting.
+    size_t memoryUsage() const;
+
+private:
+    h256 const m_hash;
+    bytes const m_code;
+    bytes m_executable;
+    std::vector< bool > m_jumpDests;  ///< bit per code byte
+    std::vector< u256 > m_pool;
+    std::vector< uint64_t > m_beginSubs;
+};
+
+/**
+ * @brief Process-wide cache of analyzed code keyed by code hash, bounded by memory use.
+ * Sharded LRU; entries stay alive while any frame still holds them.
+ */
+class CodeCache {
+public:
+    struct Stats {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t evictions = 0;
+        size_t entries = 0;
+        size_t bytes = 0;
+        size_t capacity = 0;
+    };
+
+    static constexpr size_t c_defaultCapacityBytes = 128 * 1024 * 1024;
+
+    explicit CodeCache( size_t _capacityBytes );
+
+    /// @returns the analyzed @a _code, analyzing and caching it on a miss.
+    /// @a _hash must be the sha3 of @a _code.
+    std::shared_ptr< AnalyzedCode const > get( h256 const& _hash, bytesConstRef _code );
+
+    /// @returns the cached code for @a _hash or nullptr; does not count hits or misses.
+    std::shared_ptr< AnalyzedCode const > find( h256 const& _hash ) const;
+
+    void clear();
+
+    Stats stats() const;
+
+    static CodeCache& instance() {
+        static CodeCache cache( c_defaultCapacityBytes );
+        return cache;
+    }
+
+private:
+    static constexpr size_t c_shards = 16;
+
+    using Entry = std::shared_ptr< AnalyzedCode const >;
+
+    struct Shard {
+        mutable std::mutex mutex;
+        std::list< Entry > lru;  ///< most recently used first
+        std::unordered_map< h256, std::list< Entry >::iterator > index;
+        size_t bytes = 0;
+    };
+
+    Shard& shardFor( h256 const& _hash ) const { return m_shards[_hash[0] % c_shards]; }
+
+    mutable std::array< Shard, c_shards > m_shards;
+    size_t const m_capacity;
+    size_t const m_shardCapacity;
+
+    std::atomic< uint64_t > m_hits{0};
+    std::atomic< uint64_t > m_misses{0};
+    std::atomic< uint64_t > m_evictions{0};
+};
+
+}  // namespace eth
+}  // namespace dev
@@ -231,21 +231,33 @@ evmc::result EvmCHost::call( evmc_message const& _msg ) noexcept {
 }
 
 ExtVMFace::ExtVMFace( EnvInfo const& _envInfo, Address _myAddress, Address _caller, Address _origin,
-    u256 _value, u256 _gasPrice, bytesConstRef _data, bytes _code, h256 const& _codeHash,
+    u256 _value, u256 _gasPrice, bytesConstRef _data, bytesConstRef _code, h256 const& _codeHash,
     u256 const& _version, unsigned _depth, bool _isCreate, bool _staticCall )
     : m_envInfo( _envInfo ),
+      // init code mostly runs once, keep it out of the cache
+      m_analyzedCode( _isCreate ? std::make_shared< AnalyzedCode const >( _codeHash, _code ) :
+                                  CodeCache::instance().get( _codeHash, _code ) ),
       myAddress( _myAddress ),
       caller( _caller ),
       origin( _origin ),
       value( _value ),
       gasPrice( _gasPrice ),
       data( _data ),
-      code( std::move( _code ) ),
+      code( &m_analyzedCode->code() ),
       codeHash( _codeHash ),
       version( _version ),
       depth( _depth ),
       isCreate( _isCreate ),
       staticCall( _staticCall ) {}
 
+std::shared_ptr< AnalyzedCode const > const& ExtVMFace::analyzedCode() {
+    // code may be replaced after construction, as test tooling does
+    if ( m_analyzedCode->hash() != codeHash || m_analyzedCode->code().data() != code.data() ) {
+        m_analyzedCode = CodeCache::instance().get( codeHash, code );
+        code = &m_analyzedCode->code();
+    }
+    return m_analyzedCode;
+}
+
 }  // namespace eth
 }  // namespace dev
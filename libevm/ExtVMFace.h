@@ -17,6 +17,7 @@
 
 #pragma once
 
+#include "CodeCache.h"
 #include "Instruction.h"
 
 #include <libdevcore/Common.h>
@@ -193,8 +194,9 @@ class ExtVMFace {
 public:
     /// Full constructor.
     ExtVMFace( EnvInfo const& _envInfo, Address _myAddress, Address _caller, Address _origin,
-        u256 _value, u256 _gasPrice, bytesConstRef _data, bytes _code, h256 const& _codeHash,
-        u256 const& _version, unsigned _depth, bool _isCreate, bool _staticCall );
+        u256 _value, u256 _gasPrice, bytesConstRef _data, bytesConstRef _code,
+        h256 const& _codeHash, u256 const& _version, unsigned _depth, bool _isCreate,
+        bool _staticCall );
 
     ExtVMFace( ExtVMFace const& ) = delete;
     ExtVMFace& operator=( ExtVMFace const& ) = delete;
@@ -249,8 +251,13 @@ public:
     /// Return the EVM gas-price schedule for this execution context.
     virtual EVMSchedule const& evmSchedule() const { return DefaultSchedule; }
 
+    /// @returns the executing code with its analysis, shared with other frames running it.
+    std::shared_ptr< AnalyzedCode const > const& analyzedCode();
+
 private:
     EnvInfo const& m_envInfo;
+    /// Owns the bytes code refers to.
+    std::shared_ptr< AnalyzedCode const > m_analyzedCode;
 
 public:
     // TODO: make private
@@ -260,7 +267,7 @@ public:
     u256 value;         ///< Value (in Wei) that was passed to this address.
     u256 gasPrice;      ///< Price of gas (that we already paid).
     bytesConstRef data;       ///< Current input data.
-    bytes code;               ///< Current code that is executing.
+    bytesConstRef code;       ///< Current code that is executing.
     h256 codeHash;            ///< SHA3 hash of the executing code
     u256 version;             ///< Version of the VM to execute code
     u256 salt;                ///< Values used in new address construction by CREATE2
@@ -693,7 +693,7 @@ void LegacyVM::interpretCases() {
             ON_OP();
             updateIOGas();
 
-            m_PC = decodeJumpDest( m_code.data(), m_PC );
+            m_PC = decodeJumpDest( m_code, m_PC );
         }
         CONTINUE
 
@@ -702,7 +702,7 @@ void LegacyVM::interpretCases() {
             updateIOGas();
 
             if ( m_SP[0] )
-                m_PC = decodeJumpDest( m_code.data(), m_PC );
+                m_PC = decodeJumpDest( m_code, m_PC );
             else
                 ++m_PC;
         }
@@ -711,7 +711,7 @@ void LegacyVM::interpretCases() {
         CASE( JUMPV ) {
             ON_OP();
             updateIOGas();
-            m_PC = decodeJumpvDest( m_code.data(), m_PC, byte( m_SP[0] ) );
+            m_PC = decodeJumpvDest( m_code, m_PC, byte( m_SP[0] ) );
         }
         CONTINUE
 
@@ -719,7 +719,7 @@ void LegacyVM::interpretCases() {
             ON_OP();
             updateIOGas();
             *m_RP++ = m_PC++;
-            m_PC = decodeJumpDest( m_code.data(), m_PC );
+            m_PC = decodeJumpDest( m_code, m_PC );
         }
         CONTINUE
 
@@ -727,7 +727,7 @@ void LegacyVM::interpretCases() {
             ON_OP();
             updateIOGas();
             *m_RP++ = m_PC;
-            m_PC = decodeJumpvDest( m_code.data(), m_PC, byte( m_SP[0] ) );
+            m_PC = decodeJumpvDest( m_code, m_PC, byte( m_SP[0] ) );
         }
         CONTINUE
 
@@ -1229,7 +1229,7 @@ void LegacyVM::interpretCases() {
             updateMem( memNeed( m_SP[0], m_SP[2] ) );
             updateIOGas();
 
-            copyDataToMemory( &m_ext->code, m_SP );
+            copyDataToMemory( m_ext->code, m_SP );
         }
         NEXT
 
@@ -17,6 +17,7 @@
 
 #pragma once
 
+#include "CodeCache.h"
 #include "Instruction.h"
 #include "LegacyVMConfig.h"
 #include "VMFace.h"
@@ -51,7 +52,6 @@ private:
     static std::array< InstructionMetric, 256 > c_metrics;
     static void initMetrics();
     static u256 exp256( u256 _base, u256 _exponent );
-    void copyCode( int );
     typedef void ( LegacyVM::*MemFnPtr )();
     MemFnPtr m_bounce = 0;
     MemFnPtr m_onFail = 0;
@@ -64,8 +64,9 @@ private:
     // space for memory
     bytes m_mem;
 
-    // space for code
-    bytes m_code;
+    // code being run, borrowed from m_analyzedCode
+    std::shared_ptr< AnalyzedCode const > m_analyzedCode;
+    _byte_ const* m_code = nullptr;
 
     /// RETURNDATA buffer for memory returned from direct subcalls.
     bytes m_returnData;
@@ -84,7 +85,7 @@ private:
 #endif
 
     // constant pool
-    std::vector< u256 > m_pool;
+    u256 const* m_pool = nullptr;
 
     // interpreter state
     Instruction m_OP;         // current operation
@@ -124,8 +125,6 @@ private:
     void throwBufferOverrun( bigint const& _enfOfAccess );
     void throwStorageOverflow( const std::string& _addr );
 
-    std::vector< uint64_t > m_beginSubs;
-    std::vector< uint64_t > m_jumpDests;
     int64_t verifyJumpDest( u256 const& _dest, bool _throw = true );
 
     void onOperation();
@@ -68,19 +68,34 @@ inline Slice toSlice( std::string const& _s ) {
     return Slice( reinterpret_cast< char const* >( &_s[0] ), _s.size() );
 }
 
+inline string toKey( bytes const& _b ) {
+    return string( _b.begin(), _b.end() );
+}
+
+inline string toKey( h160 const& _h ) {
+    return string( reinterpret_cast< char const* >( _h.data() ), _h.size );
+}
+
+inline string toKey( h256 const& _h ) {
+    return string( reinterpret_cast< char const* >( _h.data() ), _h.size );
+}
+
 // inline Slice toSlice( bytesConstRef _h ) { // l_sergiy: clang did detected this as unused
 //    return Slice( reinterpret_cast< char const* >( _h.data() ), _h.size() );
 //}
 
 }  // namespace
 
-OverlayDB::OverlayDB( std::unique_ptr< dev::db::DatabaseFace > _db )
+OverlayDB::OverlayDB( std::unique_ptr< dev::db::DatabaseFace > _db, size_t _readCacheBytes )
     : m_db( _db.release(), []( dev::db::DatabaseFace* db ) {
           // clog(dev::VerbosityDebug, "overlaydb") << "Closing state DB";
           //        std::cerr << "!!! Closing state DB !!!" << std::endl;
           //        std::cerr.flush();
           delete db;
-      } ) {}
+      } ) {
+    if ( m_db && _readCacheBytes > 0 )
+        m_readCache = std::make_shared< OverlayReadCache >( _readCacheBytes );
+}
 
 void OverlayDB::commit() {
     if ( m_db ) {
@@ -135,6 +150,7 @@ void OverlayDB::commit() {
                 std::this_thread::sleep_for( std::chrono::seconds( commitTry + 1 ) );
             }
         }
+        refreshReadCache();
 #if DEV_GUARDED_DB
         DEV_WRITE_GUARDED( x_this )
 #endif
@@ -146,6 +162,43 @@ void OverlayDB::commit() {
     }
 }
 
+void OverlayDB::refreshReadCache() {
+    if ( !m_readCache )
+        return;
+    for ( auto const& addressValuePair : m_cache )
+        m_readCache->update( toKey( addressValuePair.first ), toKey( addressValuePair.second ) );
+    for ( auto const& addressSpacePair : m_auxiliaryCache )
+        for ( auto const& spaceValuePair : addressSpacePair.second )
+            m_readCache->update(
+                toKey( getAuxiliaryKey( addressSpacePair.first, spaceValuePair.first ) ),
+                toKey( spaceValuePair.second ) );
+    for ( auto const& addressStoragePair : m_storageCache )
+        for ( auto const& stateAddressValuePair : addressStoragePair.second )
+            m_readCache->update(
+                toKey( getStorageKey( addressStoragePair.first, stateAddressValuePair.first ) ),
+                toKey( stateAddressValuePair.second ) );
+    m_readCache->update( "storageUsed", storageUsed_.str() );
+}
+
+string OverlayDB::readThrough( string const& _key ) const {
+    if ( !m_readCache )
+        return m_db->lookup( toSlice( _key ) );
+
+    string value;
+    if ( m_readCache->find( _key, value ) )
+        return value;
+    uint64_t generation = m_readCache->generation( _key );
+    value = m_db->lookup( toSlice( _key ) );
+    m_readCache->fill( _key, value, generation );
+    return value;
+}
+
+OverlayReadCache::Stats OverlayDB::readCacheStats() const {
+    if ( !m_readCache )
+        return OverlayReadCache::Stats();
+    return m_readCache->stats();
+}
+
 string OverlayDB::lookupAuxiliary( h160 const& _address, _byte_ _space ) const {
     string value;
     auto addressSpacePairPtr = m_auxiliaryCache.find( _address );
@@ -158,7 +211,7 @@ string OverlayDB::lookupAuxiliary( h160 const& _address, _byte_ _space ) const {
     if ( !value.empty() || !m_db )
         return value;
 
-    std::string const loadedValue = m_db->lookup( toSlice( getAuxiliaryKey( _address, _space ) ) );
+    std::string const loadedValue = readThrough( toKey( getAuxiliaryKey( _address, _space ) ) );
     if ( loadedValue.empty() )
         cwarn << "Aux not found: " << _address;
 
@@ -180,9 +233,12 @@ void OverlayDB::killAuxiliary( const dev::h160& _address, _byte_ _space ) {
     }
     if ( !cache_hit ) {
         if ( m_db ) {
-            Slice key = toSlice( getAuxiliaryKey( _address, _space ) );
+            bytes const keyBytes = getAuxiliaryKey( _address, _space );
+            Slice key = toSlice( keyBytes );
             if ( m_db->exists( key ) ) {
                 m_db->kill( key );
+                if ( m_readCache )
+                    m_readCache->invalidate( toKey( keyBytes ) );
             } else {
                 cnote << "Try to delete non existing key " << _address << "(" << _space << ")";
             }
@@ -267,6 +323,8 @@ void OverlayDB::clearDB() {
         for ( const auto& key : keys ) {
             m_db->kill( key );
         }
+        if ( m_readCache )
+            m_readCache->clear();
     }
 }
 
@@ -310,13 +368,19 @@ string OverlayDB::lookup( h160 const& _h ) const {
     if ( !ret.empty() || !m_db )
         return ret;
 
-    return m_db->lookup( toSlice( _h ) );
+    return readThrough( toKey( _h ) );
 }
 
 bool OverlayDB::exists( h160 const& _h ) const {
     if ( m_cache.find( _h ) != m_cache.end() )
         return true;
-    return m_db && m_db->exists( toSlice( _h ) );
+    if ( !m_db )
+        return false;
+    // empty cached values are not trusted as values and absent keys both read as empty
+    string value;
+    if ( m_readCache && m_readCache->find( toKey( _h ), value ) && !value.empty() )
+        return true;
+    return m_db->exists( toSlice( _h ) );
 }
 
 void OverlayDB::kill( h160 const& _h ) {
@@ -328,6 +392,8 @@ void OverlayDB::kill( h160 const& _h ) {
             Slice key = toSlice( _h );
             if ( m_db->exists( key ) ) {
                 m_db->kill( key );
+                if ( m_readCache )
+                    m_readCache->invalidate( toKey( _h ) );
             } else {
                 cnote << "Try to delete non existing key " << _h;
             }
@@ -353,7 +419,7 @@ h256 OverlayDB::lookup( const dev::h160& _address, const dev::h256& _storageAddr
     }
 
     if ( m_db ) {
-        string value = m_db->lookup( toSlice( getStorageKey( _address, _storageAddress ) ) );
+        string value = readThrough( toKey( getStorageKey( _address, _storageAddress ) ) );
         return h256( value, h256::ConstructFromStringType::FromBinary );
     } else {
         return h256( 0 );
@@ -377,7 +443,7 @@ void OverlayDB::insert(
 
 dev::s256 OverlayDB::storageUsed() const {
     if ( m_db ) {
-        return dev::s256( m_db->lookup( toSlice( "storageUsed" ) ) );
+        return dev::s256( readThrough( "storageUsed" ) );
     }
     return 0;
 }
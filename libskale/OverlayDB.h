@@ -30,11 +30,17 @@
 #include <libdevcore/Log.h>
 #include <libdevcore/db.h>
 
+#include "OverlayReadCache.h"
 
 namespace skale {
 class OverlayDB {
 public:
-    explicit OverlayDB( std::unique_ptr< dev::db::DatabaseFace > _db = nullptr );
+    /// Default memory limit of the read cache shared by copies of one OverlayDB.
+    static constexpr size_t c_defaultReadCacheBytes = 64 * 1024 * 1024;
+
+    /// @param _readCacheBytes memory limit of the read cache, 0 disables it.
+    explicit OverlayDB( std::unique_ptr< dev::db::DatabaseFace > _db = nullptr,
+        size_t _readCacheBytes = c_defaultReadCacheBytes );
 
     virtual ~OverlayDB() = default;
 
@@ -78,6 +84,9 @@ public:
 
     std::unordered_map< dev::u256, dev::u256 > storage( dev::h160 const& address ) const;
 
+    /// @returns statistics of the read cache, all zeros when it is disabled.
+    OverlayReadCache::Stats readCacheStats() const;
+
 private:
     std::unordered_map< dev::h160, dev::bytes > m_cache;
     std::unordered_map< dev::h160, std::unordered_map< _byte_, dev::bytes > > m_auxiliaryCache;
@@ -85,6 +94,13 @@ private:
     dev::s256 storageUsed_ = 0;
 
     std::shared_ptr< dev::db::DatabaseFace > m_db;
+    /// Records read from m_db; shared by copies as they share m_db.
+    std::shared_ptr< OverlayReadCache > m_readCache;
+
+    /// Reads @a _key from m_db through m_readCache.
+    std::string readThrough( std::string const& _key ) const;
+    /// Brings m_readCache up to date with the records of the last successful commit.
+    void refreshReadCache();
 
     dev::bytes getAuxiliaryKey( dev::h160 const& _address, _byte_ space ) const;
     dev::bytes getStorageKey( dev::h160 const& _address, dev::h256 const& _storageAddress ) const;
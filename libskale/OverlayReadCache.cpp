@@ -0,0 +1,136 @@
+/*
+    Copyright (C) 2018-present, SKALE Labs
+
+    This file is part of skaled.
+
+    skaled is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skaled is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with skaled.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * @file OverlayReadCache.cpp
+ * @date 2026
+ */
+
+#include "OverlayReadCache.h"
+
+#include <functional>
+
+namespace skale {
+
+OverlayReadCache::OverlayReadCache( size_t _capacityBytes )
+    : m_capacity( _capacityBytes ), m_shardCapacity( _capacityBytes / c_shards ) {}
+
+OverlayReadCache::Shard& OverlayReadCache::shardFor( std::string const& _key ) const {
+    return m_shards[std::hash< std::string >()( _key ) % c_shards];
+}
+
+uint64_t OverlayReadCache::generation( std::string const& _key ) const {
+    Shard& shard = shardFor( _key );
+    std::lock_guard< std::mutex > lock( shard.mutex );
+    return shard.generation;
+}
+
+bool OverlayReadCache::find( std::string const& _key, std::string& o_value ) {
+    Shard& shard = shardFor( _key );
+    {
+        std::lock_guard< std::mutex > lock( shard.mutex );
+        auto it = shard.index.find( _key );
+        if ( it != shard.index.end() ) {
+            shard.lru.splice( shard.lru.begin(), shard.lru, it->second );
+            o_value = it->second->second;
+            ++m_hits;
+            return true;
+        }
+    }
+    ++m_misses;
+    return false;
+}
+
+void OverlayReadCache::fill(
+    std::string const& _key, std::string const& _value, uint64_t _generation ) {
+    Shard& shard = shardFor( _key );
+    std::lock_guard< std::mutex > lock( shard.mutex );
+    if ( shard.generation != _generation || shard.index.count( _key ) )
+        return;
+    if ( _key.size() + _value.size() + c_entryOverhead > m_shardCapacity )
+        return;
+    shard.lru.emplace_front( _key, _value );
+    shard.index.emplace( _key, shard.lru.begin() );
+    shard.bytes += entryBytes( shard.lru.front() );
+    ++m_insertions;
+    evictOverflow( shard );
+}
+
+void OverlayReadCache::update( std::string const& _key, std::string const& _value ) {
+    Shard& shard = shardFor( _key );
+    std::lock_guard< std::mutex > lock( shard.mutex );
+    ++shard.generation;
+    auto it = shard.index.find( _key );
+    if ( it == shard.index.end() )
+        return;
+    shard.bytes -= entryBytes( *it->second );
+    it->second->second = _value;
+    shard.bytes += entryBytes( *it->second );
+    evictOverflow( shard );
+}
+
+void OverlayReadCache::invalidate( std::string const& _key ) {
+    Shard& shard = shardFor( _key );
+    std::lock_guard< std::mutex > lock( shard.mutex );
+    ++shard.generation;
+    auto it = shard.index.find( _key );
+    if ( it == shard.index.end() )
+        return;
+    shard.bytes -= entryBytes( *it->second );
+    shard.lru.erase( it->second );
+    shard.index.erase( it );
+    ++m_invalidations;
+}
+
+void OverlayReadCache::clear() {
+    for ( Shard& shard : m_shards ) {
+        std::lock_guard< std::mutex > lock( shard.mutex );
+        ++shard.generation;
+        m_invalidations += shard.index.size();
+        shard.index.clear();
+        shard.lru.clear();
+        shard.bytes = 0;
+    }
+}
+
+void OverlayReadCache::evictOverflow( Shard& _shard ) {
+    while ( _shard.bytes > m_shardCapacity && !_shard.lru.empty() ) {
+        _shard.bytes -= entryBytes( _shard.lru.back() );
+        _shard.index.erase( _shard.lru.back().first );
+        _shard.lru.pop_back();
+        ++m_evictions;
+    }
+}
+
+OverlayReadCache::Stats OverlayReadCache::stats() const {
+    Stats stats;
+    stats.hits = m_hits;
+    stats.misses = m_misses;
+    stats.insertions = m_insertions;
+    stats.evictions = m_evictions;
+    stats.invalidations = m_invalidations;
+    stats.capacity = m_capacity;
+    for ( Shard const& shard : m_shards ) {
+        std::lock_guard< std::mutex > lock( shard.mutex );
+        stats.entries += shard.index.size();
+        stats.bytes += shard.bytes;
+    }
+    return stats;
+}
+
+}  // namespace skale
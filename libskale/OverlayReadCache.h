@@ -0,0 +1,108 @@
+/*
+    Copyright (C) 2018-present, SKALE Labs
+
+    This file is part of skaled.
+
+    skaled is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skaled is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with skaled.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * @file OverlayReadCache.h
+ * @date 2026
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace skale {
+
+/// Size-bounded read cache of state database records (accounts, auxiliary spaces and storage
+/// slots) keyed by their database keys. It is shared by all copies of one OverlayDB, so it
+/// survives commits: records written by a commit are refreshed in place instead of dropped.
+/// Thread-safe; every shard keeps its own LRU list under its own mutex.
+class OverlayReadCache {
+public:
+    struct Stats {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t insertions = 0;
+        uint64_t evictions = 0;
+        uint64_t invalidations = 0;
+        size_t entries = 0;
+        size_t bytes = 0;     ///< accounted memory: keys, values and per-entry overhead
+        size_t capacity = 0;  ///< memory limit in bytes
+    };
+
+    explicit OverlayReadCache( size_t _capacityBytes );
+
+    /// @returns the generation of @a _key's shard; pass it to fill() after the database read.
+    uint64_t generation( std::string const& _key ) const;
+
+    /// Looks @a _key up and counts a hit or a miss.
+    bool find( std::string const& _key, std::string& o_value );
+
+    /// Caches a value read from the database. Ignored when a write touched the shard after
+    /// @a _generation was taken, as the value read might be stale already.
+    void fill( std::string const& _key, std::string const& _value, uint64_t _generation );
+
+    /// Refreshes @a _key after it was written to the database; absent keys are not added.
+    void update( std::string const& _key, std::string const& _value );
+
+    /// Drops @a _key after it was removed from the database.
+    void invalidate( std::string const& _key );
+
+    void clear();
+
+    Stats stats() const;
+
+private:
+    static constexpr size_t c_shards = 16;
+    /// Rough cost of list and hash map nodes for one entry.
+    static constexpr size_t c_entryOverhead = 96;
+
+    using Entry = std::pair< std::string, std::string >;
+
+    struct Shard {
+        mutable std::mutex mutex;
+        std::list< Entry > lru;  ///< most recently used first
+        std::unordered_map< std::string, std::list< Entry >::iterator > index;
+        size_t bytes = 0;
+        uint64_t generation = 0;
+    };
+
+    static size_t entryBytes( Entry const& _entry ) {
+        return _entry.first.size() + _entry.second.size() + c_entryOverhead;
+    }
+
+    Shard& shardFor( std::string const& _key ) const;
+    void evictOverflow( Shard& _shard );
+
+    mutable std::array< Shard, c_shards > m_shards;
+    size_t const m_capacity;
+    size_t const m_shardCapacity;
+
+    std::atomic< uint64_t > m_hits{0};
+    std::atomic< uint64_t > m_misses{0};
+    std::atomic< uint64_t > m_insertions{0};
+    std::atomic< uint64_t > m_evictions{0};
+    std::atomic< uint64_t > m_invalidations{0};
+};
+
+}  // namespace skale
@@ -30,6 +30,7 @@
 
 #include <boost/filesystem.hpp>
 
+#include <limits>
 #include <mutex>
 #include <string>
 #include <vector>
@@ -138,8 +139,11 @@ public:
     /////////////// MORE INTERESTING STUFF ////////////////
 
 public:
-    SnapshotManager(
-        const boost::filesystem::path& _dataDir, const std::vector< std::string >& _volumes );
+    /// Databases of snapshots for blocks from @a _multisetHashBlock on are hashed with
+    /// incrementally maintained multiset hashes, older ones by reading all records.
+    SnapshotManager( const boost::filesystem::path& _dataDir,
+        const std::vector< std::string >& _volumes,
+        uint64_t _multisetHashBlock = std::numeric_limits< uint64_t >::max() );
     void doSnapshot( unsigned _blockNumber );
     void restoreSnapshot( unsigned _blockNumber );
     boost::filesystem::path makeOrGetDiff( unsigned _toBlock );
@@ -160,18 +164,26 @@ private:
     std::vector< std::string > volumes;
     boost::filesystem::path snapshots_dir;
     boost::filesystem::path diffs_dir;
+    uint64_t multiset_hash_block;
 
     static const std::string snapshot_hash_file_name;
     mutable std::mutex hash_file_mutex;
 
+    // filestorage files are read by chunks of this size in up to this number of threads
+    static const size_t file_hashing_chunk_size;
+    static const size_t file_hashing_max_threads;
+
     void computeFileSystemHash( const boost::filesystem::path& _fileSystemDir,
         secp256k1_sha256_t* ctx, bool is_checking ) const;
     void proceedFileSystemDirectory( const boost::filesystem::path& _fileSystemDir,
         secp256k1_sha256_t* ctx, bool is_checking ) const;
+    dev::h256 computeFileSystemEntryHash(
+        const boost::filesystem::path& _path, bool _isFile, bool is_checking ) const;
+    static dev::h256 computeFileHash( const boost::filesystem::path& _filePath );
     void computeAllVolumesHash(
         unsigned _blockNumber, secp256k1_sha256_t* ctx, bool is_checking ) const;
-    void computeDatabaseHash(
-        const boost::filesystem::path& _dbDir, secp256k1_sha256_t* ctx ) const;
+    void computeDatabaseHash( const boost::filesystem::path& _dbDir, secp256k1_sha256_t* ctx,
+        bool _isMultiset, bool is_checking ) const;
 };
 
 #endif  // SNAPSHOTAGENT_H
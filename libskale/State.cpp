@@ -32,8 +32,8 @@
 
 #include <libdevcore/DBImpl.h>
 #include <libethcore/SealEngine.h>
-#include <libethereum/CodeSizeCache.h>
 #include <libethereum/Defaults.h>
+#include <libevm/CodeCache.h>
 
 #include "libweb3jsonrpc/Eth.h"
 #include "libweb3jsonrpc/JsonHelper.h"
@@ -82,8 +82,8 @@ State::State( u256 const& _accountStartNonce, OverlayDB const& _db, BaseState _b
     }
 }
 
-skale::OverlayDB State::openDB(
-    fs::path const& _basePath, h256 const& _genesisHash, WithExisting _we ) {
+skale::OverlayDB State::openDB( fs::path const& _basePath, h256 const& _genesisHash,
+    WithExisting _we, bool _maintainDigests ) {
     fs::path path = _basePath.empty() ? eth::Defaults::dbPath() : _basePath;
 
     if ( _we == WithExisting::Kill ) {
@@ -98,7 +98,9 @@ skale::OverlayDB State::openDB(
 
     fs::path state_path = path / fs::path( "state" );
     try {
-        std::unique_ptr< db::DatabaseFace > db( new db::DBImpl( state_path ) );
+        std::unique_ptr< db::DBImpl > db( new db::DBImpl( state_path ) );
+        if ( _maintainDigests )
+            db->enableDigests();
         clog( VerbosityTrace, "statedb" ) << cc::success( "Opened state DB." );
         return OverlayDB( std::move( db ) );
     } catch ( boost::exception const& ex ) {
@@ -117,11 +119,18 @@ skale::OverlayDB State::openDB(
     }
 }
 
-State::State( const State& _s ) {
-    *this = _s;
+State::State( const State& _s ) : State( _s, CopyCache::Yes ) {}
+
+State::State( const State& _s, CopyCache _copyCache ) {
+    assign( _s, _copyCache );
 }
 
 State& State::operator=( const State& _s ) {
+    assign( _s, CopyCache::Yes );
+    return *this;
+}
+
+void State::assign( const State& _s, CopyCache _copyCache ) {
     x_db_ptr = _s.x_db_ptr;
     if ( _s.m_db_read_lock ) {
         m_db_read_lock.emplace( *x_db_ptr );
@@ -132,16 +141,23 @@ State& State::operator=( const State& _s ) {
     m_db_ptr = _s.m_db_ptr;
     m_storedVersion = _s.m_storedVersion;
     m_currentVersion = _s.m_currentVersion;
-    m_cache = _s.m_cache;
-    m_unchangedCacheEntries = _s.m_unchangedCacheEntries;
-    m_nonExistingAccountsCache = _s.m_nonExistingAccountsCache;
+    if ( _copyCache == CopyCache::Yes ) {
+        m_cache = _s.m_cache;
+        m_unchangedCacheEntries = _s.m_unchangedCacheEntries;
+        m_nonExistingAccountsCache = _s.m_nonExistingAccountsCache;
+        m_changeLog = _s.m_changeLog;
+    } else {
+        m_cache.clear();
+        m_unchangedCacheEntries.clear();
+        m_nonExistingAccountsCache.clear();
+        m_changeLog.clear();
+    }
     m_accountStartNonce = _s.m_accountStartNonce;
-    m_changeLog = _s.m_changeLog;
     m_initial_funds = _s.m_initial_funds;
+    m_speculative = _s.m_speculative;
+    m_accessLog = _s.m_accessLog;
     storageLimit_ = _s.storageLimit_;
     totalStorageUsed_ = _s.storageUsedTotal();
-
-    return *this;
 }
 
 void State::populateFrom( eth::AccountMap const& _map ) {
@@ -242,6 +258,9 @@ eth::Account const* State::account( Address const& _a ) const {
 }
 
 eth::Account* State::account( Address const& _address ) {
+    if ( m_accessLog )
+        m_accessLog->accountsRead.insert( _address );
+
     auto it = m_cache.find( _address );
     if ( it != m_cache.end() )
         return &it->second;
@@ -285,6 +304,11 @@ eth::Account* State::account( Address const& _address ) {
 }
 
 void State::clearCacheIfTooLarge() const {
+    // speculative copies keep everything to be merged
+    // and also must not use shared random engine from parallel threads
+    if ( m_speculative )
+        return;
+
     // TODO: Find a good magic number
     while ( m_unchangedCacheEntries.size() > 1000 ) {
         // Remove a random element
@@ -322,6 +346,8 @@ void State::commit( CommitBehaviour _commitBehaviour ) {
 
             if ( account.isDirty() ) {
                 if ( !account.isAlive() ) {
+                    if ( m_accessLog )
+                        m_accessLog->accountsWritten.insert( address );
                     m_db_ptr->kill( address );
                     m_db_ptr->killAuxiliary( address, Auxiliary::CODE );
                     // TODO: remove account storage
@@ -353,6 +379,9 @@ void State::commit( CommitBehaviour _commitBehaviour ) {
         m_currentVersion = *m_storedVersion;
     }
 
+    if ( m_accessLog )
+        m_accessLog->noteWrites( m_changeLog );
+
     m_changeLog.clear();
     m_cache.clear();
     m_unchangedCacheEntries.clear();
@@ -458,12 +487,19 @@ void State::createAccount( Address const& _address, eth::Account const&& _accoun
 }
 
 void State::kill( Address _addr ) {
+    // killed accounts are not registered in the change log
+    if ( m_speculative )
+        abandonSpeculation();
+
     if ( auto a = account( _addr ) )
         a->kill();
     // If the account is not in the db, nothing to kill.
 }
 
 std::map< h256, std::pair< u256, u256 > > State::storage( const Address& _contract ) const {
+    if ( m_speculative )
+        abandonSpeculation();
+
     boost::shared_lock< boost::shared_mutex > lock( *x_db_ptr );
     if ( !checkVersion() ) {
         cerr << "Current state version is " << m_currentVersion << " but stored version is "
@@ -497,6 +533,9 @@ u256 State::getNonce( Address const& _addr ) const {
 }
 
 u256 State::storage( Address const& _id, u256 const& _key ) const {
+    if ( m_accessLog )
+        m_accessLog->storageRead.emplace( _id, _key );
+
     if ( eth::Account const* acc = account( _id ) ) {
         auto memoryIterator = acc->storageOverlay().find( _key );
         if ( memoryIterator != acc->storageOverlay().end() )
@@ -542,13 +581,21 @@ void State::setStorage( Address const& _contract, u256 const& _key, u256 const&
     storageUsage[_contract] += count * 32;
     currentStorageUsed_ += count * 32;
 
+    if ( m_speculative )
+        m_accessLog->peakStorageUsed = max( m_accessLog->peakStorageUsed, currentStorageUsed_ );
+
     if ( totalStorageUsed_ + currentStorageUsed_ > storageLimit_ ) {
+        if ( m_speculative )
+            abandonSpeculation();
         BOOST_THROW_EXCEPTION( dev::StorageOverflow() << errinfo_comment( _contract.hex() ) );
     }
     // TODO::review it |^
 }
 
 u256 State::originalStorageValue( Address const& _contract, u256 const& _key ) const {
+    if ( m_accessLog )
+        m_accessLog->storageRead.emplace( _contract, _key );
+
     if ( Account const* acc = account( _contract ) ) {
         auto memoryPtr = acc->originalStorageValue().find( _key );
         if ( memoryPtr != acc->originalStorageValue().end() ) {
@@ -568,6 +615,10 @@ u256 State::originalStorageValue( Address const& _contract, u256 const& _key ) c
 }
 
 void State::clearStorage( Address const& _contract ) {
+    // changes total storage usage directly
+    if ( m_speculative )
+        abandonSpeculation();
+
     // TODO: This is extremely inefficient
     Account* acc = account( _contract );
     for ( auto const& hashPairPair : storage( _contract ) ) {
@@ -593,7 +644,8 @@ bytes const& State::code( Address const& _addr ) const {
             BOOST_THROW_EXCEPTION( AttemptToReadFromStateInThePast() );
         }
         mutableAccount->noteCode( m_db_ptr->lookupAuxiliary( _addr, Auxiliary::CODE ) );
-        eth::CodeSizeCache::instance().store( a->codeHash(), a->code().size() );
+        // analyze once here, frames running this code will then borrow it
+        eth::CodeCache::instance().get( a->codeHash(), &a->code() );
     }
 
     return a->code();
@@ -622,15 +674,10 @@ size_t State::codeSize( Address const& _a ) const {
     if ( eth::Account const* a = account( _a ) ) {
         if ( a->hasNewCode() )
             return a->code().size();
-        auto& codeSizeCache = eth::CodeSizeCache::instance();
-        h256 codeHash = a->codeHash();
-        if ( codeSizeCache.contains( codeHash ) )
-            return codeSizeCache.get( codeHash );
-        else {
-            size_t size = code( _a ).size();
-            codeSizeCache.store( codeHash, size );
-            return size;
-        }
+        if ( auto analyzedCode = eth::CodeCache::instance().find( a->codeHash() ) )
+            return analyzedCode->size();
+        else
+            return code( _a ).size();
     } else
         return 0;
 }
@@ -696,14 +743,14 @@ void State::updateToLatestVersion() {
 }
 
 State State::startRead() const {
-    State stateCopy = State( *this );
+    State stateCopy = startOverlay();
     stateCopy.m_db_read_lock.emplace( *stateCopy.x_db_ptr );
     stateCopy.updateToLatestVersion();
     return stateCopy;
 }
 
 State State::startWrite() const {
-    State stateCopy = State( *this );
+    State stateCopy = startOverlay();
     stateCopy.m_db_write_lock.emplace( *stateCopy.x_db_ptr );
     stateCopy.updateToLatestVersion();
     return stateCopy;
@@ -727,18 +774,80 @@ void State::stopWrite() {
     m_db_write_lock = boost::none;
 }
 
+State State::startOverlay() const {
+    return State( *this, CopyCache::No );
+}
+
 State State::startNew() {
-    State copy;
-    if ( m_db_write_lock )
-        copy = delegateWrite();
-    else
-        copy = State( *this );
+    State copy = m_db_write_lock ? delegateWrite() : startOverlay();
     if ( m_db_read_lock )
         copy.m_db_read_lock.emplace( *copy.x_db_ptr );
     copy.updateToLatestVersion();
     return copy;
 }
 
+State State::startSpeculative() const {
+    State stateCopy = State( *this );
+    stateCopy.m_speculative = true;
+    stateCopy.m_accessLog = make_shared< StateAccessLog >();
+    return stateCopy;
+}
+
+void State::abandonSpeculation() const {
+    assert( m_speculative );
+    m_accessLog->mergeable = false;
+}
+
+void State::addAuthorFees( Address const& _author, u256 const& _fees ) {
+    if ( m_speculative )
+        m_accessLog->authorFees += _fees;
+    else
+        addBalance( _author, _fees );
+}
+
+bool State::canMergeSpeculative( State const& _speculative ) const {
+    StateAccessLog const& log = _speculative.accessLog();
+    if ( !log.mergeable )
+        return false;
+    // storage usage check in setStorage() depends on changes made before
+    if ( totalStorageUsed_ + log.peakStorageUsed > storageLimit_ )
+        return false;
+    return !m_accessLog || !log.conflictsWith( *m_accessLog );
+}
+
+void State::mergeSpeculative( State const& _speculative, Transaction const& _t,
+    Address const& _author, CommitBehaviour _commitBehaviour ) {
+    assert( canMergeSpeculative( _speculative ) );
+
+    // Nothing read by the speculative execution has been changed since, so changed accounts
+    // can be taken as they are. The only exception is storage usage accumulated by other
+    // transactions that is not visible to the execution.
+    for ( auto const& addressAccountPair : _speculative.m_cache ) {
+        Address const& address = addressAccountPair.first;
+        Account const& speculativeAccount = addressAccountPair.second;
+        if ( !speculativeAccount.isDirty() )
+            continue;
+
+        Account merged = speculativeAccount;
+        if ( Account const* current = account( address ) )
+            merged.updateStorageUsage( current->storageUsed() - speculativeAccount.storageUsed() );
+        m_cache[address] = std::move( merged );
+        m_nonExistingAccountsCache.erase( address );
+    }
+    m_changeLog = _speculative.m_changeLog;
+
+    addBalance( _author, _speculative.accessLog().authorFees );
+
+    // the same as in execute() with Permanence::Committed
+    storageUsage = _speculative.storageUsage;
+    currentStorageUsed_ = _speculative.currentStorageUsed_;
+    if ( account( _t.from() ) != nullptr && account( _t.from() )->code() == bytes() ) {
+        totalStorageUsed_ += currentStorageUsed_;
+        updateStorageUsage();
+    }
+    commit( _commitBehaviour );
+}
+
 void State::clearAll() {
     if ( m_db_ptr ) {
         if ( !m_db_write_lock ) {
@@ -779,7 +888,8 @@ std::pair< ExecutionResult, TransactionReceipt > State::execute( EnvInfo const&
     // Create and initialize the executive. This will throw fairly cheaply and quickly if the
     // transaction is bad in any way.
     // HACK 0 here is for gasPrice
-    Executive e( *this, _envInfo, _sealEngine, 0, 0, _p != Permanence::Committed );
+    Executive e( *this, _envInfo, _sealEngine, 0, 0,
+        _p != Permanence::Committed && _p != Permanence::Speculative );
     ExecutionResult res;
     e.setResultRecipient( res );
 
@@ -822,6 +932,9 @@ std::pair< ExecutionResult, TransactionReceipt > State::execute( EnvInfo const&
     case Permanence::Uncommitted:
         resetStorageChanges();
         break;
+    case Permanence::Speculative:
+        // everything is kept for mergeSpeculative()
+        break;
     }
 
     TransactionReceipt receipt =
@@ -861,6 +974,10 @@ void State::updateStorageUsage() {
 }
 
 dev::s256 State::storageUsed( const dev::Address& _addr ) const {
+    // storage usage is adjusted during merge
+    if ( m_speculative )
+        abandonSpeculation();
+
     if ( auto a = account( _addr ) ) {
         return a->storageUsed();
     } else {
@@ -868,6 +985,25 @@ dev::s256 State::storageUsed( const dev::Address& _addr ) const {
     }
 }
 
+void StateAccessLog::noteWrites( ChangeLog const& _changeLog ) {
+    for ( Change const& change : _changeLog ) {
+        if ( change.kind == Change::Storage )
+            storageWritten.emplace( change.address, change.key );
+        else
+            accountsWritten.insert( change.address );
+    }
+}
+
+bool StateAccessLog::conflictsWith( StateAccessLog const& _other ) const {
+    for ( Address const& address : accountsRead )
+        if ( _other.accountsWritten.count( address ) )
+            return true;
+    for ( StorageSlot const& slot : storageRead )
+        if ( _other.storageWritten.count( slot ) )
+            return true;
+    return false;
+}
+
 bool State::checkVersion() const {
     return *m_storedVersion == m_currentVersion;
 }
@@ -25,7 +25,9 @@
 #pragma once
 
 #include <array>
+#include <memory>
 #include <queue>
+#include <set>
 #include <unordered_map>
 
 #include <boost/optional.hpp>
@@ -91,7 +93,8 @@ enum class Permanence {
     Reverted,
     Committed,
     Uncommitted,  ///< Uncommitted state for change log readings in tests.
-    CommittedWithoutState
+    CommittedWithoutState,
+    Speculative  ///< Changes are kept in cache to be merged later, see State::mergeSpeculative().
 };
 
 /// An atomic state changelog entry.
@@ -149,6 +152,28 @@ struct Change {
 
 using ChangeLog = std::vector< Change >;
 
+/// Accounts and storage slots accessed while executing transactions.
+/// Used to find conflicts between transactions executed speculatively in parallel.
+struct StateAccessLog {
+    using StorageSlot = std::pair< dev::Address, dev::u256 >;
+
+    std::set< dev::Address > accountsRead;  ///< Accounts looked up, existing or not.
+    std::set< StorageSlot > storageRead;    ///< Storage slots looked up.
+    std::set< dev::Address > accountsWritten;  ///< Accounts with changed nonce, balance, code etc.
+    std::set< StorageSlot > storageWritten;    ///< Storage slots changed.
+
+    dev::u256 authorFees;           ///< Fees for the block author deferred until merge.
+    dev::s256 peakStorageUsed = 0;  ///< Maximal storage usage growth within the transaction.
+    bool mergeable = true;  ///< false if speculative results cannot be used, e.g. when the
+                            ///< transaction has effects outside of the state.
+
+    /// Register changes from @a _changeLog as writes.
+    void noteWrites( ChangeLog const& _changeLog );
+
+    /// @returns true if anything read here was written in @a _other.
+    bool conflictsWith( StateAccessLog const& _other ) const;
+};
+
 /**
  * Model of an Skale state.
  *
@@ -176,13 +201,15 @@ public:
     /// Use the default when you already have a database and you just want to make a State object
     /// which uses it. If you have no preexisting database then set BaseState to something other
     /// than BaseState::PreExisting in order to prepopulate the state.
+    /// With @a _maintainDigests the database keeps its hash up to date on every write.
     explicit State( dev::u256 const& _accountStartNonce, boost::filesystem::path const& _dbPath,
         dev::h256 const& _genesis, BaseState _bs = BaseState::PreExisting,
-        dev::u256 _initialFunds = 0, dev::s256 _storageLimit = 32 )
+        dev::u256 _initialFunds = 0, dev::s256 _storageLimit = 32, bool _maintainDigests = false )
         : State( _accountStartNonce,
               openDB( _dbPath, _genesis,
                   _bs == BaseState::PreExisting ? dev::WithExisting::Trust :
-                                                  dev::WithExisting::Kill ),
+                                                  dev::WithExisting::Kill,
+                  _maintainDigests ),
               _bs, _initialFunds, _storageLimit ) {}
 
     State() : State( dev::Invalid256, OverlayDB(), BaseState::Empty ) {}
@@ -348,6 +375,12 @@ public:
     /// Create State copy to modify data.
     State startWrite() const;
 
+    /// Create State copy that shares database, version and read lock with this one
+    /// but starts with an empty account cache, so its cost doesn't depend on how much
+    /// this object has cached. Changes made to the copy stay in its own cache, e.g. for
+    /// Permanence::Reverted execution. Uncommitted changes of this object are not visible in it.
+    State startOverlay() const;
+
     /// Create State copy to modify data and pass writing lock to it
     State delegateWrite();
 
@@ -355,6 +388,36 @@ public:
 
     State startNew();
 
+    /// Create State copy for speculative execution with Permanence::Speculative.
+    /// Different copies can be executed in parallel threads while the original holds
+    /// the write lock. Accessed accounts and storage slots are recorded in accessLog().
+    /// The copy can't be committed; use mergeSpeculative() on the original instead.
+    State startSpeculative() const;
+
+    bool isSpeculative() const { return m_speculative; }
+
+    /// Record accesses and committed changes of this object and its copies in @a _log.
+    void setAccessLog( std::shared_ptr< StateAccessLog > const& _log ) { m_accessLog = _log; }
+
+    StateAccessLog const& accessLog() const { return *m_accessLog; }
+
+    /// Mark speculative execution results as not usable, so the transaction is executed again.
+    void abandonSpeculation() const;
+
+    /// Pay transaction fees to the block author.
+    /// Deferred until mergeSpeculative() for speculative State copies so that fees
+    /// do not make every transaction in a block depend on the previous one.
+    void addAuthorFees( dev::Address const& _author, dev::u256 const& _fees );
+
+    /// @returns true if changes made by @a _speculative can be merged into this state,
+    /// i.e. it read nothing that was changed since it had been copied.
+    bool canMergeSpeculative( State const& _speculative ) const;
+
+    /// Apply and commit changes made by @a _t executed on @a _speculative copy.
+    /// The result is the same as executing @a _t here with Permanence::Committed.
+    void mergeSpeculative( State const& _speculative, dev::eth::Transaction const& _t,
+        dev::Address const& _author, CommitBehaviour _commitBehaviour );
+
     /**
      * @brief clearAll removes all data from database
      */
@@ -377,11 +440,20 @@ public:
 
     dev::s256 storageUsedTotal() const { return m_db_ptr->storageUsed(); }
 
+    /// @returns statistics of the state database read cache.
+    OverlayReadCache::Stats dbReadCacheStats() const { return m_db_ptr->readCacheStats(); }
+
     void setStorageLimit( const dev::s256& _storageLimit ) {
         storageLimit_ = _storageLimit;
     };  // only for tests
 
 private:
+    enum class CopyCache { No, Yes };
+
+    State( State const& _s, CopyCache _copyCache );
+
+    void assign( State const& _s, CopyCache _copyCache );
+
     void updateToLatestVersion();
 
     explicit State( dev::u256 const& _accountStartNonce, OverlayDB const& _db,
@@ -389,9 +461,9 @@ private:
         dev::s256 _storageLimit = 32 );
 
     /// Open a DB - useful for passing into the constructor & keeping for other states that are
-    /// necessary.
+    /// necessary. With @a _maintainDigests, see dev::db::LevelDB::enableDigests().
     static OverlayDB openDB( boost::filesystem::path const& _path, dev::h256 const& _genesisHash,
-        dev::WithExisting _we = dev::WithExisting::Trust );
+        dev::WithExisting _we = dev::WithExisting::Trust, bool _maintainDigests = false );
 
     /// Turns all "touched" empty accounts into non-alive accounts.
     void removeEmptyAccounts();
@@ -447,6 +519,9 @@ private:
 
     dev::u256 m_initial_funds = 0;
 
+    bool m_speculative = false;
+    std::shared_ptr< StateAccessLog > m_accessLog;
+
     dev::s256 storageLimit_ = 0;
     std::map< dev::Address, dev::s256 > storageUsage;
     dev::s256 totalStorageUsed_ = 0;
@@ -36,6 +36,11 @@
 
 Broadcaster::~Broadcaster() {}
 
+void Broadcaster::broadcastBatch( const dev::bytes& _rlpList ) {
+    for ( const auto& item : dev::RLP( _rlpList ) )
+        broadcast( dev::toJS( item.data().toBytes() ) );
+}
+
 HttpBroadcaster::HttpBroadcaster( dev::eth::Client& _client ) : m_client( _client ) {
     const dev::eth::ChainParams& ch = _client.chainParams();
     initClients( ch.sChain, ch.nodeInfo );
@@ -179,7 +184,12 @@ void ZmqBroadcaster::startService() {
                 std::string str( static_cast< char* >( data ), size );
 
                 try {
-                    m_skaleHost.receiveTransaction( str );
+                    // single transactions are sent as hex strings, batches - as binary RLP lists
+                    if ( size > 0 && static_cast< uint8_t >( str[0] ) >= dev::c_rlpListStart )
+                        m_skaleHost.receiveTransactions( dev::bytesConstRef(
+                            static_cast< const dev::_byte_* >( data ), size ) );
+                    else
+                        m_skaleHost.receiveTransaction( str );
                 } catch ( const std::exception& ex ) {
                     clog( dev::VerbosityInfo, "skale-host" )
                         << "Received bad transaction through broadcast: " << ex.what();
@@ -227,3 +237,10 @@ void ZmqBroadcaster::broadcast( const std::string& _rlp ) {
         throw std::runtime_error( "Zmq can't send data" );
     }
 }
+
+void ZmqBroadcaster::broadcastBatch( const dev::bytes& _rlpList ) {
+    int res = zmq_send( server_socket(), _rlpList.data(), _rlpList.size(), 0 );
+    if ( res <= 0 ) {
+        throw std::runtime_error( "Zmq can't send data" );
+    }
+}
@@ -53,6 +53,8 @@ public:
     virtual ~Broadcaster();
 
     virtual void broadcast( const std::string& _rlp ) = 0;
+    // sends RLP list of transactions, by default one by one
+    virtual void broadcastBatch( const dev::bytes& _rlpList );
 
     virtual void startService() = 0;
     virtual void stopService() = 0;
@@ -81,6 +83,8 @@ public:
     virtual ~ZmqBroadcaster();
 
     virtual void broadcast( const std::string& _rlp );
+    // sends binary RLP list in one message
+    virtual void broadcastBatch( const dev::bytes& _rlpList );
 
     virtual void startService();
     virtual void stopService();
@@ -47,6 +47,7 @@
 #include <limits.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <time.h>
 
 #include <libethcore/CommonJS.h>
 
@@ -168,6 +169,19 @@ nlohmann::json nljsBlockNumber( dev::eth::BlockNumber bn ) {
     return nlohmann::json( unsigned( bn ) );
 }
 
+nlohmann::json toJsonLog( dev::eth::LocalisedLogEntry const& e ) {
+    nlohmann::json log = nlohmann::json::object();
+    log["logIndex"] = e.logIndex;
+    log["transactionIndex"] = e.transactionIndex;
+    log["transactionHash"] = toJS( e.transactionHash );
+    log["address"] = dev::toJS( e.address );
+    log["data"] = dev::toJS( e.data );
+    log["topics"] = nlohmann::json::array();
+    for ( auto const& t : e.topics )
+        log["topics"].push_back( dev::toJS( t ) );
+    return log;
+}
+
 nlohmann::json toJson( std::unordered_map< dev::h256, dev::eth::LocalisedLogEntries > const& eb,
     std::vector< dev::h256 > const& order ) {
     nlohmann::json res = nlohmann::json::array();
@@ -183,18 +197,8 @@ nlohmann::json toJson( std::unordered_map< dev::h256, dev::eth::LocalisedLogEntr
             currentBlock["type"] = "pending";
         currentBlock["polarity"] = entry.polarity == dev::eth::BlockPolarity::Live ? true : false;
         currentBlock["logs"] = nlohmann::json::array();
-        for ( dev::eth::LocalisedLogEntry const& e : entries ) {
-            nlohmann::json log = nlohmann::json::object();
-            log["logIndex"] = e.logIndex;
-            log["transactionIndex"] = e.transactionIndex;
-            log["transactionHash"] = toJS( e.transactionHash );
-            log["address"] = dev::toJS( e.address );
-            log["data"] = dev::toJS( e.data );
-            log["topics"] = nlohmann::json::array();
-            for ( auto const& t : e.topics )
-                log["topics"].push_back( dev::toJS( t ) );
-            currentBlock["logs"].push_back( log );
-        }
+        for ( dev::eth::LocalisedLogEntry const& e : entries )
+            currentBlock["logs"].push_back( toJsonLog( e ) );
         res.push_back( currentBlock );
     }
     return res;
@@ -257,6 +261,56 @@ bool checkParamsIsObject(
     return false;
 }
 
+std::string composeBatchAnswer( const std::vector< std::string >& vecResponses ) {
+    size_t cntBytes = 2;
+    for ( const std::string& strResponse : vecResponses )
+        cntBytes += strResponse.size() + 1;
+    std::string strBatchAnswer;
+    strBatchAnswer.reserve( cntBytes );
+    strBatchAnswer += '[';
+    for ( const std::string& strResponse : vecResponses ) {
+        if ( strBatchAnswer.size() > 1 )
+            strBatchAnswer += ',';
+        strBatchAnswer += skutils::tools::trim_copy( strResponse );
+    }
+    strBatchAnswer += ']';
+    return strBatchAnswer;
+}
+
+bool isParallelSafeBatchItem( const nlohmann::json& joRequest ) {
+    // read-only methods which don't depend on other elements of the same batch
+    static const std::set< std::string > g_setParallelSafe = {"web3_clientVersion",
+        "web3_sha3", "net_version", "net_listening", "net_peerCount", "eth_protocolVersion",
+        "eth_chainId", "eth_syncing", "eth_gasPrice", "eth_blockNumber", "eth_getBalance",
+        "eth_getStorageAt", "eth_getTransactionCount", "eth_getBlockTransactionCountByHash",
+        "eth_getBlockTransactionCountByNumber", "eth_getUncleCountByBlockHash",
+        "eth_getUncleCountByBlockNumber", "eth_getCode", "eth_call", "eth_estimateGas",
+        "eth_getBlockByHash", "eth_getBlockByNumber", "eth_getTransactionByHash",
+        "eth_getTransactionByBlockHashAndIndex", "eth_getTransactionByBlockNumberAndIndex",
+        "eth_getTransactionReceipt", "eth_getLogs"};
+    if ( !joRequest.is_object() )
+        return false;
+    auto itMethod = joRequest.find( "method" );
+    if ( itMethod == joRequest.end() || !itMethod->is_string() )
+        return false;
+    return g_setParallelSafe.count( itMethod->get< std::string >() ) != 0;
+}
+
+uint64_t thread_cpu_time_ns() {
+    struct timespec ts;
+    if ( clock_gettime( CLOCK_THREAD_CPUTIME_ID, &ts ) != 0 )
+        return 0;
+    return uint64_t( ts.tv_sec ) * 1000000000 + uint64_t( ts.tv_nsec );
+}
+
+// traced RPC calls, one queue per protocol
+const skutils::task::performance::trace_point g_traceCallHTTP{
+    "rpc/HTTP", "call", "method", {"server", "size", "answer", "error"}};
+const skutils::task::performance::trace_point g_traceCallHTTPS{
+    "rpc/HTTPS", "call", "method", {"server", "size", "answer", "error"}};
+const skutils::task::performance::trace_point g_traceCallWS{
+    "rpc/WS", "call", "method", {"server", "size", "answer", "error"}};
+
 };  // namespace helper
 };  // namespace server
 };  // namespace skale
@@ -267,152 +321,30 @@ bool checkParamsIsObject(
 
 namespace stats {
 
-typedef skutils::multithreading::recursive_mutex_type mutex_type_stats;
-typedef std::lock_guard< mutex_type_stats > lock_type_stats;
-static skutils::multithreading::recursive_mutex_type g_mtx_stats( "RMTX-NMA-PEER-ALL" );
-
-struct map_method_call_stats_t
-    : public std::map< std::string, skutils::stats::named_event_stats* > {
-    typedef std::map< std::string, skutils::stats::named_event_stats* > my_base_t;
-    void clear() {
-        iterator itWalk = begin(), itEnd = end();
-        for ( ; itWalk != itEnd; ++itWalk ) {
-            skutils::stats::named_event_stats* x = itWalk->second;
-            if ( x )
-                delete x;
-        }
-        my_base_t::clear();
-    }
-    map_method_call_stats_t() = default;
-    ~map_method_call_stats_t() { clear(); }
-    map_method_call_stats_t( const map_method_call_stats_t& ) = delete;
-    map_method_call_stats_t( map_method_call_stats_t&& ) = delete;
-    map_method_call_stats_t& operator=( const map_method_call_stats_t& ) = delete;
-    map_method_call_stats_t& operator=( map_method_call_stats_t&& ) = delete;
-};
-
-map_method_call_stats_t g_map_method_call_stats;
-map_method_call_stats_t g_map_method_answer_stats;
-map_method_call_stats_t g_map_method_error_stats;
-map_method_call_stats_t g_map_method_exception_stats;
-map_method_call_stats_t g_map_method_traffic_stats_in;
-map_method_call_stats_t g_map_method_traffic_stats_out;
-static size_t g_nDefaultQueueSize = 10;
-
-static skutils::stats::named_event_stats& stat_subsystem_call_queue( const char* strSubSystem ) {
-    lock_type_stats lock( g_mtx_stats );
-    map_method_call_stats_t::iterator itFind = g_map_method_call_stats.find( strSubSystem ),
-                                      itEnd = g_map_method_call_stats.end();
-    if ( itFind != itEnd ) {
-        skutils::stats::named_event_stats* x = itFind->second;
-        if ( x )
-            return ( *x );
-    }
-    skutils::stats::named_event_stats* x = new skutils::stats::named_event_stats;
-    g_map_method_call_stats[strSubSystem] = x;
-    return ( *x );
-}
-static skutils::stats::named_event_stats& stat_subsystem_answer_queue( const char* strSubSystem ) {
-    lock_type_stats lock( g_mtx_stats );
-    map_method_call_stats_t::iterator itFind = g_map_method_answer_stats.find( strSubSystem ),
-                                      itEnd = g_map_method_answer_stats.end();
-    if ( itFind != itEnd ) {
-        skutils::stats::named_event_stats* x = itFind->second;
-        if ( x )
-            return ( *x );
-    }
-    skutils::stats::named_event_stats* x = new skutils::stats::named_event_stats;
-    g_map_method_answer_stats[strSubSystem] = x;
-    return ( *x );
-}
-static skutils::stats::named_event_stats& stat_subsystem_error_queue( const char* strSubSystem ) {
-    lock_type_stats lock( g_mtx_stats );
-    map_method_call_stats_t::iterator itFind = g_map_method_error_stats.find( strSubSystem ),
-                                      itEnd = g_map_method_error_stats.end();
-    if ( itFind != itEnd ) {
-        skutils::stats::named_event_stats* x = itFind->second;
-        if ( x )
-            return ( *x );
-    }
-    skutils::stats::named_event_stats* x = new skutils::stats::named_event_stats;
-    g_map_method_error_stats[strSubSystem] = x;
-    return ( *x );
-}
-static skutils::stats::named_event_stats& stat_subsystem_exception_queue(
-    const char* strSubSystem ) {
-    lock_type_stats lock( g_mtx_stats );
-    map_method_call_stats_t::iterator itFind = g_map_method_exception_stats.find( strSubSystem ),
-                                      itEnd = g_map_method_exception_stats.end();
-    if ( itFind != itEnd ) {
-        skutils::stats::named_event_stats* x = itFind->second;
-        if ( x )
-            return ( *x );
-    }
-    skutils::stats::named_event_stats* x = new skutils::stats::named_event_stats;
-    g_map_method_exception_stats[strSubSystem] = x;
-    return ( *x );
-}
-
-static skutils::stats::named_event_stats& stat_subsystem_traffic_queue_in(
-    const char* strSubSystem ) {
-    lock_type_stats lock( g_mtx_stats );
-    const auto itFind = g_map_method_traffic_stats_in.find( strSubSystem );
-    if ( itFind != std::end( g_map_method_traffic_stats_in ) ) {
-        skutils::stats::named_event_stats* x = itFind->second;
-        if ( x )
-            return ( *x );
-    }
-    skutils::stats::named_event_stats* x = new skutils::stats::named_event_stats;
-    g_map_method_traffic_stats_in[strSubSystem] = x;
-    return ( *x );
-}
-static skutils::stats::named_event_stats& stat_subsystem_traffic_queue_out(
-    const char* strSubSystem ) {
-    lock_type_stats lock( g_mtx_stats );
-    const auto itFind = g_map_method_traffic_stats_out.find( strSubSystem );
-    if ( itFind != std::end( g_map_method_traffic_stats_out ) ) {
-        skutils::stats::named_event_stats* x = itFind->second;
-        if ( x )
-            return ( *x );
-    }
-    skutils::stats::named_event_stats* x = new skutils::stats::named_event_stats;
-    g_map_method_traffic_stats_out[strSubSystem] = x;
-    return ( *x );
-}
-
-
 void register_stats_message(
     const char* strSubSystem, const char* strMethodName, const size_t nJsonSize ) {
-    lock_type_stats lock( g_mtx_stats );
-    skutils::stats::named_event_stats& cq = stat_subsystem_call_queue( strSubSystem );
-    cq.event_queue_add( strMethodName, g_nDefaultQueueSize );
-    cq.event_add( strMethodName );
-    skutils::stats::named_event_stats& tq = stat_subsystem_traffic_queue_in( strSubSystem );
-    tq.event_queue_add( strMethodName, g_nDefaultQueueSize );
-    tq.event_add( strMethodName, nJsonSize );
+    skutils::stats::sharded::register_call( strSubSystem, strMethodName, nJsonSize );
 }
 void register_stats_answer(
     const char* strSubSystem, const char* strMethodName, const size_t nJsonSize ) {
-    lock_type_stats lock( g_mtx_stats );
-    skutils::stats::named_event_stats& aq = stat_subsystem_answer_queue( strSubSystem );
-    aq.event_queue_add( strMethodName, g_nDefaultQueueSize );
-    aq.event_add( strMethodName );
-
-    skutils::stats::named_event_stats& tq = stat_subsystem_traffic_queue_out( strSubSystem );
-    tq.event_queue_add( strMethodName, g_nDefaultQueueSize );
-    tq.event_add( strMethodName, nJsonSize );
+    skutils::stats::sharded::register_answer( strSubSystem, strMethodName, nJsonSize );
 }
 void register_stats_error( const char* strSubSystem, const char* strMethodName ) {
-    lock_type_stats lock( g_mtx_stats );
-    skutils::stats::named_event_stats& eq = stat_subsystem_error_queue( strSubSystem );
-    eq.event_queue_add( strMethodName, g_nDefaultQueueSize );
-    eq.event_add( strMethodName );
+    skutils::stats::sharded::register_error( strSubSystem, strMethodName );
 }
 void register_stats_exception( const char* strSubSystem, const char* strMethodName ) {
-    lock_type_stats lock( g_mtx_stats );
-    skutils::stats::named_event_stats& eq = stat_subsystem_exception_queue( strSubSystem );
-    eq.event_queue_add( strMethodName, g_nDefaultQueueSize );
-    eq.event_add( strMethodName );
+    skutils::stats::sharded::register_exception( strSubSystem, strMethodName );
+}
+// records time of call started at tpStart in RPC/<protocol> and RPC subsystems, in seconds
+double register_stats_call_time( const char* strProtocol, const char* strMethodName,
+    const skutils::stats::time_point& tpStart ) {
+    uint64_t nMicroseconds = uint64_t( std::chrono::duration_cast< std::chrono::microseconds >(
+        skutils::stats::clock::now() - tpStart )
+                                           .count() );
+    skutils::stats::sharded::register_latency(
+        ( std::string( "RPC/" ) + strProtocol ).c_str(), strMethodName, nMicroseconds );
+    skutils::stats::sharded::register_latency( "RPC", strMethodName, nMicroseconds );
+    return double( nMicroseconds ) / 1000000.0;
 }
 
 void register_stats_message( const char* strSubSystem, const nlohmann::json& joMessage ) {
@@ -437,67 +369,92 @@ void register_stats_exception( const char* strSubSystem, const nlohmann::json& j
     register_stats_exception( strSubSystem, strMethodName.c_str() );
 }
 
+static const skutils::stats::time_point g_tpStatsStart = skutils::stats::clock::now();
+
+static double per_second( uint64_t n, double lfSeconds ) {
+    return ( lfSeconds > 0.0 ) ? double( n ) / lfSeconds : 0.0;
+}
+
+// rates are averages since start, so reading stats changes nothing and every reader sees the same
 static nlohmann::json generate_subsystem_stats( const char* strSubSystem ) {
-    lock_type_stats lock( g_mtx_stats );
     nlohmann::json jo = nlohmann::json::object();
-    skutils::stats::named_event_stats& cq = stat_subsystem_call_queue( strSubSystem );
-    skutils::stats::named_event_stats& aq = stat_subsystem_answer_queue( strSubSystem );
-    skutils::stats::named_event_stats& erq = stat_subsystem_error_queue( strSubSystem );
-    skutils::stats::named_event_stats& exq = stat_subsystem_exception_queue( strSubSystem );
-    skutils::stats::named_event_stats& tq_in = stat_subsystem_traffic_queue_in( strSubSystem );
-    skutils::stats::named_event_stats& tq_out = stat_subsystem_traffic_queue_out( strSubSystem );
-    std::set< std::string > setNames = cq.all_queue_names(), setNames_aq = aq.all_queue_names(),
-                            setNames_erq = erq.all_queue_names(),
-                            setNames_exq = exq.all_queue_names(),
-                            setNames_tq_in = tq_in.all_queue_names(),
-                            setNames_tq_out = tq_out.all_queue_names();
-    std::set< std::string >::const_iterator itNameWalk, itNameEnd;
-    for ( itNameWalk = setNames_aq.cbegin(), itNameEnd = setNames_aq.cend();
-          itNameWalk != itNameEnd; ++itNameWalk )
-        setNames.insert( *itNameWalk );
-    for ( itNameWalk = setNames_erq.cbegin(), itNameEnd = setNames_erq.cend();
-          itNameWalk != itNameEnd; ++itNameWalk )
-        setNames.insert( *itNameWalk );
-    for ( itNameWalk = setNames_exq.cbegin(), itNameEnd = setNames_exq.cend();
-          itNameWalk != itNameEnd; ++itNameWalk )
-        setNames.insert( *itNameWalk );
-    for ( itNameWalk = setNames_tq_in.cbegin(), itNameEnd = setNames_tq_in.cend();
-          itNameWalk != itNameEnd; ++itNameWalk )
-        setNames.insert( *itNameWalk );
-    for ( itNameWalk = setNames_tq_out.cbegin(), itNameEnd = setNames_tq_out.cend();
-          itNameWalk != itNameEnd; ++itNameWalk )
-        setNames.insert( *itNameWalk );
-    for ( itNameWalk = setNames.cbegin(), itNameEnd = setNames.cend(); itNameWalk != itNameEnd;
-          ++itNameWalk ) {
-        const std::string& strMethodName = ( *itNameWalk );
-        size_t nCalls = 0, nAnswers = 0, nErrors = 0, nExceptions = 0;
-        skutils::stats::bytes_count_t nBytesRecv = 0, nBytesSent = 0;
-        skutils::stats::time_point tpNow = skutils::stats::clock::now();
-        double lfCallsPerSecond = cq.compute_eps( strMethodName, tpNow, nullptr, &nCalls );
-        double lfAnswersPerSecond = aq.compute_eps( strMethodName, tpNow, nullptr, &nAnswers );
-        double lfErrorsPerSecond = erq.compute_eps( strMethodName, tpNow, nullptr, &nErrors );
-        double lfExceptionsPerSecond =
-            exq.compute_eps( strMethodName, tpNow, nullptr, &nExceptions );
-        double lfBytesPerSecondRecv = tq_in.compute_eps( strMethodName, tpNow, &nBytesRecv );
-        double lfBytesPerSecondSent = tq_out.compute_eps( strMethodName, tpNow, &nBytesSent );
+    double lfSeconds =
+        std::chrono::duration< double >( skutils::stats::clock::now() - g_tpStatsStart ).count();
+    for ( const auto& method : skutils::stats::sharded::collect( strSubSystem ) ) {
+        const skutils::stats::sharded::method_totals_t& totals = method.second;
         nlohmann::json joMethod = nlohmann::json::object();
-        joMethod["cps"] = lfCallsPerSecond;
-        joMethod["aps"] = lfAnswersPerSecond;
-        joMethod["erps"] = lfErrorsPerSecond;
-        joMethod["exps"] = lfExceptionsPerSecond;
-        joMethod["bps_recv"] = lfBytesPerSecondRecv;
-        joMethod["bps_sent"] = lfBytesPerSecondSent;
-        joMethod["calls"] = nCalls;
-        joMethod["answers"] = nAnswers;
-        joMethod["errors"] = nErrors;
-        joMethod["exceptions"] = nExceptions;
-        joMethod["bytes_recv"] = nBytesRecv;
-        joMethod["bytes_sent"] = nBytesSent;
-        jo[strMethodName] = joMethod;
+        joMethod["cps"] = per_second( totals.calls_, lfSeconds );
+        joMethod["aps"] = per_second( totals.answers_, lfSeconds );
+        joMethod["erps"] = per_second( totals.errors_, lfSeconds );
+        joMethod["exps"] = per_second( totals.exceptions_, lfSeconds );
+        joMethod["bps_recv"] = per_second( totals.bytes_recv_, lfSeconds );
+        joMethod["bps_sent"] = per_second( totals.bytes_sent_, lfSeconds );
+        joMethod["calls"] = totals.calls_;
+        joMethod["answers"] = totals.answers_;
+        joMethod["errors"] = totals.errors_;
+        joMethod["exceptions"] = totals.exceptions_;
+        joMethod["bytes_recv"] = totals.bytes_recv_;
+        joMethod["bytes_sent"] = totals.bytes_sent_;
+        if ( totals.latency_.count() > 0 )
+            joMethod["latency"] = totals.latency_.toJSON( 1e-6 );  // in seconds
+        jo[method.first] = joMethod;
     }
     return jo;
 }
 
+// fastest and slowest calls per protocol, from latencies of all calls since start
+static nlohmann::json generate_execution_performance() {
+    nlohmann::json joStatsAll = nlohmann::json::object();
+    nlohmann::json joProtocols = nlohmann::json::object();
+    skutils::stats::latency_histogram latencyAll;
+    std::string protocolMin( "N/A" ), protocolMax( "N/A" );
+    std::string strMethodMin( "unknown-method" ), strMethodMax( "unknown-method" );
+    for ( const char* strProtocol : {"HTTP", "HTTPS", "WS", "WSS"} ) {
+        skutils::stats::latency_histogram latencyProtocol;
+        std::string strProtocolMethodMin, strProtocolMethodMax;
+        for ( const auto& method :
+            skutils::stats::sharded::collect( ( std::string( "RPC/" ) + strProtocol ).c_str() ) ) {
+            const skutils::stats::latency_histogram& latency = method.second.latency_;
+            if ( latency.count() == 0 )
+                continue;
+            if ( latencyProtocol.count() == 0 || latency.min() < latencyProtocol.min() )
+                strProtocolMethodMin = method.first;
+            if ( latencyProtocol.count() == 0 || latency.max() > latencyProtocol.max() )
+                strProtocolMethodMax = method.first;
+            latencyProtocol.merge( latency );
+        }
+        if ( latencyProtocol.count() == 0 )
+            continue;
+        nlohmann::json joStatsProtocol = nlohmann::json::object();
+        joStatsProtocol["callTimeMin"] = double( latencyProtocol.min() ) / 1000000.0;
+        joStatsProtocol["callTimeMax"] = double( latencyProtocol.max() ) / 1000000.0;
+        joStatsProtocol["callTimeAvg"] = latencyProtocol.mean() / 1000000.0;
+        joStatsProtocol["methodMin"] = strProtocolMethodMin;
+        joStatsProtocol["methodMax"] = strProtocolMethodMax;
+        joProtocols[strProtocol] = joStatsProtocol;
+        if ( latencyAll.count() == 0 || latencyProtocol.min() < latencyAll.min() ) {
+            strMethodMin = strProtocolMethodMin;
+            protocolMin = strProtocol;
+        }
+        if ( latencyAll.count() == 0 || latencyProtocol.max() > latencyAll.max() ) {
+            strMethodMax = strProtocolMethodMax;
+            protocolMax = strProtocol;
+        }
+        latencyAll.merge( latencyProtocol );
+    }
+    nlohmann::json joSummary = nlohmann::json::object();
+    joSummary["callTimeMin"] = double( latencyAll.min() ) / 1000000.0;
+    joSummary["callTimeMax"] = double( latencyAll.max() ) / 1000000.0;
+    joSummary["callTimeAvg"] = latencyAll.mean() / 1000000.0;
+    joSummary["methodMin"] = strMethodMin;
+    joSummary["methodMax"] = strMethodMax;
+    joSummary["protocolMin"] = protocolMin;
+    joSummary["protocolMax"] = protocolMax;
+    joStatsAll["summary"] = joSummary;
+    joStatsAll["protocols"] = joProtocols;
+    return joStatsAll;
+}
+
 };  // namespace stats
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -649,6 +606,344 @@ void SkaleStatsSubscriptionManager::unsubscribeAll() {
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+void SkaleLogsFanOut::indexLogGroup(
+    const dev::h256& h, const dev::eth::LogFilter& filter, bool isAdd ) {
+    auto fnUpdate = [&]( auto& mapIndex, const auto& key ) -> void {
+        if ( isAdd ) {
+            mapIndex[key].insert( h );
+            return;
+        }
+        auto itFind = mapIndex.find( key );
+        if ( itFind == mapIndex.end() )
+            return;
+        itFind->second.erase( h );
+        if ( itFind->second.empty() )
+            mapIndex.erase( itFind );
+    };
+    // any log matching group has one of its addresses, otherwise one of topics in first
+    // constrained slot, so group needs to be found by these ones only
+    if ( !filter.addresses().empty() ) {
+        for ( const dev::Address& address : filter.addresses() )
+            fnUpdate( map_log_groups_by_address_, address );
+        return;
+    }
+    for ( unsigned i = 0; i < 4; ++i ) {
+        if ( filter.topics()[i].empty() )
+            continue;
+        for ( const dev::h256& topic : filter.topics()[i] )
+            fnUpdate( map_log_groups_by_topic_, std::make_pair( i, topic ) );
+        return;
+    }
+    if ( isAdd )
+        set_log_groups_unindexed_.insert( h );
+    else
+        set_log_groups_unindexed_.erase( h );
+}
+
+void SkaleLogsFanOut::add(
+    subscription_id_t idSubscription, peer_key_t peer, const dev::eth::LogFilter& filter ) {
+    dev::h256 h = filter.sha3();  // includes block range
+    map_log_groups_t::iterator itGroup = map_log_groups_.find( h );
+    if ( itGroup == map_log_groups_.end() ) {
+        itGroup = map_log_groups_.emplace( h, log_group_t() ).first;
+        itGroup->second.m_filter = filter;
+        indexLogGroup( h, filter, true );
+    }
+    itGroup->second.m_subscribers[idSubscription] = peer;
+    map_log_subscriptions_[idSubscription] = h;
+}
+
+bool SkaleLogsFanOut::remove( subscription_id_t idSubscription ) {
+    auto itFind = map_log_subscriptions_.find( idSubscription );
+    if ( itFind == map_log_subscriptions_.end() )
+        return false;
+    map_log_groups_t::iterator itGroup = map_log_groups_.find( itFind->second );
+    map_log_subscriptions_.erase( itFind );
+    if ( itGroup != map_log_groups_.end() ) {
+        itGroup->second.m_subscribers.erase( idSubscription );
+        if ( itGroup->second.m_subscribers.empty() ) {
+            indexLogGroup( itGroup->first, itGroup->second.m_filter, false );
+            map_log_groups_.erase( itGroup );
+        }
+    }
+    return true;
+}
+
+SkaleLogsFanOut::map_peer_batches_t SkaleLogsFanOut::fanOut(
+    const dev::eth::LocalisedLogEntries& changes ) {
+    map_peer_batches_t mapBatches;
+    dev::h256 hashLastBlock;
+    set_group_hashes_t setCandidates;
+    for ( const dev::eth::LocalisedLogEntry& e : changes ) {
+        if ( e.isSpecial || !e.mined )
+            continue;
+        if ( e.blockHash != hashLastBlock ) {
+            hashLastBlock = e.blockHash;
+            ++cntLogBlocks_;
+        }
+        ++cntLogsEvaluated_;
+        setCandidates = set_log_groups_unindexed_;
+        auto itAddress = map_log_groups_by_address_.find( e.address );
+        if ( itAddress != map_log_groups_by_address_.end() )
+            setCandidates.insert( itAddress->second.begin(), itAddress->second.end() );
+        for ( unsigned i = 0; i < e.topics.size() && i < 4; ++i ) {
+            auto itTopic = map_log_groups_by_topic_.find( std::make_pair( i, e.topics[i] ) );
+            if ( itTopic != map_log_groups_by_topic_.end() )
+                setCandidates.insert( itTopic->second.begin(), itTopic->second.end() );
+        }
+        std::string strResult;  // serialized once for all subscribers
+        for ( const dev::h256& h : setCandidates ) {
+            const log_group_t& group = map_log_groups_.at( h );
+            // "latest" and "pending" do not limit new logs
+            dev::eth::BlockNumber bnEarliest = group.m_filter.earliest(),
+                                  bnLatest = group.m_filter.latest();
+            if ( bnEarliest != dev::eth::LatestBlock && bnEarliest != dev::eth::PendingBlock &&
+                 e.blockNumber < bnEarliest )
+                continue;
+            if ( bnLatest != dev::eth::LatestBlock && bnLatest != dev::eth::PendingBlock &&
+                 e.blockNumber > bnLatest )
+                continue;
+            if ( !group.m_filter.matches( static_cast< const dev::eth::LogEntry& >( e ) ) )
+                continue;
+            if ( strResult.empty() ) {
+                nlohmann::json joLog = skale::server::helper::toJsonLog( e );
+                joLog["blockHash"] = dev::toJS( e.blockHash );
+                joLog["blockNumber"] = unsigned( e.blockNumber );
+                strResult = joLog.dump();
+                ++cntLogsSerialized_;
+            }
+            for ( const auto& subscriber : group.m_subscribers ) {
+                peer_batch_ptr_t& pBatch = mapBatches[subscriber.second];
+                if ( !pBatch )
+                    pBatch = std::make_shared< peer_batch_t >();
+                // same text as dump() of notification object with keys in sorted order
+                std::string strNotification =
+                    "{\"jsonrpc\":\"2.0\",\"method\":\"eth_subscription\",\"params\":{"
+                    "\"result\":" +
+                    strResult + ",\"subscription\":\"" + dev::toJS( subscriber.first ) + "\"}}";
+                pBatch->m_nBytes += strNotification.size();
+                pBatch->m_notifications.push_back( std::move( strNotification ) );
+                pBatch->m_ids.insert( subscriber.first );
+            }
+        }
+    }
+    return mapBatches;
+}
+
+void SkaleLogsFanOut::deliver( const map_peer_batches_t& batches, size_t nMaxPendingBytes,
+    const fn_pending_bytes_t& fnPendingBytes, const fn_batch_t& fnSend,
+    const fn_batch_t& fnDisconnect ) {
+    for ( const auto& batchEntry : batches ) {
+        const peer_batch_ptr_t& pBatch = batchEntry.second;
+        if ( fnPendingBytes( batchEntry.first ) + pBatch->m_nBytes > nMaxPendingBytes ) {
+            // slow peer would make queues grow without limit, it will re-subscribe if it can
+            cntLogNotificationsDropped_ += pBatch->m_notifications.size();
+            ++cntLogPeersDisconnected_;
+            fnDisconnect( batchEntry.first, pBatch );
+            continue;
+        }
+        fnSend( batchEntry.first, pBatch );
+    }
+}
+
+nlohmann::json SkaleLogsFanOut::stats() const {
+    nlohmann::json joStats = nlohmann::json::object();
+    joStats["subscriptions"] = map_log_subscriptions_.size();
+    joStats["filterGroups"] = map_log_groups_.size();
+    joStats["indexedAddresses"] = map_log_groups_by_address_.size();
+    joStats["indexedTopics"] = map_log_groups_by_topic_.size();
+    joStats["unindexedGroups"] = set_log_groups_unindexed_.size();
+    joStats["blocks"] = size_t( cntLogBlocks_ );
+    joStats["logs"] = size_t( cntLogsEvaluated_ );
+    joStats["logsSerialized"] = size_t( cntLogsSerialized_ );
+    joStats["notifications"] = size_t( cntLogNotifications_ );
+    joStats["notificationsDropped"] = size_t( cntLogNotificationsDropped_ );
+    joStats["peersDisconnected"] = size_t( cntLogPeersDisconnected_ );
+    return joStats;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+SkaleLogsSubscriptionManager::SkaleLogsSubscriptionManager() : next_log_subscription_( 1 ) {}
+SkaleLogsSubscriptionManager::~SkaleLogsSubscriptionManager() {
+    // wait for jobs already running and let the ones still queued do nothing
+    std::unique_lock< std::shared_mutex > lockAlive( pLogsAlive_->mtx );
+    pLogsAlive_->isAlive = false;
+    lock_type lock( mtx_logs_ );
+    // its callback refers to this manager
+    uninstallAllLogsWatch();
+    map_log_peers_.clear();
+}
+
+void SkaleLogsSubscriptionManager::uninstallAllLogsWatch() {
+    if ( iwAllLogs_ == unsigned( -1 ) )
+        return;
+    unsigned iw = iwAllLogs_;
+    iwAllLogs_ = unsigned( -1 );
+    try {
+        pEthForLogs_->uninstallWatch( iw );
+    } catch ( ... ) {
+    }
+}
+
+bool SkaleLogsSubscriptionManager::subscribeLogs(
+    SkaleLogsSubscriptionManager::subscription_id_t& idSubscription, SkaleWsPeer* pPeer,
+    const dev::eth::LogFilter& filter ) {
+    idSubscription = 0;
+    if ( !pPeer )
+        return false;
+    if ( !pPeer->isConnected() )
+        return false;
+    lock_type lock( mtx_logs_ );
+    if ( iwAllLogs_ == unsigned( -1 ) ) {
+        pEthForLogs_ = pPeer->ethereum();
+        dev::eth::fnClientWatchHandlerMulti_t fnOnAllLogs;
+        std::shared_ptr< logs_alive_t > pAlive = pLogsAlive_;
+        fnOnAllLogs += [this, pAlive]( unsigned /*iw*/ ) -> void {
+            // client calls this with its watches locked, changes are fetched on other thread
+            skutils::dispatch::async( "logs-rethread", [this, pAlive]() -> void {
+                std::shared_lock< std::shared_mutex > lockAlive( pAlive->mtx );
+                if ( pAlive->isAlive )
+                    onAllLogsChanged();
+            } );
+        };
+        iwAllLogs_ = pEthForLogs_->installWatch( dev::eth::LogFilter(),
+            dev::eth::Reaping::Manual, fnOnAllLogs, true );  // isWS = true
+    }
+    idSubscription =
+        subscription_id_t( next_log_subscription_++ ) & ( ~( SKALED_WS_SUBSCRIPTION_TYPE_MASK ) );
+    logsFanOut_.add( idSubscription, pPeer, filter );
+    map_log_peers_[idSubscription] = pPeer;
+    return true;
+}
+
+bool SkaleLogsSubscriptionManager::unsubscribeLogs(
+    const SkaleLogsSubscriptionManager::subscription_id_t& idSubscription ) {
+    try {
+        lock_type lock( mtx_logs_ );
+        if ( !logsFanOut_.remove( idSubscription ) )
+            return false;
+        map_log_peers_.erase( idSubscription );
+        if ( logsFanOut_.empty() )
+            uninstallAllLogsWatch();
+        return true;
+    } catch ( ... ) {
+        return false;
+    }
+}
+
+void SkaleLogsSubscriptionManager::onAllLogsChanged() {
+    SkaleLogsFanOut::map_peer_batches_t mapBatches;
+    std::map< SkaleLogsFanOut::peer_key_t, skutils::retain_release_ptr< SkaleWsPeer > > mapPeers;
+    {  // block
+        lock_type lock( mtx_logs_ );
+        if ( iwAllLogs_ == unsigned( -1 ) )
+            return;
+        dev::eth::LocalisedLogEntries changes;
+        try {
+            changes = pEthForLogs_->checkWatch( iwAllLogs_ );
+        } catch ( ... ) {
+            return;
+        }
+        mapBatches = logsFanOut_.fanOut( changes );
+        // peers stay alive until their batches are sent even if they unsubscribe meanwhile
+        for ( const auto& peerEntry : map_log_peers_ )
+            if ( mapBatches.count( peerEntry.second.get() ) > 0 )
+                mapPeers[peerEntry.second.get()] = peerEntry.second;
+    }  // block
+    auto fnPeer = [&]( SkaleLogsFanOut::peer_key_t key ) -> SkaleWsPeer* {
+        return mapPeers.at( key ).get_unconst();
+    };
+    auto fnPendingBytes = [&]( SkaleLogsFanOut::peer_key_t key ) -> size_t {
+        SkaleWsPeer* pPeer = fnPeer( key );
+        return pPeer->nPendingLogNotificationBytes_ + pPeer->getPendingBytes();
+    };
+    auto fnDisconnect = [&]( SkaleLogsFanOut::peer_key_t key,
+                            const SkaleLogsFanOut::peer_batch_ptr_t& pBatch ) -> void {
+        SkaleWsPeer* pPeer = fnPeer( key );
+        clog( dev::Verbosity::VerbosityWarning,
+            cc::info( pPeer->getRelay().nfoGetSchemeUC() ) + cc::debug( "/" ) +
+                cc::num10( pPeer->getRelay().serverIndex() ) )
+            << ( pPeer->desc() + " " + cc::warn( "eth_subscription/logs" ) +
+                   cc::error( " peer is disconnected, it did not read " ) +
+                   cc::size10( fnPendingBytes( key ) ) +
+                   cc::error( " bytes of notifications" ) );
+        for ( const subscription_id_t& idSubscription : pBatch->m_ids )
+            unsubscribeLogs( idSubscription );
+        pPeer->async_close( "too many pending log notifications",
+            int( skutils::ws::close_status::try_again_later ) );
+    };
+    auto fnSend = [&]( SkaleLogsFanOut::peer_key_t key,
+                      const SkaleLogsFanOut::peer_batch_ptr_t& pBatch ) -> void {
+        skutils::retain_release_ptr< SkaleWsPeer > pPeerRetained = mapPeers.at( key );
+        SkaleWsPeer* pPeer = pPeerRetained.get_unconst();
+        pPeer->nPendingLogNotificationBytes_ += pBatch->m_nBytes;
+        std::shared_ptr< logs_alive_t > pAlive = pLogsAlive_;
+        skutils::dispatch::async(
+            pPeer->m_strPeerQueueID, [pBatch, pPeerRetained, pAlive, this]() -> void {
+                SkaleWsPeer* pPeer = pPeerRetained.get_unconst();
+                std::shared_lock< std::shared_mutex > lockAlive( pAlive->mtx );
+                if ( !pAlive->isAlive ) {
+                    pPeer->nPendingLogNotificationBytes_ -= pBatch->m_nBytes;
+                    return;
+                }
+                const std::string strSchemeUC = pPeer->getRelay().nfoGetSchemeUC();
+                bool bMessageSentOK = true;
+                for ( const std::string& strNotification : pBatch->m_notifications ) {
+                    if ( bMessageSentOK ) {
+                        if ( getSSO().m_bTraceCalls )
+                            clog( dev::VerbosityInfo,
+                                cc::info( strSchemeUC ) +
+                                    cc::ws_tx_inv( " <<< " + strSchemeUC + "/TX <<< " ) )
+                                << ( pPeer->desc() + cc::ws_tx( " <<< " ) +
+                                       cc::j( strNotification ) );
+                        try {
+                            bMessageSentOK = pPeer->sendMessage( strNotification );
+                        } catch ( ... ) {
+                            bMessageSentOK = false;
+                        }
+                    }
+                    if ( bMessageSentOK ) {
+                        ++logsFanOut_.cntLogNotifications_;
+                        stats::register_stats_answer(
+                            ( std::string( "RPC/" ) + strSchemeUC ).c_str(),
+                            "eth_subscription/logs", strNotification.size() );
+                        stats::register_stats_answer(
+                            "RPC", "eth_subscription/logs", strNotification.size() );
+                    } else {
+                        ++logsFanOut_.cntLogNotificationsDropped_;
+                        stats::register_stats_error(
+                            ( std::string( "RPC/" ) + strSchemeUC ).c_str(),
+                            "eth_subscription/logs" );
+                        stats::register_stats_error( "RPC", "eth_subscription/logs" );
+                    }
+                }
+                pPeer->nPendingLogNotificationBytes_ -= pBatch->m_nBytes;
+                if ( !bMessageSentOK ) {
+                    clog( dev::Verbosity::VerbosityError,
+                        cc::info( strSchemeUC ) + cc::debug( "/" ) +
+                            cc::num10( pPeer->getRelay().serverIndex() ) )
+                        << ( pPeer->desc() + " " + cc::error( "error in " ) +
+                               cc::warn( "eth_subscription/logs" ) +
+                               cc::error( " will unsubscribe because message was not sent" ) );
+                    for ( const subscription_id_t& idSubscription : pBatch->m_ids )
+                        unsubscribeLogs( idSubscription );
+                }
+            } );
+    };
+    logsFanOut_.deliver(
+        mapBatches, maxPendingLogNotificationBytesPerPeer_, fnPendingBytes, fnSend, fnDisconnect );
+}
+
+nlohmann::json SkaleLogsSubscriptionManager::logsSubscriptionStats() {
+    lock_type lock( mtx_logs_ );
+    return logsFanOut_.stats();
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
 SkaleServerConnectionsTrackHelper::SkaleServerConnectionsTrackHelper( SkaleServerOverride& sso )
     : m_sso( sso ) {
     m_sso.connection_counter_inc();
@@ -785,31 +1080,22 @@ void SkaleWsPeer::onMessage( const std::string& msg, skutils::ws::opcv eOpCode )
     }
     //
     // WS-processing-lambda
-    auto fnAsyncMessageHandler = [pThis, jarrRequest, pSO,
-                                     isBatch]() -> void {  // WS-processing-lambda
-        nlohmann::json jarrBatchAnswer;
-        if ( isBatch )
-            jarrBatchAnswer = nlohmann::json::array();
-        for ( const nlohmann::json& joRequest : jarrRequest ) {
-            std::string strRequest = joRequest.dump();
+    auto fnAsyncMessageHandler = [pThis, jarrRequest, pSO, isBatch,
+                                     msg]() -> void {  // WS-processing-lambda
+        // handles one request of message, batch elements run on batch pool workers too
+        auto fnHandleOne = [&]( const nlohmann::json& joRequest, std::string& strResponse ) {
+            // single request is passed to jsoncpp fallback as it arrived, without re-dumping
+            std::string strRequest = isBatch ? joRequest.dump() : msg;
             std::string strMethod =
                 skutils::tools::getFieldSafe< std::string >( joRequest, "method" );
+            const char* strMethodStats = pSO->methodStatsKey( strMethod );
             nlohmann::json joID = joRequest["id"];
             //
-            std::string strPerformanceQueueName =
-                skutils::tools::format( "rpc/%s/%zu/%s", pThis->getRelay().nfoGetSchemeUC().c_str(),
-                    pThis->getRelay().serverIndex(), pThis->desc( false ).c_str() );
-            std::string strPerformanceActionName =
-                skutils::tools::format( "%s task %zu", pThis->getRelay().nfoGetSchemeUC().c_str(),
-                    pThis.get_unconst()->nTaskNumberInPeer_++ );
-            //
-            skutils::stats::time_tracker::element_ptr_t rttElement;
-            rttElement.emplace( "RPC", pThis->getRelay().nfoGetSchemeUC().c_str(),
-                strMethod.c_str(), pThis->getRelay().serverIndex(), -1 );
+            skutils::stats::time_point tpStart = skutils::stats::clock::now();
             size_t nRequestSize = strRequest.size();
             //
-            skutils::task::performance::action a(
-                strPerformanceQueueName, strPerformanceActionName, joRequest );
+            skutils::task::performance::trace_scope trace( skale::server::helper::g_traceCallWS,
+                strMethod, pThis->getRelay().serverIndex(), nRequestSize );
             bool bSkipMethodTrafficTrace =
                 skale::server::helper::isSkipMethodTrafficTrace( strMethod );
             if ( pSO->m_bTraceCalls && ( !bSkipMethodTrafficTrace ) )
@@ -820,33 +1106,31 @@ void SkaleWsPeer::onMessage( const std::string& msg, skutils::ws::opcv eOpCode )
                                         std::to_string( pThis->getRelay().serverIndex() ) +
                                         "/RX >>> " ) +
                            pThis->desc() + cc::ws_rx( " >>> " ) + cc::j( joRequest ) );
-            std::string strResponse;
             bool bPassed = false;
             try {
                 stats::register_stats_message(
                     pThis->getRelay().nfoGetSchemeUC().c_str(), "messages", nRequestSize );
                 stats::register_stats_message(
                     ( std::string( "RPC/" ) + pThis->getRelay().nfoGetSchemeUC() ).c_str(),
-                    joRequest );
-                stats::register_stats_message( "RPC", joRequest );
+                    strMethodStats, nRequestSize );
+                stats::register_stats_message( "RPC", strMethodStats, nRequestSize );
                 if ( !pThis.get_unconst()->handleWebSocketSpecificRequest(
-                         joRequest, strResponse ) ) {
+                         joRequest, strResponse ) &&
+                     !pSO->handleNativeRequest( joRequest, strResponse ) ) {
                     jsonrpc::IClientConnectionHandler* handler = pSO->GetHandler( "/" );
                     if ( handler == nullptr )
                         throw std::runtime_error( "No client connection handler found" );
                     handler->HandleRequest( strRequest, strResponse );
                 }
-                nlohmann::json joResponse = nlohmann::json::parse( strResponse );
                 stats::register_stats_answer(
                     pThis->getRelay().nfoGetSchemeUC().c_str(), "messages", strResponse.size() );
                 stats::register_stats_answer(
                     ( std::string( "RPC/" ) + pThis->getRelay().nfoGetSchemeUC() ).c_str(),
-                    joRequest, joResponse );
-                stats::register_stats_answer( "RPC", joRequest, joResponse );
-                a.set_json_out( joResponse );
+                    strMethodStats, strResponse.size() );
+                stats::register_stats_answer( "RPC", strMethodStats, strResponse.size() );
+                trace.set_arg( 2, strResponse.size() );
                 bPassed = true;
             } catch ( const std::exception& ex ) {
-                rttElement->setError();
                 clog( dev::VerbosityError, cc::info( pThis->getRelay().nfoGetSchemeUC() ) +
                                                cc::debug( "/" ) +
                                                cc::num10( pThis->getRelay().serverIndex() ) )
@@ -864,11 +1148,10 @@ void SkaleWsPeer::onMessage( const std::string& msg, skutils::ws::opcv eOpCode )
                 if ( !strMethod.empty() ) {
                     stats::register_stats_exception(
                         pThis->getRelay().nfoGetSchemeUC().c_str(), "messages" );
-                    stats::register_stats_exception( "RPC", strMethod.c_str() );
+                    stats::register_stats_exception( "RPC", strMethodStats );
                 }
-                a.set_json_err( joErrorResponce );
+                trace.set_arg( 3, 1 );
             } catch ( ... ) {
-                rttElement->setError();
                 const char* e = "unknown exception in SkaleServerOverride";
                 clog( dev::VerbosityError, cc::info( pThis->getRelay().nfoGetSchemeUC() ) +
                                                cc::debug( "/" ) +
@@ -888,9 +1171,9 @@ void SkaleWsPeer::onMessage( const std::string& msg, skutils::ws::opcv eOpCode )
                 if ( !strMethod.empty() ) {
                     stats::register_stats_exception(
                         pThis->getRelay().nfoGetSchemeUC().c_str(), "messages" );
-                    stats::register_stats_exception( "RPC", strMethod.c_str() );
+                    stats::register_stats_exception( "RPC", strMethodStats );
                 }
-                a.set_json_err( joErrorResponce );
+                trace.set_arg( 3, 1 );
             }
             if ( pSO->m_bTraceCalls && ( !bSkipMethodTrafficTrace ) )
                 clog( dev::VerbosityInfo, cc::info( pThis->getRelay().nfoGetSchemeUC() ) +
@@ -900,25 +1183,27 @@ void SkaleWsPeer::onMessage( const std::string& msg, skutils::ws::opcv eOpCode )
                                         std::to_string( pThis->getRelay().serverIndex() ) +
                                         "/TX <<< " ) +
                            pThis->desc() + cc::ws_tx( " <<< " ) + cc::j( strResponse ) );
-            if ( isBatch ) {
-                nlohmann::json joAnswerPart = nlohmann::json::parse( strResponse );
-                jarrBatchAnswer.push_back( joAnswerPart );
-            } else
-                pThis.get_unconst()->sendMessage( skutils::tools::trim_copy( strResponse ) );
             if ( !bPassed )
                 stats::register_stats_answer(
                     pThis->getRelay().nfoGetSchemeUC().c_str(), "messages", strResponse.size() );
-            rttElement->stop();
-            double lfExecutionDuration = rttElement->getDurationInSeconds();  // in seconds
+            double lfExecutionDuration = stats::register_stats_call_time(
+                pThis->getRelay().nfoGetSchemeUC().c_str(), strMethodStats, tpStart );
             if ( lfExecutionDuration >= pSO->lfExecutionDurationMaxForPerformanceWarning_ )
                 pSO->logPerformanceWarning( lfExecutionDuration, -1,
                     pThis->getRelay().nfoGetSchemeUC().c_str(), pThis->getRelay().serverIndex(),
                     pThis->getOrigin().c_str(), strMethod.c_str(), joID );
-        }  // for( const nlohmann::json & joRequest : jarrRequest )
-        if ( isBatch ) {
-            std::string strResponse = jarrBatchAnswer.dump();
+        };
+        if ( !isBatch ) {
+            std::string strResponse;
+            fnHandleOne( jarrRequest[0], strResponse );
             pThis.get_unconst()->sendMessage( skutils::tools::trim_copy( strResponse ) );
+            return;
         }
+        std::vector< std::string > vecResponses( jarrRequest.size() );
+        pSO->executeBatch(
+            jarrRequest, [&]( size_t i ) { fnHandleOne( jarrRequest[i], vecResponses[i] ); } );
+        pThis.get_unconst()->sendMessage(
+            skale::server::helper::composeBatchAnswer( vecResponses ) );
     };  // WS-processing-lambda
     skutils::dispatch::async( pThis->m_strPeerQueueID, fnAsyncMessageHandler );
     // skutils::ws::peer::onMessage( msg, eOpCode );
@@ -973,13 +1258,9 @@ void SkaleWsPeer::uninstallAllWatches() {
     //
     sw = setInstalledWatchesLogs_;
     setInstalledWatchesLogs_.clear();
+    for ( auto iw : sw )
+        pso()->unsubscribeLogs( iw );
     auto pEthereum = ethereum();
-    for ( auto iw : sw ) {
-        try {
-            pEthereum->uninstallWatch( iw );
-        } catch ( ... ) {
-        }
-    }
     //
     sw = setInstalledWatchesNewPendingTransactions_;
     setInstalledWatchesNewPendingTransactions_.clear();
@@ -1008,7 +1289,7 @@ bool SkaleWsPeer::handleRequestWithBinaryAnswer( const nlohmann::json& joRequest
             skutils::tools::getFieldSafe< std::string >( joRequest, "method" );
         std::string s( buffer.begin(), buffer.end() );
         sendMessage( s, skutils::ws::opcv::binary );
-        stats::register_stats_answer( "RPC", strMethodName, buffer.size() );
+        stats::register_stats_answer( "RPC", pSO->methodStatsKey( strMethodName ), buffer.size() );
         return true;
     }
     return false;
@@ -1115,110 +1396,9 @@ void SkaleWsPeer::eth_subscribe_logs(
                 }
             }
         }  // for ( idxParam = 0; idxParam < cntParams; ++idxParam )
-        skutils::retain_release_ptr< SkaleWsPeer > pThis( this );
-        dev::eth::fnClientWatchHandlerMulti_t fnOnSunscriptionEvent;
-        fnOnSunscriptionEvent += [pThis]( unsigned iw ) -> void {
-            skutils::dispatch::async( "logs-rethread", [=]() -> void {
-                skutils::dispatch::async( pThis->m_strPeerQueueID, [pThis, iw]() -> void {
-                    dev::eth::LocalisedLogEntries le = pThis->ethereum()->logs( iw );
-                    nlohmann::json joResult = skale::server::helper::toJsonByBlock( le );
-                    if ( joResult.is_array() ) {
-                        for ( const auto& joRW : joResult ) {
-                            if ( joRW.is_object() && joRW.count( "logs" ) > 0 &&
-                                 joRW.count( "blockHash" ) > 0 &&
-                                 joRW.count( "blockNumber" ) > 0 ) {
-                                std::string strBlockHash = joRW["blockHash"].get< std::string >();
-                                unsigned nBlockNumber = joRW["blockNumber"].get< unsigned >();
-                                const nlohmann::json& joResultLogs = joRW["logs"];
-                                if ( joResultLogs.is_array() ) {
-                                    for ( const auto& joWalk : joResultLogs ) {
-                                        if ( !joWalk.is_object() )
-                                            continue;
-                                        nlohmann::json joLog = joWalk;  // copy
-                                        joLog["blockHash"] = strBlockHash;
-                                        joLog["blockNumber"] = nBlockNumber;
-                                        nlohmann::json joParams = nlohmann::json::object();
-                                        joParams["subscription"] = dev::toJS( iw );
-                                        joParams["result"] = joLog;
-                                        nlohmann::json joNotification = nlohmann::json::object();
-                                        joNotification["jsonrpc"] = "2.0";
-                                        joNotification["method"] = "eth_subscription";
-                                        joNotification["params"] = joParams;
-                                        std::string strNotification = joNotification.dump();
-                                        const SkaleServerOverride* pSO = pThis->pso();
-                                        if ( pSO->m_bTraceCalls )
-                                            clog( dev::VerbosityInfo,
-                                                cc::info( pThis->getRelay().nfoGetSchemeUC() ) +
-                                                    cc::ws_tx_inv(
-                                                        " <<< " +
-                                                        pThis->getRelay().nfoGetSchemeUC() +
-                                                        "/TX <<< " ) )
-                                                << ( pThis->desc() + cc::ws_tx( " <<< " ) +
-                                                       cc::j( strNotification ) );
-                                        // skutils::dispatch::async( pThis->m_strPeerQueueID,
-                                        // [pThis, strNotification]() -> void {
-                                        bool bMessageSentOK = false;
-                                        try {
-                                            bMessageSentOK =
-                                                const_cast< SkaleWsPeer* >( pThis.get() )
-                                                    ->sendMessage( skutils::tools::trim_copy(
-                                                        strNotification ) );
-                                            if ( !bMessageSentOK )
-                                                throw std::runtime_error(
-                                                    "eth_subscription/logs failed to sent "
-                                                    "message" );
-                                            stats::register_stats_answer(
-                                                ( std::string( "RPC/" ) +
-                                                    pThis->getRelay().nfoGetSchemeUC() )
-                                                    .c_str(),
-                                                "eth_subscription/logs", strNotification.size() );
-                                            stats::register_stats_answer( "RPC",
-                                                "eth_subscription/logs", strNotification.size() );
-                                        } catch ( std::exception& ex ) {
-                                            clog( dev::Verbosity::VerbosityError,
-                                                cc::info( pThis->getRelay().nfoGetSchemeUC() ) +
-                                                    cc::debug( "/" ) +
-                                                    cc::num10( pThis->getRelay().serverIndex() ) )
-                                                << ( pThis->desc() + " " +
-                                                       cc::error( "error in " ) +
-                                                       cc::warn( "eth_subscription/logs" ) +
-                                                       cc::error(
-                                                           " will uninstall watcher callback "
-                                                           "because of exception: " ) +
-                                                       cc::warn( ex.what() ) );
-                                        } catch ( ... ) {
-                                            clog( dev::Verbosity::VerbosityError,
-                                                cc::info( pThis->getRelay().nfoGetSchemeUC() ) +
-                                                    cc::debug( "/" ) +
-                                                    cc::num10( pThis->getRelay().serverIndex() ) )
-                                                << ( pThis->desc() + " " +
-                                                       cc::error( "error in " ) +
-                                                       cc::warn( "eth_subscription/logs" ) +
-                                                       cc::error(
-                                                           " will uninstall watcher callback "
-                                                           "because of unknown exception" ) );
-                                        }
-                                        if ( !bMessageSentOK ) {
-                                            stats::register_stats_error(
-                                                ( std::string( "RPC/" ) +
-                                                    pThis->getRelay().nfoGetSchemeUC() )
-                                                    .c_str(),
-                                                "eth_subscription/logs" );
-                                            stats::register_stats_error(
-                                                "RPC", "eth_subscription/logs" );
-                                            pThis->ethereum()->uninstallWatch( iw );
-                                        }
-                                        //    } );
-                                    }  // for ( const auto& joWalk : joResultLogs )
-                                }      // if ( joResultLogs.is_array() )
-                            }
-                        }  // for ( const auto& joRW : joResult )
-                    }      // if ( joResult.is_array() )
-                } );
-            } );
-        };
-        unsigned iw = ethereum()->installWatch(
-            logFilter, dev::eth::Reaping::Automatic, fnOnSunscriptionEvent, true );  // isWS = true
+        SkaleLogsSubscriptionManager::subscription_id_t iw = 0;
+        if ( !pSO->subscribeLogs( iw, this, logFilter ) )
+            throw std::runtime_error( "failed to subscribe" );
         setInstalledWatchesLogs_.insert( iw );
         std::string strIW = dev::toJS( iw );
         if ( pSO->m_bTraceCalls )
@@ -1226,7 +1406,7 @@ void SkaleWsPeer::eth_subscribe_logs(
                                                       cc::debug( "/" ) +
                                                       cc::num10( getRelay().serverIndex() ) )
                 << ( desc() + " " + cc::info( "eth_subscribe/logs" ) +
-                       cc::debug( " rpc method did installed watch " ) + cc::info( strIW ) );
+                       cc::debug( " rpc method did subscribe " ) + cc::info( strIW ) );
         joResponse["result"] = strIW;
     } catch ( const std::exception& ex ) {
         if ( pSO->m_bTraceCalls )
@@ -1664,7 +1844,7 @@ void SkaleWsPeer::eth_unsubscribe( const nlohmann::json& joRequest, nlohmann::js
                 joResponse["error"] = joError;
                 return;
             }
-            ethereum()->uninstallWatch( iw );
+            pSO->unsubscribeLogs( iw );
             setInstalledWatchesLogs_.erase( iw );
         }
     }  // for ( idxParam = 0; idxParam < cntParams; ++idxParam )
@@ -1852,14 +2032,8 @@ SkaleRelayHTTP::~SkaleRelayHTTP() {
 }
 
 bool SkaleRelayHTTP::handleHttpSpecificRequest(
-    const std::string& strOrigin, const std::string& strRequest, std::string& strResponse ) {
+    const std::string& strOrigin, const nlohmann::json& joRequest, std::string& strResponse ) {
     strResponse.clear();
-    nlohmann::json joRequest;
-    try {
-        joRequest = nlohmann::json::parse( strRequest );
-    } catch ( ... ) {
-        return false;
-    }
     nlohmann::json joResponse = nlohmann::json::object();
     joResponse["jsonrpc"] = "2.0";
     if ( joRequest.count( "id" ) > 0 )
@@ -2110,6 +2284,8 @@ bool SkaleServerOverride::implStartListening( std::shared_ptr< SkaleRelayHTTP >&
         else
             pSrv.reset( new SkaleRelayHTTP( pSO, ipVer, strAddr.c_str(), nPort, nullptr, nullptr,
                 nServerIndex, a_max_http_handler_queues, is_async_http_transfer_mode ) );
+        if ( !bIsSSL )
+            pSrv->m_pServer->epoll_io_threads_ = http_epoll_io_threads_;
         pSrv->m_pServer->Options(
             "/", [=]( const skutils::http::request& req, skutils::http::response& res ) {
                 stats::register_stats_message(
@@ -2127,6 +2303,21 @@ bool SkaleServerOverride::implStartListening( std::shared_ptr< SkaleRelayHTTP >&
                 stats::register_stats_answer(
                     bIsSSL ? "HTTPS" : "HTTP", "query options", res.body_.size() );
             } );
+        pSrv->m_pServer->Get(
+            "/snapshot", [=]( const skutils::http::request& req, skutils::http::response& res ) {
+                stats::register_stats_message( bIsSSL ? "HTTPS" : "HTTP", "GET", 0 );
+                if ( !handleAdminOriginFilter( "skale_downloadSnapshotFragment", req.origin_ ) ) {
+                    res.status_ = 403;
+                    return;
+                }
+                if ( !fn_snapshot_range_serve_ ) {
+                    res.status_ = 404;
+                    return;
+                }
+                fn_snapshot_range_serve_( req, res );
+                stats::register_stats_answer(
+                    bIsSSL ? "HTTPS" : "HTTP", "GET", res.file_.length_ );
+            } );
         pSrv->m_pServer->Post( "/", [=]( const skutils::http::request& req,
                                         skutils::http::response& res ) {
             if ( isShutdownMode() ) {
@@ -2185,9 +2376,10 @@ bool SkaleServerOverride::implStartListening( std::shared_ptr< SkaleRelayHTTP >&
                 joErrorResponce["result"] = "error";
                 joErrorResponce["error"] = std::string( e );
                 std::string strResponse = joErrorResponce.dump();
+                const char* strMethodStats = methodStatsKey( strMethod );
                 stats::register_stats_exception( bIsSSL ? "HTTPS" : "HTTP", "POST" );
-                stats::register_stats_exception( bIsSSL ? "HTTPS" : "HTTP", strMethod.c_str() );
-                stats::register_stats_exception( "RPC", strMethod.c_str() );
+                stats::register_stats_exception( bIsSSL ? "HTTPS" : "HTTP", strMethodStats );
+                stats::register_stats_exception( "RPC", strMethodStats );
                 res.set_header( "access-control-allow-origin", "*" );
                 res.set_header( "vary", "Origin" );
                 res.set_content( strResponse.c_str(), "application/json" );
@@ -2195,29 +2387,30 @@ bool SkaleServerOverride::implStartListening( std::shared_ptr< SkaleRelayHTTP >&
                 return true;
             }
             //
-            nlohmann::json jarrBatchAnswer;
-            if ( isBatch )
-                jarrBatchAnswer = nlohmann::json::array();
-            for ( const nlohmann::json& joRequest : jarrRequest ) {
-                std::string strBody = joRequest.dump();  // = req.body_;
-                std::string strPerformanceQueueName = skutils::tools::format(
-                    "rpc/%s/%zu", bIsSSL ? "HTTPS" : "HTTP", pSrv->serverIndex() );
-                std::string strPerformanceActionName = skutils::tools::format( "%s task %zu, %s",
-                    bIsSSL ? "HTTPS" : "HTTP", nTaskNumberCall_++, strMethod.c_str() );
-                skutils::task::performance::action a(
-                    strPerformanceQueueName, strPerformanceActionName, joRequest );
+            // handles one request, batch elements run on batch pool workers too; binary answers
+            // are given to single requests only, they are stored into pBuffer and false is returned
+            auto fnHandleOne = [&]( const nlohmann::json& joRequest, std::string& strResponse,
+                                   std::vector< uint8_t >* pBuffer ) -> bool {
+                std::string strMethod =
+                    skutils::tools::getFieldSafe< std::string >( joRequest, "method" );
+                const char* strMethodStats = methodStatsKey( strMethod );
+                nlohmann::json joID = joRequest["id"];
+                // single request is passed to jsoncpp fallback as it arrived, without re-dumping
+                std::string strBody = isBatch ? joRequest.dump() : req.body_;
+                const skutils::task::performance::trace_point& tracePoint =
+                    bIsSSL ? skale::server::helper::g_traceCallHTTPS :
+                             skale::server::helper::g_traceCallHTTP;
+                skutils::task::performance::trace_scope trace(
+                    tracePoint, strMethod, pSrv->serverIndex(), strBody.size() );
                 //
-                skutils::stats::time_tracker::element_ptr_t rttElement;
-                rttElement.emplace( "RPC", bIsSSL ? "HTTPS" : "HTTP", strMethod.c_str(),
-                    pSrv->serverIndex(), ipVer );
+                skutils::stats::time_point tpStart = skutils::stats::clock::now();
                 //
                 bool bSkipMethodTrafficTrace =
                     skale::server::helper::isSkipMethodTrafficTrace( strMethod );
                 SkaleServerConnectionsTrackHelper sscth( *this );
                 if ( m_bTraceCalls && ( !bSkipMethodTrafficTrace ) )
                     logTraceServerTraffic( true, false, ipVer, bIsSSL ? "HTTPS" : "HTTP",
-                        pSrv->serverIndex(), req.origin_.c_str(), cc::j( strBody ) );
-                std::string strResponse;
+                        pSrv->serverIndex(), req.origin_.c_str(), cc::j( joRequest ) );
                 bool bPassed = false;
                 try {
                     if ( is_connection_limit_overflow() ) {
@@ -2225,7 +2418,6 @@ bool SkaleServerOverride::implStartListening( std::shared_ptr< SkaleRelayHTTP >&
                             ipVer, bIsSSL ? "HTTPS" : "HTTP", pSrv->serverIndex(), nPort );
                         throw std::runtime_error( "server too busy" );
                     }
-                    strMethod = skutils::tools::getFieldSafe< std::string >( joRequest, "method" );
                     if ( !handleAdminOriginFilter( strMethod, req.origin_ ) ) {
                         throw std::runtime_error( "origin not allowed for call attempt" );
                     }
@@ -2237,36 +2429,38 @@ bool SkaleServerOverride::implStartListening( std::shared_ptr< SkaleRelayHTTP >&
                         bIsSSL ? "HTTPS" : "HTTP", "POST", strBody.size() );
                     stats::register_stats_message(
                         ( std::string( "RPC/" ) + ( bIsSSL ? "HTTPS" : "HTTP" ) ).c_str(),
-                        joRequest );
-                    stats::register_stats_message( "RPC", joRequest );
+                        strMethodStats, strBody.size() );
+                    stats::register_stats_message( "RPC", strMethodStats, strBody.size() );
                     //
-                    std::vector< uint8_t > buffer;
-                    if ( handleRequestWithBinaryAnswer( joRequest, buffer ) ) {
-                        res.set_header( "access-control-allow-origin", "*" );
-                        res.set_header( "vary", "Origin" );
-                        res.set_content(
-                            ( char* ) buffer.data(), buffer.size(), "application/octet-stream" );
+                    if ( pBuffer && handleRequestWithFileAnswer( joRequest, req, res ) ) {
+                        stats::register_stats_answer(
+                            bIsSSL ? "HTTPS" : "HTTP", "POST", res.file_.length_ );
+                        stats::register_stats_call_time(
+                            bIsSSL ? "HTTPS" : "HTTP", strMethodStats, tpStart );
+                        return false;
+                    }
+                    if ( pBuffer && handleRequestWithBinaryAnswer( joRequest, *pBuffer ) ) {
                         stats::register_stats_answer(
-                            bIsSSL ? "HTTPS" : "HTTP", "POST", buffer.size() );
-                        rttElement->stop();
-                        return true;
+                            bIsSSL ? "HTTPS" : "HTTP", "POST", pBuffer->size() );
+                        stats::register_stats_call_time(
+                            bIsSSL ? "HTTPS" : "HTTP", strMethodStats, tpStart );
+                        return false;
                     }
-                    if ( !pSrv->handleHttpSpecificRequest( req.origin_, strBody, strResponse ) ) {
+                    if ( !handleNativeRequest( joRequest, strResponse ) &&
+                         !pSrv->handleHttpSpecificRequest( req.origin_, joRequest, strResponse ) ) {
                         handler->HandleRequest( strBody.c_str(), strResponse );
                     }
                     //
                     stats::register_stats_answer(
                         bIsSSL ? "HTTPS" : "HTTP", "POST", strResponse.size() );
-                    nlohmann::json joResponse = nlohmann::json::parse( strResponse );
                     stats::register_stats_answer(
                         ( std::string( "RPC/" ) + ( bIsSSL ? "HTTPS" : "HTTP" ) ).c_str(),
-                        joRequest, joResponse );
-                    stats::register_stats_answer( "RPC", joRequest, joResponse );
+                        strMethodStats, strResponse.size() );
+                    stats::register_stats_answer( "RPC", strMethodStats, strResponse.size() );
                     //
-                    a.set_json_out( joResponse );
+                    trace.set_arg( 2, strResponse.size() );
                     bPassed = true;
                 } catch ( const std::exception& ex ) {
-                    rttElement->setError();
                     logTraceServerTraffic( false, true, ipVer, bIsSSL ? "HTTPS" : "HTTP",
                         pSrv->serverIndex(), req.origin_.c_str(), cc::warn( ex.what() ) );
                     nlohmann::json joErrorResponce;
@@ -2277,12 +2471,11 @@ bool SkaleServerOverride::implStartListening( std::shared_ptr< SkaleRelayHTTP >&
                     stats::register_stats_exception( bIsSSL ? "HTTPS" : "HTTP", "POST" );
                     if ( !strMethod.empty() ) {
                         stats::register_stats_exception(
-                            bIsSSL ? "HTTPS" : "HTTP", strMethod.c_str() );
-                        stats::register_stats_exception( "RPC", strMethod.c_str() );
+                            bIsSSL ? "HTTPS" : "HTTP", strMethodStats );
+                        stats::register_stats_exception( "RPC", strMethodStats );
                     }
-                    a.set_json_err( joErrorResponce );
+                    trace.set_arg( 3, 1 );
                 } catch ( ... ) {
-                    rttElement->setError();
                     const char* e = "unknown exception in SkaleServerOverride";
                     logTraceServerTraffic( false, true, ipVer, bIsSSL ? "HTTPS" : "HTTP",
                         pSrv->serverIndex(), req.origin_.c_str(), cc::warn( e ) );
@@ -2294,38 +2487,43 @@ bool SkaleServerOverride::implStartListening( std::shared_ptr< SkaleRelayHTTP >&
                     stats::register_stats_exception( bIsSSL ? "HTTPS" : "HTTP", "POST" );
                     if ( !strMethod.empty() ) {
                         stats::register_stats_exception(
-                            bIsSSL ? "HTTPS" : "HTTP", strMethod.c_str() );
-                        stats::register_stats_exception( "RPC", strMethod.c_str() );
+                            bIsSSL ? "HTTPS" : "HTTP", strMethodStats );
+                        stats::register_stats_exception( "RPC", strMethodStats );
                     }
-                    a.set_json_err( joErrorResponce );
+                    trace.set_arg( 3, 1 );
                 }
                 if ( m_bTraceCalls && ( !bSkipMethodTrafficTrace ) )
                     logTraceServerTraffic( false, false, ipVer, bIsSSL ? "HTTPS" : "HTTP",
                         pSrv->serverIndex(), req.origin_.c_str(), cc::j( strResponse ) );
-                if ( isBatch ) {
-                    nlohmann::json joAnswerPart = nlohmann::json::parse( strResponse );
-                    jarrBatchAnswer.push_back( joAnswerPart );
-                } else {
-                    res.set_header( "access-control-allow-origin", "*" );
-                    res.set_header( "vary", "Origin" );
-                    res.set_content( strResponse.c_str(), "application/json" );
-                }
                 if ( !bPassed )
                     stats::register_stats_answer(
-                        bIsSSL ? "HTTPS" : "HTTP", "POST", res.body_.size() );
-                rttElement->stop();
-                double lfExecutionDuration = rttElement->getDurationInSeconds();  // in seconds
+                        bIsSSL ? "HTTPS" : "HTTP", "POST", strResponse.size() );
+                double lfExecutionDuration = stats::register_stats_call_time(
+                    bIsSSL ? "HTTPS" : "HTTP", strMethodStats, tpStart );
                 if ( lfExecutionDuration >= pSO->lfExecutionDurationMaxForPerformanceWarning_ )
                     pSO->logPerformanceWarning( lfExecutionDuration, ipVer,
                         bIsSSL ? "HTTPS" : "HTTP", pSrv->serverIndex(), req.origin_.c_str(),
                         strMethod.c_str(), joID );
-            }  // for( const nlohmann::json & joRequest : jarrRequest )
-            if ( isBatch ) {
-                std::string strResponse = jarrBatchAnswer.dump();
-                res.set_header( "access-control-allow-origin", "*" );
-                res.set_header( "vary", "Origin" );
-                res.set_content( strResponse.c_str(), "application/json" );
+                return true;
+            };
+            res.set_header( "access-control-allow-origin", "*" );
+            res.set_header( "vary", "Origin" );
+            if ( !isBatch ) {
+                std::string strResponse;
+                std::vector< uint8_t > buffer;
+                if ( fnHandleOne( jarrRequest[0], strResponse, &buffer ) )
+                    res.set_content( strResponse.c_str(), "application/json" );
+                else if ( res.file_.fd_ < 0 )
+                    res.set_content(
+                        ( char* ) buffer.data(), buffer.size(), "application/octet-stream" );
+                return true;
             }
+            std::vector< std::string > vecResponses( jarrRequest.size() );
+            executeBatch( jarrRequest, [&]( size_t i ) {
+                fnHandleOne( jarrRequest[i], vecResponses[i], nullptr );
+            } );
+            res.set_content( skale::server::helper::composeBatchAnswer( vecResponses ).c_str(),
+                "application/json" );
             return true;
         } );
         // check if somebody is already listening
@@ -2694,26 +2892,24 @@ nlohmann::json SkaleServerOverride::provideSkaleStats() {  // abstract from
                                                            // dev::rpc::SkaleStatsProviderImpl
     nlohmann::json joStats = nlohmann::json::object();
     nlohmann::json joExecutionPerformance = nlohmann::json::object();
-    joExecutionPerformance["RPC"] =
-        skutils::stats::time_tracker::queue::getQueueForSubsystem( "RPC" ).getAllStats();
+    joExecutionPerformance["RPC"] = stats::generate_execution_performance();
     joStats["executionPerformance"] = joExecutionPerformance;
     joStats["protocols"]["http"]["listenerCount"] = m_serversHTTP4.size() + m_serversHTTP6.size();
     joStats["protocols"]["https"]["listenerCount"] =
         m_serversHTTPS4.size() + m_serversHTTPS6.size();
     joStats["protocols"]["wss"]["listenerCount"] = m_serversWSS4.size() + m_serversWSS6.size();
-    {  // block for subsystem stats using optimized locking only once
-        stats::lock_type_stats lock( stats::g_mtx_stats );
-        joStats["protocols"]["http"]["stats"] = stats::generate_subsystem_stats( "HTTP" );
-        joStats["protocols"]["http"]["rpc"] = stats::generate_subsystem_stats( "RPC/HTTP" );
-        joStats["protocols"]["https"]["stats"] = stats::generate_subsystem_stats( "HTTPS" );
-        joStats["protocols"]["https"]["rpc"] = stats::generate_subsystem_stats( "RPC/HTTPS" );
-        joStats["protocols"]["ws"]["listenerCount"] = m_serversWS4.size() + m_serversWS6.size();
-        joStats["protocols"]["ws"]["stats"] = stats::generate_subsystem_stats( "WS" );
-        joStats["protocols"]["ws"]["rpc"] = stats::generate_subsystem_stats( "RPC/WS" );
-        joStats["protocols"]["wss"]["stats"] = stats::generate_subsystem_stats( "WSS" );
-        joStats["protocols"]["wss"]["rpc"] = stats::generate_subsystem_stats( "RPC/WSS" );
-        joStats["rpc"] = stats::generate_subsystem_stats( "RPC" );
-    }  // block for subsystem stats using optimized locking only once
+    joStats["protocols"]["http"]["stats"] = stats::generate_subsystem_stats( "HTTP" );
+    joStats["protocols"]["http"]["rpc"] = stats::generate_subsystem_stats( "RPC/HTTP" );
+    joStats["protocols"]["https"]["stats"] = stats::generate_subsystem_stats( "HTTPS" );
+    joStats["protocols"]["https"]["rpc"] = stats::generate_subsystem_stats( "RPC/HTTPS" );
+    joStats["protocols"]["ws"]["listenerCount"] = m_serversWS4.size() + m_serversWS6.size();
+    joStats["protocols"]["ws"]["stats"] = stats::generate_subsystem_stats( "WS" );
+    joStats["protocols"]["ws"]["rpc"] = stats::generate_subsystem_stats( "RPC/WS" );
+    joStats["protocols"]["wss"]["stats"] = stats::generate_subsystem_stats( "WSS" );
+    joStats["protocols"]["wss"]["rpc"] = stats::generate_subsystem_stats( "RPC/WSS" );
+    joStats["rpc"] = stats::generate_subsystem_stats( "RPC" );
+    joStats["batches"] = batchStats();
+    joStats["logsSubscriptions"] = logsSubscriptionStats();
     //
     skutils::tools::load_monitor& lm = stat_get_load_monitor();
     double lfCpuLoad = lm.last_cpu_load();
@@ -2724,6 +2920,118 @@ nlohmann::json SkaleServerOverride::provideSkaleStats() {  // abstract from
     return joStats;
 }
 
+uint64_t SkaleServerOverride::executeBatchParallel(
+    size_t nFirst, size_t nEnd, const std::function< void( size_t ) >& fnItem ) {
+    // shared with pool workers which may start after whole batch is done, such ones
+    // must not touch fnItem and anything else from caller's stack
+    struct batch_state {
+        std::function< void( size_t ) > fnItem;
+        size_t nEnd = 0;
+        size_t cntItems = 0;
+        std::atomic_size_t nextItem{0};
+        std::atomic< uint64_t > nCpuNs{0};
+        std::mutex mtx;
+        std::condition_variable cv;
+        size_t cntDone = 0;
+    };
+    auto pState = std::make_shared< batch_state >();
+    pState->fnItem = fnItem;
+    pState->nEnd = nEnd;
+    pState->cntItems = nEnd - nFirst;
+    pState->nextItem = nFirst;
+    auto fnWork = [pState]() {
+        uint64_t nCpuNs = 0;
+        size_t cntDone = 0;
+        for ( size_t i = pState->nextItem++; i < pState->nEnd; i = pState->nextItem++ ) {
+            uint64_t nStartNs = skale::server::helper::thread_cpu_time_ns();
+            try {
+                pState->fnItem( i );
+            } catch ( ... ) {
+            }
+            nCpuNs += skale::server::helper::thread_cpu_time_ns() - nStartNs;
+            ++cntDone;
+        }
+        if ( cntDone == 0 )
+            return;
+        pState->nCpuNs += nCpuNs;
+        std::lock_guard< std::mutex > lock( pState->mtx );
+        pState->cntDone += cntDone;
+        if ( pState->cntDone == pState->cntItems )
+            pState->cv.notify_all();
+    };
+    // calling thread always works on its own batch, so batch completes even if pool is busy
+    size_t cntParallel =
+        std::min( std::max< size_t >( maxParallelInBatchJsonRpcRequest_, 1 ), pState->cntItems );
+    if ( cntParallel > 1 ) {
+        std::call_once( m_onceBatchPool, [this]() {
+            m_pBatchPool.reset( new skutils::thread_pool(
+                std::max< size_t >( std::thread::hardware_concurrency(), 2 ) ) );
+        } );
+        for ( size_t i = 1; i < cntParallel; ++i )
+            m_pBatchPool->safe_submit_without_future( fnWork );
+    }
+    fnWork();
+    {
+        std::unique_lock< std::mutex > lock( pState->mtx );
+        pState->cv.wait( lock, [&]() { return pState->cntDone == pState->cntItems; } );
+    }
+    return pState->nCpuNs;
+}
+
+void SkaleServerOverride::executeBatch(
+    const nlohmann::json& jarrRequest, const std::function< void( size_t ) >& fnItem ) {
+    auto tpStart = std::chrono::steady_clock::now();
+    size_t cntItems = jarrRequest.size();
+    uint64_t nCpuNs = 0;
+    // runs of read-only elements go in parallel, any other element waits for everything before
+    // it and runs alone, so the batch behaves as if executed in order
+    for ( size_t i = 0; i < cntItems; ) {
+        size_t nEnd = i;
+        while ( nEnd < cntItems &&
+                skale::server::helper::isParallelSafeBatchItem( jarrRequest[nEnd] ) )
+            ++nEnd;
+        if ( nEnd - i > 1 ) {
+            nCpuNs += executeBatchParallel( i, nEnd, fnItem );
+            i = nEnd;
+            continue;
+        }
+        uint64_t nStartNs = skale::server::helper::thread_cpu_time_ns();
+        try {
+            fnItem( i );
+        } catch ( ... ) {
+        }
+        nCpuNs += skale::server::helper::thread_cpu_time_ns() - nStartNs;
+        ++i;
+    }
+    uint64_t nWallNs = std::chrono::duration_cast< std::chrono::nanoseconds >(
+        std::chrono::steady_clock::now() - tpStart )
+                           .count();
+    ++m_cntBatches;
+    m_cntBatchItems += cntItems;
+    size_t nSizeMax = m_nBatchSizeMax;
+    while ( cntItems > nSizeMax && !m_nBatchSizeMax.compare_exchange_weak( nSizeMax, cntItems ) ) {
+    }
+    m_nBatchWallClockNs += nWallNs;
+    m_nBatchCpuNs += nCpuNs;
+}
+
+nlohmann::json SkaleServerOverride::batchStats() const {
+    nlohmann::json joBatches = nlohmann::json::object();
+    size_t cntBatches = m_cntBatches;
+    uint64_t nWallNs = m_nBatchWallClockNs, nCpuNs = m_nBatchCpuNs;
+    joBatches["count"] = cntBatches;
+    joBatches["items"] = size_t( m_cntBatchItems );
+    joBatches["maxSize"] = size_t( m_nBatchSizeMax );
+    joBatches["averageSize"] = cntBatches ? double( m_cntBatchItems ) / cntBatches : 0.0;
+    joBatches["wallClockMs"] = nWallNs / 1000000.0;
+    joBatches["cpuMs"] = nCpuNs / 1000000.0;
+    // how many items ran at once on average, CPU time spent per wall-clock time
+    joBatches["parallelism"] = nWallNs ? double( nCpuNs ) / nWallNs : 0.0;
+    joBatches["maxParallel"] = maxParallelInBatchJsonRpcRequest_;
+    joBatches["workerThreads"] = m_pBatchPool ? m_pBatchPool->number_of_threads() : 0;
+    return joBatches;
+}
+
 bool SkaleServerOverride::handleRequestWithBinaryAnswer(
     const nlohmann::json& joRequest, std::vector< uint8_t >& buffer ) {
     buffer.clear();
@@ -2745,6 +3053,38 @@ bool SkaleServerOverride::handleRequestWithBinaryAnswer(
     return false;
 }
 
+bool SkaleServerOverride::handleRequestWithFileAnswer( const nlohmann::json& joRequest,
+    const skutils::http::request& req, skutils::http::response& res ) {
+    if ( !fn_snapshot_fragment_serve_ )
+        return false;
+    std::string strMethodName = skutils::tools::getFieldSafe< std::string >( joRequest, "method" );
+    if ( strMethodName != "skale_downloadSnapshotFragment" )
+        return false;
+    const nlohmann::json& joParams = joRequest["params"];
+    if ( joParams.count( "isBinary" ) == 0 || !joParams["isBinary"].get< bool >() )
+        return false;
+    return fn_snapshot_fragment_serve_( req, joParams, res );
+}
+
+void SkaleServerOverride::setSnapshotFileServing(
+    fn_snapshot_fragment_serve_t fnFragment, fn_snapshot_range_serve_t fnRange ) {
+    fn_snapshot_fragment_serve_ = fnFragment;
+    fn_snapshot_range_serve_ = fnRange;
+}
+
+void SkaleServerOverride::setKnownMethods( fn_is_known_method_t fnIsKnownMethod ) {
+    fn_is_known_method_ = fnIsKnownMethod;
+}
+
+const char* SkaleServerOverride::methodStatsKey( const std::string& strMethod ) const {
+    if ( g_protocol_rpc_map.count( strMethod ) > 0 || g_native_rpc_map.count( strMethod ) > 0 ||
+         SkaleWsPeer::g_ws_rpc_map.count( strMethod ) > 0 ||
+         SkaleRelayHTTP::g_http_rpc_map.count( strMethod ) > 0 ||
+         ( fn_is_known_method_ && fn_is_known_method_( strMethod ) ) )
+        return strMethod.c_str();
+    return skutils::stats::time_tracker::element::g_strMethodNameUnknown;
+}
+
 bool SkaleServerOverride::handleAdminOriginFilter(
     const std::string& strMethod, const std::string& strOriginURL ) {
     // std::cout << cc::attention( "------------ " ) << cc::info( strOriginURL ) <<
@@ -2785,6 +3125,129 @@ const SkaleServerOverride::protocol_rpc_map_t SkaleServerOverride::g_protocol_rp
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+bool SkaleServerOverride::handleNativeRequest(
+    const nlohmann::json& joRequest, std::string& strResponse ) {
+    if ( !joRequest.is_object() )
+        return false;
+    nlohmann::json::const_iterator itMethod = joRequest.find( "method" );
+    if ( itMethod == joRequest.end() || !itMethod->is_string() )
+        return false;
+    native_rpc_map_t::const_iterator itFind =
+        g_native_rpc_map.find( itMethod->get_ref< const std::string& >() );
+    if ( itFind == g_native_rpc_map.end() )
+        return false;
+    // everything jsoncpp would reject or treat specially goes the slow way
+    nlohmann::json::const_iterator itVersion = joRequest.find( "jsonrpc" );
+    if ( itVersion == joRequest.end() || ( *itVersion ) != "2.0" )
+        return false;
+    nlohmann::json::const_iterator itID = joRequest.find( "id" );
+    if ( itID == joRequest.end() || !( itID->is_number_integer() || itID->is_string() ) )
+        return false;
+    nlohmann::json::const_iterator itParams = joRequest.find( "params" );
+    if ( itParams == joRequest.end() || !itParams->is_array() )
+        return false;
+    for ( const nlohmann::json& joParam : *itParams ) {
+        if ( !joParam.is_string() )
+            return false;
+    }
+    std::string strResult;
+    try {
+        if ( !( ( *this ).*( itFind->second ) )( *itParams, strResult ) )
+            return false;
+    } catch ( ... ) {
+        // covered methods have no side effects, so jsoncpp can repeat call and report error
+        return false;
+    }
+    // stream answer exactly as jsoncpp writes it, keys are sorted
+    strResponse.clear();
+    strResponse.reserve( strResult.size() + 64 );
+    strResponse += "{\"id\":";
+    strResponse += itID->dump();
+    strResponse += ",\"jsonrpc\":\"2.0\",\"result\":";
+    strResponse += strResult;
+    strResponse += '}';
+    return true;
+}
+
+const SkaleServerOverride::native_rpc_map_t SkaleServerOverride::g_native_rpc_map = {
+    {"eth_blockNumber", &SkaleServerOverride::eth_blockNumber},
+    {"eth_chainId", &SkaleServerOverride::eth_chainId},
+    {"eth_gasPrice", &SkaleServerOverride::eth_gasPrice},
+    {"eth_getBalance", &SkaleServerOverride::eth_getBalance},
+    {"eth_getTransactionCount", &SkaleServerOverride::eth_getTransactionCount},
+    {"eth_getCode", &SkaleServerOverride::eth_getCode},
+    {"eth_getStorageAt", &SkaleServerOverride::eth_getStorageAt},
+};
+
+// results below are hex strings, they never need escaping
+static std::string native_hex_result( const std::string& strHex ) {
+    return "\"" + strHex + "\"";
+}
+
+// block number parameters are ignored in the same way as rpc::Eth does it (SKALE-430)
+
+bool SkaleServerOverride::eth_blockNumber(
+    const nlohmann::json& jarrParams, std::string& strResult ) {
+    if ( !jarrParams.empty() )
+        return false;
+    strResult = native_hex_result( dev::toJS( ethereum()->number() ) );
+    return true;
+}
+
+bool SkaleServerOverride::eth_chainId( const nlohmann::json& jarrParams, std::string& strResult ) {
+    if ( !jarrParams.empty() )
+        return false;
+    strResult = native_hex_result( dev::toJS( ethereum()->chainId() ) );
+    return true;
+}
+
+bool SkaleServerOverride::eth_gasPrice( const nlohmann::json& jarrParams, std::string& strResult ) {
+    if ( !jarrParams.empty() )
+        return false;
+    strResult = native_hex_result( dev::toJS( ethereum()->gasBidPrice() ) );
+    return true;
+}
+
+bool SkaleServerOverride::eth_getBalance(
+    const nlohmann::json& jarrParams, std::string& strResult ) {
+    if ( jarrParams.size() != 2 )
+        return false;
+    dev::Address address = dev::jsToAddress( jarrParams[0].get_ref< const std::string& >() );
+    strResult = native_hex_result( dev::toJS( ethereum()->balanceAt( address ) ) );
+    return true;
+}
+
+bool SkaleServerOverride::eth_getTransactionCount(
+    const nlohmann::json& jarrParams, std::string& strResult ) {
+    if ( jarrParams.size() != 2 )
+        return false;
+    dev::Address address = dev::jsToAddress( jarrParams[0].get_ref< const std::string& >() );
+    strResult = native_hex_result( dev::toJS( ethereum()->countAt( address ) ) );
+    return true;
+}
+
+bool SkaleServerOverride::eth_getCode( const nlohmann::json& jarrParams, std::string& strResult ) {
+    if ( jarrParams.size() != 2 )
+        return false;
+    dev::Address address = dev::jsToAddress( jarrParams[0].get_ref< const std::string& >() );
+    strResult = native_hex_result( dev::toJS( ethereum()->codeAt( address ) ) );
+    return true;
+}
+
+bool SkaleServerOverride::eth_getStorageAt(
+    const nlohmann::json& jarrParams, std::string& strResult ) {
+    if ( jarrParams.size() != 3 )
+        return false;
+    dev::Address address = dev::jsToAddress( jarrParams[0].get_ref< const std::string& >() );
+    dev::u256 position = dev::jsToU256( jarrParams[1].get_ref< const std::string& >() );
+    strResult = native_hex_result(
+        dev::toJS( dev::toCompactBigEndian( ethereum()->stateAt( address, position ), 32 ) ) );
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
 void SkaleServerOverride::setSchainExitTime( SkaleServerHelper& /*sse*/,
     const std::string& strOrigin, const nlohmann::json& joRequest, nlohmann::json& joResponse ) {
     SkaleServerOverride* pSO = this;
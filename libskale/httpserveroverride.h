@@ -48,10 +48,13 @@ typedef intptr_t ssize_t;
 #include <memory>
 #include <mutex>
 #include <set>
+#include <shared_mutex>
 #include <string>
+#include <vector>
 
 #include <skutils/console_colors.h>
 #include <skutils/dispatch.h>
+#include <skutils/thread_pool.h>
 #include <skutils/http.h>
 #include <skutils/stats.h>
 #include <skutils/utils.h>
@@ -66,11 +69,26 @@ typedef intptr_t ssize_t;
 #include <libweb3jsonrpc/SkaleStatsSite.h>
 
 class SkaleStatsSubscriptionManager;
+class SkaleLogsSubscriptionManager;
 struct SkaleServerConnectionsTrackHelper;
 class SkaleWsPeer;
 class SkaleRelayWS;
 class SkaleServerOverride;
 
+namespace skale {
+namespace server {
+namespace helper {
+
+// joins answers to batch elements into JSON array text, keeping their order
+std::string composeBatchAnswer( const std::vector< std::string >& vecResponses );
+
+// true for batch elements calling read-only methods which may run in parallel with each other
+bool isParallelSafeBatchItem( const nlohmann::json& joRequest );
+
+};  // namespace helper
+};  // namespace server
+};  // namespace skale
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
@@ -108,6 +126,111 @@ public:
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+// matching and fan-out of eth_subscribe("logs") notifications, apart from connections: identical
+// filters are grouped, groups are indexed by address or by first constrained topic, so each log
+// is matched once against candidate groups only and its JSON is serialized once for all
+// subscribers of the groups it matches; not thread safe, SkaleLogsSubscriptionManager locks it
+class SkaleLogsFanOut {
+public:
+    typedef unsigned subscription_id_t;
+    typedef const void* peer_key_t;  // identifies connection of subscriber
+
+    // everything one peer receives from one change set
+    struct peer_batch_t {
+        std::vector< std::string > m_notifications;
+        std::set< subscription_id_t > m_ids;
+        size_t m_nBytes = 0;
+    };  /// struct peer_batch_t
+    typedef std::shared_ptr< peer_batch_t > peer_batch_ptr_t;
+    typedef std::map< peer_key_t, peer_batch_ptr_t > map_peer_batches_t;
+
+    typedef std::function< size_t( peer_key_t ) > fn_pending_bytes_t;
+    typedef std::function< void( peer_key_t, const peer_batch_ptr_t& ) > fn_batch_t;
+
+    std::atomic_size_t cntLogBlocks_{0}, cntLogsEvaluated_{0}, cntLogsSerialized_{0},
+        cntLogNotifications_{0}, cntLogNotificationsDropped_{0}, cntLogPeersDisconnected_{0};
+
+    void add( subscription_id_t idSubscription, peer_key_t peer,
+        const dev::eth::LogFilter& filter );
+    bool remove( subscription_id_t idSubscription );
+    bool empty() const { return map_log_subscriptions_.empty(); }
+    size_t groupCount() const { return map_log_groups_.size(); }
+
+    // notifications of mined logs for subscriptions whose filter and block range they match
+    map_peer_batches_t fanOut( const dev::eth::LocalisedLogEntries& changes );
+    // passes each batch to fnSend, or to fnDisconnect if it would make more than
+    // nMaxPendingBytes bytes pending for its peer
+    void deliver( const map_peer_batches_t& batches, size_t nMaxPendingBytes,
+        const fn_pending_bytes_t& fnPendingBytes, const fn_batch_t& fnSend,
+        const fn_batch_t& fnDisconnect );
+
+    nlohmann::json stats() const;
+
+private:
+    typedef std::map< subscription_id_t, peer_key_t > map_subscribers_t;
+    struct log_group_t {
+        dev::eth::LogFilter m_filter;
+        map_subscribers_t m_subscribers;
+    };  /// struct log_group_t
+    typedef std::map< dev::h256, log_group_t > map_log_groups_t;  // filter hash -> group
+    map_log_groups_t map_log_groups_;
+    std::map< subscription_id_t, dev::h256 > map_log_subscriptions_;
+
+    typedef std::set< dev::h256 > set_group_hashes_t;
+    std::map< dev::Address, set_group_hashes_t > map_log_groups_by_address_;
+    std::map< std::pair< unsigned, dev::h256 >, set_group_hashes_t > map_log_groups_by_topic_;
+    set_group_hashes_t set_log_groups_unindexed_;
+
+    void indexLogGroup( const dev::h256& h, const dev::eth::LogFilter& filter, bool isAdd );
+};  // class SkaleLogsFanOut
+
+// one engine serves all eth_subscribe("logs") subscriptions, see SkaleLogsFanOut, with one
+// client watch catching all new logs; peers which do not read fast enough are disconnected
+class SkaleLogsSubscriptionManager {
+public:
+    typedef SkaleLogsFanOut::subscription_id_t subscription_id_t;
+
+protected:
+    typedef skutils::multithreading::recursive_mutex_type mutex_type;
+    typedef std::lock_guard< mutex_type > lock_type;
+    mutex_type mtx_logs_;
+
+    std::atomic< subscription_id_t > next_log_subscription_;
+
+    SkaleLogsFanOut logsFanOut_;
+    // keeps peers alive while subscribed, keys of logsFanOut_ point to them
+    std::map< subscription_id_t, skutils::retain_release_ptr< SkaleWsPeer > > map_log_peers_;
+
+    dev::eth::Interface* pEthForLogs_ = nullptr;
+    unsigned iwAllLogs_ = unsigned( -1 );  // watch catching all logs, installed while needed
+
+    // jobs dispatched to other threads hold it shared and do nothing once manager is destroyed
+    struct logs_alive_t {
+        std::shared_mutex mtx;
+        bool isAlive = true;
+    };  /// struct logs_alive_t
+    std::shared_ptr< logs_alive_t > pLogsAlive_ = std::make_shared< logs_alive_t >();
+
+    void uninstallAllLogsWatch();
+    void onAllLogsChanged();
+
+public:
+    // bytes of log notifications queued for one peer, including not yet sent out by socket,
+    // after which peer is disconnected
+    size_t maxPendingLogNotificationBytesPerPeer_ = 16 * 1024 * 1024;
+
+    SkaleLogsSubscriptionManager();
+    virtual ~SkaleLogsSubscriptionManager();
+    bool subscribeLogs( subscription_id_t& idSubscription, SkaleWsPeer* pPeer,
+        const dev::eth::LogFilter& filter );
+    bool unsubscribeLogs( const subscription_id_t& idSubscription );
+    nlohmann::json logsSubscriptionStats();
+    virtual SkaleServerOverride& getSSO() = 0;
+};  // class SkaleLogsSubscriptionManager
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
 struct SkaleServerConnectionsTrackHelper {
     SkaleServerOverride& m_sso;
     SkaleServerConnectionsTrackHelper( SkaleServerOverride& sso );
@@ -119,7 +242,7 @@ struct SkaleServerConnectionsTrackHelper {
 
 class SkaleWsPeer : public skutils::ws::peer {
 public:
-    std::atomic_size_t nTaskNumberInPeer_ = 0;
+    std::atomic_size_t nPendingLogNotificationBytes_ = 0;  // dispatched to peer queue, not sent
     const std::string m_strPeerQueueID;
     std::unique_ptr< SkaleServerConnectionsTrackHelper > m_pSSCTH;
     SkaleWsPeer( skutils::ws::server& srv, const skutils::ws::hdl_t& hdl );
@@ -173,6 +296,7 @@ protected:
 
 public:
     friend class SkaleRelayWS;
+    friend class SkaleServerOverride;
 };  /// class SkaleWsPeer
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -256,7 +380,7 @@ public:
     SkaleServerOverride* pso() { return m_pSO; }
     const SkaleServerOverride* pso() const { return m_pSO; }
     bool handleHttpSpecificRequest(
-        const std::string& strOrigin, const std::string& strRequest, std::string& strResponse );
+        const std::string& strOrigin, const nlohmann::json& joRequest, std::string& strResponse );
     bool handleHttpSpecificRequest(
         const std::string& strOrigin, const nlohmann::json& joRequest, nlohmann::json& joResponse );
 
@@ -265,6 +389,8 @@ protected:
         const std::string& strOrigin, const nlohmann::json& joRequest, nlohmann::json& joResponse );
     typedef std::map< std::string, rpc_method_t > http_rpc_map_t;
     static const http_rpc_map_t g_http_rpc_map;
+
+    friend class SkaleServerOverride;
 };  /// class SkaleRelayHTTP
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -272,8 +398,8 @@ protected:
 
 class SkaleServerOverride : public jsonrpc::AbstractServerConnector,
                             public SkaleStatsSubscriptionManager,
+                            public SkaleLogsSubscriptionManager,
                             public dev::rpc::SkaleStatsProviderImpl {
-    std::atomic_size_t nTaskNumberCall_ = 9;
     size_t m_cntServers;
     mutable dev::eth::Interface* pEth_;
     dev::eth::ChainParams& chainParams_;
@@ -282,8 +408,23 @@ public:
     typedef std::function< std::vector< uint8_t >( const nlohmann::json& joRequest ) >
         fn_binary_snapshot_download_t;
 
+    // makes res send binary skale_downloadSnapshotFragment answer straight from snapshot file,
+    // returns false if there is no file to send
+    typedef std::function< bool( const skutils::http::request& req,
+        const nlohmann::json& joParams, skutils::http::response& res ) >
+        fn_snapshot_fragment_serve_t;
+    // answers GET /snapshot, whole file or range from "Range" header
+    typedef std::function< void( const skutils::http::request& req,
+        skutils::http::response& res ) >
+        fn_snapshot_range_serve_t;
+    // tells whether handler "/" serves method of given name
+    typedef std::function< bool( const std::string& strMethod ) > fn_is_known_method_t;
+
 private:
     fn_binary_snapshot_download_t fn_binary_snapshot_download_;
+    fn_snapshot_fragment_serve_t fn_snapshot_fragment_serve_;
+    fn_snapshot_range_serve_t fn_snapshot_range_serve_;
+    fn_is_known_method_t fn_is_known_method_;
 
 public:
     const double lfExecutionDurationMaxForPerformanceWarning_;                 // in seconds
@@ -291,6 +432,8 @@ public:
                                                                                // default 1 second
 
     size_t maxCountInBatchJsonRpcRequest_ = 128;
+    // how many elements of one batch may run at once, 1 runs batches sequentially
+    size_t maxParallelInBatchJsonRpcRequest_ = 8;
 
     SkaleServerOverride( dev::eth::ChainParams& chainParams,
         fn_binary_snapshot_download_t fn_binary_snapshot_download, size_t cntServers,
@@ -309,6 +452,14 @@ public:
     dev::eth::ChainParams& chainParams();
     const dev::eth::ChainParams& chainParams() const;
     bool checkAdminOriginAllowed( const std::string& origin ) const;
+    // must be set before listening starts
+    void setSnapshotFileServing(
+        fn_snapshot_fragment_serve_t fnFragment, fn_snapshot_range_serve_t fnRange );
+    // must be set before listening starts
+    void setKnownMethods( fn_is_known_method_t fnIsKnownMethod );
+    // stats are kept per method name, names of methods nobody serves come from clients and
+    // are all counted under one key, so stats do not grow without limit
+    const char* methodStatsKey( const std::string& strMethod ) const;
 
 private:
     bool implStartListening( std::shared_ptr< SkaleRelayHTTP >& pSrv, int ipVer,
@@ -325,6 +476,8 @@ private:
 public:
     size_t max_http_handler_queues_ = __SKUTILS_HTTP_DEFAULT_MAX_PARALLEL_QUEUES_COUNT__;
     bool is_async_http_transfer_mode_ = true;
+    /// I/O threads of epoll reactor serving plain HTTP, zero keeps is_async_http_transfer_mode_
+    size_t http_epoll_io_threads_ = 0;
     virtual bool StartListening() override;
     virtual bool StopListening() override;
 
@@ -372,6 +525,16 @@ private:
     std::atomic_size_t m_cntConnections;
     std::atomic_size_t m_cntConnectionsMax;  // 0 is unlimited
 
+    // workers shared by all batch requests, created on first parallel batch
+    std::unique_ptr< skutils::thread_pool > m_pBatchPool;
+    std::once_flag m_onceBatchPool;
+    std::atomic_size_t m_cntBatches{0}, m_cntBatchItems{0}, m_nBatchSizeMax{0};
+    std::atomic< uint64_t > m_nBatchWallClockNs{0}, m_nBatchCpuNs{0};
+
+    // runs fnItem( i ) for i in [nFirst, nEnd) in parallel, returns their CPU time
+    uint64_t executeBatchParallel(
+        size_t nFirst, size_t nEnd, const std::function< void( size_t ) >& fnItem );
+
 public:
     // status API, returns running server port or -1 if server is not started
     int getServerPortStatusHTTP( int ipVer ) const;
@@ -387,11 +550,22 @@ public:
     virtual void on_connection_overflow_peer_closed(
         int ipVer, const char* strProtocol, int nServerIndex, int nPort );
 
-    SkaleServerOverride& getSSO() override;       // abstract in SkaleStatsSubscriptionManager
+    SkaleServerOverride& getSSO() override;  // abstract in SkaleStatsSubscriptionManager and
+                                             // SkaleLogsSubscriptionManager
     nlohmann::json provideSkaleStats() override;  // abstract from dev::rpc::SkaleStatsProviderImpl
 
     bool handleRequestWithBinaryAnswer(
         const nlohmann::json& joRequest, std::vector< uint8_t >& buffer );
+    // HTTP only, body of res is sent from snapshot file without copying it
+    bool handleRequestWithFileAnswer( const nlohmann::json& joRequest,
+        const skutils::http::request& req, skutils::http::response& res );
+    // runs fnItem( i ) for every element of jarrRequest, returns when all are done; consecutive
+    // read-only elements run on calling thread and at most maxParallelInBatchJsonRpcRequest_ - 1
+    // batch pool workers, other elements run alone in request order
+    void executeBatch(
+        const nlohmann::json& jarrRequest, const std::function< void( size_t ) >& fnItem );
+    // batch count and sizes, wall-clock time of batches versus CPU time summed over elements
+    nlohmann::json batchStats() const;
     bool handleAdminOriginFilter( const std::string& strMethod, const std::string& strOriginURL );
 
     bool isShutdownMode() const { return m_bShutdownMode; }
@@ -408,6 +582,27 @@ protected:
     void setSchainExitTime( SkaleServerHelper& sse, const std::string& strOrigin,
         const nlohmann::json& joRequest, nlohmann::json& joResponse );
 
+public:
+    // native dispatch of hot read-only eth_* calls, bypasses jsoncpp re-parsing and re-writing;
+    // returns false if method is not covered or request is not a plainly valid call, then caller
+    // falls back to jsoncpp handler which also produces all error answers
+    bool handleNativeRequest( const nlohmann::json& joRequest, std::string& strResponse );
+
+protected:
+    // writes JSON text of call result into strResult, returns false to fall back
+    typedef bool ( SkaleServerOverride::*native_rpc_method_t )(
+        const nlohmann::json& jarrParams, std::string& strResult );
+    typedef std::map< std::string, native_rpc_method_t > native_rpc_map_t;
+    static const native_rpc_map_t g_native_rpc_map;
+
+    bool eth_blockNumber( const nlohmann::json& jarrParams, std::string& strResult );
+    bool eth_chainId( const nlohmann::json& jarrParams, std::string& strResult );
+    bool eth_gasPrice( const nlohmann::json& jarrParams, std::string& strResult );
+    bool eth_getBalance( const nlohmann::json& jarrParams, std::string& strResult );
+    bool eth_getTransactionCount( const nlohmann::json& jarrParams, std::string& strResult );
+    bool eth_getCode( const nlohmann::json& jarrParams, std::string& strResult );
+    bool eth_getStorageAt( const nlohmann::json& jarrParams, std::string& strResult );
+
     friend class SkaleRelayWS;
     friend class SkaleWsPeer;
 };  /// class SkaleServerOverride
@@ -64,6 +64,7 @@ typedef int socket_t;
 #include <regex>
 #include <string>
 #include <thread>
+#include <vector>
 
 #include <openssl/err.h>
 #include <openssl/ssl.h>
@@ -94,6 +95,11 @@ typedef int socket_t;
 
 #define __SKUTILS_HTTP_DEFAULT_MAX_PARALLEL_QUEUES_COUNT__ ( 16 )
 
+#define __SKUTILS_HTTP_EPOLL_MAX_EVENTS__ ( 256 )
+#define __SKUTILS_HTTP_EPOLL_MAX_HEADERS_SIZE__ ( 64 * 1024 )
+#define __SKUTILS_HTTP_EPOLL_MAX_CONTENT_SIZE__ ( 256 * 1024 * 1024 )
+#define __SKUTILS_HTTP_EPOLL_WRITE_TIMEOUT_MILLISECONDS__ ( 30 * 1000 )
+
 #define __SKUTILS_HTTP_CLIENT_CONNECT_TIMEOUT_MILLISECONDS__ ( 60 * 1000 )
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -121,6 +127,11 @@ typedef std::multimap< std::string, std::string, detail::ci > map_headers;
 template < typename uint64_t, typename... Args >
 std::pair< std::string, std::string > make_range_header( uint64_t value, Args... args );
 
+// parses single range "Range" header value like "bytes=0-1023", "bytes=1024-" or "bytes=-512"
+// against content of total_size bytes, returns false if it's malformed or not satisfiable
+bool parse_range_header(
+    const std::string& value, uint64_t total_size, uint64_t& offset, uint64_t& length );
+
 typedef std::multimap< std::string, std::string > map_params;
 typedef std::smatch match;
 typedef std::function< bool( uint64_t current, uint64_t total ) > fn_progress;
@@ -139,6 +150,18 @@ typedef std::multimap< std::string, multipart_file > multipart_files;
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+// part of open file sent as response body, socket streams send it without copying through user
+// space
+struct file_range {
+    int fd_ = -1;
+    uint64_t offset_ = 0;
+    uint64_t length_ = 0;
+    std::shared_ptr< void > owner_;  // keeps fd_ open until range is sent
+};  /// struct file_range
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
 struct request {
     std::string origin_;
     std::string version_;
@@ -178,6 +201,7 @@ struct response {
     map_headers headers_;
     std::string body_;
     std::function< std::string( uint64_t offset ) > streamcb_;
+    file_range file_;
 
     response();
     ~response();
@@ -190,6 +214,7 @@ struct response {
     void set_redirect( const char* uri );
     void set_content( const char* s, size_t n, const char* content_type );
     void set_content( const std::string& s, const char* content_type );
+    void set_file_content( const file_range& range, const char* content_type );
 
 };  /// struct response
 
@@ -203,6 +228,8 @@ public:
     virtual int read( char* ptr, size_t size ) = 0;
     virtual int write( const char* ptr, size_t size1 ) = 0;
     virtual std::string get_remote_addr() const = 0;
+    // writes up to size bytes of file fd at offset, returns count of bytes written or -1
+    virtual int write_file( int fd, uint64_t offset, size_t size );
 
     template < typename... Args >
     void write_format( const char* fmt, const Args&... args );
@@ -215,6 +242,7 @@ public:
     virtual int read( char* ptr, size_t size );
     virtual int write( const char* ptr, size_t size );
     virtual std::string get_remote_addr() const;
+    virtual int write_file( int fd, uint64_t offset, size_t size );
 
 private:
     socket_t sock_;
@@ -239,6 +267,28 @@ private:
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+// reads one request already received by the epoll reactor, collects the response and sends it
+// to the non-blocking socket in as few calls as possible
+class reactor_stream : public stream {
+public:
+    reactor_stream( socket_t sock, const std::string& request );
+    virtual ~reactor_stream();
+    virtual int read( char* ptr, size_t size );
+    virtual int write( const char* ptr, size_t size );
+    virtual std::string get_remote_addr() const;
+    virtual int write_file( int fd, uint64_t offset, size_t size );
+    bool flush();
+
+private:
+    socket_t sock_;
+    const std::string& request_;
+    size_t pos_ = 0;
+    std::string out_;
+};  /// class reactor_stream
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
 class server;
 
 class async_query_handler : public skutils::ref_retain_release {
@@ -341,6 +391,59 @@ public:
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+// edge-triggered epoll reactor of plain HTTP server: few I/O threads own all keep-alive
+// connections, read them without blocking and hand every complete request to the handler queues
+class epoll_reactor {
+public:
+    epoll_reactor( server& srv, size_t io_threads );
+    ~epoll_reactor();
+    bool is_valid() const;
+    void add( socket_t sock );
+    void stop();
+    size_t connection_count() const;
+
+    // returns size of the first complete request in buffer, 0 if more bytes are needed
+    // or std::string::npos if request is malformed or too large
+    static size_t complete_request_size( const std::string& buffer, bool peer_closed );
+
+private:
+    struct connection {
+        socket_t sock_ = INVALID_SOCKET;
+        std::string origin_;
+        std::mutex mtx_;
+        std::string in_;  // received bytes not yet handled
+        bool busy_ = false;  // handler job owns the connection
+        bool peer_closed_ = false;
+        bool closed_ = false;
+        size_t served_ = 0;
+        std::chrono::steady_clock::time_point last_active_;
+    };
+    typedef std::shared_ptr< connection > connection_ptr;
+    struct io_thread {
+        int epoll_fd_ = -1;
+        int wake_fd_ = -1;
+        mutable std::mutex mtx_;
+        std::map< socket_t, connection_ptr > connections_;
+        std::thread thread_;
+    };
+
+    void run( io_thread& t );
+    void on_readable( io_thread& t, const connection_ptr& c );
+    void close_idle( io_thread& t );
+    void dispatch( io_thread& t, const connection_ptr& c );
+    void handle( io_thread& t, const connection_ptr& c );
+    void close_connection( io_thread& t, const connection_ptr& c );  // c->mtx_ must be locked
+
+    server& srv_;
+    std::vector< std::unique_ptr< io_thread > > threads_;
+    std::atomic_size_t next_thread_{0};
+    std::atomic_size_t pending_jobs_{0};
+    std::atomic_bool stopping_{false};
+};  /// class epoll_reactor
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
 class common_network_exception : public std::exception {
 public:
     enum error_type {
@@ -388,6 +491,9 @@ public:
 class server : public common {
 public:
     mutable bool is_async_http_transfer_mode_;
+    // non-zero count of I/O threads makes plain HTTP server use epoll reactor instead of
+    // is_async_http_transfer_mode_, ignored by SSL server and on platforms without epoll
+    size_t epoll_io_threads_ = 0;
     mutable int boundToPort_ = -1;
     typedef std::function< void( const request&, response& ) > Handler;
     typedef std::function< void( const request&, const response& ) > Logger;
@@ -452,6 +558,7 @@ private:
     virtual bool read_and_close_socket_sync( socket_t sock );
     virtual void read_and_close_socket_async( socket_t sock );
 
+    std::unique_ptr< epoll_reactor > reactor_;
     std::atomic_bool is_in_loop_ = false;
     std::atomic_bool is_running_ = false;
     socket_t svr_sock_;
@@ -512,6 +619,7 @@ public:
     friend class async_read_and_close_socket_base;
     friend class async_read_and_close_socket;
     friend class async_read_and_close_socket_SSL;
+    friend class epoll_reactor;
 };  /// class server
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
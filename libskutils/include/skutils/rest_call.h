@@ -37,6 +37,8 @@ struct data_t {
     std::string s_;
     std::string content_type_;
     skutils::http::common_network_exception::error_info ei_;
+    int status_ = 0;          // of HTTP response, 0 if there was none
+    size_t retry_after_ = 0;  // seconds, from "Retry-After" header of HTTP response
     data_t();
     data_t( const data_t& d );
     ~data_t();
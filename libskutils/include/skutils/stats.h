@@ -180,6 +180,66 @@ double stat_compute_bps_last_known(
 double stat_compute_bps_til_now( const traffic_queue_t& qtr, bytes_count_t* p_nSummary = nullptr );
 };  // namespace named_traffic_stats
 
+/// HDR-style histogram of latencies: every power of two is split into sub_bucket_count linear
+/// sub-buckets, so any recorded value is known within 1/16 of its size from 1 to 2^36 units.
+/// Values are added by one thread at a time and may be read concurrently by any thread.
+class latency_histogram {
+public:
+    static constexpr size_t sub_bucket_bits = 4;
+    static constexpr size_t sub_bucket_count = size_t( 1 ) << sub_bucket_bits;
+    static constexpr size_t value_bits = 36;  // larger values are counted in the last bucket
+    static constexpr size_t bucket_count = ( value_bits - sub_bucket_bits + 1 ) * sub_bucket_count;
+
+    latency_histogram();
+    latency_histogram( const latency_histogram& x );
+    latency_histogram& operator=( const latency_histogram& x );
+
+    static size_t bucket_of( uint64_t nValue );
+    static uint64_t bucket_lowest( size_t idxBucket );
+    static uint64_t bucket_highest( size_t idxBucket );
+
+    void add( uint64_t nValue );  // single writer
+    void merge( const latency_histogram& x );
+    uint64_t count() const { return cnt_.load( std::memory_order_relaxed ); }
+    uint64_t sum() const { return sum_.load( std::memory_order_relaxed ); }
+    uint64_t min() const { return min_.load( std::memory_order_relaxed ); }
+    uint64_t max() const { return max_.load( std::memory_order_relaxed ); }
+    double mean() const;
+    // highest value equivalent to the one at given percentile, zero if empty
+    uint64_t percentile( double lfPercentile ) const;
+    // values are multiplied by lfUnit, e.g. 1e-6 to report microseconds as seconds
+    nlohmann::json toJSON( double lfUnit = 1.0 ) const;
+
+private:
+    std::atomic< uint64_t > buckets_[bucket_count];
+    std::atomic< uint64_t > cnt_, sum_, min_, max_;
+};  /// class latency_histogram
+
+// per-thread sharded counters of calls to named methods in named subsystems
+// a thread records into its own shard only, so recording never waits for other threads,
+// shards are summed up when stats are read; every name keeps its counters in every thread
+// forever, so callers pass names from a bounded set only
+namespace sharded {
+
+struct method_totals_t {
+    uint64_t calls_ = 0, answers_ = 0, errors_ = 0, exceptions_ = 0;
+    bytes_count_t bytes_recv_ = 0, bytes_sent_ = 0;
+    latency_histogram latency_;  // in microseconds
+    void merge( const method_totals_t& x );
+};
+typedef std::map< std::string, method_totals_t > map_method_totals_t;
+
+void register_call( const char* strSubSystem, const char* strMethod, bytes_count_t nBytes );
+void register_answer( const char* strSubSystem, const char* strMethod, bytes_count_t nBytes );
+void register_error( const char* strSubSystem, const char* strMethod );
+void register_exception( const char* strSubSystem, const char* strMethod );
+void register_latency( const char* strSubSystem, const char* strMethod, uint64_t nMicroseconds );
+
+// totals of all threads since start, including threads which already exited
+map_method_totals_t collect( const char* strSubSystem );
+
+};  // namespace sharded
+
 namespace time_tracker {
 
 class element : public skutils::ref_retain_release {
@@ -5,6 +5,7 @@
 #include <map>
 #include <mutex>
 #include <string>
+#include <vector>
 
 #include <skutils/atomic_shared_ptr.h>
 #include <skutils/multithreading.h>
@@ -196,6 +197,7 @@ class tracker : public skutils::ref_retain_release,
     typedef std::map< string, queue_ptr > map_type;
     mutable map_type map_;
 
+    atomic_bool isTraceSink_ = false;  // true for the default tracker only, see trace_scope
     atomic_bool isEnabled_ = true;
     atomic_index_type safeMaxItemCount_ = 10 * 1000 * 1000;
     atomic_index_type sessionMaxItemCount_ = 0;  // zero means use safeMaxItemCount_
@@ -211,8 +213,10 @@ public:
 
 private:
     void reset();
+    void update_tracing();
 
 public:
+    void set_trace_sink();
     bool is_enabled() const;
     void set_enabled( bool b );
     size_t get_safe_max_item_count() const;
@@ -271,6 +275,79 @@ public:
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+// Binary trace: hot paths record fixed-size events into ring buffers of their own threads
+// instead of building json for an action. Events are turned into json, in the same shape as
+// items of queues, only when the default tracker composes its json.
+
+static const size_t trace_arg_count = 4;
+static const size_t trace_tag_size = 32;
+
+// static description of traced events, call sites keep it in a static variable
+struct trace_point {
+    const char* queue;
+    const char* name;
+    const char* tag;                    // name of the text argument, nullptr if unused
+    const char* args[trace_arg_count];  // names of numeric arguments, nullptr if unused
+};
+
+struct trace_event {
+    const trace_point* point = nullptr;
+    size_t session = 0;
+    index_type indexT = 0;
+    int64_t nsStart = 0, nsEnd = 0;  // since clock epoch
+    uint64_t args[trace_arg_count] = {0, 0, 0, 0};
+    char tag[trace_tag_size] = {0};  // cut if longer
+};
+
+// true while the default tracker is enabled and running
+extern atomic_bool g_bIsTracing;
+
+inline bool is_tracing() {
+    return g_bIsTracing.load( std::memory_order_relaxed );
+}
+
+// records an event lasting for its own lifetime; costs one branch while tracing is off, so
+// arguments must be cheap to compute, expensive ones are set only if is_active()
+class trace_scope {
+    trace_event event_;
+
+public:
+    trace_scope( const trace_point& point, uint64_t arg0 = 0, uint64_t arg1 = 0,
+        uint64_t arg2 = 0, uint64_t arg3 = 0 ) {
+        if ( is_tracing() )
+            start( point, nullptr, arg0, arg1, arg2, arg3 );
+    }
+    trace_scope( const trace_point& point, const string& tag, uint64_t arg0 = 0,
+        uint64_t arg1 = 0, uint64_t arg2 = 0, uint64_t arg3 = 0 ) {
+        if ( is_tracing() )
+            start( point, &tag, arg0, arg1, arg2, arg3 );
+    }
+    trace_scope( const trace_scope& ) = delete;
+    trace_scope( trace_scope&& ) = delete;
+    ~trace_scope() {
+        if ( event_.point )
+            finish();
+    }
+    trace_scope& operator=( const trace_scope& ) = delete;
+    trace_scope& operator=( trace_scope&& ) = delete;
+    bool is_active() const { return event_.point != nullptr; }
+    void set_arg( size_t i, uint64_t value ) {
+        if ( event_.point )
+            event_.args[i] = value;
+    }
+    void finish();
+
+private:
+    void start( const trace_point& point, const string* pTag, uint64_t arg0, uint64_t arg1,
+        uint64_t arg2, uint64_t arg3 );
+};
+
+// events of the current session still kept in ring buffers, in order of their indices
+extern std::vector< trace_event > collect_trace_events( index_type minIndexT = 0 );
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
 };  // namespace performance
 };  // namespace task
 };  // namespace skutils
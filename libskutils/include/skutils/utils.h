@@ -21,6 +21,7 @@
 #include <string>
 #include <thread>
 #include <type_traits>
+#include <unordered_map>
 #include <vector>
 
 //#include <nlohmann/json.hpp>
@@ -592,10 +593,34 @@ extern std::string generate_stack_trace( int nSkip = 1, bool isExtended = true )
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+// immutable parsed configuration, every value reachable by plain dot separated path of object
+// keys and decimal array indices is found by one hash lookup without walking JSON
+class json_config_snapshot {
+    const nlohmann::json joConfig_;
+    const size_t nVersion_;
+    std::list< nlohmann::json > lstArraySizes_;  // values of "count", "size" and "length" paths
+    std::unordered_map< std::string, const nlohmann::json* > mapPaths_;
+    void compile( const nlohmann::json& jo, const std::string& strPath );
+
+public:
+    json_config_snapshot( nlohmann::json&& joConfig, size_t nVersion );
+    json_config_snapshot( const json_config_snapshot& ) = delete;
+    json_config_snapshot& operator=( const json_config_snapshot& ) = delete;
+    const nlohmann::json& json() const { return joConfig_; }
+    size_t version() const { return nVersion_; }  // incremented with each reload
+    // same result as json_config_file_accessor::stat_extract_at_path(), which is used for paths
+    // not in lookup table
+    nlohmann::json extract_at_path( const std::string& strPath ) const;
+};  /// class json_config_snapshot
+
+typedef std::shared_ptr< const json_config_snapshot > json_config_snapshot_ptr_t;
+
 class json_config_file_accessor {
     const std::string configPath_;
     time_t configModificationTime_;
-    nlohmann::json joConfig_;
+    json_config_snapshot_ptr_t pSnapshot_;  // accessed via std::atomic_load/atomic_store
+    size_t nVersion_ = 0;
+    std::atomic< uint64_t > nNextModificationCheckMs_;
 
     typedef std::recursive_mutex mutex_type;
     typedef std::lock_guard< mutex_type > lock_type;
@@ -603,9 +628,15 @@ class json_config_file_accessor {
     mutex_type& mtx() { return mtx_; }
 
 public:
+    // getConfigSnapshot() checks file modification time not more often than this
+    uint64_t nModificationCheckIntervalMs_ = 1000;
+
     json_config_file_accessor( const std::string& configPath );
     virtual ~json_config_file_accessor();
     void reloadConfigIfNeeded();
+    // snapshot taken at last reload, file is re-checked at most once per interval, so this
+    // does not lock or copy between checks
+    json_config_snapshot_ptr_t getConfigSnapshot();
     nlohmann::json getConfigJSON();
     nlohmann::json getConfigJSON() const {
         return ( const_cast< json_config_file_accessor* >( this ) )->getConfigJSON();
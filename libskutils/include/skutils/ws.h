@@ -651,6 +651,7 @@ public:
     std::string getPeerClientAddressName( connection_identifier_t cid );  // notice: used as
                                                                           // "origin"
     std::string getPeerRemoteIP( connection_identifier_t cid );  // notice: no port is returned
+    size_t getPeerPendingBytes( connection_identifier_t cid );  // queued, not yet written out
     peer_ptr_t getPeer( connection_identifier_t cid );
     peer_ptr_t detachPeer( connection_identifier_t cid );
     bool setPeer( connection_identifier_t cid, peer_ptr_t pPeer );
@@ -812,6 +813,7 @@ public:
     const security_args& onGetSecurityArgs() const override;
     virtual std::string getRemoteIp() const;
     virtual std::string getOrigin() const;
+    virtual size_t getPendingBytes() const;
     virtual std::string getCidString() const;
     static connection_identifier_t stat_getCid( const hdl_t& hdl );
     // static std::string stat_getCidString( const hdl_t & hdl ); // hdl_t is same as
@@ -880,6 +882,7 @@ public:
 
     std::string getRemoteIp( hdl_t hdl );
     std::string getOrigin( hdl_t hdl );
+    size_t getPendingBytes( hdl_t hdl );
     bool sendMessage( hdl_t hdl, const std::string& msg, opcv eOpCode = opcv::text );
     //
     virtual peer_ptr_t onPeerInstantiate( hdl_t hdl );
@@ -28,6 +28,11 @@ skutils::multithreading::recursive_mutex_type& get_dispatch_mtx() {
     return skutils::get_ref_mtx();
 }
 
+static const skutils::task::performance::trace_point g_trace_queue_job{
+    "dispatch/queue", "task", "queue", {}};
+static const skutils::task::performance::trace_point g_trace_thread_job{
+    "dispatch/thread", "task", nullptr, {"thread"}};
+
 static void stat_sleep( duration_t how_much ) {
     // auto nNanoSeconds = how_much.count();
     // struct timespec ts{ time_t(nNanoSeconds/1000000000),
@@ -1008,12 +1013,7 @@ bool queue::impl_job_run( job_t /*&*/ fn ) {  // run explicitly specified job sy
             std::cout.flush();
 #endif
             //
-            std::string strPerformanceQueueName =
-                skutils::tools::format( "dispatch/queue/%s", id_.c_str() );
-            std::string strPerformanceActionName =
-                skutils::tools::format( "task %zu", nTaskNumberInQueue_++ );
-            skutils::task::performance::action a(
-                strPerformanceQueueName, strPerformanceActionName );
+            skutils::task::performance::trace_scope trace( g_trace_queue_job, id_ );
             //
             fn();
 #if ( defined __SKUTILS_DISPATCH_DEBUG_CONSOLE_TRACE_QUEUE_STATES__ )
@@ -1266,8 +1266,7 @@ void domain::impl_startup( size_t nWaitMilliSeconds /*= size_t(-1)*/ ) {
         std::atomic_size_t cntFailedToStartThreads;
         cntFailedToStartThreads = 0;
         for ( idxThread = 0; idxThread < cntThreadsToStart; ++idxThread ) {
-            std::string strPerformanceQueueName = skutils::tools::format(
-                "dispatch/thread/%zu", idxThread );  // notice - no domain reference
+            size_t idxPoolThread = idxThread;  // notice - no domain reference in traces
             std::string strError;
             static const size_t cntAttempts = 5;
             for ( size_t idxAttempt = 0; idxAttempt < cntAttempts; ++idxAttempt ) {
@@ -1276,10 +1275,9 @@ void domain::impl_startup( size_t nWaitMilliSeconds /*= size_t(-1)*/ ) {
                     std::this_thread::sleep_for( std::chrono::milliseconds( 500 ) );
                 }
                 try {
-                    thread_pool_.safe_submit_without_future_te( [this, strPerformanceQueueName]() {
+                    thread_pool_.safe_submit_without_future_te( [this, idxPoolThread]() {
                         ++cntRunningThreads_;
                         try {
-                            size_t nTaskNumberInThisThread = 0;
                             for ( ; true; ) {
                                 if ( shutdown_flag_ )
                                     break;
@@ -1291,10 +1289,8 @@ void domain::impl_startup( size_t nWaitMilliSeconds /*= size_t(-1)*/ ) {
                                     break;
                                 for ( ; true; ) {
                                     //
-                                    std::string strPerformanceActionName = skutils::tools::format(
-                                        "task %zu", nTaskNumberInThisThread++ );
-                                    skutils::task::performance::action a(
-                                        strPerformanceQueueName, strPerformanceActionName );
+                                    skutils::task::performance::trace_scope trace(
+                                        g_trace_thread_job, idxPoolThread );
                                     //
                                     if ( !run_one() )
                                         break;
@@ -1317,8 +1313,8 @@ void domain::impl_startup( size_t nWaitMilliSeconds /*= size_t(-1)*/ ) {
                 }
                 if ( strError.empty() )
                     break;
-                std::cout << "Failed submit initialization task for the \""
-                          << strPerformanceQueueName << "\" queue at attempt " << idxAttempt
+                std::cout << "Failed submit initialization task for the \"dispatch/thread/"
+                          << idxPoolThread << "\" queue at attempt " << idxAttempt
                           << " of " << cntAttempts << ", error is: " << strError << "\n";
             }  // for( size_t idxAttempt = 0; idxAttempt < 3; ++ idxAttempt ) {
             if ( !strError.empty() ) {
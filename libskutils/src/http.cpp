@@ -3,6 +3,7 @@
 #if ( !defined _WIN32 )
 
 #include <arpa/inet.h>
+#include <errno.h>
 #include <netdb.h>
 #include <netinet/in.h>
 #include <pthread.h>
@@ -12,6 +13,12 @@
 #include <sys/socket.h>
 #include <unistd.h>
 
+#if ( defined __linux__ )
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/sendfile.h>
+#endif  // (defined __linux__)
+
 #endif  // (!defined _WIN32)
 
 //#define __SKUTILS_HTTP_DEBUG_CONSOLE_TRACE_HTTP_TASK_STATES__ 1
@@ -432,6 +439,8 @@ const char* status_message( int status ) {
     switch ( status ) {
     case 200:
         return "OK";
+    case 206:
+        return "Partial Content";
     case 301:
         return "Moved Permanently";
     case 302:
@@ -448,6 +457,10 @@ const char* status_message( int status ) {
         return "Not Found";
     case 415:
         return "Unsupported Media Type";
+    case 416:
+        return "Range Not Satisfiable";
+    case 503:
+        return "Service Unavailable";
     default:
     case 500:
         return "Internal server Error";
@@ -970,6 +983,35 @@ std::pair< std::string, std::string > make_range_header( uint64_t value, Args...
     return std::make_pair( "Range", field );
 }
 
+bool parse_range_header(
+    const std::string& value, uint64_t total_size, uint64_t& offset, uint64_t& length ) {
+    static const std::regex g_re( R"(bytes=(\d*)-(\d*))" );
+    std::smatch m;
+    if ( !std::regex_match( value, m, g_re ) || ( m[1].length() == 0 && m[2].length() == 0 ) )
+        return false;
+    try {
+        if ( m[1].length() == 0 ) {
+            // suffix range, i.e. last bytes of content
+            uint64_t suffix = std::stoull( m[2] );
+            if ( suffix == 0 || total_size == 0 )
+                return false;
+            length = std::min( suffix, total_size );
+            offset = total_size - length;
+            return true;
+        }
+        offset = std::stoull( m[1] );
+        if ( offset >= total_size )
+            return false;
+        uint64_t last = ( m[2].length() > 0 ) ? std::stoull( m[2] ) : ( total_size - 1 );
+        if ( last < offset )
+            return false;
+        length = std::min( last, total_size - 1 ) - offset + 1;
+    } catch ( ... ) {  // numbers out of range
+        return false;
+    }
+    return true;
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
@@ -1061,12 +1103,30 @@ void response::set_content( const std::string& s, const char* content_type ) {
     set_header( "Content-Type", content_type );
 }
 
+void response::set_file_content( const file_range& range, const char* content_type ) {
+    body_.clear();
+    file_ = range;
+    set_header( "Content-Type", content_type );
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 stream::stream() {}
 stream::~stream() {}
 
+int stream::write_file( int fd, uint64_t offset, size_t size ) {
+#if ( defined _WIN32 )
+    return -1;
+#else
+    char buf[64 * 1024];
+    ssize_t n = ::pread( fd, buf, std::min( size, sizeof( buf ) ), off_t( offset ) );
+    if ( n <= 0 )
+        return -1;
+    return write( buf, size_t( n ) );
+#endif
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
@@ -1088,6 +1148,21 @@ std::string socket_stream::get_remote_addr() const {
     return detail::get_remote_addr( sock_ );
 }
 
+int socket_stream::write_file( int fd, uint64_t offset, size_t size ) {
+#if ( defined __linux__ )
+    off_t pos = off_t( offset );
+    ssize_t n;
+    do
+        n = ::sendfile( sock_, fd, &pos, size );
+    while ( n < 0 && errno == EINTR );
+    if ( n < 0 && ( errno == EINVAL || errno == ENOSYS ) )
+        return stream::write_file( fd, offset, size );  // file system cannot sendfile
+    return ( n > 0 ) ? int( n ) : -1;
+#else
+    return stream::write_file( fd, offset, size );
+#endif
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
@@ -1122,6 +1197,80 @@ const std::string& buffer_stream::get_buffer() const {
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+reactor_stream::reactor_stream( socket_t sock, const std::string& request )
+    : sock_( sock ), request_( request ) {}
+reactor_stream::~reactor_stream() {}
+
+int reactor_stream::read( char* ptr, size_t size ) {
+    if ( ptr == nullptr || size == 0 )
+        return 0;
+    size_t n = std::min( size, request_.size() - pos_ );
+    memcpy( ptr, request_.data() + pos_, n );
+    pos_ += n;
+    return static_cast< int >( n );
+}
+
+int reactor_stream::write( const char* ptr, size_t size ) {
+    if ( ptr == nullptr || size == 0 )
+        return 0;
+    out_.append( ptr, size );
+    if ( out_.size() >= 64 * 1024 && !flush() )
+        return -1;
+    return static_cast< int >( size );
+}
+
+std::string reactor_stream::get_remote_addr() const {
+    return detail::get_remote_addr( sock_ );
+}
+
+int reactor_stream::write_file( int fd, uint64_t offset, size_t size ) {
+    if ( !flush() )
+        return -1;
+#if ( defined __linux__ )
+    off_t pos = off_t( offset );
+    for ( ;; ) {
+        ssize_t n = ::sendfile( sock_, fd, &pos, size );
+        if ( n > 0 )
+            return int( n );
+        if ( n < 0 && errno == EINTR )
+            continue;
+        if ( n < 0 && ( errno == EAGAIN || errno == EWOULDBLOCK ) &&
+             detail::poll_write( sock_, __SKUTILS_HTTP_EPOLL_WRITE_TIMEOUT_MILLISECONDS__ ) )
+            continue;
+        if ( n < 0 && ( errno == EINVAL || errno == ENOSYS ) )
+            break;  // file system cannot sendfile
+        return -1;
+    }
+#endif
+    return stream::write_file( fd, offset, size );
+}
+
+bool reactor_stream::flush() {
+    // socket is non-blocking, wait for it only when kernel buffer is full
+    const char* ptr = out_.data();
+    size_t size = out_.size();
+    while ( size > 0 ) {
+        auto n = send( sock_, ptr, size, 0 );
+        if ( n > 0 ) {
+            ptr += n;
+            size -= size_t( n );
+            continue;
+        }
+        if ( n < 0 && errno == EINTR )
+            continue;
+        if ( n < 0 && ( errno == EAGAIN || errno == EWOULDBLOCK ) &&
+             detail::poll_write( sock_, __SKUTILS_HTTP_EPOLL_WRITE_TIMEOUT_MILLISECONDS__ ) )
+            continue;
+        out_.clear();
+        return false;
+    }
+    out_.clear();
+    return true;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
 SSL_socket_stream::SSL_socket_stream( socket_t sock, SSL* ssl ) : sock_( sock ), ssl_( ssl ) {}
 
 SSL_socket_stream::~SSL_socket_stream() {}
@@ -1596,6 +1745,332 @@ void async_read_and_close_socket_SSL::close_socket() {
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+size_t epoll_reactor::complete_request_size( const std::string& buffer, bool peer_closed ) {
+    static const size_t npos = std::string::npos;
+    const size_t headers_end = buffer.find( "\r\n\r\n" );
+    if ( headers_end == npos )
+        return ( buffer.size() > __SKUTILS_HTTP_EPOLL_MAX_HEADERS_SIZE__ ) ? npos : 0;
+    const size_t body_begin = headers_end + 4;
+    if ( body_begin > __SKUTILS_HTTP_EPOLL_MAX_HEADERS_SIZE__ )
+        return npos;
+    // only these methods have body read by server::process_request()
+    const std::string method = buffer.substr( 0, buffer.find( ' ' ) );
+    if ( method != "POST" && method != "PUT" && method != "PATCH" )
+        return body_begin;
+    // body framing follows detail::read_content(), first header of a name wins
+    bool have_length = false, have_encoding = false, is_chunked = false;
+    size_t length = 0;
+    for ( size_t line_begin = buffer.find( "\r\n" ) + 2; line_begin < headers_end; ) {
+        const size_t line_end = buffer.find( "\r\n", line_begin );
+        const size_t colon = buffer.find( ':', line_begin );
+        if ( colon < line_end ) {
+            const std::string key = skutils::tools::to_lower(
+                skutils::tools::trim_copy( buffer.substr( line_begin, colon - line_begin ) ) );
+            const std::string value =
+                skutils::tools::trim_copy( buffer.substr( colon + 1, line_end - colon - 1 ) );
+            if ( key == "content-length" && !have_length ) {
+                have_length = true;
+                length = size_t( strtoull( value.c_str(), nullptr, 10 ) );
+            } else if ( key == "transfer-encoding" && !have_encoding ) {
+                have_encoding = true;
+                is_chunked = !strcasecmp( value.c_str(), "chunked" );
+            }
+        }
+        line_begin = line_end + 2;
+    }
+    if ( have_length && length > 0 ) {
+        if ( length > __SKUTILS_HTTP_EPOLL_MAX_CONTENT_SIZE__ )
+            return npos;
+        return ( buffer.size() >= body_begin + length ) ? ( body_begin + length ) : 0;
+    }
+    if ( is_chunked ) {
+        for ( size_t pos = body_begin;; ) {
+            const size_t line_end = buffer.find( "\r\n", pos );
+            if ( line_end == npos )
+                return ( buffer.size() - pos > 16 ) ? npos : 0;
+            char* end = nullptr;
+            const size_t chunk_len = size_t( strtoull( buffer.c_str() + pos, &end, 16 ) );
+            if ( end == buffer.c_str() + pos )
+                return npos;
+            pos = line_end + 2;
+            if ( chunk_len == 0 )  // terminator line follows last chunk
+                return ( buffer.size() >= pos + 2 ) ? ( pos + 2 ) : 0;
+            if ( pos - body_begin + chunk_len > __SKUTILS_HTTP_EPOLL_MAX_CONTENT_SIZE__ )
+                return npos;
+            pos += chunk_len + 2;
+            if ( pos > buffer.size() )
+                return 0;
+        }
+    }
+    if ( have_length )
+        return body_begin;
+    // body without length ends when peer closes its side of connection
+    if ( peer_closed )
+        return buffer.size();
+    return ( buffer.size() - body_begin > __SKUTILS_HTTP_EPOLL_MAX_CONTENT_SIZE__ ) ? npos : 0;
+}
+
+#if ( defined __linux__ )
+
+epoll_reactor::epoll_reactor( server& srv, size_t io_threads ) : srv_( srv ) {
+    for ( size_t i = 0; i < io_threads; ++i ) {
+        std::unique_ptr< io_thread > t( new io_thread );
+        t->epoll_fd_ = ::epoll_create1( EPOLL_CLOEXEC );
+        t->wake_fd_ = ::eventfd( 0, EFD_NONBLOCK | EFD_CLOEXEC );
+        epoll_event ev;
+        memset( &ev, 0, sizeof( ev ) );
+        ev.events = EPOLLIN;
+        ev.data.fd = t->wake_fd_;
+        if ( t->epoll_fd_ < 0 || t->wake_fd_ < 0 ||
+             ::epoll_ctl( t->epoll_fd_, EPOLL_CTL_ADD, t->wake_fd_, &ev ) != 0 ) {
+            if ( t->epoll_fd_ >= 0 )
+                ::close( t->epoll_fd_ );
+            if ( t->wake_fd_ >= 0 )
+                ::close( t->wake_fd_ );
+            break;
+        }
+        threads_.push_back( std::move( t ) );
+    }
+    for ( auto& t : threads_ ) {
+        io_thread* pt = t.get();
+        pt->thread_ = std::thread( [this, pt]() { run( *pt ); } );
+    }
+}
+
+epoll_reactor::~epoll_reactor() {
+    stop();
+}
+
+bool epoll_reactor::is_valid() const {
+    return !threads_.empty();
+}
+
+void epoll_reactor::add( socket_t sock ) {
+    if ( threads_.empty() || stopping_ ) {
+        detail::close_socket( sock );
+        return;
+    }
+    io_thread& t = *threads_[next_thread_++ % threads_.size()];
+    detail::set_nonblocking( sock, true );
+    connection_ptr c = std::make_shared< connection >();
+    c->sock_ = sock;
+    c->origin_ = skutils::network::get_fd_name_as_url( sock, "HTTP", true );
+    c->last_active_ = std::chrono::steady_clock::now();
+    std::lock_guard< std::mutex > lock( t.mtx_ );
+    t.connections_[sock] = c;
+    epoll_event ev;
+    memset( &ev, 0, sizeof( ev ) );
+    ev.events = EPOLLIN | EPOLLRDHUP | EPOLLET;
+    ev.data.fd = sock;
+    if ( ::epoll_ctl( t.epoll_fd_, EPOLL_CTL_ADD, sock, &ev ) != 0 ) {
+        t.connections_.erase( sock );
+        detail::close_socket( sock );
+    }
+}
+
+void epoll_reactor::stop() {
+    if ( stopping_.exchange( true ) )
+        return;
+    for ( auto& t : threads_ ) {
+        uint64_t one = 1;
+        if ( ::write( t->wake_fd_, &one, sizeof( one ) ) < 0 ) {
+            // I/O thread will see stopping_ after epoll_wait() timeout
+        }
+    }
+    for ( auto& t : threads_ ) {
+        if ( t->thread_.joinable() )
+            t->thread_.join();
+    }
+    // queued and running handler jobs refer to this reactor and own their connections
+    while ( pending_jobs_ > 0 )
+        std::this_thread::sleep_for( std::chrono::milliseconds( 10 ) );
+    for ( auto& t : threads_ ) {
+        std::map< socket_t, connection_ptr > connections;
+        {  // block
+            std::lock_guard< std::mutex > lock( t->mtx_ );
+            connections = t->connections_;
+        }  // block
+        for ( auto& x : connections ) {
+            std::lock_guard< std::mutex > lock( x.second->mtx_ );
+            close_connection( *t, x.second );
+        }
+        ::close( t->epoll_fd_ );
+        ::close( t->wake_fd_ );
+    }
+    threads_.clear();
+}
+
+size_t epoll_reactor::connection_count() const {
+    size_t n = 0;
+    for ( auto& t : threads_ ) {
+        std::lock_guard< std::mutex > lock( t->mtx_ );
+        n += t->connections_.size();
+    }
+    return n;
+}
+
+void epoll_reactor::run( io_thread& t ) {
+    epoll_event events[__SKUTILS_HTTP_EPOLL_MAX_EVENTS__];
+    auto next_idle_check = std::chrono::steady_clock::now() + std::chrono::seconds( 1 );
+    while ( !stopping_ ) {
+        int n = ::epoll_wait( t.epoll_fd_, events, __SKUTILS_HTTP_EPOLL_MAX_EVENTS__, 1000 );
+        if ( n < 0 && errno != EINTR )
+            break;
+        for ( int i = 0; i < n && !stopping_; ++i ) {
+            if ( events[i].data.fd == t.wake_fd_ )
+                continue;
+            connection_ptr c;
+            {  // block
+                std::lock_guard< std::mutex > lock( t.mtx_ );
+                auto it = t.connections_.find( events[i].data.fd );
+                if ( it != t.connections_.end() )
+                    c = it->second;
+            }  // block
+            if ( c )
+                on_readable( t, c );
+        }
+        if ( std::chrono::steady_clock::now() >= next_idle_check ) {
+            close_idle( t );
+            next_idle_check = std::chrono::steady_clock::now() + std::chrono::seconds( 1 );
+        }
+    }
+}
+
+void epoll_reactor::on_readable( io_thread& t, const connection_ptr& c ) {
+    std::lock_guard< std::mutex > lock( c->mtx_ );
+    if ( c->closed_ )
+        return;
+    // edge-triggered, so drain the socket: no new event comes until more bytes arrive
+    char buf[64 * 1024];
+    for ( ;; ) {
+        auto n = recv( c->sock_, buf, sizeof( buf ), 0 );
+        if ( n > 0 ) {
+            c->in_.append( buf, size_t( n ) );
+            const size_t max_size =
+                __SKUTILS_HTTP_EPOLL_MAX_HEADERS_SIZE__ + __SKUTILS_HTTP_EPOLL_MAX_CONTENT_SIZE__;
+            if ( c->in_.size() > max_size ) {
+                c->in_.clear();  // peer floods while handler is busy, drop it
+                c->peer_closed_ = true;
+                break;
+            }
+            continue;
+        }
+        if ( n < 0 && errno == EINTR )
+            continue;
+        if ( n == 0 || ( errno != EAGAIN && errno != EWOULDBLOCK ) )
+            c->peer_closed_ = true;
+        break;
+    }
+    c->last_active_ = std::chrono::steady_clock::now();
+    if ( c->busy_ )
+        return;  // handler job takes next request when done with current one
+    size_t size = complete_request_size( c->in_, c->peer_closed_ );
+    if ( size == std::string::npos || ( size == 0 && c->peer_closed_ ) )
+        close_connection( t, c );
+    else if ( size > 0 )
+        dispatch( t, c );
+}
+
+void epoll_reactor::close_idle( io_thread& t ) {
+    std::vector< connection_ptr > connections;
+    {  // block
+        std::lock_guard< std::mutex > lock( t.mtx_ );
+        connections.reserve( t.connections_.size() );
+        for ( auto& x : t.connections_ )
+            connections.push_back( x.second );
+    }  // block
+    const auto deadline = std::chrono::steady_clock::now() -
+                          std::chrono::milliseconds(
+                              __SKUTILS_HTTP_KEEPALIVE_TIMEOUT_MILLISECONDS__ );
+    for ( auto& c : connections ) {
+        std::lock_guard< std::mutex > lock( c->mtx_ );
+        if ( !c->busy_ && c->last_active_ < deadline )
+            close_connection( t, c );
+    }
+}
+
+void epoll_reactor::dispatch( io_thread& t, const connection_ptr& c ) {
+    c->busy_ = true;
+    ++pending_jobs_;
+    io_thread* pt = &t;
+    connection_ptr pc = c;
+    skutils::dispatch::async( srv_.next_handler_queue_id(), [this, pt, pc]() {
+        handle( *pt, pc );
+        --pending_jobs_;
+    } );
+}
+
+void epoll_reactor::handle( io_thread& t, const connection_ptr& c ) {
+    MICROPROFILE_SCOPEI( "skutils", "http::epoll_reactor::handle", MP_PAPAYAWHIP );
+    const size_t max_count = std::max< size_t >( srv_.get_keep_alive_max_count(), 1 );
+    std::unique_lock< std::mutex > lock( c->mtx_ );
+    for ( ;; ) {
+        // pipelined requests are served in order by this job
+        size_t size = complete_request_size( c->in_, c->peer_closed_ );
+        if ( stopping_ || size == 0 || size == std::string::npos ) {
+            c->busy_ = false;
+            if ( stopping_ || size == std::string::npos || c->peer_closed_ )
+                close_connection( t, c );
+            return;
+        }
+        std::string request = c->in_.substr( 0, size );
+        c->in_.erase( 0, size );
+        bool last_connection = ( ++c->served_ >= max_count );
+        lock.unlock();
+        reactor_stream strm( c->sock_, request );
+        bool connection_close = false, is_ok = false;
+        try {
+            is_ok = srv_.process_request( c->origin_, strm, last_connection, connection_close ) &&
+                    strm.flush();
+        } catch ( ... ) {
+        }
+        lock.lock();
+        c->last_active_ = std::chrono::steady_clock::now();
+        if ( !is_ok || last_connection || connection_close ) {
+            c->busy_ = false;
+            close_connection( t, c );
+            return;
+        }
+    }
+}
+
+void epoll_reactor::close_connection( io_thread& t, const connection_ptr& c ) {
+    if ( c->closed_ )
+        return;
+    c->closed_ = true;
+    {  // block
+        std::lock_guard< std::mutex > lock( t.mtx_ );
+        ::epoll_ctl( t.epoll_fd_, EPOLL_CTL_DEL, c->sock_, nullptr );
+        t.connections_.erase( c->sock_ );
+    }  // block
+    detail::close_socket( c->sock_ );
+}
+
+#else  // (defined __linux__)
+
+epoll_reactor::epoll_reactor( server& srv, size_t /*io_threads*/ ) : srv_( srv ) {}
+
+epoll_reactor::~epoll_reactor() {}
+
+bool epoll_reactor::is_valid() const {
+    return false;
+}
+
+void epoll_reactor::add( socket_t sock ) {
+    detail::close_socket( sock );
+}
+
+void epoll_reactor::stop() {}
+
+size_t epoll_reactor::connection_count() const {
+    return 0;
+}
+
+#endif  // else from (defined __linux__)
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
 common::common( int ipVer ) : ipVer_( ipVer ) {}
 
 common::~common() {}
@@ -1733,7 +2208,7 @@ bool server::parse_request_line( const char* s, request& req ) {
 void server::write_response(
     stream& strm, bool last_connection, const request& req, response& res ) {
     assert( res.status_ != -1 );
-    if ( res.status_ != 200 )
+    if ( res.status_ != 200 && res.status_ != 206 )
         std::cout << "Failed to handle HTTP request, returning status " << res.status_
                   << ", request body is: " << req.body_ << "\n";
     if ( 400 <= res.status_ && error_handler_ ) {
@@ -1748,7 +2223,10 @@ void server::write_response(
     if ( !last_connection && req.get_header_value( "Connection" ) == "Keep-Alive" ) {
         res.set_header( "Connection", "Keep-Alive" );
     }
-    if ( res.body_.empty() ) {
+    if ( res.body_.empty() && res.file_.fd_ >= 0 ) {
+        auto length = std::to_string( res.file_.length_ );
+        res.set_header( "Content-Length", length.c_str() );
+    } else if ( res.body_.empty() ) {
         if ( !res.has_header( "Content-Length" ) ) {
             if ( res.streamcb_ ) {
                 // streamed response
@@ -1778,6 +2256,16 @@ void server::write_response(
     if ( req.method_ != "HEAD" ) {
         if ( !res.body_.empty() ) {
             strm.write( res.body_.c_str(), res.body_.size() );
+        } else if ( res.file_.fd_ >= 0 ) {
+            static const size_t g_nFilePieceSize = 256 * 1024;
+            uint64_t offset = res.file_.offset_, end = res.file_.offset_ + res.file_.length_;
+            while ( offset < end ) {
+                int n = strm.write_file( res.file_.fd_, offset,
+                    size_t( std::min< uint64_t >( end - offset, g_nFilePieceSize ) ) );
+                if ( n <= 0 )
+                    break;  // Stop on error
+                offset += n;
+            }
         } else if ( res.streamcb_ ) {
             bool chunked_response = !res.has_header( "Content-Length" );
             uint64_t offset = 0;
@@ -1830,7 +2318,9 @@ socket_t server::create_server_socket( int ipVer, const char* host, int port, in
                 return false;
             }
             boundToPort_ = port;
-            if (::listen( sock, 5 ) ) {  // listen through 5 channels
+            // epoll reactor is meant to take many connections at once
+            int backlog = ( epoll_io_threads_ > 0 && !is_ssl() ) ? SOMAXCONN : 5;
+            if (::listen( sock, backlog ) ) {
                 return false;
             }
             return true;
@@ -1873,6 +2363,11 @@ bool server::listen_internal() {
     auto ret = true;
     try {
         is_running_ = true;
+        if ( epoll_io_threads_ > 0 && !is_ssl() ) {
+            reactor_.reset( new epoll_reactor( *this, epoll_io_threads_ ) );
+            if ( !reactor_->is_valid() )
+                reactor_.reset();  // fall back to other transfer modes
+        }
         for ( ; is_running_; ) {
             bool isOK = detail::poll_read( svr_sock_, __SKUTILS_HTTP_ACCEPT_WAIT_MILLISECONDS__ );
             if ( !isOK ) {  // timeout
@@ -1886,7 +2381,9 @@ bool server::listen_internal() {
             socket_t sock = accept( svr_sock_, nullptr, nullptr );
             if ( sock == INVALID_SOCKET )
                 continue;
-            if ( is_async_http_transfer_mode_ )
+            if ( reactor_ )
+                reactor_->add( sock );
+            else if ( is_async_http_transfer_mode_ )
                 read_and_close_socket_async( sock );
             else
                 read_and_close_socket_sync( sock );
@@ -1902,6 +2399,10 @@ bool server::listen_internal() {
     } catch ( const std::exception& ex ) {
         std::cerr << ex.what() << std::endl;
     }
+    if ( reactor_ ) {
+        reactor_->stop();
+        reactor_.reset();
+    }
     is_running_ = false;
     is_in_loop_ = false;
     return ret;
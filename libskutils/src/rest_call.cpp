@@ -39,11 +39,15 @@ bool data_t::empty() const {
 void data_t::clear() {
     content_type_.clear();
     s_.clear();
+    status_ = 0;
+    retry_after_ = 0;
 }
 void data_t::assign( const data_t& d ) {
     s_ = d.s_;
     content_type_ = d.content_type_;
     ei_ = d.ei_;
+    status_ = d.status_;
+    retry_after_ = d.retry_after_;
 }
 
 nlohmann::json data_t::extract_json() const {
@@ -332,8 +336,16 @@ data_t client::call( const nlohmann::json& joIn, bool isAutoGenJsonID, e_data_fe
             d.ei_ = ch_->eiLast_;
             if ( !resp )
                 return d;  // data_t();
-            if ( resp->status_ != 200 )
+            d.status_ = resp->status_;
+            if ( resp->status_ != 200 ) {
+                if ( resp->has_header( "Retry-After" ) ) {
+                    try {
+                        d.retry_after_ = std::stoul( resp->get_header_value( "Retry-After" ) );
+                    } catch ( ... ) {
+                    }
+                }
                 return d;  // data_t();
+            }
             d.s_ = resp->body_;
             std::string h;
             if ( resp->has_header( "Content-Type" ) )
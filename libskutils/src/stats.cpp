@@ -2,6 +2,10 @@
 #include <skutils/stats.h>
 #include <skutils/utils.h>
 
+#include <cmath>
+#include <limits>
+#include <memory>
+
 namespace skutils {
 namespace stats {
 
@@ -347,6 +351,264 @@ double stat_compute_bps_til_now(
 
 };  // namespace named_traffic_stats
 
+latency_histogram::latency_histogram() : cnt_( 0 ), sum_( 0 ), min_( 0 ), max_( 0 ) {
+    for ( std::atomic< uint64_t >& b : buckets_ )
+        b.store( 0, std::memory_order_relaxed );
+}
+latency_histogram::latency_histogram( const latency_histogram& x ) : latency_histogram() {
+    merge( x );
+}
+latency_histogram& latency_histogram::operator=( const latency_histogram& x ) {
+    if ( this == &x )
+        return ( *this );
+    for ( std::atomic< uint64_t >& b : buckets_ )
+        b.store( 0, std::memory_order_relaxed );
+    cnt_.store( 0, std::memory_order_relaxed );
+    sum_.store( 0, std::memory_order_relaxed );
+    min_.store( 0, std::memory_order_relaxed );
+    max_.store( 0, std::memory_order_relaxed );
+    merge( x );
+    return ( *this );
+}
+
+size_t latency_histogram::bucket_of( uint64_t nValue ) {
+    static const uint64_t nValueMax = ( uint64_t( 1 ) << value_bits ) - 1;
+    if ( nValue > nValueMax )
+        nValue = nValueMax;
+    if ( nValue < sub_bucket_count )
+        return size_t( nValue );
+    // values of [2^e, 2^(e+1)) fall into sub_bucket_count buckets of 2^(e-sub_bucket_bits) each
+    size_t nShift = size_t( 63 - __builtin_clzll( nValue ) ) - sub_bucket_bits;
+    return nShift * sub_bucket_count + size_t( nValue >> nShift );
+}
+uint64_t latency_histogram::bucket_lowest( size_t idxBucket ) {
+    if ( idxBucket < 2 * sub_bucket_count )
+        return uint64_t( idxBucket );
+    size_t nShift = idxBucket / sub_bucket_count - 1;
+    return uint64_t( idxBucket % sub_bucket_count + sub_bucket_count ) << nShift;
+}
+uint64_t latency_histogram::bucket_highest( size_t idxBucket ) {
+    if ( idxBucket + 1 >= bucket_count )
+        return std::numeric_limits< uint64_t >::max();
+    return bucket_lowest( idxBucket + 1 ) - 1;
+}
+
+// the only writer, so plain loads and stores keep readers consistent enough without locking
+static inline void single_writer_add( std::atomic< uint64_t >& x, uint64_t n ) {
+    x.store( x.load( std::memory_order_relaxed ) + n, std::memory_order_relaxed );
+}
+
+void latency_histogram::add( uint64_t nValue ) {
+    single_writer_add( buckets_[bucket_of( nValue )], 1 );
+    if ( cnt_.load( std::memory_order_relaxed ) == 0 ||
+         nValue < min_.load( std::memory_order_relaxed ) )
+        min_.store( nValue, std::memory_order_relaxed );
+    if ( nValue > max_.load( std::memory_order_relaxed ) )
+        max_.store( nValue, std::memory_order_relaxed );
+    single_writer_add( sum_, nValue );
+    single_writer_add( cnt_, 1 );
+}
+
+void latency_histogram::merge( const latency_histogram& x ) {
+    uint64_t cnt = x.count();
+    if ( cnt == 0 )
+        return;
+    for ( size_t i = 0; i < bucket_count; ++i )
+        single_writer_add( buckets_[i], x.buckets_[i].load( std::memory_order_relaxed ) );
+    if ( count() == 0 || x.min() < min() )
+        min_.store( x.min(), std::memory_order_relaxed );
+    if ( x.max() > max() )
+        max_.store( x.max(), std::memory_order_relaxed );
+    single_writer_add( sum_, x.sum() );
+    single_writer_add( cnt_, cnt );
+}
+
+double latency_histogram::mean() const {
+    uint64_t cnt = count();
+    return ( cnt > 0 ) ? double( sum() ) / double( cnt ) : 0.0;
+}
+
+uint64_t latency_histogram::percentile( double lfPercentile ) const {
+    // buckets may be ahead of the count while their writer is busy, so walk them as they are
+    uint64_t cntAll = 0;
+    for ( const std::atomic< uint64_t >& b : buckets_ )
+        cntAll += b.load( std::memory_order_relaxed );
+    if ( cntAll == 0 )
+        return 0;
+    lfPercentile = std::min( std::max( lfPercentile, 0.0 ), 100.0 );
+    uint64_t nRank = uint64_t( std::ceil( lfPercentile / 100.0 * double( cntAll ) ) );
+    if ( nRank == 0 )
+        nRank = 1;
+    uint64_t cntSeen = 0;
+    size_t idxBucket = 0;
+    for ( ; idxBucket + 1 < bucket_count; ++idxBucket ) {
+        cntSeen += buckets_[idxBucket].load( std::memory_order_relaxed );
+        if ( cntSeen >= nRank )
+            break;
+    }
+    uint64_t nValue = std::min( bucket_highest( idxBucket ), max() );
+    return std::max( nValue, min() );
+}
+
+nlohmann::json latency_histogram::toJSON( double lfUnit ) const {
+    nlohmann::json jo = nlohmann::json::object();
+    jo["count"] = count();
+    jo["min"] = double( min() ) * lfUnit;
+    jo["max"] = double( max() ) * lfUnit;
+    jo["mean"] = mean() * lfUnit;
+    jo["p50"] = double( percentile( 50.0 ) ) * lfUnit;
+    jo["p90"] = double( percentile( 90.0 ) ) * lfUnit;
+    jo["p99"] = double( percentile( 99.0 ) ) * lfUnit;
+    jo["p999"] = double( percentile( 99.9 ) ) * lfUnit;
+    return jo;
+}
+
+namespace sharded {
+
+void method_totals_t::merge( const method_totals_t& x ) {
+    calls_ += x.calls_;
+    answers_ += x.answers_;
+    errors_ += x.errors_;
+    exceptions_ += x.exceptions_;
+    bytes_recv_ += x.bytes_recv_;
+    bytes_sent_ += x.bytes_sent_;
+    latency_.merge( x.latency_ );
+}
+
+namespace {
+
+// counters of one method in one thread, written by that thread only
+struct method_counters {
+    std::atomic< uint64_t > calls_{0}, answers_{0}, errors_{0}, exceptions_{0};
+    std::atomic< uint64_t > bytes_recv_{0}, bytes_sent_{0};
+    std::atomic< latency_histogram* > latency_{nullptr};  // allocated on first use, ~4KB
+    ~method_counters() { delete latency_.load(); }
+    void add_to( method_totals_t& totals ) const {
+        totals.calls_ += calls_.load( std::memory_order_relaxed );
+        totals.answers_ += answers_.load( std::memory_order_relaxed );
+        totals.errors_ += errors_.load( std::memory_order_relaxed );
+        totals.exceptions_ += exceptions_.load( std::memory_order_relaxed );
+        totals.bytes_recv_ += bytes_recv_.load( std::memory_order_relaxed );
+        totals.bytes_sent_ += bytes_sent_.load( std::memory_order_relaxed );
+        const latency_histogram* pLatency = latency_.load( std::memory_order_acquire );
+        if ( pLatency )
+            totals.latency_.merge( *pLatency );
+    }
+};
+
+// std::less<> finds methods by plain C strings without building keys
+typedef std::map< std::string, method_counters, std::less<> > map_method_counters_t;
+typedef std::map< std::string, map_method_counters_t, std::less<> > map_subsystem_counters_t;
+
+struct shard {
+    // the owning thread looks up without locking, it locks only to add new names
+    std::mutex mtx_;
+    map_subsystem_counters_t subsystems_;
+    std::atomic_bool isRetired_{false};
+
+    method_counters& counters( const char* strSubSystem, const char* strMethod ) {
+        map_subsystem_counters_t::iterator itSubSystem = subsystems_.find( strSubSystem );
+        if ( itSubSystem != subsystems_.end() ) {
+            map_method_counters_t::iterator itMethod = itSubSystem->second.find( strMethod );
+            if ( itMethod != itSubSystem->second.end() )
+                return itMethod->second;
+        }
+        std::lock_guard< std::mutex > lock( mtx_ );
+        return subsystems_[strSubSystem][strMethod];
+    }
+};
+typedef std::shared_ptr< shard > shard_ptr;
+
+struct shard_registry {
+    std::mutex mtx_;
+    std::vector< shard_ptr > shards_;
+    std::map< std::string, map_method_totals_t > retired_;  // totals of exited threads
+};
+
+shard_registry& get_shard_registry() {
+    static shard_registry* g_pRegistry = new shard_registry;
+    return *g_pRegistry;
+}
+
+struct shard_holder {
+    shard_ptr pShard_;
+    ~shard_holder() {
+        if ( pShard_ )
+            pShard_->isRetired_ = true;
+    }
+};
+
+method_counters& get_thread_counters( const char* strSubSystem, const char* strMethod ) {
+    static thread_local shard_holder g_holder;
+    if ( !g_holder.pShard_ ) {
+        g_holder.pShard_ = std::make_shared< shard >();
+        shard_registry& r = get_shard_registry();
+        std::lock_guard< std::mutex > lock( r.mtx_ );
+        r.shards_.push_back( g_holder.pShard_ );
+    }
+    return g_holder.pShard_->counters( strSubSystem ? strSubSystem : "",
+        strMethod ? strMethod : "" );
+}
+
+}  // namespace
+
+void register_call( const char* strSubSystem, const char* strMethod, bytes_count_t nBytes ) {
+    method_counters& c = get_thread_counters( strSubSystem, strMethod );
+    single_writer_add( c.calls_, 1 );
+    single_writer_add( c.bytes_recv_, nBytes );
+}
+void register_answer( const char* strSubSystem, const char* strMethod, bytes_count_t nBytes ) {
+    method_counters& c = get_thread_counters( strSubSystem, strMethod );
+    single_writer_add( c.answers_, 1 );
+    single_writer_add( c.bytes_sent_, nBytes );
+}
+void register_error( const char* strSubSystem, const char* strMethod ) {
+    single_writer_add( get_thread_counters( strSubSystem, strMethod ).errors_, 1 );
+}
+void register_exception( const char* strSubSystem, const char* strMethod ) {
+    single_writer_add( get_thread_counters( strSubSystem, strMethod ).exceptions_, 1 );
+}
+void register_latency( const char* strSubSystem, const char* strMethod, uint64_t nMicroseconds ) {
+    method_counters& c = get_thread_counters( strSubSystem, strMethod );
+    latency_histogram* pLatency = c.latency_.load( std::memory_order_relaxed );
+    if ( !pLatency ) {
+        pLatency = new latency_histogram;
+        c.latency_.store( pLatency, std::memory_order_release );
+    }
+    pLatency->add( nMicroseconds );
+}
+
+map_method_totals_t collect( const char* strSubSystem ) {
+    map_method_totals_t totals;
+    shard_registry& r = get_shard_registry();
+    std::lock_guard< std::mutex > lock( r.mtx_ );
+    // shards of exited threads are folded into retired totals once, then released
+    for ( const shard_ptr& pShard : r.shards_ ) {
+        if ( !pShard->isRetired_ )
+            continue;
+        for ( const auto& subsystem : pShard->subsystems_ )
+            for ( const auto& method : subsystem.second )
+                method.second.add_to( r.retired_[subsystem.first][method.first] );
+    }
+    r.shards_.erase( std::remove_if( r.shards_.begin(), r.shards_.end(),
+                         []( const shard_ptr& p ) { return p->isRetired_.load(); } ),
+        r.shards_.end() );
+    auto itRetired = r.retired_.find( strSubSystem );
+    if ( itRetired != r.retired_.end() )
+        totals = itRetired->second;
+    for ( const shard_ptr& pShard : r.shards_ ) {
+        std::lock_guard< std::mutex > lockShard( pShard->mtx_ );
+        auto itSubSystem = pShard->subsystems_.find( strSubSystem );
+        if ( itSubSystem == pShard->subsystems_.end() )
+            continue;
+        for ( const auto& method : itSubSystem->second )
+            method.second.add_to( totals[method.first] );
+    }
+    return totals;
+}
+
+};  // namespace sharded
+
 namespace time_tracker {
 
 const char element::g_strMethodNameUnknown[] = "unknown-method";
@@ -2,7 +2,10 @@
 #include <skutils/task_performance.h>
 #include <skutils/utils.h>
 
+#include <algorithm>
+#include <cstring>
 #include <exception>
+#include <memory>
 
 namespace skutils {
 namespace task {
@@ -291,8 +294,158 @@ json queue::compose_json( index_type minIndexT ) const {
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+atomic_bool g_bIsTracing( false );
+
+namespace {
+
+// events written by one thread, readers copy them out concurrently: every slot is guarded by
+// a sequence number which is odd while the slot is written and 2 * ( n + 1 ) once it keeps the
+// n-th event of the thread, so readers skip slots overwritten while they were copied
+class trace_ring {
+public:
+    static const size_t capacity = 4096;
+
+    void push( const trace_event& e ) {
+        uint64_t n = head_.load( std::memory_order_relaxed );
+        slot& s = slots_[n % capacity];
+        s.seq_.store( 2 * n + 1, std::memory_order_relaxed );
+        std::atomic_thread_fence( std::memory_order_release );
+        s.event_ = e;
+        s.seq_.store( 2 * n + 2, std::memory_order_release );
+        head_.store( n + 1, std::memory_order_release );
+    }
+
+    void collect( size_t session, std::vector< trace_event >& events ) const {
+        uint64_t head = head_.load( std::memory_order_acquire );
+        for ( uint64_t n = head > capacity ? head - capacity : 0; n < head; ++n ) {
+            const slot& s = slots_[n % capacity];
+            uint64_t seq = s.seq_.load( std::memory_order_acquire );
+            if ( seq != 2 * n + 2 )
+                continue;
+            trace_event e = s.event_;
+            std::atomic_thread_fence( std::memory_order_acquire );
+            if ( s.seq_.load( std::memory_order_relaxed ) != seq || e.session != session )
+                continue;
+            events.push_back( e );
+        }
+    }
+
+    atomic_bool isRetired_{false};  // owning thread has exited
+
+private:
+    struct slot {
+        std::atomic< uint64_t > seq_{0};
+        trace_event event_;
+    };
+    slot slots_[capacity];
+    std::atomic< uint64_t > head_{0};
+};
+
+typedef std::shared_ptr< trace_ring > trace_ring_ptr;
+
+// rings of all threads that recorded events, never destroyed to outlive thread local holders
+struct trace_registry {
+    std::mutex mtx_;
+    std::vector< trace_ring_ptr > rings_;
+    std::atomic_size_t session_{1};
+};
+
+trace_registry& get_trace_registry() {
+    static trace_registry* g_pRegistry = new trace_registry;
+    return *g_pRegistry;
+}
+
+struct trace_ring_holder {
+    trace_ring_ptr pRing_;
+    ~trace_ring_holder() {
+        if ( pRing_ )
+            pRing_->isRetired_ = true;
+    }
+};
+
+trace_ring& get_thread_trace_ring() {
+    static thread_local trace_ring_holder g_holder;
+    if ( !g_holder.pRing_ ) {
+        g_holder.pRing_ = std::make_shared< trace_ring >();
+        trace_registry& r = get_trace_registry();
+        std::lock_guard< std::mutex > lock( r.mtx_ );
+        r.rings_.push_back( g_holder.pRing_ );
+    }
+    return *g_holder.pRing_;
+}
+
+// tracker this process traces into, kept as plain pointer to avoid retaining it per event
+tracker& get_trace_tracker() {
+    static tracker* g_pTracker = get_default_tracker().get();
+    return *g_pTracker;
+}
+
+// drops events of the previous session together with rings of exited threads
+void start_trace_session() {
+    trace_registry& r = get_trace_registry();
+    std::lock_guard< std::mutex > lock( r.mtx_ );
+    ++r.session_;
+    r.rings_.erase( std::remove_if( r.rings_.begin(), r.rings_.end(),
+                        []( const trace_ring_ptr& p ) { return p->isRetired_.load(); } ),
+        r.rings_.end() );
+}
+
+json compose_trace_event_json( const trace_event& e, index_type indexQ ) {
+    json jsnIn = json::object();
+    if ( e.point->tag )
+        jsnIn[e.point->tag] = string( e.tag );
+    for ( size_t i = 0; i < trace_arg_count; ++i )
+        if ( e.point->args[i] )
+            jsnIn[e.point->args[i]] = e.args[i];
+    time_point tpStart( std::chrono::duration_cast< clock::duration >(
+        std::chrono::nanoseconds( e.nsStart ) ) );
+    time_point tpEnd(
+        std::chrono::duration_cast< clock::duration >( std::chrono::nanoseconds( e.nsEnd ) ) );
+    json jsn = json::object();
+    jsn["name"] = e.point->name;
+    jsn["iq"] = indexQ;
+    jsn["it"] = e.indexT;
+    jsn["jsnIn"] = jsnIn;
+    jsn["jsnOut"] = json::object();
+    jsn["jsnErr"] = json::object();
+    jsn["fin"] = true;
+    jsn["tsStart"] = cc::time2string( tpStart, true, false, false );
+    jsn["tsEnd"] = cc::time2string( tpEnd, true, false, false );
+    jsn["duration"] = cc::duration2string( std::chrono::nanoseconds( e.nsEnd - e.nsStart ) );
+    return jsn;
+}
+
+int64_t now_ns() {
+    return std::chrono::duration_cast< std::chrono::nanoseconds >(
+        clock::now().time_since_epoch() )
+        .count();
+}
+
+}  // namespace
+
+std::vector< trace_event > collect_trace_events( index_type minIndexT ) {
+    std::vector< trace_event > events;
+    trace_registry& r = get_trace_registry();
+    {  // block
+        std::lock_guard< std::mutex > lock( r.mtx_ );
+        size_t session = r.session_;
+        for ( const trace_ring_ptr& pRing : r.rings_ )
+            pRing->collect( session, events );
+    }  // block
+    events.erase( std::remove_if( events.begin(), events.end(),
+                      [minIndexT]( const trace_event& e ) { return e.indexT < minIndexT; } ),
+        events.end() );
+    std::sort( events.begin(), events.end(),
+        []( const trace_event& a, const trace_event& b ) { return a.indexT < b.indexT; } );
+    return events;
+}
+
 tracker_ptr get_default_tracker() {
-    static tracker_ptr g_pDefaultTracker = tracker_ptr::make();
+    static tracker_ptr g_pDefaultTracker = []() {
+        tracker_ptr pTracker = tracker_ptr::make();
+        pTracker->set_trace_sink();
+        return pTracker;
+    }();
     return g_pDefaultTracker;
 }
 
@@ -307,6 +460,18 @@ void tracker::reset() {
     lockable::lock_type lock( mtx() );
     map_.clear();
     index_holder::reset();
+    if ( isTraceSink_ )
+        start_trace_session();
+}
+
+void tracker::update_tracing() {
+    if ( isTraceSink_ )
+        g_bIsTracing = is_enabled() && is_running();
+}
+
+void tracker::set_trace_sink() {
+    isTraceSink_ = true;
+    update_tracing();
 }
 
 bool tracker::is_enabled() const {
@@ -325,6 +490,7 @@ void tracker::set_enabled( bool b ) {
     isEnabled_ = b;
     if ( !b )
         cancel();
+    update_tracing();
 }
 
 size_t tracker::get_safe_max_item_count() const {
@@ -356,6 +522,7 @@ void tracker::set_running( bool b ) {
     time_holder::set_running( b );
     if ( !b )
         reset();
+    update_tracing();
 }
 
 queue_ptr tracker::get_queue( const string& strName ) {
@@ -388,6 +555,19 @@ json tracker::compose_json( index_type minIndexT ) const {
             jsnQueues[strName] = pQueue->compose_json( minIndexT );
         }
     }  // block
+    if ( isTraceSink_ ) {
+        std::vector< trace_event > events = collect_trace_events();
+        std::map< string, index_type > mapIndicesQ;
+        for ( const trace_event& e : events ) {
+            index_type indexQ = mapIndicesQ[e.point->queue]++;
+            if ( e.indexT < minIndexT )
+                continue;
+            json& jarr = jsnQueues[e.point->queue];
+            if ( !jarr.is_array() )
+                jarr = json::array();
+            jarr.push_back( compose_trace_event_json( e, indexQ ) );
+        }
+    }
     jsn["queues"] = jsnQueues;
     jsn["nextTimeFetchIndex"] = idxFetchPointNextTime;
     jsn["tsStart"] = tp_start_s();  // entire session start, not time point of minIndexT
@@ -561,6 +741,49 @@ bool action::is_skipped() const {
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+void trace_scope::start( const trace_point& point, const string* pTag, uint64_t arg0,
+    uint64_t arg1, uint64_t arg2, uint64_t arg3 ) {
+    // the index is allocated even past limits, so that only the first event beyond them notes
+    // the stop reason under the tracker lock
+    tracker& t = get_trace_tracker();
+    index_type n = t.alloc_index();
+    if ( n >= t.get_safe_max_item_count() ) {
+        if ( n == t.get_safe_max_item_count() )
+            t.came_accross_with_possible_session_stop_reason( "max limit of events reached" );
+        return;
+    }
+    if ( n >= t.get_session_max_item_count() ) {
+        if ( n == t.get_session_max_item_count() )
+            t.came_accross_with_possible_session_stop_reason(
+                "number of requested of events saved" );
+        return;
+    }
+    event_.point = &point;
+    event_.session = get_trace_registry().session_.load( std::memory_order_relaxed );
+    event_.indexT = n;
+    event_.args[0] = arg0;
+    event_.args[1] = arg1;
+    event_.args[2] = arg2;
+    event_.args[3] = arg3;
+    if ( pTag ) {
+        size_t nLen = std::min( pTag->size(), trace_tag_size - 1 );
+        std::memcpy( event_.tag, pTag->data(), nLen );
+        event_.tag[nLen] = '\0';
+    }
+    event_.nsStart = now_ns();
+}
+
+void trace_scope::finish() {
+    if ( !event_.point )
+        return;
+    event_.nsEnd = now_ns();
+    get_thread_trace_ring().push( event_ );
+    event_.point = nullptr;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
 };  // namespace performance
 };  // namespace task
 };  // namespace skutils
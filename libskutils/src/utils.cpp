@@ -1623,10 +1623,46 @@ std::string generate_stack_trace( int nSkip, bool isExtended ) {
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+json_config_snapshot::json_config_snapshot( nlohmann::json&& joConfig, size_t nVersion )
+    : joConfig_( std::move( joConfig ) ), nVersion_( nVersion ) {
+    if ( joConfig_.is_object() )
+        for ( auto itWalk = joConfig_.cbegin(); itWalk != joConfig_.cend(); ++itWalk )
+            compile( itWalk.value(), itWalk.key() );
+}
+
+void json_config_snapshot::compile( const nlohmann::json& jo, const std::string& strPath ) {
+    mapPaths_.emplace( strPath, &jo );
+    if ( jo.is_array() ) {
+        lstArraySizes_.emplace_back( jo.size() );
+        for ( const char* strSizeName : {"count", "size", "length"} )
+            mapPaths_.emplace( strPath + "." + strSizeName, &lstArraySizes_.back() );
+        for ( size_t i = 0; i < jo.size(); ++i )
+            compile( jo[i], strPath + "." + std::to_string( i ) );
+        return;
+    }
+    if ( !jo.is_object() )
+        return;
+    for ( auto itWalk = jo.cbegin(); itWalk != jo.cend(); ++itWalk ) {
+        // such keys are not reached by splitting path at dots the same way
+        const std::string& strKey = itWalk.key();
+        if ( strKey.empty() || strKey.find( '.' ) != std::string::npos )
+            continue;
+        compile( itWalk.value(), strPath + "." + strKey );
+    }
+}
+
+nlohmann::json json_config_snapshot::extract_at_path( const std::string& strPath ) const {
+    auto itFind = mapPaths_.find( strPath );
+    if ( itFind != mapPaths_.end() )
+        return *itFind->second;
+    return json_config_file_accessor::stat_extract_at_path( joConfig_, strPath );
+}
+
 json_config_file_accessor::json_config_file_accessor( const std::string& configPath )
     : configPath_( configPath ),
       configModificationTime_( 0 ),
-      joConfig_( nlohmann::json::object() ) {}
+      pSnapshot_( std::make_shared< json_config_snapshot >( nlohmann::json::object(), 0 ) ),
+      nNextModificationCheckMs_( 0 ) {}
 json_config_file_accessor::~json_config_file_accessor() {}
 
 void json_config_file_accessor::reloadConfigIfNeeded() {
@@ -1643,7 +1679,9 @@ void json_config_file_accessor::reloadConfigIfNeeded() {
         std::ifstream ifs( configPath_.c_str() );
         std::cout << strLogPrefix << cc::debug( " Parsing configuration JSON ... " ) << "\n";
         nlohmann::json joNewConfig = nlohmann::json::parse( ifs );
-        joConfig_ = joNewConfig;
+        json_config_snapshot_ptr_t pNewSnapshot =
+            std::make_shared< json_config_snapshot >( std::move( joNewConfig ), ++nVersion_ );
+        std::atomic_store( &pSnapshot_, pNewSnapshot );
         configModificationTime_ = tt;
         std::cout << strLogPrefix << cc::success( " Done, loaded configuration file " )
                   << cc::p( configPath_ ) << "\n";
@@ -1661,9 +1699,26 @@ void json_config_file_accessor::reloadConfigIfNeeded() {
     }
 }
 
+json_config_snapshot_ptr_t json_config_file_accessor::getConfigSnapshot() {
+    uint64_t nNowMs = std::chrono::duration_cast< std::chrono::milliseconds >(
+        std::chrono::steady_clock::now().time_since_epoch() )
+                          .count();
+    uint64_t nNextMs = nNextModificationCheckMs_;
+    // first caller after interval checks file, others keep using current snapshot meanwhile
+    if ( nNowMs >= nNextMs && nNextModificationCheckMs_.compare_exchange_strong(
+                                  nNextMs, nNowMs + nModificationCheckIntervalMs_ ) )
+        reloadConfigIfNeeded();
+    json_config_snapshot_ptr_t pSnapshot = std::atomic_load( &pSnapshot_ );
+    if ( pSnapshot->version() == 0 ) {  // not loaded yet
+        reloadConfigIfNeeded();
+        pSnapshot = std::atomic_load( &pSnapshot_ );
+    }
+    return pSnapshot;
+}
+
 nlohmann::json json_config_file_accessor::getConfigJSON() {
     reloadConfigIfNeeded();
-    return joConfig_;
+    return std::atomic_load( &pSnapshot_ )->json();
 }
 
 
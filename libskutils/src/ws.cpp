@@ -3001,6 +3001,21 @@ std::string server_api::getPeerRemoteIP( connection_identifier_t cid ) {  // not
         return pcd->strPeerRemoteIP_;
     return "";
 }
+size_t server_api::getPeerPendingBytes( connection_identifier_t cid ) {
+    if ( !initialized_ )
+        return 0;
+    lock_type lock( mtx_api() );
+    map_connections_t::iterator itCnFind = connections_.find( cid ), itCnEnd = connections_.end();
+    if ( itCnFind == itCnEnd )
+        return 0;
+    server_api::connection_data* pcd = itCnFind->second;
+    if ( !pcd )
+        return 0;
+    size_t cnt = 0;
+    for ( const message_payload_data& data : pcd->buffer_ )
+        cnt += data.size();
+    return cnt;
+}
 peer_ptr_t server_api::getPeer( connection_identifier_t cid ) {
     if ( !initialized_ )
         return nullptr;
@@ -3527,6 +3542,9 @@ std::string peer::getRemoteIp() const {
 std::string peer::getOrigin() const {
     return srv_.getOrigin( hdl_ );
 }
+size_t peer::getPendingBytes() const {
+    return srv_.getPendingBytes( hdl_ );
+}
 
 std::string peer::getCidString() const {
     return stat_getCidString( cid_ );
@@ -3647,6 +3665,9 @@ std::string server::getRemoteIp( hdl_t hdl ) {
 std::string server::getOrigin( hdl_t hdl ) {
     return api_.getPeerClientAddressName( hdl );  // notice: used as "origin"
 }
+size_t server::getPendingBytes( hdl_t hdl ) {
+    return api_.getPeerPendingBytes( hdl );
+}
 bool server::sendMessage( hdl_t hdl, const std::string& msg, opcv eOpCode /*= opcv::text*/ ) {
     message_payload_data data;
     if ( eOpCode == opcv::binary )
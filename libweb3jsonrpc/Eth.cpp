@@ -525,6 +525,10 @@ Json::Value Eth::eth_getFilterLogs( string const& _filterId ) {
 Json::Value Eth::eth_getLogs( Json::Value const& _json ) {
     try {
         return toJson( client()->logs( toLogFilter( _json ) ) );
+    } catch ( TooManyLogs const& ) {
+        BOOST_THROW_EXCEPTION( JsonRpcException( Errors::ERROR_RPC_INVALID_PARAMS,
+            "Query returns more than " + toString( c_maxLogsPerResponse ) +
+                " results, narrow the block range or use \"offset\" and \"limit\"" ) );
     } catch ( ... ) {
         BOOST_THROW_EXCEPTION( JsonRpcException( Errors::ERROR_RPC_INVALID_PARAMS ) );
     }
@@ -436,6 +436,14 @@ dev::eth::LogFilter toLogFilter( Json::Value const& _json )  // commented to avo
                                                         // should and will fail
                 filter.topic( i, jsToFixed< 32 >( _json["topics"][i].asString() ) );
         }
+    // skaled extension for paging through large results
+    auto const fnCount = []( Json::Value const& _v ) -> size_t {
+        return _v.isString() ? size_t( jsToInt( _v.asString() ) ) : size_t( _v.asUInt64() );
+    };
+    if ( !_json["offset"].empty() )
+        filter.withOffset( fnCount( _json["offset"] ) );
+    if ( !_json["limit"].empty() )
+        filter.withLimit( fnCount( _json["limit"] ) );
     return filter;
 }
 
@@ -90,6 +90,9 @@ public:
         response = m_implementedModules;
     }
 
+    /// @returns true if a method or notification of this name is served.
+    virtual bool hasMethod( std::string const& _name ) const { return _name == "rpc_modules"; }
+
     virtual ~ModularServer() { StopListening(); }
 
     virtual void StartListening() {
@@ -157,6 +160,11 @@ public:
             this->m_implementedModules[module.name] = module.version;
     }
 
+    bool hasMethod( std::string const& _name ) const override {
+        return m_methods.count( _name ) || m_notifications.count( _name ) ||
+               ModularServer< Is... >::hasMethod( _name );
+    }
+
     virtual void HandleMethodCall(
         jsonrpc::Procedure& _proc, Json::Value const& _input, Json::Value& _output ) override {
         auto pointer = m_methods.find( _proc.GetProcedureName() );
@@ -29,6 +29,7 @@
 #include <libethereum/SkaleHost.h>
 
 #include "JsonHelper.h"
+#include "SnapshotDownloader.h"
 #include <libethcore/Common.h>
 #include <libethcore/CommonJS.h>
 
@@ -37,6 +38,7 @@
 
 #include <skutils/console_colors.h>
 #include <skutils/eth_utils.h>
+#include <skutils/http.h>
 
 #include <boost/algorithm/string.hpp>
 
@@ -145,6 +147,30 @@ nlohmann::json Skale::impl_skale_getSnapshot( const nlohmann::json& joRequest, C
 
     nlohmann::json joResponse = nlohmann::json::object();
 
+    // TODO check
+    unsigned blockNumber = joRequest["blockNumber"].get< unsigned >();
+
+    // files of the same snapshot differ from node to node, downloaders compare this hash instead
+    auto addSnapshotHash = [&]() {
+        try {
+            joResponse["snapshotHash"] =
+                dev::toHexPrefixed( client.getSnapshotHash( blockNumber ) );
+        } catch ( ... ) {
+            // not computed yet, downloaders will not use this node
+        }
+    };
+
+    // same file again, e.g. for another downloader
+    if ( currentSnapshotBlockNumber >= 0 && unsigned( currentSnapshotBlockNumber ) == blockNumber &&
+         fs::exists( currentSnapshotPath ) ) {
+        currentSnapshotTime = time( NULL );
+        joResponse["dataSize"] = fs::file_size( currentSnapshotPath );
+        joResponse["maxAllowedChunkSize"] = g_nMaxChunckSize;
+        joResponse["chunkHashes"] = currentSnapshotChunkHashes;
+        addSnapshotHash();
+        return joResponse;
+    }
+
     // exit if too early
     if ( currentSnapshotBlockNumber >= 0 &&
          time( NULL ) - currentSnapshotTime <= SNAPSHOT_DOWNLOAD_TIMEOUT ) {
@@ -155,14 +181,21 @@ nlohmann::json Skale::impl_skale_getSnapshot( const nlohmann::json& joRequest, C
         return joResponse;
     }
 
-    if ( currentSnapshotBlockNumber >= 0 )
+    if ( currentSnapshotBlockNumber >= 0 ) {
+        m_snapshotFragments.close();
         fs::remove( currentSnapshotPath );
+        currentSnapshotBlockNumber = -1;
+    }
 
-    // TODO check
-    unsigned blockNumber = joRequest["blockNumber"].get< unsigned >();
     currentSnapshotPath = client.createSnapshotFile( blockNumber );
+    // lets downloaders verify every chunk and fetch chunks of the same file from several nodes
+    currentSnapshotChunkHashes = nlohmann::json::array();
+    for ( const dev::h256& h :
+        snapshot::Downloader::chunkHashes( currentSnapshotPath, g_nMaxChunckSize ) )
+        currentSnapshotChunkHashes.push_back( dev::toHexPrefixed( h ) );
     currentSnapshotTime = time( NULL );
     currentSnapshotBlockNumber = blockNumber;
+    m_snapshotFragments.open( currentSnapshotPath );
 
     //
     //
@@ -171,6 +204,8 @@ nlohmann::json Skale::impl_skale_getSnapshot( const nlohmann::json& joRequest, C
     //
     joResponse["dataSize"] = sizeOfFile;
     joResponse["maxAllowedChunkSize"] = g_nMaxChunckSize;
+    joResponse["chunkHashes"] = currentSnapshotChunkHashes;
+    addSnapshotHash();
     return joResponse;
 }
 
@@ -204,10 +239,7 @@ std::vector< uint8_t > Skale::ll_impl_skale_downloadSnapshotFragment(
     f.open( fp.native(), std::ios::in | std::ios::binary );
     if ( !f.is_open() )
         throw std::runtime_error( "failed to open snapshot file" );
-    size_t i;
-    std::vector< uint8_t > buffer;
-    for ( i = 0; i < sizeOfChunk; ++i )
-        buffer.push_back( ( uint8_t )( 0 ) );
+    std::vector< uint8_t > buffer( sizeOfChunk );
     f.seekg( idxFrom );
     f.read( ( char* ) buffer.data(), sizeOfChunk );
     f.close();
@@ -217,44 +249,35 @@ std::vector< uint8_t > Skale::impl_skale_downloadSnapshotFragmentBinary(
     const nlohmann::json& joRequest ) {
     //    unsigned blockNumber = joRequest["blockNumber"].get< unsigned >();
     //    ... ...
-    fs::path fp = currentSnapshotPath;
-    //
     size_t idxFrom = joRequest["from"].get< size_t >();
-    size_t sizeOfChunk = joRequest["size"].get< size_t >();
-    size_t sizeOfFile = fs::file_size( fp );
-    if ( idxFrom >= sizeOfFile )
-        sizeOfChunk = 0;
-    if ( ( idxFrom + sizeOfChunk ) > sizeOfFile )
-        sizeOfChunk = sizeOfFile - idxFrom;
-    if ( sizeOfChunk > g_nMaxChunckSize )
-        sizeOfChunk = g_nMaxChunckSize;
-    std::vector< uint8_t > buffer =
-        Skale::ll_impl_skale_downloadSnapshotFragment( fp, idxFrom, sizeOfChunk );
-    return buffer;
+    size_t sizeOfChunk = std::min( joRequest["size"].get< size_t >(), g_nMaxChunckSize );
+    return m_snapshotFragments.read( idxFrom, sizeOfChunk );
 }
 nlohmann::json Skale::impl_skale_downloadSnapshotFragmentJSON( const nlohmann::json& joRequest ) {
     //    unsigned blockNumber = joRequest["blockNumber"].get< unsigned >();
     //    ... ...
-    fs::path fp = currentSnapshotPath;
-    //
     size_t idxFrom = joRequest["from"].get< size_t >();
-    size_t sizeOfChunk = joRequest["size"].get< size_t >();
-    size_t sizeOfFile = fs::file_size( fp );
-    if ( idxFrom >= sizeOfFile )
-        sizeOfChunk = 0;
-    if ( ( idxFrom + sizeOfChunk ) > sizeOfFile )
-        sizeOfChunk = sizeOfFile - idxFrom;
-    if ( sizeOfChunk > g_nMaxChunckSize )
-        sizeOfChunk = g_nMaxChunckSize;
-    std::vector< uint8_t > buffer =
-        Skale::ll_impl_skale_downloadSnapshotFragment( fp, idxFrom, sizeOfChunk );
-    std::string strBase64 = skutils::tools::base64::encode( buffer.data(), sizeOfChunk );
+    size_t sizeOfChunk = std::min( joRequest["size"].get< size_t >(), g_nMaxChunckSize );
+    std::vector< uint8_t > buffer = m_snapshotFragments.read( idxFrom, sizeOfChunk );
+    std::string strBase64 = skutils::tools::base64::encode( buffer.data(), buffer.size() );
     nlohmann::json joResponse = nlohmann::json::object();
-    joResponse["size"] = sizeOfChunk;
+    joResponse["size"] = buffer.size();
     joResponse["data"] = strBase64;
     return joResponse;
 }
 
+bool Skale::impl_skale_serveSnapshotFragment( const skutils::http::request& req,
+    const nlohmann::json& joRequest, skutils::http::response& res ) {
+    size_t idxFrom = joRequest["from"].get< size_t >();
+    size_t sizeOfChunk = std::min( joRequest["size"].get< size_t >(), g_nMaxChunckSize );
+    return m_snapshotFragments.serve( idxFrom, sizeOfChunk, req, res );
+}
+
+void Skale::impl_skale_serveSnapshotRange(
+    const skutils::http::request& req, skutils::http::response& res ) {
+    m_snapshotFragments.serveRange( req, res );
+}
+
 Json::Value Skale::skale_downloadSnapshotFragment( const Json::Value& request ) {
     try {
         Json::FastWriter fastWriter;
@@ -31,6 +31,7 @@
 #include <jsonrpccpp/server.h>
 #include <libethereum/Client.h>
 #include <libweb3jsonrpc/SkaleFace.h>
+#include <libweb3jsonrpc/SnapshotServer.h>
 #include <functional>
 #include <iosfwd>
 #include <libconsensus/thirdparty/json.hpp>
@@ -84,6 +85,14 @@ public:
     std::vector< uint8_t > impl_skale_downloadSnapshotFragmentBinary(
         const nlohmann::json& joRequest );
     nlohmann::json impl_skale_downloadSnapshotFragmentJSON( const nlohmann::json& joRequest );
+    // binary skale_downloadSnapshotFragment answer sent straight from the snapshot file
+    bool impl_skale_serveSnapshotFragment( const skutils::http::request& req,
+        const nlohmann::json& joRequest, skutils::http::response& res );
+    // GET of the snapshot file or of the range in the Range header
+    void impl_skale_serveSnapshotRange(
+        const skutils::http::request& req, skutils::http::response& res );
+
+    dev::rpc::snapshot::FragmentServer& snapshotFragmentServer() { return m_snapshotFragments; }
 
 private:
     static volatile bool g_bShutdownViaWeb3Enabled;
@@ -95,7 +104,10 @@ private:
     int currentSnapshotBlockNumber = -1;
     fs::path currentSnapshotPath;
     time_t currentSnapshotTime = 0;
+    /// hashes of currentSnapshotPath chunks, computed once when the file is created
+    nlohmann::json currentSnapshotChunkHashes = nlohmann::json::array();
     static const time_t SNAPSHOT_DOWNLOAD_TIMEOUT = 100;
+    dev::rpc::snapshot::FragmentServer m_snapshotFragments;
 };
 
 namespace snapshot {
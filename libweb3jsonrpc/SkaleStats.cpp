@@ -31,6 +31,8 @@
 #include <libdevcore/BMPBN.h>
 #include <libdevcore/Common.h>
 #include <libdevcore/CommonJS.h>
+#include <libdevcore/ManuallyRotatingLevelDB.h>
+#include <libevm/CodeCache.h>
 
 #include <skutils/console_colors.h>
 #include <skutils/eth_utils.h>
@@ -119,6 +121,89 @@ Json::Value SkaleStats::skale_stats() {
 
             joStats["tracepoints"] = joTrace;
 
+            SkaleHost::BroadcastStats broadcastStats = h->broadcastStats();
+            nlohmann::json joBroadcast = nlohmann::json::object();
+            joBroadcast["sentBatches"] = broadcastStats.sentBatches;
+            joBroadcast["sentTransactions"] = broadcastStats.sentTransactions;
+            joBroadcast["maxBatchSize"] = broadcastStats.maxBatchSize;
+            joBroadcast["averageBatchSize"] =
+                broadcastStats.sentBatches ?
+                    double( broadcastStats.sentTransactions ) / broadcastStats.sentBatches :
+                    0.0;
+            joBroadcast["maxLatencyMicroseconds"] = broadcastStats.maxLatencyMicroseconds;
+            joBroadcast["averageLatencyMicroseconds"] =
+                broadcastStats.sentBatches ?
+                    double( broadcastStats.totalLatencyMicroseconds ) / broadcastStats.sentBatches :
+                    0.0;
+            joBroadcast["receivedBatches"] = broadcastStats.receivedBatches;
+            joBroadcast["receivedTransactions"] = broadcastStats.receivedTransactions;
+            joStats["broadcast"] = joBroadcast;
+
+            dev::eth::VerifiedTransactionCache::Stats cacheStats =
+                c->verifiedTransactionCacheStats();
+            nlohmann::json joCache = nlohmann::json::object();
+            joCache["hits"] = cacheStats.hits;
+            joCache["misses"] = cacheStats.misses;
+            joCache["insertions"] = cacheStats.insertions;
+            joCache["evictions"] = cacheStats.evictions;
+            joCache["size"] = cacheStats.size;
+            joCache["capacity"] = cacheStats.capacity;
+            joStats["verifiedTransactionCache"] = joCache;
+
+            // from the current piece to the oldest one
+            nlohmann::json joPieces = nlohmann::json::array();
+            for ( const auto& piece : c->blockChain().rotatingDB()->pieceStats() ) {
+                nlohmann::json joPiece = nlohmann::json::object();
+                joPiece["probes"] = piece.probes;
+                joPiece["skippedByFilter"] = piece.skipped;
+                joPiece["hits"] = piece.hits;
+                joPiece["falsePositives"] = piece.falsePositives;
+                joPiece["filterKeys"] = piece.filterKeys;
+                joPiece["hitRate"] = piece.probes ? double( piece.hits ) / piece.probes : 0.0;
+                joPieces.push_back( joPiece );
+            }
+            joStats["blocksAndExtrasPieces"] = joPieces;
+
+            skale::OverlayReadCache::Stats stateCacheStats = c->state().dbReadCacheStats();
+            nlohmann::json joStateCache = nlohmann::json::object();
+            joStateCache["hits"] = stateCacheStats.hits;
+            joStateCache["misses"] = stateCacheStats.misses;
+            joStateCache["insertions"] = stateCacheStats.insertions;
+            joStateCache["evictions"] = stateCacheStats.evictions;
+            joStateCache["invalidations"] = stateCacheStats.invalidations;
+            joStateCache["entries"] = stateCacheStats.entries;
+            joStateCache["bytes"] = stateCacheStats.bytes;
+            joStateCache["capacityBytes"] = stateCacheStats.capacity;
+            joStats["stateReadCache"] = joStateCache;
+
+            dev::eth::CodeCache::Stats codeCacheStats = dev::eth::CodeCache::instance().stats();
+            nlohmann::json joCodeCache = nlohmann::json::object();
+            joCodeCache["hits"] = codeCacheStats.hits;
+            joCodeCache["misses"] = codeCacheStats.misses;
+            joCodeCache["evictions"] = codeCacheStats.evictions;
+            joCodeCache["entries"] = codeCacheStats.entries;
+            joCodeCache["bytes"] = codeCacheStats.bytes;
+            joCodeCache["capacityBytes"] = codeCacheStats.capacity;
+            joStats["codeCache"] = joCodeCache;
+
+            dev::eth::CallCache::Stats callCacheStats = c->callCacheStats();
+            nlohmann::json joCallCache = nlohmann::json::object();
+            joCallCache["hits"] = callCacheStats.hits;
+            joCallCache["misses"] = callCacheStats.misses;
+            joCallCache["joined"] = callCacheStats.joined;
+            joCallCache["bypassed"] = callCacheStats.bypassed;
+            joCallCache["evictions"] = callCacheStats.evictions;
+            joCallCache["invalidations"] = callCacheStats.invalidations;
+            joCallCache["entries"] = callCacheStats.size;
+            joCallCache["capacity"] = callCacheStats.capacity;
+            uint64_t const callCacheLookups =
+                callCacheStats.hits + callCacheStats.joined + callCacheStats.misses;
+            joCallCache["hitRate"] =
+                callCacheLookups ?
+                    double( callCacheStats.hits + callCacheStats.joined ) / callCacheLookups :
+                    0.0;
+            joStats["callCache"] = joCallCache;
+
         }  // if client
 
         std::string strStatsJson = joStats.dump();
@@ -0,0 +1,498 @@
+/*
+    Copyright (C) 2018-present, SKALE Labs
+
+    This file is part of skaled.
+
+    skaled is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skaled is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with skaled.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * @file SnapshotDownloader.cpp
+ * @date 2026
+ */
+
+#include "SnapshotDownloader.h"
+
+#include <libdevcore/Log.h>
+#include <libdevcore/RLP.h>
+#include <libdevcore/SHA3.h>
+
+#include <skutils/console_colors.h>
+#include <skutils/rest_call.h>
+
+#include <json.hpp>
+
+#include <boost/filesystem.hpp>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <map>
+#include <thread>
+
+using namespace std;
+using namespace dev;
+using namespace dev::rpc::snapshot;
+
+namespace fs = boost::filesystem;
+
+namespace {
+// a node answers "too early" while somebody else downloads its snapshot, we wait that long
+time_t const c_maxWaitForNodeSeconds = 110;
+}  // namespace
+
+h256 Downloader::Description::digest() const {
+    RLPStream s( 3 );
+    s << size << chunkSize;
+    s.appendVector( chunkHashes );
+    return sha3( s.out() );
+}
+
+Downloader::Downloader( vector< string > const& _urls, fs::path const& _saveTo )
+    : m_urls( _urls ), m_saveTo( _saveTo ) {}
+
+h256s Downloader::chunkHashes( fs::path const& _file, size_t _chunkSize ) {
+    ifstream f( _file.native(), ios::in | ios::binary );
+    if ( !f.is_open() )
+        throw runtime_error( "failed to open snapshot file \"" + _file.native() + "\"" );
+    h256s ret;
+    bytes buffer( _chunkSize );
+    while ( f ) {
+        f.read( reinterpret_cast< char* >( buffer.data() ), _chunkSize );
+        size_t const n = size_t( f.gcount() );
+        if ( n == 0 )
+            break;
+        ret.push_back( sha3( bytesConstRef( buffer.data(), n ) ) );
+    }
+    return ret;
+}
+
+fs::path Downloader::progressPath( fs::path const& _saveTo ) {
+    return _saveTo.string() + ".progress";
+}
+
+bool Downloader::describe(
+    string const& _url, unsigned _blockNumber, Description& o_description ) {
+    skutils::rest::client cli;
+    if ( !cli.open( _url ) )
+        return false;
+    nlohmann::json joIn = nlohmann::json::object();
+    joIn["jsonrpc"] = "2.0";
+    joIn["method"] = "skale_getSnapshot";
+    nlohmann::json joParams = nlohmann::json::object();
+    joParams["autoCreate"] = false;
+    joParams["blockNumber"] = _blockNumber;
+    joIn["params"] = joParams;
+    for ( bool waited = false;; waited = true ) {
+        skutils::rest::data_t d = cli.call( joIn );
+        if ( d.empty() )
+            return false;
+        nlohmann::json joSnapshotInfo = nlohmann::json::parse( d.s_ )["result"];
+        if ( joSnapshotInfo.count( "error" ) > 0 ) {
+            if ( waited || joSnapshotInfo.count( "timeValid" ) == 0 )
+                return false;
+            time_t const wait = joSnapshotInfo["timeValid"].get< time_t >() + 1 - time( NULL );
+            this_thread::sleep_for(
+                chrono::seconds( max< time_t >( 0, min( wait, c_maxWaitForNodeSeconds ) ) ) );
+            continue;
+        }
+        // nodes not serving snapshot and chunk hashes can't take part
+        if ( joSnapshotInfo.count( "snapshotHash" ) == 0 ||
+             joSnapshotInfo.count( "chunkHashes" ) == 0 )
+            return false;
+        o_description.stateHash = h256( joSnapshotInfo["snapshotHash"].get< string >() );
+        o_description.size = joSnapshotInfo["dataSize"].get< size_t >();
+        o_description.chunkSize = joSnapshotInfo["maxAllowedChunkSize"].get< size_t >();
+        o_description.chunkHashes.clear();
+        for ( auto const& h : joSnapshotInfo["chunkHashes"] )
+            o_description.chunkHashes.push_back( h256( h.get< string >() ) );
+        return o_description.chunkSize > 0 &&
+               o_description.chunkHashes.size() ==
+                   ( o_description.size + o_description.chunkSize - 1 ) /
+                       o_description.chunkSize;
+    }
+}
+
+void Downloader::open( h256 const& _digest ) {
+    size_t const cntChunks = m_description.chunkHashes.size();
+    m_chunks.assign( cntChunks, ChunkState::Missing );
+    m_fetching.assign( cntChunks, 0 );
+    m_fetchedFrom.assign( cntChunks, 0 );
+    m_done = 0;
+    m_nextMissing = 0;
+    m_requeued.clear();
+    m_stats.chunks = cntChunks;
+
+    // chunks recorded as finished by an earlier attempt on the same file
+    vector< uint8_t > finished;
+    {
+        ifstream f( progressPath( m_saveTo ).native(), ios::in | ios::binary );
+        h256 digest;
+        if ( f.read( reinterpret_cast< char* >( digest.data() ), h256::size ) &&
+             digest == _digest && fs::exists( m_saveTo ) &&
+             fs::file_size( m_saveTo ) == m_description.size ) {
+            finished.assign( cntChunks, 0 );
+            // a torn record at the end is ignored
+            uint8_t record[4];
+            while ( f.read( reinterpret_cast< char* >( record ), sizeof( record ) ) ) {
+                size_t const i = size_t( record[0] ) | size_t( record[1] ) << 8 |
+                                 size_t( record[2] ) << 16 | size_t( record[3] ) << 24;
+                if ( i < cntChunks )
+                    finished[i] = 1;
+            }
+        }
+    }
+
+    m_fd = ::open( m_saveTo.c_str(), O_RDWR | O_CREAT, 0644 );
+    if ( m_fd < 0 )
+        throw runtime_error( "failed to open snapshot file \"" + m_saveTo.native() + "\"" );
+    if ( finished.empty() ) {
+        if ( ::ftruncate( m_fd, 0 ) != 0 ||
+             ::ftruncate( m_fd, off_t( m_description.size ) ) != 0 )
+            throw runtime_error( "failed to resize snapshot file \"" + m_saveTo.native() + "\"" );
+    }
+
+    // what is on disk is verified again, it might not have been flushed
+    bytes buffer( m_description.chunkSize );
+    for ( size_t i = 0; i < finished.size(); ++i ) {
+        if ( !finished[i] )
+            continue;
+        size_t const offset = i * m_description.chunkSize;
+        size_t const n = min( m_description.chunkSize, m_description.size - offset );
+        if ( ::pread( m_fd, buffer.data(), n, off_t( offset ) ) != ssize_t( n ) ||
+             sha3( bytesConstRef( buffer.data(), n ) ) != m_description.chunkHashes[i] )
+            continue;
+        m_chunks[i] = ChunkState::Done;
+        ++m_done;
+        ++m_stats.resumed;
+    }
+    startProgress();
+}
+
+void Downloader::startProgress() {
+    // rewritten once per download, then only appended to
+    fs::path const path = progressPath( m_saveTo );
+    fs::path const tmp = path.string() + ".tmp";
+    {
+        ofstream f( tmp.native(), ios::out | ios::binary | ios::trunc );
+        f.write( reinterpret_cast< char const* >( m_digest.data() ), h256::size );
+        for ( size_t i = 0; i < m_chunks.size(); ++i )
+            if ( m_chunks[i] == ChunkState::Done ) {
+                uint8_t const record[4] = {uint8_t( i ), uint8_t( i >> 8 ), uint8_t( i >> 16 ),
+                    uint8_t( i >> 24 )};
+                f.write( reinterpret_cast< char const* >( record ), sizeof( record ) );
+            }
+        if ( !f )
+            return;  // resuming is an optimization only
+    }
+    boost::system::error_code ec;
+    fs::rename( tmp, path, ec );
+    if ( !ec )
+        m_progressFd = ::open( path.c_str(), O_WRONLY | O_APPEND );
+}
+
+void Downloader::recordProgress( size_t _chunk ) {
+    if ( m_progressFd < 0 )
+        return;
+    uint8_t const record[4] = {uint8_t( _chunk ), uint8_t( _chunk >> 8 ),
+        uint8_t( _chunk >> 16 ), uint8_t( _chunk >> 24 )};
+    // small O_APPEND writes don't interleave, so workers don't need m_mutex here
+    if ( ::write( m_progressFd, record, sizeof( record ) ) != ssize_t( sizeof( record ) ) ) {
+        ::close( m_progressFd );
+        m_progressFd = -1;
+    }
+}
+
+void Downloader::requeue( size_t _chunk ) {
+    if ( m_chunks[_chunk] == ChunkState::InFlight && m_fetching[_chunk] == 0 ) {
+        m_chunks[_chunk] = ChunkState::Missing;
+        m_requeued.push_back( _chunk );
+    }
+}
+
+bool Downloader::pick( size_t _node, size_t& o_chunk ) {
+    while ( !m_requeued.empty() ) {
+        size_t const chunk = m_requeued.back();
+        m_requeued.pop_back();
+        if ( m_chunks[chunk] == ChunkState::Missing ) {
+            o_chunk = chunk;
+            break;
+        }
+    }
+    if ( o_chunk == size_t( -1 ) ) {
+        while ( m_nextMissing < m_chunks.size() &&
+                m_chunks[m_nextMissing] != ChunkState::Missing )
+            ++m_nextMissing;
+        if ( m_nextMissing < m_chunks.size() )
+            o_chunk = m_nextMissing++;
+    }
+    if ( o_chunk != size_t( -1 ) ) {
+        m_chunks[o_chunk] = ChunkState::InFlight;
+        m_fetching[o_chunk] = 1;
+        m_fetchedFrom[o_chunk] = _node;
+        return true;
+    }
+
+    // nothing left to start, help with a chunk another node is still busy with
+    for ( size_t i = 0; i < m_chunks.size(); ++i ) {
+        if ( m_chunks[i] == ChunkState::InFlight && m_fetching[i] == 1 &&
+             m_fetchedFrom[i] != _node ) {
+            ++m_fetching[i];
+            ++m_stats.duplicated;
+            o_chunk = i;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool Downloader::fetch( skutils::rest::client& _cli, size_t _chunk, vector< uint8_t >& o_data,
+    size_t& o_retryAfter ) const {
+    nlohmann::json joIn = nlohmann::json::object();
+    joIn["jsonrpc"] = "2.0";
+    joIn["method"] = "skale_downloadSnapshotFragment";
+    nlohmann::json joParams = nlohmann::json::object();
+    joParams["blockNumber"] = "latest";
+    joParams["from"] = _chunk * m_description.chunkSize;
+    joParams["size"] = m_description.chunkSize;
+    joParams["isBinary"] = true;
+    joIn["params"] = joParams;
+    skutils::rest::data_t d =
+        _cli.call( joIn, true, skutils::rest::e_data_fetch_strategy::edfs_nearest_binary );
+    // node over its bandwidth budget
+    if ( d.status_ == 503 && d.retry_after_ > 0 )
+        o_retryAfter = d.retry_after_;
+    if ( d.empty() )
+        return false;
+    o_data.assign( d.s_.begin(), d.s_.end() );
+    return true;
+}
+
+void Downloader::work( size_t _node ) {
+    skutils::rest::client cli;
+    bool const opened = cli.open( m_nodes[_node].url );
+    vector< uint8_t > data;
+    for ( ;; ) {
+        size_t chunk = size_t( -1 );
+        {
+            unique_lock< mutex > lock( m_mutex );
+            if ( !opened ) {
+                m_nodes[_node].retired = true;
+                ++m_stats.failures;
+                m_changed.notify_all();
+                return;
+            }
+            for ( ;; ) {
+                if ( m_cancelled || m_nodes[_node].retired || m_done == m_chunks.size() )
+                    return;
+                if ( pick( _node, chunk ) )
+                    break;
+                m_changed.wait( lock );
+            }
+        }
+
+        size_t const offset = chunk * m_description.chunkSize;
+        size_t const size = min( m_description.chunkSize, m_description.size - offset );
+        bool ok = false;
+        size_t retryAfter = 0;
+        try {
+            ok = fetch( cli, chunk, data, retryAfter ) && data.size() == size &&
+                 sha3( bytesConstRef( data.data(), size ) ) == m_description.chunkHashes[chunk];
+        } catch ( ... ) {
+        }
+        if ( retryAfter > 0 ) {
+            // not a failure, the chunk goes to other nodes while this one is busy
+            unique_lock< mutex > lock( m_mutex );
+            --m_fetching[chunk];
+            requeue( chunk );
+            ++m_stats.throttled;
+            m_changed.notify_all();
+            m_changed.wait_for( lock,
+                chrono::seconds( min< size_t >( retryAfter, size_t( c_maxWaitForNodeSeconds ) ) ),
+                [this]() { return m_cancelled || m_done == m_chunks.size(); } );
+            continue;
+        }
+        for ( size_t written = 0; ok && written < size; ) {
+            ssize_t const n =
+                ::pwrite( m_fd, data.data() + written, size - written, off_t( offset + written ) );
+            if ( n < 0 && errno == EINTR )
+                continue;
+            if ( n <= 0 ) {
+                lock_guard< mutex > lock( m_mutex );
+                m_error = "failed to write snapshot file \"" + m_saveTo.native() + "\"";
+                m_cancelled = true;
+                m_changed.notify_all();
+                return;
+            }
+            written += size_t( n );
+        }
+        finish( chunk, ok, _node );
+    }
+}
+
+void Downloader::finish( size_t _chunk, bool _ok, size_t _node ) {
+    bool recorded = false;
+    unique_lock< mutex > lock( m_mutex );
+    --m_fetching[_chunk];
+    Node& node = m_nodes[_node];
+    if ( _ok ) {
+        node.failures = 0;
+        if ( m_chunks[_chunk] != ChunkState::Done ) {
+            m_chunks[_chunk] = ChunkState::Done;
+            ++m_done;
+            ++m_stats.downloaded;
+            recorded = true;
+            if ( m_onProgress && !m_onProgress( m_done, m_chunks.size() ) ) {
+                m_error = "fragment downloader stopped by callback";
+                m_cancelled = true;
+            }
+        }
+    } else {
+        ++m_stats.failures;
+        if ( ++node.failures >= c_maxNodeFailures ) {
+            node.retired = true;
+            clog( VerbosityWarning, "snapshot" )
+                << cc::warn( "Stopped downloading snapshot from " ) << cc::u( node.url );
+        }
+        requeue( _chunk );
+    }
+    m_changed.notify_all();
+    lock.unlock();
+    if ( recorded )
+        recordProgress( _chunk );
+}
+
+bool Downloader::download(
+    unsigned _blockNumber, fn_progress_t const& _onProgress, string& _error ) {
+    _error.clear();
+    m_onProgress = _onProgress;
+    m_cancelled = false;
+    m_error.clear();
+
+    // ask all nodes at once and group them by the file they describe
+    vector< Description > descriptions( m_urls.size() );
+    vector< char > described( m_urls.size(), 0 );
+    {
+        vector< thread > threads;
+        for ( size_t i = 0; i < m_urls.size(); ++i )
+            threads.emplace_back( [&, i]() {
+                try {
+                    described[i] = describe( m_urls[i], _blockNumber, descriptions[i] );
+                } catch ( ... ) {
+                }
+            } );
+        for ( auto& t : threads )
+            t.join();
+    }
+    // nodes with the same state serve different files, see the class description
+    map< h256, vector< size_t > > states;
+    for ( size_t i = 0; i < m_urls.size(); ++i )
+        if ( described[i] )
+            states[descriptions[i].stateHash].push_back( i );
+    auto state = states.end();
+    if ( expectedStateHash )
+        state = states.find( expectedStateHash );
+    else
+        for ( auto it = states.begin(); it != states.end(); ++it )
+            if ( state == states.end() || it->second.size() > state->second.size() ||
+                 ( it->second.size() == state->second.size() &&
+                     it->second.front() < state->second.front() ) )
+                state = it;
+    if ( state == states.end() ) {
+        _error = "no node described snapshot of block " + to_string( _blockNumber ) +
+                 ( expectedStateHash ? " with hash " + expectedStateHash.hex() :
+                                       " with snapshot and chunk hashes" );
+        return false;
+    }
+
+    // the file most nodes serve goes first
+    map< h256, vector< size_t > > filesByDigest;
+    for ( size_t i : state->second )
+        filesByDigest[descriptions[i].digest()].push_back( i );
+    vector< pair< h256, vector< size_t > > > files( filesByDigest.begin(), filesByDigest.end() );
+    sort( files.begin(), files.end(), []( auto const& _a, auto const& _b ) {
+        return _a.second.size() > _b.second.size() ||
+               ( _a.second.size() == _b.second.size() && _a.second.front() < _b.second.front() );
+    } );
+
+    bool complete = false;
+    for ( auto const& file : files ) {
+        m_digest = file.first;
+        m_description = descriptions[file.second.front()];
+        m_nodes.clear();
+        for ( size_t i : file.second ) {
+            Node node;
+            node.url = m_urls[i];
+            m_nodes.push_back( node );
+        }
+        m_stats.nodesUsed = m_nodes.size();
+        complete = downloadFile();
+        if ( complete || m_cancelled || !m_error.empty() )
+            break;
+        clog( VerbosityWarning, "snapshot" )
+            << cc::warn( "All nodes serving snapshot file failed, trying another file" );
+    }
+
+    if ( complete ) {
+        boost::system::error_code ec;
+        fs::remove( progressPath( m_saveTo ), ec );
+        return true;
+    }
+    _error = !m_error.empty() ? m_error :
+                                "all nodes failed, " + to_string( m_done ) + " of " +
+                                    to_string( m_chunks.size() ) + " chunks downloaded";
+    return false;
+}
+
+bool Downloader::downloadFile() {
+    try {
+        open( m_digest );
+        vector< thread > workers;
+        for ( size_t n = 0; n < m_nodes.size(); ++n )
+            for ( size_t w = 0; w < max< size_t >( workersPerNode, 1 ); ++w )
+                workers.emplace_back( [this, n]() { work( n ); } );
+        for ( auto& t : workers )
+            t.join();
+    } catch ( exception const& ex ) {
+        m_error = ex.what();
+    }
+
+    bool const complete = m_error.empty() && m_done == m_chunks.size();
+    if ( m_fd >= 0 ) {
+        if ( complete && ::fsync( m_fd ) != 0 )
+            m_error = "failed to flush snapshot file \"" + m_saveTo.native() + "\"";
+        ::close( m_fd );
+        m_fd = -1;
+    }
+    if ( m_progressFd >= 0 ) {
+        ::close( m_progressFd );
+        m_progressFd = -1;
+    }
+    return complete && m_error.empty();
+}
+
+Downloader::Stats Downloader::stats() const {
+    lock_guard< mutex > lock( m_mutex );
+    return m_stats;
+}
+
+vector< string > Downloader::nodesUsed() const {
+    lock_guard< mutex > lock( m_mutex );
+    vector< string > ret;
+    for ( Node const& node : m_nodes )
+        ret.push_back( node.url );
+    return ret;
+}
@@ -0,0 +1,161 @@
+/*
+    Copyright (C) 2018-present, SKALE Labs
+
+    This file is part of skaled.
+
+    skaled is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skaled is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with skaled.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * @file SnapshotDownloader.h
+ * @date 2026
+ */
+
+#pragma once
+
+#include <libdevcore/FixedHash.h>
+
+#include <boost/filesystem/path.hpp>
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace skutils {
+namespace rest {
+class client;
+}
+}  // namespace skutils
+
+namespace dev {
+namespace rpc {
+namespace snapshot {
+
+/**
+ * @brief Downloads a snapshot file in chunks from several nodes at once.
+ * Every node is asked for the snapshot description, i.e. hash of the snapshot state, file size,
+ * chunk size and hashes of all chunks; nodes describing the same state form the download group.
+ * The file is a btrfs send stream, which carries node-specific data, so nodes of the same state
+ * may serve different bytes. Nodes serving the same file share its chunks: workers of every
+ * node pull missing chunks from one queue, so slow nodes simply take fewer of them, and once the
+ * queue is empty idle workers duplicate chunks still in flight elsewhere. Chunks are verified
+ * against their hashes and written in place. Once all nodes of a file fail, the download starts
+ * over with another file of the same state. Finished chunks are recorded in a progress file
+ * next to the snapshot, so an interrupted download of the same file resumes.
+ */
+class Downloader {
+public:
+    /// Arguments are the number of finished and of all chunks; returns false to cancel.
+    typedef std::function< bool( size_t, size_t ) > fn_progress_t;
+
+    struct Stats {
+        size_t chunks = 0;
+        size_t resumed = 0;     ///< chunks found on disk from an earlier attempt
+        size_t downloaded = 0;  ///< chunks fetched and verified
+        size_t duplicated = 0;  ///< chunks fetched again from a second node at the end
+        size_t failures = 0;    ///< failed requests and chunks with wrong hash
+        size_t throttled = 0;   ///< requests a node asked to retry later
+        size_t nodesUsed = 0;
+    };
+
+    /// Failed requests after which a node is not asked any more.
+    static constexpr size_t c_maxNodeFailures = 3;
+
+    Downloader( std::vector< std::string > const& _urls, boost::filesystem::path const& _saveTo );
+
+    /// Parallel requests per node.
+    size_t workersPerNode = 2;
+    /// If set, only nodes describing the snapshot with this hash are used, e.g. the voted one;
+    /// otherwise nodes describing the state most of them agree on.
+    h256 expectedStateHash;
+
+    /// @returns true when the whole file is downloaded; otherwise sets @a _error and keeps
+    /// what was downloaded for the next attempt.
+    bool download( unsigned _blockNumber, fn_progress_t const& _onProgress, std::string& _error );
+
+    Stats stats() const;
+
+    /// @returns nodes the file was downloaded from, or the last file tried if all failed, known
+    /// once download() was called.
+    std::vector< std::string > nodesUsed() const;
+
+    /// @returns hashes of consecutive @a _chunkSize pieces of @a _file, as served along with the
+    /// snapshot description.
+    static h256s chunkHashes( boost::filesystem::path const& _file, size_t _chunkSize );
+
+    /// @returns path of the file recording finished chunks of @a _saveTo.
+    static boost::filesystem::path progressPath( boost::filesystem::path const& _saveTo );
+
+private:
+    struct Description {
+        h256 stateHash;  ///< same on all nodes with the same snapshot, unlike chunk hashes
+        size_t size = 0;
+        size_t chunkSize = 0;
+        h256s chunkHashes;
+        /// Identifies the file, nodes serving the same one can share its chunks.
+        h256 digest() const;
+    };
+
+    enum class ChunkState { Missing, InFlight, Done };
+
+    struct Node {
+        std::string url;
+        size_t failures = 0;  ///< in a row
+        bool retired = false;
+    };
+
+    bool describe( std::string const& _url, unsigned _blockNumber, Description& o_description );
+    /// Downloads the file of m_description from m_nodes. @returns true when it is complete.
+    bool downloadFile();
+    void open( h256 const& _digest );
+    /// Writes the progress file anew with chunks finished so far and opens it for appending.
+    void startProgress();
+    /// Appends @a _chunk to the progress file, called without m_mutex.
+    void recordProgress( size_t _chunk );
+    /// Puts @a _chunk back to the queue if nobody else is fetching it. Called under m_mutex.
+    void requeue( size_t _chunk );
+    bool pick( size_t _node, size_t& o_chunk );
+    void work( size_t _node );
+    /// Sets @a o_retryAfter to seconds the node asked to wait if it is over its bandwidth budget.
+    bool fetch( skutils::rest::client& _cli, size_t _chunk, std::vector< uint8_t >& o_data,
+        size_t& o_retryAfter ) const;
+    void finish( size_t _chunk, bool _ok, size_t _node );
+
+    std::vector< std::string > m_urls;
+    boost::filesystem::path m_saveTo;
+    Description m_description;
+    h256 m_digest;
+    int m_fd = -1;
+    int m_progressFd = -1;  ///< append-only, see recordProgress()
+
+    mutable std::mutex m_mutex;  ///< guards everything below
+    std::condition_variable m_changed;
+    std::vector< Node > m_nodes;
+    std::vector< ChunkState > m_chunks;
+    std::vector< unsigned > m_fetching;  ///< workers fetching every chunk
+    std::vector< size_t > m_fetchedFrom;  ///< node that got the chunk first
+    size_t m_done = 0;
+    size_t m_nextMissing = 0;  ///< no missing chunks before this one, except requeued ones
+    std::vector< size_t > m_requeued;
+    bool m_cancelled = false;
+    std::string m_error;
+    fn_progress_t m_onProgress;
+    Stats m_stats;
+};
+
+}  // namespace snapshot
+}  // namespace rpc
+}  // namespace dev
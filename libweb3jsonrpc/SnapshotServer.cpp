@@ -0,0 +1,232 @@
+/*
+    Copyright (C) 2018-present, SKALE Labs
+
+    This file is part of skaled.
+
+    skaled is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skaled is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with skaled.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * @file SnapshotServer.cpp
+ * @date 2026
+ */
+
+#include "SnapshotServer.h"
+
+#include <skutils/http.h>
+#include <skutils/url.h>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <stdexcept>
+
+using namespace std;
+using namespace dev::rpc::snapshot;
+
+namespace {
+// peers are told apart by address, so several connections of one node share its budget
+string peerOf( skutils::http::request const& _req ) {
+    try {
+        return skutils::url( _req.origin_.c_str() ).host();
+    } catch ( ... ) {
+        return _req.origin_;
+    }
+}
+}  // namespace
+
+BandwidthBudget::BandwidthBudget( size_t _bytesPerSecondPerPeer, size_t _bytesPerSecondTotal )
+    : m_bytesPerSecond( _bytesPerSecondPerPeer ), m_totalBytesPerSecond( _bytesPerSecondTotal ) {
+    // a second's worth of bytes to start with
+    m_total.tokens = double( _bytesPerSecondTotal );
+    m_total.refilled = chrono::steady_clock::now();
+}
+
+void BandwidthBudget::Bucket::refill( size_t _rate, chrono::steady_clock::time_point _now ) {
+    double const earned = _rate * chrono::duration< double >( _now - refilled ).count();
+    tokens = min( double( _rate ), tokens + earned );
+    refilled = _now;
+}
+
+chrono::nanoseconds BandwidthBudget::admit( string const& _peer, size_t _bytes ) {
+    size_t const rate = m_bytesPerSecond, totalRate = m_totalBytesPerSecond;
+    if ( rate == 0 && totalRate == 0 )
+        return chrono::nanoseconds( 0 );
+    lock_guard< mutex > lock( m_mutex );
+    auto const now = chrono::steady_clock::now();
+    Bucket* bucket = nullptr;
+    double wait = 0;  // seconds
+    if ( rate != 0 ) {
+        auto it = m_buckets.find( _peer );
+        if ( it == m_buckets.end() ) {
+            if ( m_buckets.size() >= c_maxIdleBuckets )
+                for ( auto i = m_buckets.begin(); i != m_buckets.end(); )
+                    i = now - i->second.refilled > chrono::seconds( 1 ) ? m_buckets.erase( i ) :
+                                                                          next( i );
+            // a new peer starts with a second's worth of bytes
+            it = m_buckets.emplace( _peer, Bucket{double( rate ), now} ).first;
+        }
+        bucket = &it->second;
+        bucket->refill( rate, now );
+        if ( bucket->tokens < 0 )
+            wait = -bucket->tokens / rate;
+    }
+    if ( totalRate != 0 ) {
+        m_total.refill( totalRate, now );
+        if ( m_total.tokens < 0 )
+            wait = max( wait, -m_total.tokens / totalRate );
+    }
+    if ( wait > 0 ) {
+        ++m_rejected;
+        return chrono::nanoseconds( max< int64_t >( int64_t( wait * 1e9 ), 1 ) );
+    }
+    if ( bucket )
+        bucket->tokens -= double( _bytes );
+    if ( totalRate != 0 )
+        m_total.tokens -= double( _bytes );
+    return chrono::nanoseconds( 0 );
+}
+
+FragmentServer::File::~File() {
+    if ( fd >= 0 )
+        ::close( fd );
+}
+
+FragmentServer::FragmentServer( size_t _bytesPerSecondPerPeer, size_t _bytesPerSecondTotal )
+    : m_budget( _bytesPerSecondPerPeer, _bytesPerSecondTotal ) {}
+
+void FragmentServer::open( boost::filesystem::path const& _file ) {
+    auto file = make_shared< File >();
+    file->fd = ::open( _file.c_str(), O_RDONLY | O_CLOEXEC );
+    if ( file->fd < 0 )
+        throw runtime_error( "failed to open snapshot file \"" + _file.string() + "\"" );
+    off_t const size = ::lseek( file->fd, 0, SEEK_END );
+    if ( size < 0 )
+        throw runtime_error( "failed to get size of snapshot file \"" + _file.string() + "\"" );
+    file->size = uint64_t( size );
+    // fragments are read in order by most downloaders
+    ::posix_fadvise( file->fd, 0, 0, POSIX_FADV_SEQUENTIAL );
+    lock_guard< mutex > lock( m_mutex );
+    m_file = file;
+}
+
+void FragmentServer::close() {
+    lock_guard< mutex > lock( m_mutex );
+    m_file.reset();
+}
+
+shared_ptr< FragmentServer::File > FragmentServer::current() const {
+    lock_guard< mutex > lock( m_mutex );
+    return m_file;
+}
+
+uint64_t FragmentServer::size() const {
+    auto file = current();
+    return file ? file->size : 0;
+}
+
+vector< uint8_t > FragmentServer::read( uint64_t _from, size_t _size ) const {
+    auto file = current();
+    if ( !file )
+        throw runtime_error( "no snapshot file is served" );
+    if ( _from >= file->size )
+        return vector< uint8_t >();
+    vector< uint8_t > buffer( size_t( min< uint64_t >( _size, file->size - _from ) ) );
+    for ( size_t done = 0; done < buffer.size(); ) {
+        ssize_t const n =
+            ::pread( file->fd, buffer.data() + done, buffer.size() - done, off_t( _from + done ) );
+        if ( n < 0 && errno == EINTR )
+            continue;
+        if ( n <= 0 )
+            throw runtime_error( "failed to read snapshot file" );
+        done += size_t( n );
+    }
+    return buffer;
+}
+
+bool FragmentServer::admit(
+    uint64_t _size, skutils::http::request const& _req, skutils::http::response& _res ) {
+    chrono::nanoseconds const wait = m_budget.admit( peerOf( _req ), size_t( _size ) );
+    if ( wait.count() == 0 )
+        return true;
+    // the worker is freed at once, the peer comes back when there is budget for it
+    auto const seconds = ( wait.count() + 999999999 ) / 1000000000;
+    _res.set_header( "Retry-After", to_string( seconds ).c_str() );
+    _res.status_ = 503;
+    return false;
+}
+
+void FragmentServer::setBody( shared_ptr< File > const& _file, uint64_t _from, uint64_t _size,
+    skutils::http::response& _res ) {
+    skutils::http::file_range range;
+    range.fd_ = _file->fd;
+    range.offset_ = _from;
+    range.length_ = _size;
+    range.owner_ = _file;
+    _res.set_file_content( range, "application/octet-stream" );
+    ++m_requests;
+    m_bytes += _size;
+}
+
+bool FragmentServer::serve( uint64_t _from, uint64_t _size, skutils::http::request const& _req,
+    skutils::http::response& _res ) {
+    auto file = current();
+    if ( !file )
+        return false;
+    _from = min( _from, file->size );
+    _size = min( _size, file->size - _from );
+    if ( admit( _size, _req, _res ) )
+        setBody( file, _from, _size, _res );
+    return true;
+}
+
+void FragmentServer::serveRange(
+    skutils::http::request const& _req, skutils::http::response& _res ) {
+    auto file = current();
+    if ( !file ) {
+        _res.status_ = 404;
+        return;
+    }
+    _res.set_header( "Accept-Ranges", "bytes" );
+    if ( !_req.has_header( "Range" ) ) {
+        if ( !admit( file->size, _req, _res ) )
+            return;
+        setBody( file, 0, file->size, _res );
+        _res.status_ = 200;
+        return;
+    }
+    uint64_t offset = 0, length = 0;
+    if ( !skutils::http::parse_range_header(
+             _req.get_header_value( "Range" ), file->size, offset, length ) ) {
+        _res.set_header( "Content-Range", ( "bytes */" + to_string( file->size ) ).c_str() );
+        _res.status_ = 416;
+        return;
+    }
+    if ( !admit( length, _req, _res ) )
+        return;
+    _res.set_header( "Content-Range", ( "bytes " + to_string( offset ) + "-" +
+                                          to_string( offset + length - 1 ) + "/" +
+                                          to_string( file->size ) )
+                                          .c_str() );
+    setBody( file, offset, length, _res );
+    _res.status_ = 206;
+}
+
+FragmentServer::Stats FragmentServer::stats() const {
+    Stats stats;
+    stats.requests = m_requests;
+    stats.bytes = m_bytes;
+    stats.rejected = m_budget.rejected();
+    return stats;
+}
@@ -0,0 +1,160 @@
+/*
+    Copyright (C) 2018-present, SKALE Labs
+
+    This file is part of skaled.
+
+    skaled is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skaled is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with skaled.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * @file SnapshotServer.h
+ * @date 2026
+ */
+
+#pragma once
+
+#include <boost/filesystem/path.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace skutils {
+namespace http {
+struct request;
+struct response;
+}  // namespace http
+}  // namespace skutils
+
+namespace dev {
+namespace rpc {
+namespace snapshot {
+
+/**
+ * @brief Token buckets limiting bytes sent per second to every peer and to all peers together.
+ * Connections of one peer share its bucket. A response is admitted while both its peer's bucket
+ * and the shared one have tokens left and is charged in full up front, so buckets can go into
+ * debt. Otherwise it is rejected with the time it takes to pay off the debt; nobody waits here.
+ */
+class BandwidthBudget {
+public:
+    /// Rates of 0 mean no limit.
+    BandwidthBudget( size_t _bytesPerSecondPerPeer, size_t _bytesPerSecondTotal );
+
+    void setBytesPerSecond( size_t _bytesPerSecond ) { m_bytesPerSecond = _bytesPerSecond; }
+    size_t bytesPerSecond() const { return m_bytesPerSecond; }
+    void setTotalBytesPerSecond( size_t _bytesPerSecond ) {
+        m_totalBytesPerSecond = _bytesPerSecond;
+    }
+    size_t totalBytesPerSecond() const { return m_totalBytesPerSecond; }
+
+    /// Charges @a _bytes to @a _peer and to all peers if neither is over its budget.
+    /// @returns 0 then, otherwise how long to wait before asking again.
+    std::chrono::nanoseconds admit( std::string const& _peer, size_t _bytes );
+
+    /// Responses rejected so far.
+    uint64_t rejected() const { return m_rejected; }
+
+private:
+    /// Buckets kept before idle ones, which are full anyway, are dropped.
+    static constexpr size_t c_maxIdleBuckets = 1024;
+
+    struct Bucket {
+        double tokens = 0;
+        std::chrono::steady_clock::time_point refilled;
+        void refill( size_t _rate, std::chrono::steady_clock::time_point _now );
+    };
+
+    std::atomic< size_t > m_bytesPerSecond;
+    std::atomic< size_t > m_totalBytesPerSecond;
+    std::mutex m_mutex;  ///< guards m_buckets and m_total
+    std::unordered_map< std::string, Bucket > m_buckets;
+    Bucket m_total;
+    std::atomic< uint64_t > m_rejected{0};
+};
+
+/**
+ * @brief Serves fragments of the current snapshot file to downloading nodes.
+ * The file is kept open and ranges of it are handed to the HTTP server, which sends them with
+ * sendfile() on plain sockets, so serving does not copy the file through user space. Responses
+ * are admitted by a BandwidthBudget so that downloads cannot starve block production; the rest
+ * get 503 with Retry-After.
+ */
+class FragmentServer {
+public:
+    struct Stats {
+        uint64_t requests = 0;
+        uint64_t bytes = 0;  ///< promised to peers, bodies cut by disconnects included
+        uint64_t rejected = 0;  ///< answered with 503, not counted in requests
+    };
+
+    static constexpr size_t c_defaultBytesPerSecondPerPeer = 64 * 1024 * 1024;
+    static constexpr size_t c_defaultBytesPerSecond = 128 * 1024 * 1024;
+
+    explicit FragmentServer( size_t _bytesPerSecondPerPeer = c_defaultBytesPerSecondPerPeer,
+        size_t _bytesPerSecondTotal = c_defaultBytesPerSecond );
+
+    /// Serves @a _file from now on. Responses still sending the previous file keep it open.
+    void open( boost::filesystem::path const& _file );
+    void close();
+
+    /// Size of the served file, 0 if there is none.
+    uint64_t size() const;
+
+    /// @returns bytes [@a _from, @a _from + @a _size) of the file, cut at its end.
+    /// Throws if no file is served.
+    std::vector< uint8_t > read( uint64_t _from, size_t _size ) const;
+
+    /// Makes @a _res send bytes [@a _from, @a _from + @a _size) of the file, cut at its end,
+    /// or answers 503 if the budget is exhausted. @returns false if no file is served.
+    bool serve( uint64_t _from, uint64_t _size, skutils::http::request const& _req,
+        skutils::http::response& _res );
+
+    /// Answers a GET of the whole file or of the range in its Range header.
+    void serveRange( skutils::http::request const& _req, skutils::http::response& _res );
+
+    BandwidthBudget& budget() { return m_budget; }
+
+    Stats stats() const;
+
+private:
+    struct File {
+        int fd = -1;
+        uint64_t size = 0;
+        ~File();
+    };
+
+    std::shared_ptr< File > current() const;
+    /// Answers 503 with Retry-After if sending @a _size bytes to the peer of @a _req is over
+    /// budget. @returns true if the response may be sent.
+    bool admit(
+        uint64_t _size, skutils::http::request const& _req, skutils::http::response& _res );
+    void setBody( std::shared_ptr< File > const& _file, uint64_t _from, uint64_t _size,
+        skutils::http::response& _res );
+
+    mutable std::mutex m_mutex;  ///< guards m_file
+    std::shared_ptr< File > m_file;
+    BandwidthBudget m_budget;
+
+    std::atomic< uint64_t > m_requests{0};
+    std::atomic< uint64_t > m_bytes{0};
+};
+
+}  // namespace snapshot
+}  // namespace rpc
+}  // namespace dev
@@ -26,6 +26,7 @@
  */
 
 #include <signal.h>
+#include <algorithm>
 #include <fstream>
 #include <iostream>
 #include <thread>
@@ -68,6 +69,7 @@
 #include <libweb3jsonrpc/Personal.h>
 #include <libweb3jsonrpc/Skale.h>
 #include <libweb3jsonrpc/SkaleStats.h>
+#include <libweb3jsonrpc/SnapshotDownloader.h>
 #include <libweb3jsonrpc/Test.h>
 #include <libweb3jsonrpc/Web3.h>
 
@@ -221,25 +223,46 @@ unsigned getLatestSnapshotBlockNumber( const std::string& strURLWeb3 ) {
     return block_number;
 }
 
-void downloadSnapshot( unsigned block_number, std::shared_ptr< SnapshotManager >& snapshotManager,
-    const std::string& strURLWeb3, const ChainParams& chainParams ) {
+/// @returns nodes the snapshot was downloaded from
+std::vector< std::string > downloadSnapshot( unsigned block_number,
+    std::shared_ptr< SnapshotManager >& snapshotManager, const std::vector< std::string >& urls,
+    const dev::h256& votedHash, const ChainParams& chainParams ) {
     fs::path saveTo;
+    std::vector< std::string > nodesUsed;
     try {
-        std::cout << cc::normal( "Will download snapshot from " ) << cc::u( strURLWeb3 )
-                  << std::endl;
+        std::cout << cc::normal( "Will download snapshot from " ) << cc::size10( urls.size() )
+                  << cc::normal( " node(s)" ) << std::endl;
 
         try {
-            bool isBinaryDownload = true;
             std::string strErrorDescription;
             saveTo = snapshotManager->getDiffPath( block_number );
-            bool bOK = dev::rpc::snapshot::download( strURLWeb3, block_number, saveTo,
-                [&]( size_t idxChunck, size_t cntChunks ) -> bool {
-                    std::cout << cc::normal( "... download progress ... " )
-                              << cc::size10( idxChunck ) << cc::normal( " of " )
-                              << cc::size10( cntChunks ) << "\r";
-                    return true;  // continue download
-                },
-                isBinaryDownload, &strErrorDescription );
+            auto fnProgress = [&]( size_t idxChunck, size_t cntChunks ) -> bool {
+                std::cout << cc::normal( "... download progress ... " ) << cc::size10( idxChunck )
+                          << cc::normal( " of " ) << cc::size10( cntChunks ) << "\r";
+                return true;  // continue download
+            };
+            dev::rpc::snapshot::Downloader downloader( urls, saveTo );
+            downloader.expectedStateHash = votedHash;
+            bool bOK = downloader.download( block_number, fnProgress, strErrorDescription );
+            nodesUsed = downloader.nodesUsed();
+            if ( !bOK && nodesUsed.empty() ) {
+                // nodes do not serve snapshot and chunk hashes, download from one in one stream
+                bool isBinaryDownload = true;
+                nodesUsed.push_back( urls.front() );
+                std::cout << cc::normal( "Will download snapshot from " )
+                          << cc::u( urls.front() ) << std::endl;
+                bOK = dev::rpc::snapshot::download( urls.front(), block_number, saveTo,
+                    fnProgress, isBinaryDownload, &strErrorDescription );
+            } else {
+                dev::rpc::snapshot::Downloader::Stats stats = downloader.stats();
+                clog( VerbosityInfo, "downloadSnapshot" )
+                    << cc::notice( "Snapshot chunks" ) << cc::debug( " downloaded: " )
+                    << cc::size10( stats.downloaded ) << cc::debug( ", resumed: " )
+                    << cc::size10( stats.resumed ) << cc::debug( ", duplicated: " )
+                    << cc::size10( stats.duplicated ) << cc::debug( ", failed requests: " )
+                    << cc::size10( stats.failures ) << cc::debug( ", nodes: " )
+                    << cc::size10( stats.nodesUsed );
+            }
             std::cout << "                                                  \r";  // clear
                                                                                   // progress
                                                                                   // line
@@ -277,7 +300,7 @@ void downloadSnapshot( unsigned block_number, std::shared_ptr< SnapshotManager >
             if ( db_path.empty() ) {
                 clog( VerbosityError, "downloadSnapshot" )
                     << cc::fatal( "Snapshot downloaded without " + prefix + " db" ) << std::endl;
-                return;
+                return nodesUsed;
             }
 
             fs::rename( db_path,
@@ -296,6 +319,7 @@ void downloadSnapshot( unsigned block_number, std::shared_ptr< SnapshotManager >
     }
     if ( !saveTo.empty() )
         fs::remove( saveTo );
+    return nodesUsed;
 }
 
 }  // namespace
@@ -493,6 +517,9 @@ int main( int argc, char** argv ) try {
     addClientOption(
         "async-http-transfer-mode", "Use asynchronous HTTP(S) query handling, default mode" );
     addClientOption( "sync-http-transfer-mode", "Use synchronous HTTP(S) query handling" );
+    addClientOption( "epoll-http-transfer-mode", po::value< size_t >()->value_name( "<threads>" ),
+        "Use edge-triggered epoll HTTP query handling with this number of I/O threads(0 is "
+        "default and keeps the mode above, HTTPS always keeps it)" );
 
     addClientOption( "acceptors", po::value< size_t >()->value_name( "<count>" ),
         "Number of parallel RPC connection(such as web3) acceptor threads per protocol(1 is "
@@ -504,6 +531,17 @@ int main( int argc, char** argv ) try {
 
     addClientOption( "max-batch", po::value< size_t >()->value_name( "<count>" ),
         "Maximum count of requests in JSON RPC batch request array" );
+    addClientOption( "max-batch-parallel", po::value< size_t >()->value_name( "<count>" ),
+        "Maximum count of requests from one JSON RPC batch request array executed in parallel" );
+    addClientOption( "ws-max-pending-bytes", po::value< size_t >()->value_name( "<bytes>" ),
+        "Maximum size of log subscription notifications queued for one WS peer, slower peers "
+        "are disconnected" );
+    addClientOption( "snapshot-download-bandwidth",
+        po::value< size_t >()->value_name( "<bytes per second>" ),
+        "Maximum speed of sending snapshot to one downloading node, 0 means no limit" );
+    addClientOption( "snapshot-download-total-bandwidth",
+        po::value< size_t >()->value_name( "<bytes per second>" ),
+        "Maximum speed of sending snapshot to all downloading nodes together, 0 means no limit" );
 
     addClientOption( "admin", po::value< string >()->value_name( "<password>" ),
         "Specify admin session key for JSON-RPC (default: auto-generated and printed at "
@@ -1194,7 +1232,8 @@ int main( int argc, char** argv ) try {
         snapshotManager.reset( new SnapshotManager(
             getDataDir(), {BlockChain::getChainDirName( chainParams ), "filestorage",
                               "prices_" + chainParams.nodeInfo.id.str() + ".db",
-                              "blocks_" + chainParams.nodeInfo.id.str() + ".db"} ) );
+                              "blocks_" + chainParams.nodeInfo.id.str() + ".db"},
+            chainParams.sChain.snapshotHashForkBlock ) );
 
     bool isStartedFromSnapshot = false;
     if ( vm.count( "download-snapshot" ) ) {
@@ -1240,12 +1279,11 @@ int main( int argc, char** argv ) try {
             }
 
             bool successfullDownload = false;
-            for ( size_t i = 0; i < list_urls_to_download.size(); ++i ) {
-                std::string urlToDownloadSnapshot;
-                urlToDownloadSnapshot = list_urls_to_download[i];
-
-                downloadSnapshot(
-                    blockNumber, snapshotManager, urlToDownloadSnapshot, chainParams );
+            // all nodes at once, without the ones a wrong snapshot came from on next attempts
+            std::vector< std::string > urlsToDownloadSnapshot = list_urls_to_download;
+            while ( !urlsToDownloadSnapshot.empty() ) {
+                std::vector< std::string > nodesUsed = downloadSnapshot( blockNumber,
+                    snapshotManager, urlsToDownloadSnapshot, voted_hash.first, chainParams );
 
                 try {
                     snapshotManager->computeSnapshotHash( blockNumber, true );
@@ -1264,6 +1302,13 @@ int main( int argc, char** argv ) try {
                 } else {
                     snapshotManager->removeSnapshot( blockNumber );
                 }
+
+                if ( nodesUsed.empty() )
+                    break;
+                for ( const std::string& url : nodesUsed )
+                    urlsToDownloadSnapshot.erase( std::remove( urlsToDownloadSnapshot.begin(),
+                                                      urlsToDownloadSnapshot.end(), url ),
+                        urlsToDownloadSnapshot.end() );
             }
 
             if ( !successfullDownload ) {
@@ -1880,7 +1925,12 @@ int main( int argc, char** argv ) try {
             //
             size_t maxConnections = 0,
                    max_http_handler_queues = __SKUTILS_HTTP_DEFAULT_MAX_PARALLEL_QUEUES_COUNT__,
-                   cntServers = 1, cntInBatch = 128;
+                   cntServers = 1, cntInBatch = 128, cntInBatchParallel = 8,
+                   cntWsMaxPendingBytes = 16 * 1024 * 1024,
+                   cntSnapshotDownloadBandwidth =
+                       rpc::snapshot::FragmentServer::c_defaultBytesPerSecondPerPeer,
+                   cntSnapshotDownloadTotalBandwidth =
+                       rpc::snapshot::FragmentServer::c_defaultBytesPerSecond;
             bool is_async_http_transfer_mode = true;
 
             // First, get "max-connections" true/false from config.json
@@ -1925,6 +1975,21 @@ int main( int argc, char** argv ) try {
             if ( vm.count( "sync-http-transfer-mode" ) )
                 is_async_http_transfer_mode = false;
 
+            // First, get "epoll-http-transfer-mode" I/O thread count from config.json
+            // Second, get it from command line parameter (higher priority source)
+            size_t http_epoll_io_threads = 0;
+            if ( chainConfigParsed ) {
+                try {
+                    http_epoll_io_threads =
+                        joConfig["skaleConfig"]["nodeInfo"]["epoll-http-transfer-mode"]
+                            .get< size_t >();
+                } catch ( ... ) {
+                    http_epoll_io_threads = 0;
+                }
+            }
+            if ( vm.count( "epoll-http-transfer-mode" ) )
+                http_epoll_io_threads = vm["epoll-http-transfer-mode"].as< size_t >();
+
             // First, get "acceptors" true/false from config.json
             // Second, get it from command line parameter (higher priority source)
             if ( chainConfigParsed ) {
@@ -1953,6 +2018,66 @@ int main( int argc, char** argv ) try {
             if ( cntInBatch < 1 )
                 cntInBatch = 1;
 
+            // First, get "max-batch-parallel" from config.json
+            // Second, get it from command line parameter (higher priority source)
+            if ( chainConfigParsed ) {
+                try {
+                    cntInBatchParallel =
+                        joConfig["skaleConfig"]["nodeInfo"]["max-batch-parallel"].get< size_t >();
+                } catch ( ... ) {
+                    cntInBatchParallel = 8;
+                }
+            }
+            if ( vm.count( "max-batch-parallel" ) )
+                cntInBatchParallel = vm["max-batch-parallel"].as< size_t >();
+            if ( cntInBatchParallel < 1 )
+                cntInBatchParallel = 1;
+
+            // First, get "ws-max-pending-bytes" from config.json
+            // Second, get it from command line parameter (higher priority source)
+            if ( chainConfigParsed ) {
+                try {
+                    cntWsMaxPendingBytes =
+                        joConfig["skaleConfig"]["nodeInfo"]["ws-max-pending-bytes"]
+                            .get< size_t >();
+                } catch ( ... ) {
+                    cntWsMaxPendingBytes = 16 * 1024 * 1024;
+                }
+            }
+            if ( vm.count( "ws-max-pending-bytes" ) )
+                cntWsMaxPendingBytes = vm["ws-max-pending-bytes"].as< size_t >();
+
+            // First, get "snapshot-download-bandwidth" from config.json
+            // Second, get it from command line parameter (higher priority source)
+            if ( chainConfigParsed ) {
+                try {
+                    cntSnapshotDownloadBandwidth =
+                        joConfig["skaleConfig"]["nodeInfo"]["snapshot-download-bandwidth"]
+                            .get< size_t >();
+                } catch ( ... ) {
+                    cntSnapshotDownloadBandwidth =
+                        rpc::snapshot::FragmentServer::c_defaultBytesPerSecondPerPeer;
+                }
+            }
+            if ( vm.count( "snapshot-download-bandwidth" ) )
+                cntSnapshotDownloadBandwidth = vm["snapshot-download-bandwidth"].as< size_t >();
+
+            // First, get "snapshot-download-total-bandwidth" from config.json
+            // Second, get it from command line parameter (higher priority source)
+            if ( chainConfigParsed ) {
+                try {
+                    cntSnapshotDownloadTotalBandwidth =
+                        joConfig["skaleConfig"]["nodeInfo"]["snapshot-download-total-bandwidth"]
+                            .get< size_t >();
+                } catch ( ... ) {
+                    cntSnapshotDownloadTotalBandwidth =
+                        rpc::snapshot::FragmentServer::c_defaultBytesPerSecond;
+                }
+            }
+            if ( vm.count( "snapshot-download-total-bandwidth" ) )
+                cntSnapshotDownloadTotalBandwidth =
+                    vm["snapshot-download-total-bandwidth"].as< size_t >();
+
             // First, get "ws-mode" true/false from config.json
             // Second, get it from command line parameter (higher priority source)
             if ( chainConfigParsed ) {
@@ -2004,10 +2129,24 @@ int main( int argc, char** argv ) try {
             clog( VerbosityInfo, "main" ) << cc::debug( "...." ) + cc::info( "Asynchronous HTTP" )
                                           << cc::debug( "........................ " )
                                           << cc::yn( is_async_http_transfer_mode );
+            clog( VerbosityInfo, "main" )
+                << cc::debug( "...." ) + cc::info( "Epoll HTTP I/O threads" )
+                << cc::debug( "................... " )
+                << ( ( http_epoll_io_threads > 0 ) ? cc::size10( http_epoll_io_threads ) :
+                                                     cc::notice( "off" ) );
             //
             clog( VerbosityInfo, "main" )
                 << cc::debug( "...." ) + cc::info( "Max count in batch JSON RPC request" )
                 << cc::debug( "...... " ) << cc::size10( cntInBatch );
+            clog( VerbosityInfo, "main" )
+                << cc::debug( "...." ) + cc::info( "Max parallel in batch JSON RPC request" )
+                << cc::debug( "... " ) << cc::size10( cntInBatchParallel );
+            clog( VerbosityInfo, "main" )
+                << cc::debug( "...." ) + cc::info( "Max pending WS log notification bytes" )
+                << cc::debug( ".... " ) << cc::size10( cntWsMaxPendingBytes );
+            clog( VerbosityInfo, "main" )
+                << cc::debug( "...." ) + cc::info( "Snapshot download bytes per second" )
+                << cc::debug( "....... " ) << cc::size10( cntSnapshotDownloadBandwidth );
             clog( VerbosityInfo, "main" )
                 << cc::debug( "...." ) + cc::info( "Parallel RPC connection acceptors" )
                 << cc::debug( "........ " ) << cc::size10( cntServers );
@@ -2025,7 +2164,27 @@ int main( int argc, char** argv ) try {
                 strPathSslCert, lfExecutionDurationMaxForPerformanceWarning );
             skale_server_connector->max_http_handler_queues_ = max_http_handler_queues;
             skale_server_connector->is_async_http_transfer_mode_ = is_async_http_transfer_mode;
+            skale_server_connector->http_epoll_io_threads_ = http_epoll_io_threads;
             skale_server_connector->maxCountInBatchJsonRpcRequest_ = cntInBatch;
+            skale_server_connector->maxParallelInBatchJsonRpcRequest_ = cntInBatchParallel;
+            skale_server_connector->maxPendingLogNotificationBytesPerPeer_ = cntWsMaxPendingBytes;
+            ModularServer<>* pJsonRpcServer = jsonrpcIpcServer.get();
+            skale_server_connector->setKnownMethods(
+                [pJsonRpcServer]( const std::string& strMethod ) {
+                    return pJsonRpcServer->hasMethod( strMethod );
+                } );
+            skaleFace->snapshotFragmentServer().budget().setBytesPerSecond(
+                cntSnapshotDownloadBandwidth );
+            skaleFace->snapshotFragmentServer().budget().setTotalBytesPerSecond(
+                cntSnapshotDownloadTotalBandwidth );
+            skale_server_connector->setSnapshotFileServing(
+                [=]( const skutils::http::request& req, const nlohmann::json& joParams,
+                    skutils::http::response& res ) -> bool {
+                    return skaleFace->impl_skale_serveSnapshotFragment( req, joParams, res );
+                },
+                [=]( const skutils::http::request& req, skutils::http::response& res ) {
+                    skaleFace->impl_skale_serveSnapshotRange( req, res );
+                } );
             //
             skaleStatsFace->setProvider( skale_server_connector );
             skale_server_connector->setConsumer( skaleStatsFace );
@@ -43,8 +43,8 @@ using skale::State;
 
 FakeExtVM::FakeExtVM( EnvInfo const& _envInfo, unsigned _depth )
     :  /// TODO: XXX: remove the default argument & fix.
-      ExtVMFace( _envInfo, Address(), Address(), Address(), 0, 1, bytesConstRef(), bytes(),
-          EmptySHA3, 0, _depth, false, false ) {}
+      ExtVMFace( _envInfo, Address(), Address(), Address(), 0, 1, bytesConstRef(),
+          bytesConstRef(), EmptySHA3, 0, _depth, false, false ) {}
 
 CreateResult FakeExtVM::create(
     u256 _endowment, u256& io_gas, bytesConstRef _init, Instruction, u256, OnOpFunc const& ) {
@@ -183,12 +183,12 @@ void FakeExtVM::importExec( mObject const& _o ) {
     execGas = gas;
 
     thisTxCode.clear();
-    code = thisTxCode;
+    code = bytesConstRef();
 
     thisTxCode = importCode( _o );
     if ( _o.count( "code" ) == 0 ||
          ( _o.at( "code" ).type() != str_type && _o.at( "code" ).type() != array_type ) )
-        code.clear();
+        code = bytesConstRef();
 
     thisTxData.clear();
     thisTxData = importData( _o );
@@ -326,7 +326,7 @@ json_spirit::mValue VmTestSuite::doTests( json_spirit::mValue const& _input, boo
         fev.importExec( testInput.at( "exec" ).get_obj() );
         if ( fev.code.empty() ) {
             fev.thisTxCode = get< 3 >( fev.addresses.at( fev.myAddress ) );
-            fev.code = fev.thisTxCode;
+            fev.code = &fev.thisTxCode;
         }
         fev.codeHash = sha3( fev.code );
 
@@ -1,19 +1,27 @@
 #include <libdevcore/Common.h>
 #include <libdevcore/CommonIO.h>
+#include <libdevcore/KeyBloomFilter.h>
 #include <libdevcore/Log.h>
 #include <libdevcore/ManuallyRotatingLevelDB.h>
+#include <libdevcore/MultisetHash.h>
 #include <libdevcore/SplitDB.h>
 #include <libdevcore/TransientDirectory.h>
+#include <libdevcrypto/Hash.h>
+#include <test/tools/libtesteth/TestHelper.h>
 #include <test/tools/libtesteth/TestOutputHelper.h>
 #include <boost/test/unit_test.hpp>
 
 #include <skutils/console_colors.h>
 
+#include <chrono>
+
 using namespace std;
 
 using namespace dev::test;
 using namespace dev;
 
+namespace utf = boost::unit_test;
+
 BOOST_FIXTURE_TEST_SUITE( LevelDBTests, TestOutputHelperFixture )
 
 void test_leveldb( db::DatabaseFace* db ) {
@@ -89,6 +97,192 @@ BOOST_AUTO_TEST_CASE( ordinary_test ) {
     test_leveldb( &leveldb );
 }
 
+BOOST_AUTO_TEST_CASE( incremental_hash_test ) {
+    TransientDirectory td1, td2;
+    h256 hash;
+    {
+        db::LevelDB db1( td1.path() );
+        db1.enableDigests();
+        BOOST_REQUIRE_EQUAL( db1.hashBase(), db1.recomputeHashBase() );
+
+        for ( int i = 0; i < 100; ++i )
+            db1.insert( to_string( i ), "old " + to_string( i ) );
+        std::unique_ptr< db::WriteBatchFace > b = db1.createWriteBatch();
+        for ( int i = 0; i < 100; i += 2 ) {
+            b->insert( to_string( i ), "tmp " + to_string( i ) );
+            b->insert( to_string( i ), "new " + to_string( i ) );
+        }
+        b->kill( string( "1" ) );
+        b->insert( string( "1" ), string( "new 1" ) );
+        db1.commit( std::move( b ) );
+        for ( int i = 3; i < 100; i += 2 )
+            db1.kill( to_string( i ) );
+        db1.kill( string( "no-key" ) );
+
+        hash = db1.hashBase();
+        BOOST_REQUIRE_EQUAL( hash, db1.recomputeHashBase() );
+    }
+
+    // same records written in other order give the same hash, with digests or without
+    db::LevelDB db2( td2.path() );
+    for ( int i = 99; i >= 0; --i )
+        if ( i % 2 == 0 || i == 1 )
+            db2.insert( to_string( i ), "new " + to_string( i ) );
+    BOOST_REQUIRE_EQUAL( db2.hashBase(), hash );
+
+    // digests are persisted
+    db::LevelDB db1( td1.path() );
+    BOOST_REQUIRE( db1.hasStoredDigests() );
+    db1.enableDigests();
+    BOOST_REQUIRE_EQUAL( db1.hashBase(), hash );
+}
+
+BOOST_AUTO_TEST_CASE( digests_are_opt_in_test ) {
+    TransientDirectory td;
+    h256 hash;
+    {
+        db::LevelDB db( td.path() );
+        BOOST_REQUIRE( !db.digestsEnabled() );
+        for ( int i = 0; i < 10; ++i )
+            db.insert( to_string( i ), "value " + to_string( i ) );
+        BOOST_REQUIRE( !db.hasStoredDigests() );
+        hash = db.hashBase();
+        BOOST_REQUIRE_EQUAL( hash, db.recomputeHashBase() );
+    }
+    {
+        // enabling computes digests of records written so far
+        db::LevelDB db( td.path() );
+        db.enableDigests();
+        BOOST_REQUIRE( db.hasStoredDigests() );
+        BOOST_REQUIRE_EQUAL( db.hashBase(), hash );
+    }
+    {
+        // hashing without digests doesn't write, so checked snapshots are left as they are
+        db::LevelDB db( td.path() );
+        BOOST_REQUIRE_EQUAL( db.recomputeHashBase(), hash );
+        BOOST_REQUIRE( db.hasStoredDigests() );
+        // but a write without digests makes the stored ones stale
+        db.insert( string( "10" ), string( "value 10" ) );
+        BOOST_REQUIRE( !db.hasStoredDigests() );
+        hash = db.hashBase();
+    }
+    db::LevelDB db( td.path() );
+    BOOST_REQUIRE( !db.hasStoredDigests() );
+    db.enableDigests();
+    BOOST_REQUIRE_EQUAL( db.hashBase(), hash );
+    BOOST_REQUIRE_EQUAL( db.recomputeHashBase(), hash );
+}
+
+BOOST_AUTO_TEST_CASE( multiset_hash_test ) {
+    MultisetHash empty, ab, ba;
+    BOOST_REQUIRE( empty.empty() );
+    ab.insert( sha3( "a" ) );
+    ab.insert( sha3( "b" ) );
+    ba.insert( sha3( "b" ) );
+    ba.insert( sha3( "a" ) );
+    BOOST_REQUIRE( ab == ba );
+    BOOST_REQUIRE( !ab.empty() );
+
+    // a multiset, not a set
+    MultisetHash aab = ab;
+    aab.insert( sha3( "a" ) );
+    BOOST_REQUIRE( aab != ab );
+    aab.erase( sha3( "a" ) );
+    BOOST_REQUIRE( aab == ab );
+
+    MultisetHash a, b;
+    a.insert( sha3( "a" ) );
+    b.insert( sha3( "b" ) );
+    a += b;
+    BOOST_REQUIRE( a == ab );
+    a.erase( sha3( "a" ) );
+    a.erase( sha3( "b" ) );
+    BOOST_REQUIRE( a.empty() );
+    BOOST_REQUIRE_EQUAL( a.hash(), empty.hash() );
+
+    bytes const serialized = ab.toBytes();
+    BOOST_REQUIRE_EQUAL( serialized.size(), MultisetHash::c_size );
+    BOOST_REQUIRE( MultisetHash( &serialized ) == ab );
+    BOOST_REQUIRE_EQUAL( MultisetHash( &serialized ).hash(), ab.hash() );
+    BOOST_REQUIRE_THROW( MultisetHash( bytesConstRef( serialized.data(), 32 ) ), std::exception );
+}
+
+BOOST_AUTO_TEST_CASE( rebuild_digests_test ) {
+    TransientDirectory td;
+    h256 hash;
+    {
+        db::LevelDB db( td.path() );
+        db.enableDigests();
+        for ( int i = 0; i < 100; ++i )
+            db.insert( to_string( i ), "value " + to_string( i ) );
+        hash = db.hashBase();
+    }
+    {
+        // a record written behind the back of digests, as in a forged snapshot
+        leveldb::DB* raw = nullptr;
+        BOOST_REQUIRE( leveldb::DB::Open( db::LevelDB::defaultDBOptions(), td.path(),
+            &raw )
+                           .ok() );
+        BOOST_REQUIRE( raw->Put( leveldb::WriteOptions(), "forged", "value" ).ok() );
+        delete raw;
+    }
+
+    db::LevelDB db( td.path() );
+    db.enableDigests();
+    BOOST_REQUIRE_EQUAL( db.hashBase(), hash );
+    BOOST_REQUIRE( db.recomputeHashBase() != hash );
+    db.rebuildDigests();
+    BOOST_REQUIRE_EQUAL( db.hashBase(), db.recomputeHashBase() );
+    BOOST_REQUIRE( db.hashBase() != hash );
+
+    // the format used before the fork reads records in order of keys, digests excluded
+    string records;
+    db.forEach( [&records]( db::Slice _key, db::Slice _value ) {
+        records.append( _key.data(), _key.size() );
+        records.append( _value.data(), _value.size() );
+        return true;
+    } );
+    BOOST_REQUIRE_EQUAL( db.legacyHashBase(), sha256( bytesConstRef( records ) ) );
+}
+
+BOOST_AUTO_TEST_CASE( digest_write_overhead,
+    *utf::label( "perf" ) * boost::unit_test::precondition( dev::test::run_not_express ) ) {
+    if ( !test::Options::get().all ) {
+        std::cout << "Skipping test LevelDBTests/digest_write_overhead. Use --all to run it.\n";
+        return;
+    }
+
+    int const records = 100000;
+    string const value( 100, 'v' );
+    TransientDirectory tdRaw, tdDigests;
+    leveldb::DB* rawPtr = nullptr;
+    BOOST_REQUIRE( leveldb::DB::Open( db::LevelDB::defaultDBOptions(), tdRaw.path(),
+        &rawPtr )
+                       .ok() );
+    std::unique_ptr< leveldb::DB > raw( rawPtr );
+    db::LevelDB digests( tdDigests.path() );
+    digests.enableDigests();
+
+    // first pass inserts new keys, second one overwrites them and so reads previous values
+    for ( char const* pass : {"insert", "overwrite"} ) {
+        auto start = chrono::steady_clock::now();
+        for ( int i = 0; i < records; ++i )
+            BOOST_REQUIRE( raw->Put( leveldb::WriteOptions(), sha3( to_string( i ) ).hex(), value )
+                               .ok() );
+        double const rawSeconds =
+            chrono::duration< double >( chrono::steady_clock::now() - start ).count();
+
+        start = chrono::steady_clock::now();
+        for ( int i = 0; i < records; ++i )
+            digests.insert( sha3( to_string( i ) ).hex(), value );
+        double const digestSeconds =
+            chrono::duration< double >( chrono::steady_clock::now() - start ).count();
+
+        cout << pass << ": " << rawSeconds * 1e6 / records << " us per raw write, "
+             << digestSeconds * 1e6 / records << " us per write with digests" << endl;
+    }
+}
+
 BOOST_AUTO_TEST_CASE( split_test ) {
     TransientDirectory td;
     auto p_leveldb = std::make_shared< db::LevelDB >( td.path() );
@@ -109,6 +303,32 @@ BOOST_AUTO_TEST_CASE( split_test ) {
     BOOST_REQUIRE( db2->hashBase() != h2 );
 }
 
+BOOST_AUTO_TEST_CASE( split_batch_test ) {
+    TransientDirectory td;
+    auto p_leveldb = std::make_shared< db::LevelDB >( td.path() );
+    db::SplitDB splitdb( p_leveldb );
+    db::DatabaseFace* db1 = splitdb.newInterface();
+    db::DatabaseFace* db2 = splitdb.newInterface();
+
+    db2->insert( string( "gone" ), string( "old" ) );
+
+    // one batch writes into both interfaces with their prefixes
+    auto batch = splitdb.createWriteBatch();
+    ( *batch )[db1].insert( string( "key" ), string( "v1" ) );
+    ( *batch )[db2].insert( string( "key" ), string( "v2" ) );
+    ( *batch )[db2].kill( string( "gone" ) );
+    BOOST_REQUIRE( !db1->exists( string( "key" ) ) );
+    splitdb.commit( std::move( batch ) );
+
+    BOOST_REQUIRE_EQUAL( db1->lookup( string( "key" ) ), "v1" );
+    BOOST_REQUIRE_EQUAL( db2->lookup( string( "key" ) ), "v2" );
+    BOOST_REQUIRE( !db2->exists( string( "gone" ) ) );
+
+    db::SplitDB other( p_leveldb );
+    batch = splitdb.createWriteBatch();
+    BOOST_REQUIRE_THROW( ( *batch )[other.newInterface()], db::DatabaseError );
+}
+
 BOOST_AUTO_TEST_CASE( rotation_test ) {
     TransientDirectory td;
     const int nPieces = 5;
@@ -170,4 +390,110 @@ BOOST_AUTO_TEST_CASE( rotation_rewrite_test ) {
     BOOST_REQUIRE_EQUAL( rdb.lookup( string( "a" ) ), string( "va_new_new" ) );
 }
 
+BOOST_AUTO_TEST_CASE( key_bloom_filter_test ) {
+    db::KeyBloomFilter filter( 100 );
+    // grows beyond expected number of keys
+    for ( int i = 0; i < 10000; ++i )
+        filter.add( "key " + to_string( i ) );
+    BOOST_REQUIRE_EQUAL( filter.keyCount(), 10000U );
+
+    for ( int i = 0; i < 10000; ++i )
+        BOOST_REQUIRE( filter.mayContain( "key " + to_string( i ) ) );
+
+    int falsePositives = 0;
+    for ( int i = 0; i < 10000; ++i )
+        falsePositives += filter.mayContain( "other " + to_string( i ) );
+    BOOST_REQUIRE_LT( falsePositives, 1000 );
+
+    TransientDirectory td;
+    boost::filesystem::path const dir( td.path() );
+    h256 const identity = sha3( "records" );
+    filter.save( dir / "filter", identity );
+    std::unique_ptr< db::KeyBloomFilter > loaded =
+        db::KeyBloomFilter::load( dir / "filter", identity );
+    BOOST_REQUIRE( loaded );
+    BOOST_REQUIRE_EQUAL( loaded->keyCount(), 10000U );
+    for ( int i = 0; i < 10000; ++i ) {
+        BOOST_REQUIRE( loaded->mayContain( "key " + to_string( i ) ) );
+        BOOST_REQUIRE_EQUAL( loaded->mayContain( "other " + to_string( i ) ),
+            filter.mayContain( "other " + to_string( i ) ) );
+    }
+
+    // filter of other records is not used
+    BOOST_REQUIRE( !db::KeyBloomFilter::load( dir / "filter", sha3( "other records" ) ) );
+
+    // damaged file is not used
+    writeFile( dir / "damaged", bytes( 100, 1 ) );
+    BOOST_REQUIRE( !db::KeyBloomFilter::load( dir / "damaged", identity ) );
+    BOOST_REQUIRE( !db::KeyBloomFilter::load( dir / "missing", identity ) );
+    bytes data = contents( dir / "filter" );
+    data[data.size() / 2] ^= 1;
+    writeFile( dir / "damaged", data );
+    BOOST_REQUIRE( !db::KeyBloomFilter::load( dir / "damaged", identity ) );
+}
+
+BOOST_AUTO_TEST_CASE( rotation_filter_test ) {
+    TransientDirectory td;
+    const int nPieces = 3;
+
+    {
+        db::ManuallyRotatingLevelDB rdb( td.path(), nPieces );
+        rdb.insert( string( "a" ), string( "va" ) );
+        rdb.rotate();
+        auto batch = rdb.createWriteBatch();
+        batch->insert( string( "b" ), string( "vb" ) );
+        rdb.commit( std::move( batch ) );
+
+        BOOST_REQUIRE_EQUAL( rdb.lookup( string( "a" ) ), "va" );
+        BOOST_REQUIRE_EQUAL( rdb.lookup( string( "b" ) ), "vb" );
+        BOOST_REQUIRE( !rdb.exists( string( "c" ) ) );
+
+        std::vector< db::ManuallyRotatingLevelDB::PieceStats > stats = rdb.pieceStats();
+        BOOST_REQUIRE_EQUAL( stats.size(), size_t( nPieces ) );
+        // "a" is in the second piece, the current one is skipped as it has no such key
+        BOOST_REQUIRE_EQUAL( stats[0].hits, 1U );
+        BOOST_REQUIRE_EQUAL( stats[1].hits, 1U );
+        BOOST_REQUIRE_GE( stats[0].skipped, 1U );
+        // empty piece needs no reads
+        BOOST_REQUIRE_EQUAL( stats[2].probes, stats[2].skipped );
+    }
+
+    // filters are saved and reopened, no keys are missed
+    {
+        db::ManuallyRotatingLevelDB rdb( td.path(), nPieces );
+        BOOST_REQUIRE_EQUAL( rdb.lookup( string( "a" ) ), "va" );
+        BOOST_REQUIRE_EQUAL( rdb.lookup( string( "b" ) ), "vb" );
+
+        rdb.kill( string( "a" ) );
+        BOOST_REQUIRE( !rdb.exists( string( "a" ) ) );
+    }
+
+    // current piece filter is rebuilt if it was not saved, e.g. after crash
+    boost::filesystem::path const dir( td.path() );
+    boost::filesystem::remove_all( dir / "2.filter" );
+    {
+        db::ManuallyRotatingLevelDB rdb( td.path(), nPieces );
+        BOOST_REQUIRE_EQUAL( rdb.lookup( string( "b" ) ), "vb" );
+        rdb.insert( string( "a" ), string( "va" ) );
+    }
+
+    // filter saved for other records is rebuilt, "a" is in piece 2 only
+    boost::filesystem::copy_file(
+        dir / "1.filter", dir / "2.filter", boost::filesystem::copy_option::overwrite_if_exists );
+    {
+        db::ManuallyRotatingLevelDB rdb( td.path(), nPieces );
+        BOOST_REQUIRE_EQUAL( rdb.lookup( string( "a" ) ), "va" );
+    }
+
+    // e.g. after snapshot install
+    db::ManuallyRotatingLevelDB::dropFilters( dir );
+    for ( int i = 0; i < nPieces; ++i )
+        BOOST_REQUIRE( !boost::filesystem::exists( dir / ( to_string( i ) + ".filter" ) ) );
+    {
+        db::ManuallyRotatingLevelDB rdb( td.path(), nPieces );
+        BOOST_REQUIRE_EQUAL( rdb.lookup( string( "a" ) ), "va" );
+        BOOST_REQUIRE_EQUAL( rdb.lookup( string( "b" ) ), "vb" );
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -43,6 +43,7 @@
 #include <test/tools/libtesteth/Options.h>
 #include <test/tools/libtesteth/TestOutputHelper.h>
 #include <boost/test/unit_test.hpp>
+#include <chrono>
 
 using namespace std;
 using namespace dev;
@@ -172,6 +173,30 @@ BOOST_AUTO_TEST_CASE( SignAndRecoverLoop,
     }
 }
 
+BOOST_AUTO_TEST_CASE( recoverBatchMatchesRecover,
+    *boost::unit_test::precondition( dev::test::run_not_express ) ) {
+    std::vector< std::pair< Signature, h256 > > items;
+    std::vector< Public > expected;
+    auto msg = h256::random();
+    for ( size_t i = 0; i < 100; ++i ) {
+        msg = sha3( msg );
+        auto kp = KeyPair::create();
+        items.emplace_back( sign( kp.secret(), msg ), msg );
+        expected.push_back( kp.pub() );
+    }
+    // v > 3 can not be recovered
+    items[7].first[64] = 4;
+    expected[7] = Public();
+
+    for ( unsigned threads : {1, 4} ) {
+        std::vector< Public > keys = recoverBatch( items, threads );
+        BOOST_REQUIRE_EQUAL( keys.size(), items.size() );
+        for ( size_t i = 0; i < items.size(); ++i )
+            BOOST_CHECK_EQUAL( keys[i], expected[i] );
+    }
+    BOOST_CHECK( recoverBatch( {} ).empty() );
+}
+
 BOOST_AUTO_TEST_CASE( cryptopp_patch ) {
     KeyPair k = KeyPair::create();
     bytes io_text;
@@ -830,5 +855,37 @@ BOOST_AUTO_TEST_CASE( PerfSHA256_4000,
     BOOST_CHECK_EQUAL( data[0], 0x4d );
 }
 
+BOOST_AUTO_TEST_CASE( PerfRecoverBatch,
+    *utf::label( "perf" ) * boost::unit_test::precondition( dev::test::run_not_express ) ) {
+    if ( !test::Options::get().all ) {
+        std::cout << "Skipping test Crypto/devcrypto/PerfRecoverBatch. Use --all to run it.\n";
+        return;
+    }
+
+    std::vector< std::pair< Signature, h256 > > items;
+    auto msg = h256::random();
+    for ( size_t i = 0; i < 5000; ++i ) {
+        msg = sha3( msg );
+        items.emplace_back( sign( KeyPair::create().secret(), msg ), msg );
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    for ( auto const& item : items )
+        BOOST_REQUIRE( !!recover( item.first, item.second ) );
+    auto serial = std::chrono::steady_clock::now() - start;
+
+    start = std::chrono::steady_clock::now();
+    std::vector< Public > keys = recoverBatch( items );
+    auto batch = std::chrono::steady_clock::now() - start;
+
+    for ( auto const& key : keys )
+        BOOST_REQUIRE( !!key );
+    std::cout << "Recovered " << items.size() << " signatures: one by one in "
+              << std::chrono::duration_cast< std::chrono::milliseconds >( serial ).count()
+              << " ms, in batch in "
+              << std::chrono::duration_cast< std::chrono::milliseconds >( batch ).count()
+              << " ms\n";
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 BOOST_AUTO_TEST_SUITE_END()
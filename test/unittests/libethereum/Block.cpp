@@ -22,12 +22,15 @@
  * Block test functions.
  */
 
+#include <libdevcore/TrieHash.h>
 #include <libethereum/Block.h>
 #include <libethereum/BlockQueue.h>
 #include <test/tools/libtesteth/BlockChainHelper.h>
 #include <test/tools/libtesteth/JsonSpiritHeaders.h>
 #include <test/tools/libtesteth/TestHelper.h>
 
+#include <random>
+
 using namespace std;
 using namespace dev;
 using namespace dev::eth;
@@ -217,6 +220,152 @@ BOOST_AUTO_TEST_CASE( bGetReceiptOverflow ) {
     BOOST_CHECK_THROW( block.receipt( 123 ), std::out_of_range );
 }
 
+namespace {
+// SSTORE( CALLDATALOAD( 0 ), SLOAD( CALLDATALOAD( 0 ) ) + 1 )
+char const* const c_counterCode = "0x6000358054600101905500";
+Address const c_counterAddress( "0x000000000000000000000000000000000000c0de" );
+
+struct SyncOutcome {
+    std::vector< bytes > receipts;
+    std::map< Address, std::tuple< u256, u256 > > accounts;
+    std::map< u256, u256 > counters;
+    Block::SpeculationStats speculation;
+};
+
+// Executes _transactions in a fresh block on top of the genesis with given accounts
+SyncOutcome syncWithThreads( json_spirit::mObject const& _accountMap,
+    Transactions const& _transactions, std::vector< Address > const& _addresses,
+    unsigned _threads ) {
+    json_spirit::mObject blockObj = TestBlockChain::defaultGenesisBlockJson();
+    blockObj["gasLimit"] = "100000000";
+    TestBlockChain testBlockchain( TestBlock( blockObj, _accountMap ) );
+    BlockChain const& blockchain = testBlockchain.getInterface();
+
+    Block block = blockchain.genesisBlock( testBlockchain.testGenesis().state() );
+    block.sync( blockchain );
+    TransactionReceipts receipts = std::get< 0 >(
+        block.syncEveryone( blockchain, _transactions, utcTime(), 0, _threads ) );
+
+    SyncOutcome outcome;
+    for ( auto const& receipt : receipts )
+        outcome.receipts.push_back( receipt.rlp() );
+    outcome.accounts[block.author()] = std::make_tuple(
+        block.state().balance( block.author() ), block.state().getNonce( block.author() ) );
+    for ( auto const& address : _addresses )
+        outcome.accounts[address] = std::make_tuple(
+            block.state().balance( address ), block.state().getNonce( address ) );
+    for ( unsigned key = 0; key < 4; ++key )
+        outcome.counters[key] = block.state().storage( c_counterAddress, key );
+    outcome.speculation = block.speculationStats();
+    return outcome;
+}
+}  // namespace
+
+BOOST_AUTO_TEST_CASE( bParallelExecutionIsDeterministic,
+    *boost::unit_test::precondition( dev::test::run_not_express ) ) {
+    std::vector< KeyPair > senders;
+    std::vector< Address > addresses{c_counterAddress, Address( 0x1234 ), Address( 0x5678 )};
+    json_spirit::mObject accountMapObj;
+    for ( unsigned i = 0; i < 4; ++i ) {
+        senders.push_back( KeyPair( Secret( sha3( "sender" + toString( i ) ) ) ) );
+        addresses.push_back( senders.back().address() );
+
+        json_spirit::mObject accountObj;
+        accountObj["balance"] = "1000000000000";
+        accountObj["nonce"] = "0";
+        accountObj["code"] = "";
+        accountObj["storage"] = json_spirit::mObject();
+        accountMapObj[senders.back().address().hex()] = accountObj;
+    }
+    json_spirit::mObject counterObj;
+    counterObj["balance"] = "0";
+    counterObj["nonce"] = "0";
+    counterObj["code"] = c_counterCode;
+    counterObj["storage"] = json_spirit::mObject();
+    accountMapObj[c_counterAddress.hex()] = counterObj;
+
+    Block::SpeculationStats total;
+    for ( unsigned seed = 0; seed < 5; ++seed ) {
+        std::mt19937 random( seed );
+        std::vector< u256 > nonces( senders.size(), 0 );
+        Transactions transactions;
+        for ( unsigned i = 0; i < 60; ++i ) {
+            size_t from = random() % senders.size();
+            // sometimes use a nonce from the future to get invalid transactions
+            u256 nonce = random() % 10 == 0 ? nonces[from] + 5 : nonces[from]++;
+            if ( random() % 2 ) {
+                Address to = addresses[1 + random() % ( addresses.size() - 1 )];
+                transactions.push_back( Transaction( random() % 1000, 1, 21000, to, bytes(), nonce,
+                    senders[from].secret() ) );
+            } else {
+                transactions.push_back( Transaction( 0, 1, 100000, c_counterAddress,
+                    h256( random() % 4 ).asBytes(), nonce, senders[from].secret() ) );
+            }
+        }
+
+        SyncOutcome serial = syncWithThreads( accountMapObj, transactions, addresses, 0 );
+        SyncOutcome parallel = syncWithThreads( accountMapObj, transactions, addresses, 4 );
+
+        BOOST_REQUIRE_EQUAL( serial.receipts.size(), parallel.receipts.size() );
+        for ( size_t i = 0; i < serial.receipts.size(); ++i )
+            BOOST_CHECK( serial.receipts[i] == parallel.receipts[i] );
+        BOOST_CHECK( serial.accounts == parallel.accounts );
+        BOOST_CHECK( serial.counters == parallel.counters );
+
+        BOOST_CHECK_EQUAL( serial.speculation.merged + serial.speculation.reexecuted, 0 );
+        total.merged += parallel.speculation.merged;
+        total.reexecuted += parallel.speculation.reexecuted;
+    }
+    // both paths were taken: independent transactions were merged, conflicting ones re-executed
+    BOOST_CHECK_GT( total.merged, 0 );
+    BOOST_CHECK_GT( total.reexecuted, 0 );
+}
+
+BOOST_AUTO_TEST_CASE( bSealedBlockEncodesOnce ) {
+    KeyPair const sender( Secret( sha3( "sender" ) ) );
+    json_spirit::mObject accountObj;
+    accountObj["balance"] = "1000000000000";
+    accountObj["nonce"] = "0";
+    accountObj["code"] = "";
+    accountObj["storage"] = json_spirit::mObject();
+    json_spirit::mObject accountMapObj;
+    accountMapObj[sender.address().hex()] = accountObj;
+
+    TestBlockChain testBlockchain(
+        TestBlock( TestBlockChain::defaultGenesisBlockJson(), accountMapObj ) );
+    BlockChain const& blockchain = testBlockchain.getInterface();
+    Block block = blockchain.genesisBlock( testBlockchain.testGenesis().state() );
+    block.sync( blockchain );
+
+    Transactions transactions;
+    for ( unsigned i = 0; i < 3; ++i )
+        transactions.push_back(
+            Transaction( 100 + i, 1, 21000, Address( 0x1234 ), bytes(), i, sender.secret() ) );
+    block.syncEveryone( blockchain, transactions, utcTime(), 0 );
+    block.commitToSeal( blockchain );
+    RLPStream header;
+    block.info().streamRLP( header );
+    BOOST_REQUIRE( block.sealBlock( header.out() ) );
+
+    // the roots match the tries of separately encoded items, the body and receipts reuse them
+    std::vector< bytes > txs, receipts;
+    for ( unsigned i = 0; i < transactions.size(); ++i ) {
+        txs.push_back( block.pending()[i].rlp() );
+        receipts.push_back( block.receipt( i ).rlp() );
+    }
+    BOOST_CHECK_EQUAL( block.info().transactionsRoot(), orderedTrieRoot( txs ) );
+    BOOST_CHECK_EQUAL( block.info().receiptsRoot(), orderedTrieRoot( receipts ) );
+
+    RLP const body( block.blockData() );
+    BOOST_REQUIRE_EQUAL( body[1].itemCount(), transactions.size() );
+    for ( unsigned i = 0; i < transactions.size(); ++i )
+        BOOST_CHECK( body[1][i].data().toBytes() == txs[i] );
+
+    BlockReceipts blockReceipts;
+    blockReceipts.receipts = block.receipts();
+    BOOST_CHECK( block.receiptsData() == blockReceipts.rlp() );
+}
+
 BOOST_FIXTURE_TEST_SUITE( ConstantinopleBlockSuite, ConstantinopleTestFixture )
 
 BOOST_AUTO_TEST_CASE( bConstantinopleBlockReward ) {
@@ -0,0 +1,145 @@
+/*
+    Copyright (C) 2018-present, SKALE Labs
+
+    This file is part of skaled.
+
+    skaled is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skaled is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with skaled.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file CallCache.cpp
+ * CallCache test functions.
+ */
+
+#include <libethereum/CallCache.h>
+#include <test/tools/libtesteth/TestOutputHelper.h>
+#include <boost/test/unit_test.hpp>
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+using namespace std;
+using namespace dev;
+using namespace dev::eth;
+using namespace dev::test;
+
+namespace {
+h256 callKey( h256 const& _block, bytes const& _data ) {
+    return CallCache::key( _block, Address( 1 ), Address( 2 ), 0, _data, 100000, 1, true );
+}
+
+ExecutionResult resultWithOutput( bytes const& _output ) {
+    ExecutionResult r;
+    r.excepted = TransactionException::None;
+    r.output = _output;
+    return r;
+}
+}  // namespace
+
+BOOST_FIXTURE_TEST_SUITE( CallCacheSuite, TestOutputHelperFixture )
+
+BOOST_AUTO_TEST_CASE( cachesPerBlock ) {
+    CallCache cache( 16 );
+    int executions = 0;
+    auto execute = [&]() {
+        ++executions;
+        return resultWithOutput( bytes{1, 2, 3} );
+    };
+
+    h256 key = callKey( h256( 1 ), bytes{0xaa} );
+    BOOST_CHECK( cache.get( key, execute ).output == bytes( {1, 2, 3} ) );
+    BOOST_CHECK( cache.get( key, execute ).output == bytes( {1, 2, 3} ) );
+    BOOST_CHECK_EQUAL( executions, 1 );
+
+    // other block or other data is another call
+    BOOST_CHECK( callKey( h256( 2 ), bytes{0xaa} ) != key );
+    BOOST_CHECK( callKey( h256( 1 ), bytes{0xab} ) != key );
+
+    cache.invalidate();
+    cache.get( key, execute );
+    BOOST_CHECK_EQUAL( executions, 2 );
+
+    CallCache::Stats stats = cache.stats();
+    BOOST_CHECK_EQUAL( stats.hits, 1U );
+    BOOST_CHECK_EQUAL( stats.misses, 2U );
+    BOOST_CHECK_EQUAL( stats.invalidations, 1U );
+    BOOST_CHECK_EQUAL( stats.size, 1U );
+}
+
+BOOST_AUTO_TEST_CASE( exceptionsAreNotCached ) {
+    CallCache cache( 16 );
+    h256 key = callKey( h256( 1 ), bytes() );
+    BOOST_CHECK_THROW(
+        cache.get( key, []() -> ExecutionResult { throw std::runtime_error( "failed" ); } ),
+        std::runtime_error );
+    BOOST_CHECK( cache.get( key, []() { return resultWithOutput( bytes{1} ); } ).output ==
+                 bytes{1} );
+    BOOST_CHECK_EQUAL( cache.stats().misses, 2U );
+}
+
+BOOST_AUTO_TEST_CASE( joinsCallInFlight ) {
+    CallCache cache( 16 );
+    h256 key = callKey( h256( 1 ), bytes() );
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool release = false;
+    std::atomic< int > executions{0};
+    auto execute = [&]() {
+        ++executions;
+        std::unique_lock< std::mutex > lock( mutex );
+        cv.wait( lock, [&]() { return release; } );
+        return resultWithOutput( bytes{7} );
+    };
+
+    std::thread first( [&]() { cache.get( key, execute ); } );
+    while ( cache.stats().misses == 0 )
+        std::this_thread::yield();
+
+    std::atomic< bool > allSame{true};
+    std::vector< std::thread > waiting;
+    for ( size_t i = 0; i < 4; ++i )
+        waiting.emplace_back( [&]() {
+            if ( cache.get( key, execute ).output != bytes{7} )
+                allSame = false;
+        } );
+    while ( cache.stats().joined < 4 )
+        std::this_thread::yield();
+
+    {
+        std::lock_guard< std::mutex > lock( mutex );
+        release = true;
+    }
+    cv.notify_all();
+    first.join();
+    for ( auto& t : waiting )
+        t.join();
+
+    BOOST_CHECK( allSame );
+    BOOST_CHECK_EQUAL( executions, 1 );
+    BOOST_CHECK_EQUAL( cache.stats().joined, 4U );
+}
+
+BOOST_AUTO_TEST_CASE( resultOfInvalidatedBlockIsDropped ) {
+    CallCache cache( 16 );
+    h256 key = callKey( h256( 1 ), bytes() );
+    cache.get( key, [&]() {
+        // a new block is imported while the call executes
+        cache.invalidate();
+        return resultWithOutput( bytes() );
+    } );
+    BOOST_CHECK_EQUAL( cache.stats().size, 0U );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
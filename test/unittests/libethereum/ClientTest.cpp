@@ -348,7 +348,8 @@ static std::string const c_genesisInfoSkaleTest = std::string() +
         "0000000000000000000000000000000000000008": { "precompiled": { "name": "alt_bn128_pairing_product", "startingBlock" : "0x2dc6c0" } },
         "0xca4409573a5129a72edf85d6c51e26760fc9c903": { "balance": "100000000000000000000000" },
         "0xD2001300000000000000000000000000000000D2": { "balance": "0", "nonce": "0", "storage": {}, "code":"0x6080604052348015600f57600080fd5b506004361060325760003560e01c8063815b8ab41460375780638273f754146062575b600080fd5b606060048036036020811015604b57600080fd5b8101908080359060200190929190505050606a565b005b60686081565b005b60005a90505b815a82031015607d576070565b5050565b60005a9050609660028281609157fe5b04606a565b5056fea165627a7a72305820f5fb5a65e97cbda96c32b3a2e1497cd6b7989179b5dc29e9875bcbea5a96c4520029"},
-        "0xd40B3c51D0ECED279b1697DbdF45d4D19b872164": { "balance": "0", "nonce": "0", "storage": {}, "code":"0x6080604052348015600f57600080fd5b506004361060325760003560e01c80636057361d146037578063b05784b8146062575b600080fd5b606060048036036020811015604b57600080fd5b8101908080359060200190929190505050607e565b005b60686088565b6040518082815260200191505060405180910390f35b8060008190555050565b6000805490509056fea2646970667358221220e5ff9593bfa9540a34cad5ecbe137dcafcfe1f93e3c4832610438d6f0ece37db64736f6c63430006060033"}
+        "0xd40B3c51D0ECED279b1697DbdF45d4D19b872164": { "balance": "0", "nonce": "0", "storage": {}, "code":"0x6080604052348015600f57600080fd5b506004361060325760003560e01c80636057361d146037578063b05784b8146062575b600080fd5b606060048036036020811015604b57600080fd5b8101908080359060200190929190505050607e565b005b60686088565b6040518082815260200191505060405180910390f35b8060008190555050565b6000805490509056fea2646970667358221220e5ff9593bfa9540a34cad5ecbe137dcafcfe1f93e3c4832610438d6f0ece37db64736f6c63430006060033"},
+        "0xD2001400000000000000000000000000000000D2": { "balance": "0", "nonce": "0", "storage": {}, "code":"0x36600060003760006000366000600073d40b3c51d0eced279b1697dbdf45d4d19b8721645af115602b57005b600080fd"}
     }
 }
 )E";
@@ -501,6 +502,43 @@ BOOST_AUTO_TEST_CASE( runsInterference ) {
     BOOST_CHECK_EQUAL( estimate, u256( 41684 ) );
 }
 
+BOOST_AUTO_TEST_CASE( forwardsAllGas ) {
+    TestClientFixture fixture( c_genesisInfoSkaleTest );
+    ClientTest* testClient = asClientTest( fixture.ethereum() );
+
+    //    This contract is listed in c_genesisInfoSkaleTest, address:
+    //    0xD2001400000000000000000000000000000000D2
+    //    It calls the Storage contract from runsInterference with its own call data,
+    //    passing all gas, and reverts if the call fails:
+
+    //    CALLDATASIZE PUSH1 0 PUSH1 0 CALLDATACOPY
+    //    PUSH1 0 PUSH1 0 CALLDATASIZE PUSH1 0 PUSH1 0
+    //    PUSH20 0xd40B3c51D0ECED279b1697DbdF45d4D19b872164 GAS CALL
+    //    ISZERO PUSH1 0x2b JUMPI STOP JUMPDEST PUSH1 0 DUP1 REVERT
+
+    Address from( "0xca4409573a5129a72edf85d6c51e26760fc9c903" );
+    Address proxyAddress( "0xD2001400000000000000000000000000000000D2" );
+
+    // data to call store()
+    bytes data =
+        jsToBytes( "0x6057361d0000000000000000000000000000000000000000000000000000000000000016" );
+
+    int64_t maxGas = 100000;
+    std::vector< GasEstimationProgress > progress;
+    auto estimate = testClient->estimateGas( from, 0, proxyAddress, data, maxGas, 1000000,
+        [&]( GasEstimationProgress const& _p ) { progress.push_back( _p ); } );
+
+    // the estimate lets the call succeed, and the proxy keeps 1/64 of the gas it passes on
+    BOOST_REQUIRE( estimate.second.excepted == TransactionException::None );
+    BOOST_CHECK_GT( estimate.first, estimate.second.gasUsed );
+    BOOST_CHECK_LT( estimate.first, u256( maxGas ) );
+
+    // the traced gas limit was verified at once, without iterative search
+    BOOST_REQUIRE_EQUAL( progress.size(), 1 );
+    BOOST_CHECK_EQUAL( progress[0].lowerBound, estimate.first );
+    BOOST_CHECK_EQUAL( progress[0].upperBound, estimate.first );
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 static std::string const c_skaleConfigString = R"(
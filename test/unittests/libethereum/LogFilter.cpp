@@ -0,0 +1,26 @@
+#include <libethereum/LogFilter.h>
+#include <test/tools/libtesteth/TestOutputHelper.h>
+#include <boost/test/unit_test.hpp>
+
+using namespace std;
+using namespace dev;
+using namespace dev::eth;
+using namespace dev::test;
+
+BOOST_FIXTURE_TEST_SUITE( LogFilterTests, TestOutputHelperFixture )
+
+BOOST_AUTO_TEST_CASE( matches_entry ) {
+    Address const token( 1 );
+    h256 const transfer( 10 );
+    LogEntry const entry( token, h256s{transfer}, bytes() );
+
+    BOOST_REQUIRE( LogFilter().matches( entry ) );
+    BOOST_REQUIRE( LogFilter().address( token ).topic( 0, transfer ).matches( entry ) );
+    BOOST_REQUIRE( !LogFilter().address( Address( 2 ) ).matches( entry ) );
+    BOOST_REQUIRE( !LogFilter().topic( 0, h256( 20 ) ).matches( entry ) );
+
+    // a constrained slot past the last topic does not match
+    BOOST_REQUIRE( !LogFilter().topic( 1, transfer ).matches( entry ) );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,96 @@
+#include <libdevcore/LevelDB.h>
+#include <libdevcore/TransientDirectory.h>
+#include <libethereum/BlockChain.h>
+#include <libethereum/LogIndex.h>
+#include <test/tools/libtesteth/TestOutputHelper.h>
+#include <boost/test/unit_test.hpp>
+
+using namespace std;
+using namespace dev;
+using namespace dev::eth;
+using namespace dev::test;
+
+namespace {
+Address const c_token( 1 );
+Address const c_other( 2 );
+h256 const c_transfer( 10 );
+h256 const c_approval( 20 );
+
+// every block: token transfer, other approval + transfer, and a second token transfer in
+// every third block
+bytes blockReceipts( unsigned _number ) {
+    RLPStream s( 2 );
+    TransactionReceipt( uint8_t( 1 ), 1,
+        LogEntries{LogEntry( c_token, h256s{c_transfer}, bytes() ),
+            LogEntry( c_other, h256s{c_approval, c_transfer}, bytes() )} )
+        .streamRLP( s );
+    TransactionReceipt( uint8_t( 1 ), 2,
+        LogEntries{LogEntry( _number % 3 ? c_other : c_token, h256s{c_transfer}, bytes() )} )
+        .streamRLP( s );
+    return s.out();
+}
+}  // namespace
+
+BOOST_FIXTURE_TEST_SUITE( LogIndexTests, TestOutputHelperFixture )
+
+BOOST_AUTO_TEST_CASE( find_merges_postings ) {
+    TransientDirectory td;
+    db::LevelDB db( td.path() );
+    LogIndex index( &db );
+    index.open( 1 );
+    BOOST_REQUIRE_EQUAL( index.firstBlock(), 1U );
+
+    unsigned const blocks = 5 * LogIndex::c_bucketBlocks;
+    for ( unsigned n = 1; n <= blocks; ++n ) {
+        bytes const receipts = blockReceipts( n );
+        index.insert( n, &receipts );
+    }
+    BOOST_REQUIRE_EQUAL( index.nextBlock(), blocks + 1 );
+
+    LogFilter byAddress;
+    byAddress.address( c_token );
+    LogPositions positions = index.find( byAddress, 10, 200, 1000 );
+    size_t expected = 0;
+    for ( unsigned n = 10; n <= 200; ++n )
+        expected += n % 3 ? 1 : 2;
+    BOOST_REQUIRE_EQUAL( positions.size(), expected );
+    BOOST_REQUIRE_EQUAL( positions.front().block, 10U );
+    BOOST_REQUIRE_EQUAL( positions.back().block, 200U );
+    BOOST_REQUIRE( is_sorted( positions.begin(), positions.end() ) );
+
+    // topics are matched in their slots only
+    LogFilter bySecondTopic;
+    bySecondTopic.topic( 1, c_transfer );
+    positions = index.find( bySecondTopic, 1, blocks, 1000 );
+    BOOST_REQUIRE_EQUAL( positions.size(), blocks );
+    BOOST_REQUIRE_EQUAL( positions.front().transaction, 0U );
+    BOOST_REQUIRE_EQUAL( positions.front().log, 1U );
+
+    // address and topic are intersected, the limit is respected
+    LogFilter both;
+    both.address( c_other );
+    both.topic( 0, c_transfer );
+    positions = index.find( both, 1, blocks, 3 );
+    BOOST_REQUIRE_EQUAL( positions.size(), 3U );
+    BOOST_REQUIRE_EQUAL( positions[0].block, 1U );
+    BOOST_REQUIRE_EQUAL( positions[2].block, 4U );
+
+    // the indexed blocks survive reopening
+    LogIndex reopened( &db );
+    reopened.open( blocks + 100 );
+    BOOST_REQUIRE_EQUAL( reopened.firstBlock(), 1U );
+    BOOST_REQUIRE_EQUAL( reopened.nextBlock(), blocks + 1 );
+    BOOST_REQUIRE_EQUAL( reopened.find( byAddress, 10, 200, 1000 ).size(), expected );
+
+    // blocks imported again, e.g. after a crash, are not indexed twice
+    for ( unsigned n = blocks - 3; n <= blocks; ++n ) {
+        bytes const receipts = blockReceipts( n );
+        reopened.insert( n, &receipts );
+    }
+    BOOST_REQUIRE_EQUAL( reopened.nextBlock(), blocks + 1 );
+    positions = reopened.find( byAddress, blocks - 3, blocks, 1000 );
+    BOOST_REQUIRE( adjacent_find( positions.begin(), positions.end() ) == positions.end() );
+    BOOST_REQUIRE_EQUAL( reopened.find( byAddress, 10, 200, 1000 ).size(), expected );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
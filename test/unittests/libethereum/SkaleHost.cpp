@@ -714,6 +714,34 @@ BOOST_AUTO_TEST_CASE( transactionDropReceive ) {
     BOOST_REQUIRE_EQUAL( txns.size(), 1 );
 }
 
+BOOST_AUTO_TEST_CASE( transactionBatchReceive ) {
+    auto senderAddress = coinbase.address();
+    auto receiver = KeyPair::create();
+
+    Json::Value json;
+    json["from"] = toJS( senderAddress );
+    json["to"] = toJS( receiver.address() );
+    json["value"] = jsToDecimal( toJS( 10000 * dev::eth::szabo ) );
+    json["nonce"] = 0;
+    bytes tx1 = bytes_from_json( json );
+
+    json["nonce"] = 1;
+    bytes tx2 = bytes_from_json( json );
+
+    // batch with duplicate transaction
+    RLPStream batch( 3 );
+    batch.appendRaw( tx1 );
+    batch.appendRaw( tx2 );
+    batch.appendRaw( tx1 );
+
+    BOOST_REQUIRE_EQUAL( skaleHost->receiveTransactions( &batch.out() ), 2 );
+    BOOST_REQUIRE_EQUAL( tq->knownTransactions().size(), 2 );
+
+    SkaleHost::BroadcastStats stats = skaleHost->broadcastStats();
+    BOOST_REQUIRE_EQUAL( stats.receivedBatches, 1 );
+    BOOST_REQUIRE_EQUAL( stats.receivedTransactions, 3 );
+}
+
 BOOST_AUTO_TEST_CASE( transactionDropQueue, 
     *boost::unit_test::precondition( dev::test::run_not_express ) ) {
     auto senderAddress = coinbase.address();
@@ -23,13 +23,19 @@
 #include <libethcore/BasicAuthority.h>
 #include <libethereum/Block.h>
 #include <libethereum/BlockChain.h>
+#include <libethereum/ChainParams.h>
 #include <libethereum/Defaults.h>
 #include <test/tools/libtesteth/TestHelper.h>
+#include <test/tools/libtestutils/TestLastBlockHashes.h>
+
+#include <chrono>
 
 using namespace std;
 using namespace dev;
 using namespace dev::eth;
+namespace utf = boost::unit_test;
 using skale::BaseState;
+using skale::Permanence;
 using skale::State;
 
 namespace dev {
@@ -56,6 +62,51 @@ BOOST_AUTO_TEST_CASE( LoadAccountCode ) {
         std::equal( std::begin( codeData ), std::end( codeData ), std::begin( loadedCode ) ) );
 }
 
+BOOST_AUTO_TEST_CASE( callLatencyByCacheSize,
+    *utf::label( "perf" ) * boost::unit_test::precondition( dev::test::run_not_express ) ) {
+    if ( !test::Options::get().all ) {
+        std::cout << "Skipping test StateUnitTests/callLatencyByCacheSize. Use --all to run it.\n";
+        return;
+    }
+
+    TransientDirectory tempDir;
+    State state( 0, tempDir.path(), h256{}, BaseState::Empty );
+    ChainParams params;
+    std::unique_ptr< SealEngineFace > sealEngine( params.createSealEngine() );
+    BlockHeader header;
+    header.setGasLimit( 10000000 );
+    TestLastBlockHashes lastBlockHashes( {} );
+    EnvInfo envInfo( header, lastBlockHashes, 0, params.chainID );
+
+    Address const from( "0xa94f5374fce5edbc8e2a8697c15331677e6ebf0b" );
+    Transaction t( 1, 0, 21000, Address( 1 ), bytes(), 0 );
+    t.forceSender( from );
+    t.checkOutExternalGas( ~u256( 0 ) );
+
+    const size_t cntCalls = 200;
+    for ( size_t cacheSize : {0, 1000, 10000, 100000} ) {
+        // a pending block state holding changes of many accounts
+        State source = state.startRead();
+        for ( size_t i = 0; i < cacheSize; ++i )
+            source.addBalance( Address( 0x10000 + i ), 1 );
+
+        for ( bool bOverlay : {false, true} ) {
+            auto start = std::chrono::steady_clock::now();
+            for ( size_t i = 0; i < cntCalls; ++i ) {
+                State call = bOverlay ? source.startOverlay() : State( source );
+                call.addBalance( from, t.gas() * t.gasPrice() + t.value() );
+                auto result = call.execute( envInfo, *sealEngine, t, Permanence::Reverted );
+                BOOST_REQUIRE( result.first.excepted == TransactionException::None );
+            }
+            auto us = std::chrono::duration_cast< std::chrono::microseconds >(
+                std::chrono::steady_clock::now() - start )
+                          .count();
+            std::cout << cacheSize << " cached accounts, " << ( bOverlay ? "overlay" : "full copy" )
+                      << ": " << double( us ) / cntCalls << " us per call\n";
+        }
+    }
+}
+
 class AddressRangeTestFixture : public TestOutputHelperFixture {
 public:
     AddressRangeTestFixture() {
@@ -155,6 +206,26 @@ BOOST_AUTO_TEST_CASE( addressesReturnsCreatedInCache,
         BOOST_CHECK( addresses.find( hashAndAddr.first ) != addresses.end() );
 }
 
+BOOST_AUTO_TEST_CASE( overlaySeesCommittedStateOnly ) {
+    auto it = hashToAddress.begin();
+    Address const changed = it->second;
+    Address const other = ( ++it )->second;
+
+    State s = state.startRead();
+    s.addBalance( changed, 5 );
+    // don't commit
+
+    State overlay = s.startOverlay();
+    BOOST_CHECK( overlay.changeLog().empty() );
+    BOOST_CHECK_EQUAL( overlay.balance( changed ), 100 );
+    overlay.addBalance( other, 7 );
+    BOOST_CHECK_EQUAL( overlay.balance( other ), 107 );
+
+    BOOST_CHECK_EQUAL( s.balance( changed ), 105 );
+    BOOST_CHECK_EQUAL( s.balance( other ), 100 );
+    BOOST_CHECK_EQUAL( state.startRead().balance( other ), 100 );
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -31,6 +31,19 @@ using namespace dev;
 using namespace dev::eth;
 using namespace dev::test;
 
+namespace utf = boost::unit_test;
+
+namespace {
+/// Transactions signed by different random keys
+Transactions randomSignedTransactions( size_t _count ) {
+    Transactions transactions;
+    for ( size_t i = 0; i < _count; ++i )
+        transactions.emplace_back( 0, 1, 50000, Address( 0x1000 ), bytes(), 0,
+            KeyPair::create().secret() );
+    return transactions;
+}
+}  // namespace
+
 BOOST_FIXTURE_TEST_SUITE( TransactionQueueSuite, TestOutputHelperFixture )
 
 BOOST_AUTO_TEST_CASE( TransactionEIP86 ) {
@@ -275,6 +288,32 @@ BOOST_AUTO_TEST_CASE( tqLimit ) {
     BOOST_REQUIRE( topTr.size() == 1 );  // 1 imported transaction
 }
 
+BOOST_AUTO_TEST_CASE( tqTopTransactionsUntil ) {
+    TransactionQueue tq;
+    auto start = boost::chrono::steady_clock::now();
+    Transactions topTr =
+        tq.topTransactionsUntil( 10, start + boost::chrono::milliseconds( 50 ), 0, 1 );
+    BOOST_REQUIRE( topTr.empty() );
+    BOOST_CHECK( boost::chrono::steady_clock::now() - start >= boost::chrono::milliseconds( 50 ) );
+
+    // returns as soon as a transaction arrives, long before the deadline
+    TestTransaction testTransaction = TestTransaction::defaultTransaction();
+    std::thread importer( [&]() {
+        std::this_thread::sleep_for( std::chrono::milliseconds( 20 ) );
+        tq.import( testTransaction.transaction() );
+    } );
+    start = boost::chrono::steady_clock::now();
+    topTr = tq.topTransactionsUntil( 10, start + boost::chrono::seconds( 10 ), 0, 1 );
+    importer.join();
+    BOOST_REQUIRE( topTr.size() == 1 );
+    BOOST_CHECK( boost::chrono::steady_clock::now() - start < boost::chrono::seconds( 5 ) );
+
+    // already taken transactions are not returned again
+    topTr = tq.topTransactionsUntil(
+        10, boost::chrono::steady_clock::now() + boost::chrono::milliseconds( 10 ), 0, 1 );
+    BOOST_CHECK( topTr.empty() );
+}
+
 BOOST_AUTO_TEST_CASE( tqEqueue ) {
     TransactionQueue tq;
     TestTransaction testTransaction = TestTransaction::defaultTransaction();
@@ -291,18 +330,101 @@ BOOST_AUTO_TEST_CASE( tqEqueue ) {
     Transaction tRlpTransaction( payloadToDecode, CheckTransaction::Cheap );
     BOOST_REQUIRE( tRlpTransaction.data() == testTransaction.transaction().data() );
 
-    // SKALE as we don't have tx verifier threads - we won't check tx import
-    //    // try to import transactions
-    //    string hashStr =
-    //        "010203040506070809101112131415161718192021222324252627282930313201020304050607080910111213"
-    //        "14151617181920212223242526272829303132";
-    //    tq.enqueue( tRlp, h512( hashStr ) );
-    //    tq.enqueue( tRlp, h512( hashStr ) );
-    //    std::this_thread::sleep_for( std::chrono::seconds( 1 ) );
-
-    //    // at least 1 transaction should be imported through RLP
-    //    Transactions topTr = tq.topTransactions( 10 );
-    //    BOOST_REQUIRE( topTr.size() == 1 );
+    // try to import transactions
+    string hashStr =
+        "010203040506070809101112131415161718192021222324252627282930313201020304050607080910111213"
+        "14151617181920212223242526272829303132";
+    tq.enqueue( tRlp, h512( hashStr ) );
+    tq.enqueue( tRlp, h512( hashStr ) );
+    std::this_thread::sleep_for( std::chrono::seconds( 1 ) );
+
+    // at least 1 transaction should be imported through RLP
+    Transactions topTr = tq.topTransactions( 10 );
+    BOOST_REQUIRE( topTr.size() == 1 );
+}
+
+BOOST_AUTO_TEST_CASE( tqImportBatch ) {
+    TransactionQueue tq( 1024, 1024, 4 );
+
+    Transactions transactions = randomSignedTransactions( 100 );
+    transactions.push_back( transactions[0] );
+    transactions.push_back( TestTransaction::defaultZeroTransaction().transaction() );
+    Transaction const rejected = transactions[1];
+
+    std::vector< ImportResult > results =
+        tq.importBatch( transactions, [&]( Transaction const& _t ) {
+            if ( _t.sha3() == rejected.sha3() )
+                BOOST_THROW_EXCEPTION( InvalidSignature() );
+        } );
+
+    BOOST_REQUIRE_EQUAL( results.size(), transactions.size() );
+    BOOST_CHECK( results[0] == ImportResult::Success );
+    BOOST_CHECK( results[1] == ImportResult::Malformed );
+    for ( size_t i = 2; i < 100; ++i )
+        BOOST_CHECK( results[i] == ImportResult::Success );
+    BOOST_CHECK( results[100] == ImportResult::AlreadyKnown );
+    BOOST_CHECK( results[101] == ImportResult::ZeroSignature );
+    BOOST_CHECK( tq.knownTransactions().size() == 99 );
+
+    // same results without verifier threads
+    TransactionQueue serial( 1024, 1024, 0 );
+    std::vector< ImportResult > serialResults =
+        serial.importBatch( transactions, [&]( Transaction const& _t ) {
+            if ( _t.sha3() == rejected.sha3() )
+                BOOST_THROW_EXCEPTION( InvalidSignature() );
+        } );
+    BOOST_CHECK( serialResults == results );
+}
+
+// verifier threads may still hold a batch after importBatch() returns and the caller's
+// transactions are gone, run it under a sanitizer to catch use-after-free
+BOOST_AUTO_TEST_CASE( tqImportBatchOutlivesCaller ) {
+    TransactionQueue tq( 1024, 1024, 4 );
+    for ( size_t i = 0; i < 200; ++i ) {
+        auto transactions = std::make_unique< Transactions >( randomSignedTransactions( 2 ) );
+        auto verifier =
+            std::make_unique< TransactionQueue::Verifier >( []( Transaction const& ) {} );
+        std::vector< ImportResult > results = tq.importBatch( *transactions, *verifier );
+        BOOST_REQUIRE_EQUAL( results.size(), 2 );
+        transactions.reset();
+        verifier.reset();
+    }
+    BOOST_CHECK_EQUAL( tq.knownTransactions().size(), 400 );
+}
+
+BOOST_AUTO_TEST_CASE( tqImportBatchPerformance,
+    *utf::label( "perf" ) * boost::unit_test::precondition( dev::test::run_not_express ) ) {
+    if ( !test::Options::get().all ) {
+        std::cout << "Skipping test TransactionQueueSuite/tqImportBatchPerformance. Use --all to "
+                     "run it.\n";
+        return;
+    }
+
+    const size_t count = 10000;
+    const size_t batchSize = 64;
+    Transactions transactions = randomSignedTransactions( count );
+
+    for ( unsigned threads : {1, 2, 4, 8} ) {
+        // recover senders from scratch for each run
+        Transactions fresh;
+        for ( auto const& t : transactions )
+            fresh.emplace_back( t.rlp(), CheckTransaction::None );
+
+        // the calling thread verifies too
+        TransactionQueue tq( count, count, threads - 1 );
+        auto start = std::chrono::steady_clock::now();
+        for ( size_t i = 0; i < count; i += batchSize ) {
+            Transactions batch( fresh.begin() + i,
+                fresh.begin() + std::min( count, i + batchSize ) );
+            tq.importBatch( batch );
+        }
+        auto ms = std::chrono::duration_cast< std::chrono::milliseconds >(
+            std::chrono::steady_clock::now() - start )
+                      .count();
+        BOOST_REQUIRE_EQUAL( tq.knownTransactions().size(), count );
+        std::cout << threads << " verifier thread(s): " << count << " transactions in " << ms
+                  << " ms, " << ( ms ? count * 1000 / ms : 0 ) << " tx/s\n";
+    }
 }
 
 BOOST_AUTO_TEST_SUITE_END()
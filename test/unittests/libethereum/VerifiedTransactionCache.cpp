@@ -0,0 +1,115 @@
+/*
+    Copyright (C) 2018-present, SKALE Labs
+
+    This file is part of skaled.
+
+    skaled is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skaled is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with skaled.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file VerifiedTransactionCache.cpp
+ * VerifiedTransactionCache test functions.
+ */
+
+#include <libethereum/VerifiedTransactionCache.h>
+#include <test/tools/libtesteth/BlockChainHelper.h>
+#include <test/tools/libtesteth/TestHelper.h>
+
+#include <atomic>
+#include <thread>
+
+using namespace std;
+using namespace dev;
+using namespace dev::eth;
+using namespace dev::test;
+
+namespace {
+Transaction signedTransaction( u256 const& _nonce = 0 ) {
+    return Transaction( 0, 1, 50000, Address( 0x1000 ), bytes(), _nonce,
+        KeyPair::create().secret() );
+}
+}  // namespace
+
+BOOST_FIXTURE_TEST_SUITE( VerifiedTransactionCacheSuite, TestOutputHelperFixture )
+
+BOOST_AUTO_TEST_CASE( findReturnsTransactionWithSender ) {
+    VerifiedTransactionCache cache( 64 );
+    Transaction t = signedTransaction();
+    cache.insert( t );
+
+    // decoded copy has no sender yet, cached one has
+    Transaction decoded( t.rlp(), CheckTransaction::None );
+    auto cached = cache.find( decoded.sha3() );
+    BOOST_REQUIRE( cached );
+    BOOST_CHECK_EQUAL( cached->from(), t.from() );
+    BOOST_CHECK( cached->rlp() == t.rlp() );
+
+    BOOST_CHECK( !cache.find( h256( 1 ) ) );
+
+    VerifiedTransactionCache::Stats stats = cache.stats();
+    BOOST_CHECK_EQUAL( stats.hits, 1U );
+    BOOST_CHECK_EQUAL( stats.misses, 1U );
+    BOOST_CHECK_EQUAL( stats.insertions, 1U );
+    BOOST_CHECK_EQUAL( stats.size, 1U );
+}
+
+BOOST_AUTO_TEST_CASE( ignoresTransactionsWithoutSender ) {
+    VerifiedTransactionCache cache( 64 );
+    cache.insert( TestTransaction::defaultZeroTransaction().transaction() );
+    BOOST_CHECK_EQUAL( cache.stats().size, 0U );
+}
+
+BOOST_AUTO_TEST_CASE( removeAndBound ) {
+    VerifiedTransactionCache cache( 16 );
+    Transactions transactions;
+    for ( size_t i = 0; i < 200; ++i ) {
+        transactions.push_back( signedTransaction( i ) );
+        cache.insert( transactions.back() );
+    }
+
+    VerifiedTransactionCache::Stats stats = cache.stats();
+    BOOST_CHECK_LE( stats.size, stats.capacity );
+    BOOST_CHECK_EQUAL( stats.insertions, 200U );
+    BOOST_CHECK_EQUAL( stats.insertions - stats.evictions, stats.size );
+
+    // most recent transaction is still there until it's removed, e.g. by block import
+    BOOST_CHECK( cache.find( transactions.back().sha3() ) );
+    cache.remove( transactions.back().sha3() );
+    BOOST_CHECK( !cache.find( transactions.back().sha3() ) );
+}
+
+BOOST_AUTO_TEST_CASE( concurrentAccess ) {
+    VerifiedTransactionCache cache( 1024 );
+    Transactions transactions;
+    for ( size_t i = 0; i < 256; ++i )
+        transactions.push_back( signedTransaction( i ) );
+
+    std::atomic< bool > allFound{true};
+    std::vector< std::thread > threads;
+    for ( size_t n = 0; n < 4; ++n )
+        threads.emplace_back( [&]() {
+            for ( auto const& t : transactions ) {
+                cache.insert( t );
+                auto cached = cache.find( t.sha3() );
+                if ( !cached || cached->from() != t.from() )
+                    allFound = false;
+            }
+        } );
+    for ( auto& t : threads )
+        t.join();
+
+    BOOST_CHECK( allFound );
+
+    BOOST_CHECK_EQUAL( cache.stats().size, transactions.size() );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
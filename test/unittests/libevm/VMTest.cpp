@@ -18,6 +18,7 @@
  */
 
 #include <libethereum/LastBlockHashesFace.h>
+#include <libevm/CodeCache.h>
 #include <libevm/EVMC.h>
 #include <libevm/LegacyVM.h>
 #include <libskale-interpreter/interpreter.h>
@@ -26,6 +27,10 @@
 #include <test/tools/libtesteth/TestOutputHelper.h>
 #include <boost/test/unit_test.hpp>
 
+#include <chrono>
+
+namespace utf = boost::unit_test;
+
 using namespace dev;
 using namespace dev::test;
 using namespace dev::eth;
@@ -656,6 +661,45 @@ class SkaleInterpreterBalanceFixture : public BalanceFixture {
 public:
     SkaleInterpreterBalanceFixture() : BalanceFixture{new EVMC{evmc_create_interpreter()}} {}
 };
+
+class CodeCacheFixture : public TestOutputHelperFixture {
+public:
+    CodeCacheFixture() { state.addBalance( address, 1 * ether ); }
+
+    owning_bytes_ref run( bytes const& _code ) {
+        ExtVM extVm( state, envInfo, *se, address, address, address, value, gasPrice, {},
+            ref( _code ), sha3( _code ), version, depth, isCreate, staticCall );
+        u256 io_gas = gas;
+        return vm->exec( io_gas, extVm, OnOpFunc{} );
+    }
+
+    /// PUSH2 over @a _filler JUMPDESTs to the final JUMPDEST, then STOP
+    static bytes jumpOver( size_t _filler ) {
+        bytes code{0x61, _byte_( ( _filler + 4 ) >> 8 ), _byte_( _filler + 4 ), 0x56};
+        code.resize( code.size() + _filler, 0x5b );
+        code.push_back( 0x5b );
+        code.push_back( 0x00 );
+        return code;
+    }
+
+    BlockHeader blockHeader{initBlockHeader()};
+    LastBlockHashes lastBlockHashes;
+    Address address{KeyPair::create().address()};
+    State state{0};
+    std::unique_ptr< SealEngineFace > se{
+        ChainParams( genesisInfo( Network::IstanbulTest ) ).createSealEngine()};
+    EnvInfo envInfo{blockHeader, lastBlockHashes, 0, se->chainParams().chainID};
+
+    u256 value = 0;
+    u256 gasPrice = 1;
+    u256 version = IstanbulSchedule.accountVersion;
+    int depth = 0;
+    bool isCreate = false;
+    bool staticCall = false;
+    u256 gas = 1000000;
+
+    std::unique_ptr< VMFace > vm{new LegacyVM};
+};
 }  // namespace
 
 BOOST_FIXTURE_TEST_SUITE( LegacyVMSuite, TestOutputHelperFixture )
@@ -1036,4 +1080,85 @@ BOOST_AUTO_TEST_CASE( SkaleInterpreterSelfBalanceisInvalidBeforeIstanbul,
 }
 BOOST_AUTO_TEST_SUITE_END()
 
+BOOST_FIXTURE_TEST_SUITE( LegacyVMCodeCacheSuite, CodeCacheFixture )
+
+BOOST_AUTO_TEST_CASE( LegacyVMCodeCacheSharesAnalysis ) {
+    bytes const code = jumpOver( 300 );
+    h256 const codeHash = sha3( code );
+
+    ExtVM first( state, envInfo, *se, address, address, address, value, gasPrice, {}, ref( code ),
+        codeHash, version, depth, isCreate, staticCall );
+    ExtVM second( state, envInfo, *se, address, address, address, value, gasPrice, {},
+        ref( code ), codeHash, version, depth, isCreate, staticCall );
+    BOOST_REQUIRE_EQUAL( first.analyzedCode(), second.analyzedCode() );
+    BOOST_REQUIRE_EQUAL( CodeCache::instance().find( codeHash ), first.analyzedCode() );
+    // frames borrow the cached bytes instead of copying them
+    BOOST_REQUIRE( first.code.data() == first.analyzedCode()->code().data() );
+
+    AnalyzedCode const& analyzed = *first.analyzedCode();
+    BOOST_REQUIRE_EQUAL( analyzed.size(), code.size() );
+    BOOST_REQUIRE_EQUAL( analyzed.executable().size(), code.size() + AnalyzedCode::c_padding );
+    BOOST_REQUIRE( !analyzed.isJumpDest( 0 ) );
+    BOOST_REQUIRE( analyzed.isJumpDest( 4 ) );
+    BOOST_REQUIRE( analyzed.isJumpDest( 304 ) );
+    BOOST_REQUIRE( !analyzed.isJumpDest( 305 ) );
+    BOOST_REQUIRE( !analyzed.isJumpDest( code.size() + 1 ) );
+
+    BOOST_REQUIRE_NO_THROW( run( code ) );
+    BOOST_REQUIRE_NO_THROW( run( code ) );
+
+    // JUMPDEST inside PUSH data is not a destination
+    bytes const intoPushData = fromHex( "600456605b00" );
+    BOOST_REQUIRE( !CodeCache::instance().get( sha3( intoPushData ), ref( intoPushData ) )
+                        ->isJumpDest( 4 ) );
+    BOOST_REQUIRE_THROW( run( intoPushData ), BadJumpDestination );
+}
+
+BOOST_AUTO_TEST_CASE( LegacyVMCodeCacheIsBounded ) {
+    CodeCache cache( 64 * 1024 );
+    for ( size_t i = 0; i < 64; ++i ) {
+        bytes const code = jumpOver( 1000 + i );
+        cache.get( sha3( code ), ref( code ) );
+    }
+    CodeCache::Stats stats = cache.stats();
+    BOOST_REQUIRE_EQUAL( stats.misses, 64U );
+    BOOST_REQUIRE_GT( stats.evictions, 0U );
+    BOOST_REQUIRE_LE( stats.bytes, stats.capacity );
+    BOOST_REQUIRE_EQUAL( stats.entries + stats.evictions, 64U );
+
+    bytes const code = jumpOver( 1063 );
+    cache.get( sha3( code ), ref( code ) );
+    BOOST_REQUIRE_EQUAL( cache.stats().hits, 1U );
+}
+
+BOOST_AUTO_TEST_CASE( LegacyVMCodeCachePerformance,
+    *utf::label( "perf" ) * boost::unit_test::precondition( dev::test::run_not_express ) ) {
+    if ( !test::Options::get().all ) {
+        std::cout << "Skipping test LegacyVMSuite/LegacyVMCodeCacheSuite/"
+                     "LegacyVMCodeCachePerformance. Use --all to run it.\n";
+        return;
+    }
+
+    const size_t calls = 20000;
+    // a contract of typical size that does little per call
+    bytes const code = jumpOver( 16 * 1024 );
+
+    for ( bool cached : {false, true} ) {
+        auto start = std::chrono::steady_clock::now();
+        for ( size_t i = 0; i < calls; ++i ) {
+            if ( !cached )
+                CodeCache::instance().clear();
+            run( code );
+        }
+        auto us = std::chrono::duration_cast< std::chrono::microseconds >(
+            std::chrono::steady_clock::now() - start )
+                      .count();
+        std::cout << ( cached ? "shared analysis: " : "analysis per call: " ) << calls
+                  << " calls in " << us / 1000 << " ms, " << double( us ) / calls
+                  << " us/call\n";
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -22,7 +22,9 @@
 #include <test/tools/libtesteth/TestOutputHelper.h>
 #include <boost/test/unit_test.hpp>
 
+#include <fstream>
 #include <iostream>
+#include <random>
 #include <string>
 
 #include "../libweb3jsonrpc/WebThreeStubClient.h"
@@ -580,4 +582,67 @@ BOOST_FIXTURE_TEST_CASE( hashing_speed_fs, SnapshotHashingFixture) {
 }
 
 
+BOOST_FIXTURE_TEST_CASE( hashing_speed_fs_synthetic, SnapshotHashingFixture ) {
+    TransientDirectory fsDir;
+    std::mt19937 random( 0 );
+    for ( int d = 0; d < 8; ++d ) {
+        boost::filesystem::path dir = fsDir.path() / ( "dir" + to_string( d ) );
+        boost::filesystem::create_directories( dir );
+        for ( int f = 0; f < 100; ++f ) {
+            // mostly small files and several big ones
+            size_t size = f % 25 == 0 ? 16 * 1024 * 1024 : random() % 64 * 1024;
+            std::string content( size, ' ' );
+            for ( auto& c : content )
+                c = random();
+            std::ofstream( ( dir / to_string( f ) ).string() ) << content;
+        }
+    }
+
+    // reference: whole files hashed one by one
+    secp256k1_sha256_t refCtx;
+    secp256k1_sha256_initialize( &refCtx );
+    auto t0 = std::chrono::high_resolution_clock::now();
+    boost::filesystem::recursive_directory_iterator it( fsDir.path() ), end;
+    for ( ; it != end; ++it ) {
+        dev::h256 hash = dev::sha256( it->path().string() );
+        if ( boost::filesystem::is_regular_file( *it ) ) {
+            std::ifstream file( it->path().string() );
+            std::string content( ( std::istreambuf_iterator< char >( file ) ),
+                std::istreambuf_iterator< char >() );
+            dev::h256 contentHash = dev::sha256( content );
+            secp256k1_sha256_t fileCtx;
+            secp256k1_sha256_initialize( &fileCtx );
+            secp256k1_sha256_write( &fileCtx, hash.data(), hash.size );
+            secp256k1_sha256_write( &fileCtx, contentHash.data(), contentHash.size );
+            secp256k1_sha256_finalize( &fileCtx, hash.data() );
+        }
+        secp256k1_sha256_write( &refCtx, hash.data(), hash.size );
+    }
+    dev::h256 refHash;
+    secp256k1_sha256_finalize( &refCtx, refHash.data() );
+
+    auto t1 = std::chrono::high_resolution_clock::now();
+    secp256k1_sha256_t ctx;
+    secp256k1_sha256_initialize( &ctx );
+    mgr->computeFileSystemHash( fsDir.path(), &ctx, true );
+    dev::h256 hash;
+    secp256k1_sha256_finalize( &ctx, hash.data() );
+
+    auto t2 = std::chrono::high_resolution_clock::now();
+    secp256k1_sha256_t cachedCtx;
+    secp256k1_sha256_initialize( &cachedCtx );
+    mgr->computeFileSystemHash( fsDir.path(), &cachedCtx, false );
+    dev::h256 cachedHash;
+    secp256k1_sha256_finalize( &cachedCtx, cachedHash.data() );
+    auto t3 = std::chrono::high_resolution_clock::now();
+
+    BOOST_REQUIRE_EQUAL( hash, refHash );
+    BOOST_REQUIRE_EQUAL( cachedHash, refHash );
+
+    std::cout << "Reference time = " << std::chrono::duration< double >( t1 - t0 ).count()
+              << " Time = " << std::chrono::duration< double >( t2 - t1 ).count()
+              << " With ._hash files = " << std::chrono::duration< double >( t3 - t2 ).count()
+              << std::endl;
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,166 @@
+#include <libdevcore/CommonJS.h>
+#include <libethereum/LogFilter.h>
+#include <libskale/httpserveroverride.h>
+#include <test/tools/libtesteth/TestOutputHelper.h>
+#include <boost/test/unit_test.hpp>
+
+#include <json.hpp>
+
+using namespace std;
+using namespace dev;
+using namespace dev::eth;
+using namespace dev::test;
+
+namespace {
+int const c_peer1 = 1, c_peer2 = 2;
+SkaleLogsFanOut::peer_key_t const peer1 = &c_peer1, peer2 = &c_peer2;
+
+LocalisedLogEntry minedLog(
+    Address const& _address, h256s const& _topics, BlockNumber _blockNumber = 1 ) {
+    return LocalisedLogEntry( LogEntry( _address, _topics, bytes() ), h256( _blockNumber ),
+        _blockNumber, h256( 100 ), 0, 0 );
+}
+
+// subscriptions notified by the batches, in order of notifications
+vector< SkaleLogsFanOut::subscription_id_t > notified(
+    SkaleLogsFanOut::map_peer_batches_t const& _batches ) {
+    vector< SkaleLogsFanOut::subscription_id_t > ret;
+    for ( auto const& batchEntry : _batches )
+        for ( string const& strNotification : batchEntry.second->m_notifications )
+            ret.push_back( SkaleLogsFanOut::subscription_id_t( jsToInt(
+                nlohmann::json::parse( strNotification )["params"]["subscription"]
+                    .get< string >() ) ) );
+    sort( ret.begin(), ret.end() );
+    return ret;
+}
+}  // namespace
+
+BOOST_FIXTURE_TEST_SUITE( LogsSubscriptionTests, TestOutputHelperFixture )
+
+BOOST_AUTO_TEST_CASE( groups_identical_filters ) {
+    Address const token( 1 );
+    SkaleLogsFanOut fanOut;
+    fanOut.add( 1, peer1, LogFilter().address( token ) );
+    fanOut.add( 2, peer2, LogFilter().address( token ) );
+    fanOut.add( 3, peer2, LogFilter().address( token ).withEarliest( 10 ) );
+    BOOST_REQUIRE_EQUAL( fanOut.groupCount(), 2U );
+    BOOST_REQUIRE_EQUAL( fanOut.stats()["subscriptions"].get< size_t >(), 3U );
+    BOOST_REQUIRE_EQUAL( fanOut.stats()["indexedAddresses"].get< size_t >(), 1U );
+
+    BOOST_REQUIRE( fanOut.remove( 1 ) );
+    BOOST_REQUIRE( !fanOut.remove( 1 ) );
+    BOOST_REQUIRE_EQUAL( fanOut.groupCount(), 2U );
+    BOOST_REQUIRE( fanOut.remove( 2 ) );
+    BOOST_REQUIRE_EQUAL( fanOut.groupCount(), 1U );
+    BOOST_REQUIRE( fanOut.remove( 3 ) );
+    BOOST_REQUIRE( fanOut.empty() );
+    BOOST_REQUIRE_EQUAL( fanOut.stats()["indexedAddresses"].get< size_t >(), 0U );
+}
+
+BOOST_AUTO_TEST_CASE( finds_groups_by_address_and_topic ) {
+    Address const token( 1 ), other( 2 );
+    h256 const transfer( 10 ), approval( 11 ), to( 12 );
+    SkaleLogsFanOut fanOut;
+    fanOut.add( 1, peer1, LogFilter().address( token ) );
+    // indexed by the first constrained slot only
+    fanOut.add( 2, peer1, LogFilter().topic( 1, to ).topic( 2, approval ) );
+    fanOut.add( 3, peer1, LogFilter().topic( 0, approval ) );
+    fanOut.add( 4, peer1, LogFilter() );
+    nlohmann::json const joStats = fanOut.stats();
+    BOOST_REQUIRE_EQUAL( joStats["indexedAddresses"].get< size_t >(), 1U );
+    BOOST_REQUIRE_EQUAL( joStats["indexedTopics"].get< size_t >(), 2U );
+    BOOST_REQUIRE_EQUAL( joStats["unindexedGroups"].get< size_t >(), 1U );
+
+    BOOST_REQUIRE( notified( fanOut.fanOut( {minedLog( token, {transfer} )} ) ) ==
+                   vector< SkaleLogsFanOut::subscription_id_t >( {1, 4} ) );
+    BOOST_REQUIRE( notified( fanOut.fanOut( {minedLog( other, {transfer, to, approval} )} ) ) ==
+                   vector< SkaleLogsFanOut::subscription_id_t >( {2, 4} ) );
+    // candidate by topic which does not match the whole filter
+    BOOST_REQUIRE( notified( fanOut.fanOut( {minedLog( other, {transfer, to} )} ) ) ==
+                   vector< SkaleLogsFanOut::subscription_id_t >( {4} ) );
+    BOOST_REQUIRE( notified( fanOut.fanOut( {minedLog( other, {approval} )} ) ) ==
+                   vector< SkaleLogsFanOut::subscription_id_t >( {3, 4} ) );
+
+    // pending and special entries are not notified
+    LocalisedLogEntry pending( LogEntry( token, h256s{transfer}, bytes() ) );
+    BOOST_REQUIRE( fanOut.fanOut( {pending} ).empty() );
+}
+
+BOOST_AUTO_TEST_CASE( serializes_log_once_for_group ) {
+    Address const token( 1 );
+    SkaleLogsFanOut fanOut;
+    fanOut.add( 1, peer1, LogFilter().address( token ) );
+    fanOut.add( 2, peer2, LogFilter().address( token ) );
+    fanOut.add( 3, peer2, LogFilter() );
+
+    SkaleLogsFanOut::map_peer_batches_t const batches =
+        fanOut.fanOut( {minedLog( token, {h256( 10 )}, 7 )} );
+    BOOST_REQUIRE_EQUAL( fanOut.cntLogsSerialized_.load(), 1U );
+    BOOST_REQUIRE_EQUAL( batches.size(), 2U );
+    BOOST_REQUIRE_EQUAL( batches.at( peer1 )->m_notifications.size(), 1U );
+    BOOST_REQUIRE_EQUAL( batches.at( peer2 )->m_notifications.size(), 2U );
+    BOOST_REQUIRE(
+        batches.at( peer2 )->m_ids == set< SkaleLogsFanOut::subscription_id_t >( {2, 3} ) );
+
+    // every notification carries the same log, under its own subscription
+    nlohmann::json const joFirst =
+        nlohmann::json::parse( batches.at( peer1 )->m_notifications.front() );
+    BOOST_REQUIRE_EQUAL( joFirst["method"], "eth_subscription" );
+    BOOST_REQUIRE_EQUAL( joFirst["params"]["result"]["blockNumber"].get< unsigned >(), 7U );
+    size_t nBytes = 0;
+    for ( string const& strNotification : batches.at( peer2 )->m_notifications ) {
+        nlohmann::json const jo = nlohmann::json::parse( strNotification );
+        BOOST_REQUIRE( jo["params"]["result"] == joFirst["params"]["result"] );
+        BOOST_REQUIRE( jo["params"]["subscription"] != joFirst["params"]["subscription"] );
+        // same text as the notification object would be serialized to
+        BOOST_REQUIRE_EQUAL( jo.dump(), strNotification );
+        nBytes += strNotification.size();
+    }
+    BOOST_REQUIRE_EQUAL( batches.at( peer2 )->m_nBytes, nBytes );
+}
+
+BOOST_AUTO_TEST_CASE( applies_block_range_of_filter ) {
+    Address const token( 1 );
+    SkaleLogsFanOut fanOut;
+    fanOut.add( 1, peer1, LogFilter( 10, 20 ).address( token ) );
+    fanOut.add( 2, peer1, LogFilter( LatestBlock, PendingBlock ).address( token ) );
+
+    BOOST_REQUIRE( notified( fanOut.fanOut( {minedLog( token, {}, 9 )} ) ) ==
+                   vector< SkaleLogsFanOut::subscription_id_t >( {2} ) );
+    BOOST_REQUIRE( notified( fanOut.fanOut( {minedLog( token, {}, 10 )} ) ) ==
+                   vector< SkaleLogsFanOut::subscription_id_t >( {1, 2} ) );
+    BOOST_REQUIRE( notified( fanOut.fanOut( {minedLog( token, {}, 20 )} ) ) ==
+                   vector< SkaleLogsFanOut::subscription_id_t >( {1, 2} ) );
+    BOOST_REQUIRE( notified( fanOut.fanOut( {minedLog( token, {}, 21 )} ) ) ==
+                   vector< SkaleLogsFanOut::subscription_id_t >( {2} ) );
+}
+
+BOOST_AUTO_TEST_CASE( disconnects_slow_peer ) {
+    Address const token( 1 );
+    SkaleLogsFanOut fanOut;
+    fanOut.add( 1, peer1, LogFilter().address( token ) );
+    fanOut.add( 2, peer2, LogFilter().address( token ) );
+    SkaleLogsFanOut::map_peer_batches_t const batches =
+        fanOut.fanOut( {minedLog( token, {} ), minedLog( token, {}, 2 )} );
+    size_t const nBatchBytes = batches.at( peer1 )->m_nBytes;
+
+    // peer1 has not read enough to take one more batch
+    size_t const nMaxPendingBytes = 10 * nBatchBytes;
+    map< SkaleLogsFanOut::peer_key_t, size_t > mapPending = {
+        {peer1, nMaxPendingBytes - nBatchBytes + 1}, {peer2, nMaxPendingBytes - nBatchBytes}};
+    vector< SkaleLogsFanOut::peer_key_t > sent, disconnected;
+    fanOut.deliver( batches, nMaxPendingBytes,
+        [&]( SkaleLogsFanOut::peer_key_t _peer ) { return mapPending.at( _peer ); },
+        [&]( SkaleLogsFanOut::peer_key_t _peer, SkaleLogsFanOut::peer_batch_ptr_t const& ) {
+            sent.push_back( _peer );
+        },
+        [&]( SkaleLogsFanOut::peer_key_t _peer, SkaleLogsFanOut::peer_batch_ptr_t const& ) {
+            disconnected.push_back( _peer );
+        } );
+    BOOST_REQUIRE( sent == vector< SkaleLogsFanOut::peer_key_t >( {peer2} ) );
+    BOOST_REQUIRE( disconnected == vector< SkaleLogsFanOut::peer_key_t >( {peer1} ) );
+    BOOST_REQUIRE_EQUAL( fanOut.cntLogPeersDisconnected_.load(), 1U );
+    BOOST_REQUIRE_EQUAL( fanOut.cntLogNotificationsDropped_.load(), 2U );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,105 @@
+#include <libdevcore/Common.h>
+#include <libdevcore/LevelDB.h>
+#include <libdevcore/TransientDirectory.h>
+#include <libskale/OverlayDB.h>
+#include <test/tools/libtesteth/TestOutputHelper.h>
+#include <boost/test/unit_test.hpp>
+
+using namespace std;
+
+using namespace dev::test;
+using namespace dev;
+
+BOOST_FIXTURE_TEST_SUITE( OverlayDBTests, TestOutputHelperFixture )
+
+BOOST_AUTO_TEST_CASE( read_cache_survives_commit ) {
+    TransientDirectory td;
+    skale::OverlayDB db( unique_ptr< db::DatabaseFace >( new db::LevelDB( td.path() ) ) );
+    h160 const address( 1 );
+    h256 const slot( 2 );
+
+    db.insert( address, dev::ref( asBytes( "account" ) ) );
+    db.insert( address, slot, h256( 3 ) );
+    db.insertAuxiliary( address, dev::ref( asBytes( "code" ) ) );
+    db.commit();
+
+    BOOST_REQUIRE_EQUAL( db.lookup( address ), "account" );
+    BOOST_REQUIRE_EQUAL( db.lookup( address, slot ), h256( 3 ) );
+    BOOST_REQUIRE_EQUAL( db.lookupAuxiliary( address ), "code" );
+    BOOST_REQUIRE_EQUAL( db.readCacheStats().misses, 3U );
+    BOOST_REQUIRE_EQUAL( db.readCacheStats().entries, 3U );
+
+    // commits refresh cached records in place
+    db.insert( address, dev::ref( asBytes( "changed" ) ) );
+    db.insert( address, slot, h256( 4 ) );
+    db.commit();
+
+    BOOST_REQUIRE_EQUAL( db.lookup( address ), "changed" );
+    BOOST_REQUIRE_EQUAL( db.lookup( address, slot ), h256( 4 ) );
+    BOOST_REQUIRE_EQUAL( db.lookupAuxiliary( address ), "code" );
+    BOOST_REQUIRE( db.exists( address ) );
+    BOOST_REQUIRE_EQUAL( db.readCacheStats().hits, 4U );
+    BOOST_REQUIRE_EQUAL( db.readCacheStats().misses, 3U );
+
+    // uncommitted changes are not seen by copies, rolled back ones are gone
+    skale::OverlayDB copy = db;
+    db.insert( address, dev::ref( asBytes( "uncommitted" ) ) );
+    BOOST_REQUIRE_EQUAL( copy.lookup( address ), "changed" );
+    db.rollback();
+    BOOST_REQUIRE_EQUAL( db.lookup( address ), "changed" );
+
+    // copies share the cache, direct kills invalidate it
+    copy.kill( address );
+    copy.killAuxiliary( address );
+    BOOST_REQUIRE( !db.exists( address ) );
+    BOOST_REQUIRE( db.lookup( address ).empty() );
+    BOOST_REQUIRE_EQUAL( db.readCacheStats().invalidations, 2U );
+
+    db.clearDB();
+    BOOST_REQUIRE_EQUAL( db.lookup( address, slot ), h256( 0 ) );
+}
+
+BOOST_AUTO_TEST_CASE( read_cache_is_bounded ) {
+    TransientDirectory td;
+    size_t const capacity = 64 * 1024;
+    skale::OverlayDB db(
+        unique_ptr< db::DatabaseFace >( new db::LevelDB( td.path() ) ), capacity );
+    h160 const address( 1 );
+
+    for ( unsigned i = 0; i < 4096; ++i )
+        db.insert( address, h256( i ), h256( i + 1 ) );
+    db.commit();
+    for ( unsigned i = 0; i < 4096; ++i )
+        BOOST_REQUIRE_EQUAL( db.lookup( address, h256( i ) ), h256( i + 1 ) );
+
+    skale::OverlayReadCache::Stats stats = db.readCacheStats();
+    BOOST_REQUIRE_LE( stats.bytes, capacity );
+    BOOST_REQUIRE_GT( stats.evictions, 0U );
+    BOOST_REQUIRE_EQUAL( stats.insertions - stats.evictions, stats.entries );
+
+    boost::filesystem::path const otherPath = boost::filesystem::path( td.path() ) / "other";
+    skale::OverlayDB uncached( unique_ptr< db::DatabaseFace >( new db::LevelDB( otherPath ) ), 0 );
+    BOOST_REQUIRE( uncached.lookup( address ).empty() );
+    BOOST_REQUIRE_EQUAL( uncached.readCacheStats().misses, 0U );
+}
+
+BOOST_AUTO_TEST_CASE( read_cache_ignores_stale_fills ) {
+    skale::OverlayReadCache cache( 1024 * 1024 );
+    string value;
+
+    uint64_t generation = cache.generation( "key" );
+    cache.update( "key", "new" );  // a commit raced with the database read
+    cache.fill( "key", "old", generation );
+    BOOST_REQUIRE( !cache.find( "key", value ) );
+
+    cache.fill( "key", "new", cache.generation( "key" ) );
+    BOOST_REQUIRE( cache.find( "key", value ) );
+    BOOST_REQUIRE_EQUAL( value, "new" );
+
+    generation = cache.generation( "key" );
+    cache.invalidate( "key" );
+    cache.fill( "key", "new", generation );
+    BOOST_REQUIRE( !cache.find( "key", value ) );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
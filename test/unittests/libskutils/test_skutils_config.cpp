@@ -0,0 +1,36 @@
+#include "test_skutils_helper.h"
+#include <libdevcore/TransientDirectory.h>
+#include <boost/test/unit_test.hpp>
+#include <fstream>
+
+BOOST_AUTO_TEST_SUITE( SkUtils )
+BOOST_AUTO_TEST_SUITE( config )
+
+BOOST_AUTO_TEST_CASE( snapshot_paths ) {
+    skutils::test::test_print_header_name( "SkUtils/config/snapshot_paths" );
+    dev::TransientDirectory td;
+    std::string strPath = td.path() + "/config.json";
+    std::ofstream( strPath ) << R"({"skaleConfig":{"nodeInfo":{"nodeID":7,"name":"node"},)"
+                             << R"("list":[{"a":"0x1"},{"a":"0x2"}],"odd.key":{"x":1}}})";
+    skutils::json_config_file_accessor accessor( strPath );
+    skutils::json_config_snapshot_ptr_t pSnapshot = accessor.getConfigSnapshot();
+    BOOST_REQUIRE_EQUAL( pSnapshot->version(), size_t( 1 ) );
+    BOOST_REQUIRE( accessor.getConfigSnapshot() == pSnapshot );
+
+    // looked up paths and ones resolved by walking give same values
+    for ( const char* strValuePath :
+        {"skaleConfig.nodeInfo.nodeID", "skaleConfig.nodeInfo", "skaleConfig.list.1.a",
+            "skaleConfig.list.count", "skaleConfig.list.[0].a", "skaleConfig.nodeInfo.name."} )
+        BOOST_REQUIRE_EQUAL( pSnapshot->extract_at_path( strValuePath ),
+            skutils::json_config_file_accessor::stat_extract_at_path(
+                pSnapshot->json(), strValuePath ) );
+    BOOST_REQUIRE_EQUAL(
+        pSnapshot->extract_at_path( "skaleConfig.list.size" ).get< size_t >(), size_t( 2 ) );
+    BOOST_REQUIRE_THROW(
+        pSnapshot->extract_at_path( "skaleConfig.nodeInfo.missing" ), std::runtime_error );
+    BOOST_REQUIRE_THROW(
+        pSnapshot->extract_at_path( "skaleConfig.odd.key.x" ), std::runtime_error );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
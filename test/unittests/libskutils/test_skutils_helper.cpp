@@ -536,8 +536,8 @@ bool test_server_wss::isSSL() const {
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-test_server_http_base::test_server_http_base(
-    const char* strScheme, int nListenPort, bool is_async_http_transfer_mode )
+test_server_http_base::test_server_http_base( const char* strScheme, int nListenPort,
+    bool is_async_http_transfer_mode, size_t epoll_io_threads )
     : test_server( strScheme, nListenPort ) {
     if ( strScheme_ == "https" ) {
         auto& ssl_info = helper_ssl_info();
@@ -547,6 +547,7 @@ test_server_http_base::test_server_http_base(
     } else
         pServer_.reset( new skutils::http::server(
             __SKUTILS_HTTP_DEFAULT_MAX_PARALLEL_QUEUES_COUNT__, is_async_http_transfer_mode ) );
+    pServer_->epoll_io_threads_ = epoll_io_threads;
     pServer_->Options(
         "/", [&]( const skutils::http::request& /*req*/, skutils::http::response& res ) {
             test_log_s( cc::info( "OPTTIONS" ) + cc::debug( " request handler" ) );
@@ -593,8 +594,10 @@ void test_server_http_base::run() {
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-test_server_http::test_server_http( int nListenPort, bool is_async_http_transfer_mode )
-    : test_server_http_base( "http", nListenPort, is_async_http_transfer_mode ) {}
+test_server_http::test_server_http(
+    int nListenPort, bool is_async_http_transfer_mode, size_t epoll_io_threads )
+    : test_server_http_base(
+          "http", nListenPort, is_async_http_transfer_mode, epoll_io_threads ) {}
 test_server_http::~test_server_http() {}
 
 bool test_server_http::isSSL() const {
@@ -1114,6 +1117,9 @@ void with_test_server(
     } else if ( sus == "http_sync" ) {
         pServer.reset( new test_server_http( nSocketListenPort, false ) );
         BOOST_REQUIRE( !pServer->isSSL() );
+    } else if ( sus == "http_epoll" ) {
+        pServer.reset( new test_server_http( nSocketListenPort, true, 2 ) );
+        BOOST_REQUIRE( !pServer->isSSL() );
     } else {
         test_log_se( cc::error( "Unknown server type: " ) + cc::warn( strServerUrlScheme ) );
         throw std::runtime_error( "Unknown server type: " + strServerUrlScheme );
@@ -1184,7 +1190,8 @@ void with_test_client( fn_with_test_client_t fn, const std::string& strTestClien
         pClient.reset( new test_client_https(
             strTestClientName.c_str(), nSocketListenPort, nConnectAttempts ) );
         BOOST_REQUIRE( pClient->isSSL() );
-    } else if ( sus == "http" || sus == "http_async" || sus == "http_sync" ) {
+    } else if ( sus == "http" || sus == "http_async" || sus == "http_sync" ||
+                sus == "http_epoll" ) {
         pClient.reset( new test_client_http(
             strTestClientName.c_str(), nSocketListenPort, nConnectAttempts ) );
         BOOST_REQUIRE( !pClient->isSSL() );
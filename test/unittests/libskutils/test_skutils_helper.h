@@ -199,8 +199,8 @@ class test_server_http_base : public test_server {
     std::shared_ptr< skutils::http::server > pServer_;  // pointer to skutils::http::server or
                                                         // skutils::SSL_server
 public:
-    test_server_http_base(
-        const char* strScheme, int nListenPort, bool is_async_http_transfer_mode = true );
+    test_server_http_base( const char* strScheme, int nListenPort,
+        bool is_async_http_transfer_mode = true, size_t epoll_io_threads = 0 );
     virtual ~test_server_http_base();
     void stop() override;
     void run() override;
@@ -211,7 +211,8 @@ public:
 
 class test_server_http : public test_server_http_base {
 public:
-    test_server_http( int nListenPort, bool is_async_http_transfer_mode = true );
+    test_server_http(
+        int nListenPort, bool is_async_http_transfer_mode = true, size_t epoll_io_threads = 0 );
     virtual ~test_server_http();
     bool isSSL() const override;
 };
@@ -1,6 +1,99 @@
 #include "test_skutils_helper.h"
+#include <test/tools/libtesteth/TestHelper.h>
 #include <boost/test/unit_test.hpp>
 
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace utf = boost::unit_test;
+
+namespace {
+
+// plain HTTP server echoing POST bodies, listening on any free port in its own thread
+struct echo_server {
+    skutils::http::server srv_;
+    std::thread thread_;
+    int port_ = -1;
+    echo_server( bool is_async, size_t epoll_io_threads, size_t keep_alive_max_count )
+        : srv_( __SKUTILS_HTTP_DEFAULT_MAX_PARALLEL_QUEUES_COUNT__, is_async ) {
+        srv_.epoll_io_threads_ = epoll_io_threads;
+        srv_.set_keep_alive_max_count( keep_alive_max_count );
+        srv_.Post( "/", []( const skutils::http::request& req, skutils::http::response& res ) {
+            res.set_content( req.body_, "text/plain" );
+        } );
+        port_ = srv_.bind_to_any_port( 4, "127.0.0.1" );
+        thread_ = std::thread( [this]() { srv_.listen_after_bind(); } );
+    }
+    ~echo_server() {
+        srv_.stop();
+        thread_.join();
+    }
+};
+
+int connect_to( int port ) {
+    int sock = ::socket( AF_INET, SOCK_STREAM, 0 );
+    if ( sock < 0 )
+        return -1;
+    timeval tv;
+    tv.tv_sec = 10;
+    tv.tv_usec = 0;
+    ::setsockopt( sock, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof( tv ) );
+    sockaddr_in addr;
+    memset( &addr, 0, sizeof( addr ) );
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons( uint16_t( port ) );
+    addr.sin_addr.s_addr = htonl( INADDR_LOOPBACK );
+    if (::connect( sock, ( sockaddr* ) &addr, sizeof( addr ) ) != 0 ) {
+        ::close( sock );
+        return -1;
+    }
+    return sock;
+}
+
+bool send_all( int sock, const std::string& data ) {
+    for ( size_t pos = 0; pos < data.size(); ) {
+        auto n = ::send( sock, data.data() + pos, data.size() - pos, 0 );
+        if ( n <= 0 )
+            return false;
+        pos += size_t( n );
+    }
+    return true;
+}
+
+std::string post_request( const std::string& body, const std::string& extra_headers = "" ) {
+    return "POST / HTTP/1.1\r\nHost: localhost\r\nContent-Type: text/plain\r\n" + extra_headers +
+           "Content-Length: " + std::to_string( body.size() ) + "\r\n\r\n" + body;
+}
+
+// reads one response, bytes of the following ones stay in io_buffer
+bool read_response( int sock, std::string& io_buffer, std::string& body, bool& is_close ) {
+    for ( ;; ) {
+        size_t headers_end = io_buffer.find( "\r\n\r\n" );
+        if ( headers_end != std::string::npos ) {
+            std::string headers = io_buffer.substr( 0, headers_end + 2 );
+            size_t pos = headers.find( "Content-Length: " );
+            size_t length =
+                ( pos == std::string::npos ) ? 0 : std::stoul( headers.substr( pos + 16 ) );
+            if ( io_buffer.size() >= headers_end + 4 + length ) {
+                body = io_buffer.substr( headers_end + 4, length );
+                is_close = headers.find( "Connection: close" ) != std::string::npos;
+                io_buffer.erase( 0, headers_end + 4 + length );
+                return true;
+            }
+        }
+        char buf[4096];
+        auto n = ::recv( sock, buf, sizeof( buf ), 0 );
+        if ( n <= 0 )
+            return false;
+        io_buffer.append( buf, size_t( n ) );
+    }
+}
+
+}  // namespace
+
 BOOST_AUTO_TEST_SUITE( SkUtils )
 BOOST_AUTO_TEST_SUITE( http )
 
@@ -44,6 +137,25 @@ BOOST_AUTO_TEST_CASE( http_parallel_calls_sync ) {
         "http_sync", skutils::test::g_nDefaultPort, skutils::test::g_vecTestClientNamesA );
 }
 
+BOOST_AUTO_TEST_CASE( http_server_startup_epoll ) {
+    skutils::test::test_print_header_name( "SkUtils/http/http_server_startup_epoll" );
+    skutils::test::test_protocol_server_startup( "http_epoll", skutils::test::g_nDefaultPort );
+}
+BOOST_AUTO_TEST_CASE( http_single_call_epoll ) {
+    skutils::test::test_print_header_name( "SkUtils/http/http_single_call_epoll" );
+    skutils::test::test_protocol_single_call( "http_epoll", skutils::test::g_nDefaultPort );
+}
+BOOST_AUTO_TEST_CASE( http_serial_calls_epoll ) {
+    skutils::test::test_print_header_name( "SkUtils/http/http_serial_calls_epoll" );
+    skutils::test::test_protocol_serial_calls(
+        "http_epoll", skutils::test::g_nDefaultPort, skutils::test::g_vecTestClientNamesA );
+}
+BOOST_AUTO_TEST_CASE( http_parallel_calls_epoll ) {
+    skutils::test::test_print_header_name( "SkUtils/http/http_parallel_calls_epoll" );
+    skutils::test::test_protocol_parallel_calls(
+        "http_epoll", skutils::test::g_nDefaultPort, skutils::test::g_vecTestClientNamesA );
+}
+
 BOOST_AUTO_TEST_CASE( http_busy_port ) {
     skutils::test::test_print_header_name( "SkUtils/http/http_busy_port" );
     skutils::test::test_protocol_busy_port( "http", skutils::test::g_nDefaultPort );
@@ -95,5 +207,170 @@ BOOST_AUTO_TEST_CASE( https_busy_port ) {
     skutils::test::test_protocol_busy_port( "https", skutils::test::g_nDefaultPort );
 }
 
+BOOST_AUTO_TEST_CASE( http_range_header ) {
+    skutils::test::test_print_header_name( "SkUtils/http/http_range_header" );
+    uint64_t offset = 0, length = 0;
+    BOOST_REQUIRE( skutils::http::parse_range_header( "bytes=0-99", 1000, offset, length ) );
+    BOOST_REQUIRE( offset == 0 && length == 100 );
+    BOOST_REQUIRE( skutils::http::parse_range_header( "bytes=900-", 1000, offset, length ) );
+    BOOST_REQUIRE( offset == 900 && length == 100 );
+    BOOST_REQUIRE( skutils::http::parse_range_header( "bytes=-300", 1000, offset, length ) );
+    BOOST_REQUIRE( offset == 700 && length == 300 );
+    // last byte past the end is cut, first one past the end is not satisfiable
+    BOOST_REQUIRE( skutils::http::parse_range_header( "bytes=990-5000", 1000, offset, length ) );
+    BOOST_REQUIRE( offset == 990 && length == 10 );
+    BOOST_REQUIRE( !skutils::http::parse_range_header( "bytes=1000-", 1000, offset, length ) );
+    BOOST_REQUIRE( !skutils::http::parse_range_header( "bytes=50-10", 1000, offset, length ) );
+    BOOST_REQUIRE( !skutils::http::parse_range_header( "bytes=-", 1000, offset, length ) );
+    BOOST_REQUIRE( !skutils::http::parse_range_header( "bytes=0-1,5-6", 1000, offset, length ) );
+    BOOST_REQUIRE( !skutils::http::parse_range_header( "items=0-1", 1000, offset, length ) );
+}
+
+BOOST_AUTO_TEST_CASE( http_epoll_request_framing ) {
+    skutils::test::test_print_header_name( "SkUtils/http/http_epoll_request_framing" );
+    typedef skutils::http::epoll_reactor reactor;
+    const size_t npos = std::string::npos;
+    const std::string get = "GET /x HTTP/1.1\r\nHost: a\r\n\r\n";
+    BOOST_REQUIRE_EQUAL( reactor::complete_request_size( get.substr( 0, 20 ), false ), 0 );
+    BOOST_REQUIRE_EQUAL( reactor::complete_request_size( get + "GET", false ), get.size() );
+    const std::string post = post_request( "0123456789" );
+    BOOST_REQUIRE_EQUAL( reactor::complete_request_size( post.substr( 0, post.size() - 1 ), false ),
+        0 );
+    BOOST_REQUIRE_EQUAL( reactor::complete_request_size( post + post, false ), post.size() );
+    const std::string chunked =
+        "POST / HTTP/1.1\r\ntransfer-encoding: Chunked\r\n\r\n2\r\nab\r\n0\r\n\r\n";
+    BOOST_REQUIRE_EQUAL(
+        reactor::complete_request_size( chunked.substr( 0, chunked.size() - 2 ), false ), 0 );
+    BOOST_REQUIRE_EQUAL( reactor::complete_request_size( chunked, false ), chunked.size() );
+    // body without length lasts until peer closes its side
+    const std::string unbounded = "POST / HTTP/1.1\r\n\r\nabc";
+    BOOST_REQUIRE_EQUAL( reactor::complete_request_size( unbounded, false ), 0 );
+    BOOST_REQUIRE_EQUAL( reactor::complete_request_size( unbounded, true ), unbounded.size() );
+    // oversized requests are refused before they are received
+    BOOST_REQUIRE_EQUAL( reactor::complete_request_size(
+                             "POST / HTTP/1.1\r\nContent-Length: 999999999999\r\n\r\n", false ),
+        npos );
+    const std::string endless( __SKUTILS_HTTP_EPOLL_MAX_HEADERS_SIZE__ + 1, 'a' );
+    BOOST_REQUIRE_EQUAL( reactor::complete_request_size( endless, false ), npos );
+}
+
+BOOST_AUTO_TEST_CASE( http_epoll_keep_alive_and_pipelining ) {
+    skutils::test::test_print_header_name( "SkUtils/http/http_epoll_keep_alive_and_pipelining" );
+    echo_server server( true, 2, 100 );
+    int sock = connect_to( server.port_ );
+    BOOST_REQUIRE( sock >= 0 );
+    std::string buffer, body;
+    bool is_close = false;
+    // sequential requests share one connection
+    for ( int i = 0; i < 10; ++i ) {
+        std::string text = "request " + std::to_string( i );
+        BOOST_REQUIRE( send_all( sock, post_request( text ) ) );
+        BOOST_REQUIRE( read_response( sock, buffer, body, is_close ) );
+        BOOST_REQUIRE_EQUAL( body, text );
+        BOOST_REQUIRE( !is_close );
+    }
+    // request arriving in pieces is handled once complete
+    std::string split = post_request( "split" );
+    BOOST_REQUIRE( send_all( sock, split.substr( 0, 20 ) ) );
+    std::this_thread::sleep_for( std::chrono::milliseconds( 50 ) );
+    BOOST_REQUIRE( send_all( sock, split.substr( 20 ) ) );
+    BOOST_REQUIRE( read_response( sock, buffer, body, is_close ) );
+    BOOST_REQUIRE_EQUAL( body, "split" );
+    // pipelined requests are answered in order
+    const std::string second =
+        "POST / HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n3\r\nsec\r\n3\r\nond\r\n0\r\n\r\n";
+    BOOST_REQUIRE( send_all( sock, post_request( "first" ) + second +
+                                       post_request( "third", "Connection: close\r\n" ) ) );
+    for ( const char* text : {"first", "second", "third"} ) {
+        BOOST_REQUIRE( read_response( sock, buffer, body, is_close ) );
+        BOOST_REQUIRE_EQUAL( body, text );
+    }
+    BOOST_REQUIRE( is_close );
+    char c = 0;
+    BOOST_REQUIRE_EQUAL( ::recv( sock, &c, 1, 0 ), 0 );
+    ::close( sock );
+
+    // connection is closed after keep-alive count of requests
+    echo_server limited( true, 1, 2 );
+    sock = connect_to( limited.port_ );
+    BOOST_REQUIRE( sock >= 0 );
+    buffer.clear();
+    BOOST_REQUIRE( send_all( sock, post_request( "a" ) ) );
+    BOOST_REQUIRE( read_response( sock, buffer, body, is_close ) );
+    BOOST_REQUIRE( !is_close );
+    BOOST_REQUIRE( send_all( sock, post_request( "b" ) ) );
+    BOOST_REQUIRE( read_response( sock, buffer, body, is_close ) );
+    BOOST_REQUIRE( is_close );
+    BOOST_REQUIRE_EQUAL( ::recv( sock, &c, 1, 0 ), 0 );
+    ::close( sock );
+}
+
+BOOST_AUTO_TEST_CASE( http_connection_scaling,
+    *utf::label( "perf" ) * boost::unit_test::precondition( dev::test::run_not_express ) ) {
+    if ( !dev::test::Options::get().all ) {
+        std::cout << "Skipping test SkUtils/http/http_connection_scaling. Use --all to run it.\n";
+        return;
+    }
+    // client and server ends of every connection are in this process
+    rlimit rl;
+    ::getrlimit( RLIMIT_NOFILE, &rl );
+    rl.rlim_cur = rl.rlim_max;
+    ::setrlimit( RLIMIT_NOFILE, &rl );
+    ::getrlimit( RLIMIT_NOFILE, &rl );
+
+    const size_t rounds = 5;
+    for ( size_t connections : {100, 1000, 5000} ) {
+        if ( connections * 2 + 256 > rl.rlim_cur ) {
+            std::cout << connections << " connections: skipped, open files limit is "
+                      << rl.rlim_cur << "\n";
+            continue;
+        }
+        for ( bool is_epoll : {false, true} ) {
+            // async mode answers one request per connection, so clients reconnect, and it
+            // accepts through a short backlog, so it's measured on the smallest count only
+            if ( !is_epoll && connections > 100 )
+                continue;
+            echo_server server( true, is_epoll ? 2 : 0, rounds + 1 );
+            std::vector< int > socks( connections, -1 );
+            std::vector< std::string > buffers( connections );
+            size_t answered = 0, reconnects = 0;
+            auto start = std::chrono::steady_clock::now();
+            for ( size_t round = 0; round < rounds; ++round ) {
+                for ( size_t i = 0; i < connections; ++i ) {
+                    if ( socks[i] < 0 ) {
+                        socks[i] = connect_to( server.port_ );
+                        buffers[i].clear();
+                        if ( round > 0 )
+                            ++reconnects;
+                    }
+                    send_all( socks[i], post_request( std::to_string( i ) ) );
+                }
+                for ( size_t i = 0; i < connections; ++i ) {
+                    std::string body;
+                    bool is_close = true;
+                    if ( read_response( socks[i], buffers[i], body, is_close ) &&
+                         body == std::to_string( i ) )
+                        ++answered;
+                    if ( is_close ) {
+                        ::close( socks[i] );
+                        socks[i] = -1;
+                    }
+                }
+            }
+            auto ms = std::chrono::duration_cast< std::chrono::milliseconds >(
+                std::chrono::steady_clock::now() - start )
+                          .count();
+            for ( int sock : socks )
+                if ( sock >= 0 )
+                    ::close( sock );
+            BOOST_REQUIRE_EQUAL( answered, connections * rounds );
+            std::cout << connections << " connections, " << ( is_epoll ? "epoll" : "async" )
+                      << " mode: " << answered << " requests in " << ms << " ms, "
+                      << ( ms ? answered * 1000 / ms : 0 ) << " req/s, " << reconnects
+                      << " reconnects\n";
+        }
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 BOOST_AUTO_TEST_SUITE_END()
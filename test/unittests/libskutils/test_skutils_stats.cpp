@@ -0,0 +1,152 @@
+#include "test_skutils_helper.h"
+#include <skutils/stats.h>
+#include <test/tools/libtesteth/TestHelper.h>
+#include <boost/test/unit_test.hpp>
+
+namespace utf = boost::unit_test;
+
+BOOST_AUTO_TEST_SUITE( SkUtils )
+BOOST_AUTO_TEST_SUITE( stats )
+
+BOOST_AUTO_TEST_CASE( latency_histogram_keeps_values_within_a_sixteenth ) {
+    skutils::test::test_print_header_name(
+        "SkUtils/stats/latency_histogram_keeps_values_within_a_sixteenth" );
+    typedef skutils::stats::latency_histogram histogram;
+    for ( uint64_t n : {uint64_t( 0 ), uint64_t( 1 ), uint64_t( 15 ), uint64_t( 16 ),
+              uint64_t( 17 ), uint64_t( 1000 ), uint64_t( 123456789 ),
+              uint64_t( 1 ) << ( histogram::value_bits - 1 )} ) {
+        size_t idxBucket = histogram::bucket_of( n );
+        BOOST_REQUIRE_LT( idxBucket, histogram::bucket_count );
+        BOOST_REQUIRE_LE( histogram::bucket_lowest( idxBucket ), n );
+        BOOST_REQUIRE_GE( histogram::bucket_highest( idxBucket ), n );
+        BOOST_REQUIRE_LE( histogram::bucket_highest( idxBucket ) - n, n / 16 );
+    }
+    for ( size_t i = 1; i + 1 < histogram::bucket_count; ++i )
+        BOOST_REQUIRE_EQUAL(
+            histogram::bucket_lowest( i ), histogram::bucket_highest( i - 1 ) + 1 );
+    BOOST_REQUIRE_EQUAL( histogram::bucket_of( uint64_t( -1 ) ), histogram::bucket_count - 1 );
+
+    histogram h;
+    BOOST_REQUIRE_EQUAL( h.percentile( 50.0 ), 0 );
+    for ( uint64_t n = 1; n <= 10000; ++n )
+        h.add( n );
+    BOOST_REQUIRE_EQUAL( h.count(), 10000 );
+    BOOST_REQUIRE_EQUAL( h.min(), 1 );
+    BOOST_REQUIRE_EQUAL( h.max(), 10000 );
+    BOOST_REQUIRE_EQUAL( h.mean(), 5000.5 );
+    BOOST_REQUIRE_GE( h.percentile( 50.0 ), 5000 );
+    BOOST_REQUIRE_LE( h.percentile( 50.0 ), 5000 + 5000 / 16 );
+    BOOST_REQUIRE_GE( h.percentile( 99.0 ), 9900 );
+    BOOST_REQUIRE_LE( h.percentile( 99.0 ), 10000 );
+    BOOST_REQUIRE_EQUAL( h.percentile( 100.0 ), 10000 );
+    BOOST_REQUIRE_EQUAL( h.percentile( 0.0 ), 1 );
+
+    histogram copy( h );
+    copy.add( 20000 );
+    h.merge( copy );
+    BOOST_REQUIRE_EQUAL( h.count(), 20001 );
+    BOOST_REQUIRE_EQUAL( h.max(), 20000 );
+    BOOST_REQUIRE_EQUAL( h.toJSON( 0.001 )["max"].get< double >(), 20.0 );
+}
+
+BOOST_AUTO_TEST_CASE( sharded_counters_sum_up_all_threads ) {
+    skutils::test::test_print_header_name( "SkUtils/stats/sharded_counters_sum_up_all_threads" );
+    namespace sharded = skutils::stats::sharded;
+    static const size_t cntThreads = 4, cntCalls = 1000;
+    auto fnWork = []() {
+        for ( size_t i = 0; i < cntCalls; ++i ) {
+            sharded::register_call( "test/sharded", "eth_call", 10 );
+            sharded::register_answer( "test/sharded", "eth_call", 20 );
+            sharded::register_latency( "test/sharded", "eth_call", i + 1 );
+            if ( i % 10 == 0 )
+                sharded::register_error( "test/sharded", "eth_call" );
+        }
+        sharded::register_exception( "test/sharded", "eth_chainId" );
+    };
+    // shards of exited threads still count
+    std::vector< std::thread > threads;
+    for ( size_t idxThread = 0; idxThread < cntThreads; ++idxThread )
+        threads.emplace_back( fnWork );
+    for ( std::thread& t : threads )
+        t.join();
+    sharded::map_method_totals_t totals = sharded::collect( "test/sharded" );
+    BOOST_REQUIRE_EQUAL( totals.size(), 2 );
+    BOOST_REQUIRE_EQUAL( totals["eth_call"].calls_, cntThreads * cntCalls );
+    BOOST_REQUIRE_EQUAL( totals["eth_call"].answers_, cntThreads * cntCalls );
+    BOOST_REQUIRE_EQUAL( totals["eth_call"].errors_, cntThreads * cntCalls / 10 );
+    BOOST_REQUIRE_EQUAL( totals["eth_call"].bytes_recv_, cntThreads * cntCalls * 10 );
+    BOOST_REQUIRE_EQUAL( totals["eth_call"].bytes_sent_, cntThreads * cntCalls * 20 );
+    BOOST_REQUIRE_EQUAL( totals["eth_call"].latency_.count(), cntThreads * cntCalls );
+    BOOST_REQUIRE_EQUAL( totals["eth_call"].latency_.max(), cntCalls );
+    BOOST_REQUIRE_EQUAL( totals["eth_chainId"].exceptions_, cntThreads );
+    BOOST_REQUIRE_EQUAL( totals["eth_chainId"].latency_.count(), 0 );
+
+    // a live thread adds to what exited threads left
+    fnWork();
+    totals = sharded::collect( "test/sharded" );
+    BOOST_REQUIRE_EQUAL( totals["eth_call"].calls_, ( cntThreads + 1 ) * cntCalls );
+    BOOST_REQUIRE_EQUAL( totals["eth_chainId"].exceptions_, cntThreads + 1 );
+    BOOST_REQUIRE( sharded::collect( "test/sharded/none" ).empty() );
+}
+
+BOOST_AUTO_TEST_CASE( sharded_counters_contention,
+    *utf::label( "perf" ) * boost::unit_test::precondition( dev::test::run_not_express ) ) {
+    if ( !dev::test::Options::get().all ) {
+        std::cout << "Skipping test SkUtils/stats/sharded_counters_contention. Use --all to run "
+                     "it.\n";
+        return;
+    }
+    namespace sharded = skutils::stats::sharded;
+    static const char* g_methods[] = {"eth_call", "eth_getBalance", "eth_blockNumber",
+        "eth_getTransactionReceipt", "eth_sendRawTransaction", "eth_chainId"};
+    static const size_t cntMethods = sizeof( g_methods ) / sizeof( g_methods[0] );
+    static const size_t cntCalls = 200000;
+    // what every RPC call used to do: call and traffic queues behind one process-wide mutex
+    skutils::multithreading::recursive_mutex_type mtx( "RMTX-TEST-STATS" );
+    skutils::stats::named_event_stats cq, tq;
+    auto fnMutex = [&]( const char* strMethod ) {
+        std::lock_guard< skutils::multithreading::recursive_mutex_type > lock( mtx );
+        cq.event_queue_add( strMethod, 10 );
+        cq.event_add( strMethod );
+        tq.event_queue_add( strMethod, 10 );
+        tq.event_add( strMethod, 100 );
+    };
+    auto fnSharded = []( const char* strMethod ) {
+        sharded::register_call( "test/contention", strMethod, 100 );
+        sharded::register_latency( "test/contention", strMethod, 250 );
+    };
+    for ( size_t cntThreads : {1, 4, 16} ) {
+        for ( bool bSharded : {false, true} ) {
+            auto start = std::chrono::steady_clock::now();
+            std::vector< std::thread > threads;
+            for ( size_t idxThread = 0; idxThread < cntThreads; ++idxThread )
+                threads.emplace_back( [&, bSharded]() {
+                    for ( size_t i = 0; i < cntCalls; ++i ) {
+                        const char* strMethod = g_methods[i % cntMethods];
+                        if ( bSharded )
+                            fnSharded( strMethod );
+                        else
+                            fnMutex( strMethod );
+                    }
+                } );
+            for ( std::thread& t : threads )
+                t.join();
+            auto ns = std::chrono::duration_cast< std::chrono::nanoseconds >(
+                std::chrono::steady_clock::now() - start )
+                          .count();
+            std::cout << cntThreads << " threads, " << ( bSharded ? "sharded" : "mutex" ) << ": "
+                      << double( ns ) / ( cntCalls * cntThreads )
+                      << " ns of wall time per registered call\n";
+        }
+    }
+    auto start = std::chrono::steady_clock::now();
+    sharded::map_method_totals_t totals = sharded::collect( "test/contention" );
+    auto us = std::chrono::duration_cast< std::chrono::microseconds >(
+        std::chrono::steady_clock::now() - start )
+                  .count();
+    BOOST_REQUIRE_EQUAL( totals.size(), cntMethods );
+    std::cout << "collecting " << cntMethods << " methods took " << us << " us\n";
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,133 @@
+#include "test_skutils_helper.h"
+#include <skutils/task_performance.h>
+#include <test/tools/libtesteth/TestHelper.h>
+#include <boost/test/unit_test.hpp>
+
+namespace utf = boost::unit_test;
+namespace performance = skutils::task::performance;
+
+static const performance::trace_point g_trace_test{
+    "test/trace", "work", "thread", {"i", "answer"}};
+
+BOOST_AUTO_TEST_SUITE( SkUtils )
+BOOST_AUTO_TEST_SUITE( task_performance )
+
+BOOST_AUTO_TEST_CASE( trace_events_are_composed_on_fetch ) {
+    skutils::test::test_print_header_name(
+        "SkUtils/task_performance/trace_events_are_composed_on_fetch" );
+    performance::tracker_ptr pTracker = performance::get_default_tracker();
+    pTracker->cancel();
+    BOOST_REQUIRE( !performance::is_tracing() );
+    {  // nothing is recorded while the tracker is stopped
+        performance::trace_scope trace( g_trace_test, 1 );
+        BOOST_REQUIRE( !trace.is_active() );
+    }
+
+    pTracker->start();
+    BOOST_REQUIRE( performance::is_tracing() );
+    static const size_t cntThreads = 4, cntEvents = 100;
+    std::vector< std::thread > threads;
+    for ( size_t idxThread = 0; idxThread < cntThreads; ++idxThread )
+        threads.emplace_back( [idxThread]() {
+            for ( size_t i = 0; i < cntEvents; ++i ) {
+                performance::trace_scope trace(
+                    g_trace_test, "thread " + std::to_string( idxThread ), i );
+                trace.set_arg( 1, 42 );
+            }
+        } );
+    for ( std::thread& t : threads )
+        t.join();
+    {  // actions and trace events share indices and queues
+        performance::action a( "test/trace", "action" );
+    }
+
+    nlohmann::json jsn = pTracker->compose_json();
+    BOOST_REQUIRE_EQUAL( jsn["nextTimeFetchIndex"].get< size_t >(), cntThreads * cntEvents + 1 );
+    const nlohmann::json& jarr = jsn["queues"]["test/trace"];
+    BOOST_REQUIRE_EQUAL( jarr.size(), cntThreads * cntEvents + 1 );
+    const nlohmann::json& jo = jarr[jarr.size() - 1];
+    BOOST_REQUIRE_EQUAL( jo["name"].get< std::string >(), "work" );
+    BOOST_REQUIRE_EQUAL( jo["it"].get< size_t >(), cntThreads * cntEvents - 1 );
+    BOOST_REQUIRE_EQUAL( jo["jsnIn"]["answer"].get< uint64_t >(), 42 );
+    BOOST_REQUIRE_EQUAL( jo["jsnIn"]["thread"].get< std::string >().substr( 0, 7 ), "thread " );
+    BOOST_REQUIRE( jo["fin"].get< bool >() );
+
+    // only events from the given index on are fetched, in order of indices
+    std::vector< performance::trace_event > events =
+        performance::collect_trace_events( cntThreads * cntEvents - 10 );
+    BOOST_REQUIRE_EQUAL( events.size(), 10 );
+    for ( size_t i = 1; i < events.size(); ++i )
+        BOOST_REQUIRE_LT( events[i - 1].indexT, events[i].indexT );
+
+    // the session limit stops recording
+    pTracker->set_session_max_item_count( cntThreads * cntEvents + 2 );
+    {
+        performance::trace_scope trace( g_trace_test );
+        BOOST_REQUIRE( trace.is_active() );
+    }
+    {
+        performance::trace_scope trace( g_trace_test );
+        BOOST_REQUIRE( !trace.is_active() );
+    }
+    BOOST_REQUIRE_EQUAL(
+        pTracker->get_first_encountered_stop_reason(), "number of requested of events saved" );
+
+    // events of a stopped session are dropped
+    pTracker->stop();
+    pTracker->set_session_max_item_count( 0 );
+    BOOST_REQUIRE( !performance::is_tracing() );
+    BOOST_REQUIRE( performance::collect_trace_events().empty() );
+}
+
+BOOST_AUTO_TEST_CASE( trace_overhead,
+    *utf::label( "perf" ) * boost::unit_test::precondition( dev::test::run_not_express ) ) {
+    if ( !dev::test::Options::get().all ) {
+        std::cout << "Skipping test SkUtils/task_performance/trace_overhead. Use --all to run "
+                     "it.\n";
+        return;
+    }
+    performance::tracker_ptr pTracker = performance::get_default_tracker();
+    const std::string strMethod = "eth_getTransactionReceipt";
+    static const size_t cntCalls = 1000000;
+    for ( size_t cntThreads : {1, 4} ) {
+        for ( bool bIsTracing : {false, true} ) {
+            pTracker->cancel();
+            if ( bIsTracing )
+                pTracker->start();
+            auto start = std::chrono::steady_clock::now();
+            std::vector< std::thread > threads;
+            for ( size_t idxThread = 0; idxThread < cntThreads; ++idxThread )
+                threads.emplace_back( [&strMethod]() {
+                    for ( size_t i = 0; i < cntCalls; ++i ) {
+                        performance::trace_scope trace( g_trace_test, strMethod, i );
+                        trace.set_arg( 1, i * 2 );
+                    }
+                } );
+            for ( std::thread& t : threads )
+                t.join();
+            auto ns = std::chrono::duration_cast< std::chrono::nanoseconds >(
+                std::chrono::steady_clock::now() - start )
+                          .count();
+            std::cout << cntThreads << " threads, tracing " << ( bIsTracing ? "on" : "off" )
+                      << ": " << double( ns ) / ( cntCalls * cntThreads )
+                      << " ns of wall time per traced scope\n";
+        }
+    }
+    // call sites used to build names and json for an action even while it was skipped
+    pTracker->cancel();
+    auto start = std::chrono::steady_clock::now();
+    for ( size_t i = 0; i < cntCalls; ++i ) {
+        nlohmann::json jsn = nlohmann::json::object();
+        jsn["method"] = strMethod;
+        performance::action a( "test/action",
+            skutils::tools::format( "task %zu, %s", i, strMethod.c_str() ), jsn );
+    }
+    auto ns = std::chrono::duration_cast< std::chrono::nanoseconds >(
+        std::chrono::steady_clock::now() - start )
+                  .count();
+    std::cout << "1 thread, action with json while stopped: " << double( ns ) / cntCalls
+              << " ns of wall time per call\n";
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
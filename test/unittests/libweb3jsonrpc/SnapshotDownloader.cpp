@@ -0,0 +1,271 @@
+/** @file SnapshotDownloader.cpp
+ * Snapshot downloader test functions.
+ */
+
+#include <libdevcore/CommonIO.h>
+#include <libdevcore/SHA3.h>
+#include <libdevcore/TransientDirectory.h>
+#include <libweb3jsonrpc/SnapshotDownloader.h>
+#include <test/tools/libtesteth/TestOutputHelper.h>
+
+#include <skutils/http.h>
+
+#include <json.hpp>
+
+#include <boost/filesystem.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <atomic>
+#include <memory>
+#include <thread>
+
+using namespace std;
+using namespace dev;
+using namespace dev::test;
+using dev::rpc::snapshot::Downloader;
+
+namespace fs = boost::filesystem;
+
+namespace {
+size_t const c_chunkSize = 1000;
+
+bytes fileContents( unsigned _seed ) {
+    bytes ret( 20 * c_chunkSize + c_chunkSize / 2 );
+    for ( size_t i = 0; i < ret.size(); ++i )
+        ret[i] = uint8_t( i * 7 + i / 251 + _seed );
+    return ret;
+}
+
+h256 const c_state = sha3( "state" );
+
+// serves skale_getSnapshot and binary skale_downloadSnapshotFragment for one file
+class FakeNode {
+public:
+    FakeNode( fs::path const& _file, bool _corrupt, h256 const& _state = c_state )
+        : m_server( 4, false ), m_corrupt( _corrupt ), m_state( _state ) {
+        m_contents = dev::contents( _file );
+        m_chunkHashes = Downloader::chunkHashes( _file, c_chunkSize );
+        m_server.Post( "/", [this]( skutils::http::request const& _req,
+                                skutils::http::response& _res ) {
+            nlohmann::json const joRequest = nlohmann::json::parse( _req.body_ );
+            nlohmann::json const& joParams = joRequest["params"];
+            if ( joRequest["method"] == "skale_getSnapshot" ) {
+                nlohmann::json joResult = nlohmann::json::object();
+                joResult["snapshotHash"] = toHexPrefixed( m_state );
+                joResult["dataSize"] = m_contents.size();
+                joResult["maxAllowedChunkSize"] = c_chunkSize;
+                joResult["chunkHashes"] = nlohmann::json::array();
+                for ( h256 const& h : m_chunkHashes )
+                    joResult["chunkHashes"].push_back( toHexPrefixed( h ) );
+                nlohmann::json joResponse = nlohmann::json::object();
+                joResponse["jsonrpc"] = "2.0";
+                joResponse["id"] = joRequest["id"];
+                joResponse["result"] = joResult;
+                _res.set_content( joResponse.dump(), "application/json" );
+                return;
+            }
+            for ( size_t n = busy.load(); n > 0; n = busy.load() )
+                if ( busy.compare_exchange_weak( n, n - 1 ) ) {
+                    _res.set_header( "Retry-After", "1" );
+                    _res.status_ = 503;
+                    return;
+                }
+            size_t const from = joParams["from"].get< size_t >();
+            size_t const size = min( joParams["size"].get< size_t >(), m_contents.size() - from );
+            bytes fragment( m_contents.begin() + from, m_contents.begin() + from + size );
+            if ( m_corrupt )
+                fragment[0] ^= 1;
+            ++fragments;
+            _res.set_content( reinterpret_cast< char const* >( fragment.data() ), fragment.size(),
+                "application/octet-stream" );
+        } );
+        int const port = m_server.bind_to_any_port( 4, "127.0.0.1" );
+        url = "http://127.0.0.1:" + to_string( port );
+        m_thread = thread( [this]() { m_server.listen_after_bind(); } );
+    }
+
+    ~FakeNode() {
+        m_server.stop();
+        m_thread.join();
+    }
+
+    string url;
+    atomic< size_t > fragments{0};
+    atomic< size_t > busy{0};  ///< fragment requests to answer with 503
+
+private:
+    skutils::http::server m_server;
+    bool const m_corrupt;
+    h256 const m_state;
+    bytes m_contents;
+    h256s m_chunkHashes;
+    thread m_thread;
+};
+
+fs::path saveFile( fs::path const& _dir, string const& _name, bytes const& _contents ) {
+    fs::path const path = fs::path( _dir ) / _name;
+    dev::writeFile( path, _contents );
+    return path;
+}
+}  // namespace
+
+BOOST_FIXTURE_TEST_SUITE( SnapshotDownloaderSuite, TestOutputHelperFixture )
+
+BOOST_AUTO_TEST_CASE( downloadsFromAllNodesOfTheMajorityFile ) {
+    TransientDirectory td;
+    bytes const contents = fileContents( 0 );
+    fs::path const source = saveFile( td.path(), "source", contents );
+    fs::path const other = saveFile( td.path(), "other", fileContents( 1 ) );
+
+    // the node with the other state is outvoted, the corrupting one is dropped after failures
+    FakeNode good1( source, false ), good2( source, false ), corrupt( source, true ),
+        different( other, false, sha3( "other state" ) );
+    Downloader downloader(
+        {different.url, good1.url, corrupt.url, good2.url}, fs::path( td.path() ) / "snapshot" );
+    string error;
+    size_t lastDone = 0, lastTotal = 0;
+    BOOST_REQUIRE( downloader.download( 1,
+        [&]( size_t _done, size_t _total ) {
+            lastDone = _done;
+            lastTotal = _total;
+            return true;
+        },
+        error ) );
+    BOOST_REQUIRE( error.empty() );
+    BOOST_REQUIRE_EQUAL( lastDone, 21U );
+    BOOST_REQUIRE_EQUAL( lastTotal, 21U );
+
+    BOOST_REQUIRE( dev::contents( fs::path( td.path() ) / "snapshot" ) == contents );
+    BOOST_REQUIRE( !fs::exists( Downloader::progressPath( fs::path( td.path() ) / "snapshot" ) ) );
+
+    Downloader::Stats const stats = downloader.stats();
+    BOOST_REQUIRE_EQUAL( stats.chunks, 21U );
+    BOOST_REQUIRE_EQUAL( stats.downloaded, 21U );
+    BOOST_REQUIRE_EQUAL( stats.resumed, 0U );
+    BOOST_REQUIRE_EQUAL( stats.nodesUsed, 3U );
+    BOOST_REQUIRE_EQUAL( different.fragments.load(), 0U );
+    BOOST_REQUIRE_GT( good1.fragments.load(), 0U );
+    BOOST_REQUIRE_GT( good2.fragments.load(), 0U );
+    BOOST_REQUIRE_EQUAL( stats.failures, corrupt.fragments.load() );
+    // workers still fetching when the node is dropped may fail once more each
+    BOOST_REQUIRE_LE(
+        corrupt.fragments.load(), Downloader::c_maxNodeFailures + downloader.workersPerNode );
+
+    vector< string > const nodesUsed = downloader.nodesUsed();
+    BOOST_REQUIRE( find( nodesUsed.begin(), nodesUsed.end(), different.url ) == nodesUsed.end() );
+}
+
+BOOST_AUTO_TEST_CASE( nodesWithDifferentFilesOfTheSameStateAgree ) {
+    TransientDirectory td;
+    fs::path const first = saveFile( td.path(), "first", fileContents( 0 ) );
+    bytes const contents = fileContents( 1 );
+    fs::path const second = saveFile( td.path(), "second", contents );
+    fs::path const other = saveFile( td.path(), "other", fileContents( 2 ) );
+    fs::path const saveTo = fs::path( td.path() ) / "snapshot";
+
+    // two nodes of the state outvote the other one although no two of them serve the same bytes,
+    // the second node takes over once the first one is dropped
+    FakeNode different( other, false, sha3( "other state" ) ), failing( first, true ),
+        good( second, false );
+    Downloader downloader( {different.url, failing.url, good.url}, saveTo );
+    string error;
+    BOOST_REQUIRE( downloader.download( 1, []( size_t, size_t ) { return true; }, error ) );
+    BOOST_REQUIRE( dev::contents( saveTo ) == contents );
+    BOOST_REQUIRE( !fs::exists( Downloader::progressPath( saveTo ) ) );
+
+    BOOST_REQUIRE_EQUAL( different.fragments.load(), 0U );
+    BOOST_REQUIRE_GE( failing.fragments.load(), Downloader::c_maxNodeFailures );
+    BOOST_REQUIRE_EQUAL( good.fragments.load(), 21U );
+    Downloader::Stats const stats = downloader.stats();
+    BOOST_REQUIRE_EQUAL( stats.downloaded, 21U );
+    BOOST_REQUIRE_EQUAL( stats.nodesUsed, 1U );
+    BOOST_REQUIRE( downloader.nodesUsed() == vector< string >{good.url} );
+}
+
+BOOST_AUTO_TEST_CASE( usesOnlyNodesOfTheExpectedState ) {
+    TransientDirectory td;
+    bytes const contents = fileContents( 0 );
+    fs::path const source = saveFile( td.path(), "source", contents );
+    fs::path const other = saveFile( td.path(), "other", fileContents( 1 ) );
+    fs::path const saveTo = fs::path( td.path() ) / "snapshot";
+
+    FakeNode different1( other, false, sha3( "other state" ) ),
+        different2( other, false, sha3( "other state" ) ), good( source, false );
+    string error;
+    {
+        Downloader downloader( {different1.url, different2.url, good.url}, saveTo );
+        downloader.expectedStateHash = c_state;
+        BOOST_REQUIRE( downloader.download( 1, []( size_t, size_t ) { return true; }, error ) );
+        BOOST_REQUIRE( dev::contents( saveTo ) == contents );
+        BOOST_REQUIRE_EQUAL( different1.fragments.load() + different2.fragments.load(), 0U );
+    }
+
+    Downloader downloader( {different1.url, different2.url}, saveTo );
+    downloader.expectedStateHash = c_state;
+    BOOST_REQUIRE( !downloader.download( 1, []( size_t, size_t ) { return true; }, error ) );
+    BOOST_REQUIRE( downloader.nodesUsed().empty() );
+}
+
+BOOST_AUTO_TEST_CASE( resumesInterruptedDownload ) {
+    TransientDirectory td;
+    bytes const contents = fileContents( 0 );
+    fs::path const source = saveFile( td.path(), "source", contents );
+    fs::path const saveTo = fs::path( td.path() ) / "snapshot";
+
+    FakeNode node( source, false );
+    string error;
+    {
+        Downloader downloader( {node.url}, saveTo );
+        downloader.workersPerNode = 1;
+        BOOST_REQUIRE( !downloader.download(
+            1, [&]( size_t _done, size_t ) { return _done < 5; }, error ) );
+        BOOST_REQUIRE( !error.empty() );
+        BOOST_REQUIRE( fs::exists( Downloader::progressPath( saveTo ) ) );
+        // digest, then one appended record per finished chunk
+        BOOST_REQUIRE_EQUAL( fs::file_size( Downloader::progressPath( saveTo ) ), 32U + 5 * 4 );
+    }
+    size_t const fetched = node.fragments.load();
+
+    Downloader downloader( {node.url}, saveTo );
+    BOOST_REQUIRE( downloader.download( 1, []( size_t, size_t ) { return true; }, error ) );
+    BOOST_REQUIRE( dev::contents( saveTo ) == contents );
+
+    Downloader::Stats const stats = downloader.stats();
+    BOOST_REQUIRE_EQUAL( stats.resumed, 5U );
+    BOOST_REQUIRE_EQUAL( stats.downloaded, 16U );
+    BOOST_REQUIRE_EQUAL( node.fragments.load(), fetched + 16 );
+}
+
+BOOST_AUTO_TEST_CASE( waitsForBusyNode ) {
+    TransientDirectory td;
+    bytes const contents = fileContents( 0 );
+    fs::path const source = saveFile( td.path(), "source", contents );
+    fs::path const saveTo = fs::path( td.path() ) / "snapshot";
+
+    // more rejections than failures it takes to drop a node
+    FakeNode node( source, false );
+    node.busy = Downloader::c_maxNodeFailures + 1;
+    Downloader downloader( {node.url}, saveTo );
+    string error;
+    BOOST_REQUIRE( downloader.download( 1, []( size_t, size_t ) { return true; }, error ) );
+    BOOST_REQUIRE( dev::contents( saveTo ) == contents );
+
+    Downloader::Stats const stats = downloader.stats();
+    BOOST_REQUIRE_EQUAL( stats.throttled, Downloader::c_maxNodeFailures + 1 );
+    BOOST_REQUIRE_EQUAL( stats.failures, 0U );
+    BOOST_REQUIRE_EQUAL( stats.downloaded, 21U );
+}
+
+BOOST_AUTO_TEST_CASE( chunkHashesCoverTheFile ) {
+    TransientDirectory td;
+    bytes const contents = fileContents( 0 );
+    fs::path const source = saveFile( td.path(), "source", contents );
+
+    h256s const hashes = Downloader::chunkHashes( source, c_chunkSize );
+    BOOST_REQUIRE_EQUAL( hashes.size(), 21U );
+    BOOST_REQUIRE_EQUAL( hashes.front(), sha3( bytesConstRef( contents.data(), c_chunkSize ) ) );
+    BOOST_REQUIRE_EQUAL( hashes.back(),
+        sha3( bytesConstRef( contents.data() + 20 * c_chunkSize, c_chunkSize / 2 ) ) );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,189 @@
+/** @file SnapshotServer.cpp
+ * Snapshot fragment server test functions.
+ */
+
+#include <libdevcore/CommonIO.h>
+#include <libdevcore/TransientDirectory.h>
+#include <libweb3jsonrpc/SnapshotServer.h>
+#include <test/tools/libtesteth/TestOutputHelper.h>
+
+#include <skutils/http.h>
+
+#include <boost/filesystem.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <chrono>
+#include <thread>
+
+using namespace std;
+using namespace dev;
+using namespace dev::test;
+using dev::rpc::snapshot::BandwidthBudget;
+using dev::rpc::snapshot::FragmentServer;
+
+namespace fs = boost::filesystem;
+
+namespace {
+bytes fileContents() {
+    bytes ret( 3 * 1024 * 1024 + 17 );
+    for ( size_t i = 0; i < ret.size(); ++i )
+        ret[i] = uint8_t( i * 13 + i / 4099 );
+    return ret;
+}
+
+string bodyOf( bytes const& _contents, size_t _from, size_t _size ) {
+    return string( _contents.begin() + _from, _contents.begin() + _from + _size );
+}
+
+// GET /snapshot answers ranges, POST / sends the fragment given by "from" and "size" params
+class FragmentHttpServer {
+public:
+    explicit FragmentHttpServer( FragmentServer& _fragments ) : m_server( 4, false ) {
+        m_server.Get( "/snapshot",
+            [&_fragments]( skutils::http::request const& _req, skutils::http::response& _res ) {
+                _fragments.serveRange( _req, _res );
+            } );
+        m_server.Post( "/",
+            [&_fragments]( skutils::http::request const& _req, skutils::http::response& _res ) {
+                if ( !_fragments.serve( stoull( _req.get_param_value( "from" ) ),
+                         stoull( _req.get_param_value( "size" ) ), _req, _res ) )
+                    _res.status_ = 404;
+            } );
+        port = m_server.bind_to_any_port( 4, "127.0.0.1" );
+        m_thread = thread( [this]() { m_server.listen_after_bind(); } );
+    }
+
+    ~FragmentHttpServer() {
+        m_server.stop();
+        m_thread.join();
+    }
+
+    int port = 0;
+
+private:
+    skutils::http::server m_server;
+    thread m_thread;
+};
+}  // namespace
+
+BOOST_FIXTURE_TEST_SUITE( SnapshotServerSuite, TestOutputHelperFixture )
+
+BOOST_AUTO_TEST_CASE( servesRangesOfTheFile ) {
+    TransientDirectory td;
+    bytes const contents = fileContents();
+    fs::path const file = fs::path( td.path() ) / "snapshot";
+    writeFile( file, contents );
+
+    FragmentServer fragments( 0, 0 );
+    BOOST_REQUIRE_THROW( fragments.read( 0, 10 ), std::runtime_error );
+    fragments.open( file );
+    BOOST_REQUIRE_EQUAL( fragments.size(), contents.size() );
+
+    FragmentHttpServer server( fragments );
+    skutils::http::client cli( 4, "127.0.0.1", server.port );
+
+    auto res = cli.Get( "/snapshot" );
+    BOOST_REQUIRE( res );
+    BOOST_REQUIRE_EQUAL( res->status_, 200 );
+    BOOST_REQUIRE( res->body_ == bodyOf( contents, 0, contents.size() ) );
+
+    res = cli.Get( "/snapshot", {{"Range", "bytes=1000-1999999"}} );
+    BOOST_REQUIRE( res );
+    BOOST_REQUIRE_EQUAL( res->status_, 206 );
+    BOOST_REQUIRE( res->body_ == bodyOf( contents, 1000, 1999000 ) );
+    BOOST_REQUIRE_EQUAL( res->get_header_value( "Content-Range" ),
+        "bytes 1000-1999999/" + to_string( contents.size() ) );
+
+    res = cli.Get( "/snapshot", {{"Range", "bytes=-17"}} );
+    BOOST_REQUIRE( res );
+    BOOST_REQUIRE_EQUAL( res->status_, 206 );
+    BOOST_REQUIRE( res->body_ == bodyOf( contents, contents.size() - 17, 17 ) );
+
+    res = cli.Get( "/snapshot", {{"Range", "bytes=" + to_string( contents.size() ) + "-"}} );
+    BOOST_REQUIRE( res );
+    BOOST_REQUIRE_EQUAL( res->status_, 416 );
+
+    // fragments are cut at the end of the file
+    res = cli.Post( "/", skutils::http::map_params{{"from", to_string( contents.size() - 5 )},
+                             {"size", "1024"}} );
+    BOOST_REQUIRE( res );
+    BOOST_REQUIRE_EQUAL( res->status_, 200 );
+    BOOST_REQUIRE( res->body_ == bodyOf( contents, contents.size() - 5, 5 ) );
+    bytes const read = fragments.read( contents.size() - 5, 1024 );
+    BOOST_REQUIRE( read == bytes( contents.end() - 5, contents.end() ) );
+
+    // nothing is served once the file is closed
+    fragments.close();
+    res = cli.Get( "/snapshot" );
+    BOOST_REQUIRE( res );
+    BOOST_REQUIRE_EQUAL( res->status_, 404 );
+
+    FragmentServer::Stats const stats = fragments.stats();
+    BOOST_REQUIRE_EQUAL( stats.requests, 4U );
+    BOOST_REQUIRE_EQUAL( stats.bytes, contents.size() + 1999000 + 17 + 5 );
+}
+
+BOOST_AUTO_TEST_CASE( budgetRejectsPeersOverIt ) {
+    size_t const rate = 1024 * 1024;
+    BandwidthBudget budget( rate, 0 );
+
+    // a second's worth of bytes goes through at once, and is charged up front
+    BOOST_REQUIRE_EQUAL( budget.admit( "a", rate + rate / 2 ).count(), 0 );
+    BOOST_REQUIRE_EQUAL( budget.admit( "b", rate ).count(), 0 );
+
+    // then a peer in debt is told to come back once it is paid off, others are not affected
+    chrono::nanoseconds const wait = budget.admit( "a", 1 );
+    BOOST_REQUIRE( wait > chrono::milliseconds( 400 ) );
+    BOOST_REQUIRE( wait <= chrono::milliseconds( 500 ) );
+    BOOST_REQUIRE_EQUAL( budget.rejected(), 1U );
+    BOOST_REQUIRE_EQUAL( budget.admit( "c", rate / 2 ).count(), 0 );
+
+    budget.setBytesPerSecond( 0 );
+    BOOST_REQUIRE_EQUAL( budget.admit( "a", 100 * rate ).count(), 0 );
+}
+
+BOOST_AUTO_TEST_CASE( budgetIsSharedByAllPeers ) {
+    size_t const rate = 1024 * 1024;
+    BandwidthBudget budget( rate, rate );
+
+    BOOST_REQUIRE_EQUAL( budget.admit( "a", rate / 2 ).count(), 0 );
+    BOOST_REQUIRE_EQUAL( budget.admit( "b", rate ).count(), 0 );
+    // both peers are within their own budgets, but not all of them together
+    BOOST_REQUIRE( budget.admit( "c", 1 ) > chrono::milliseconds( 400 ) );
+    BOOST_REQUIRE( budget.admit( "a", 1 ) > chrono::milliseconds( 400 ) );
+    BOOST_REQUIRE_EQUAL( budget.rejected(), 2U );
+
+    budget.setTotalBytesPerSecond( 0 );
+    BOOST_REQUIRE_EQUAL( budget.admit( "c", rate ).count(), 0 );
+}
+
+BOOST_AUTO_TEST_CASE( answersRetryAfterOverBudget ) {
+    TransientDirectory td;
+    bytes const contents = fileContents();
+    fs::path const file = fs::path( td.path() ) / "snapshot";
+    writeFile( file, contents );
+
+    FragmentServer fragments( 0, 1024 * 1024 );
+    fragments.open( file );
+    FragmentHttpServer server( fragments );
+    skutils::http::client cli( 4, "127.0.0.1", server.port );
+
+    auto res = cli.Get( "/snapshot", {{"Range", "bytes=0-2097151"}} );
+    BOOST_REQUIRE( res );
+    BOOST_REQUIRE_EQUAL( res->status_, 206 );
+
+    // the server doesn't wait for the budget, the peer does
+    auto const start = chrono::steady_clock::now();
+    res = cli.Get( "/snapshot", {{"Range", "bytes=0-1023"}} );
+    BOOST_REQUIRE( chrono::steady_clock::now() - start < chrono::milliseconds( 500 ) );
+    BOOST_REQUIRE( res );
+    BOOST_REQUIRE_EQUAL( res->status_, 503 );
+    BOOST_REQUIRE( res->body_.empty() );
+    BOOST_REQUIRE_EQUAL( res->get_header_value( "Retry-After" ), "1" );
+
+    FragmentServer::Stats const stats = fragments.stats();
+    BOOST_REQUIRE_EQUAL( stats.requests, 1U );
+    BOOST_REQUIRE_EQUAL( stats.rejected, 1U );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
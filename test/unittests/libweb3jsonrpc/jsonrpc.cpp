@@ -30,6 +30,7 @@
 #include <libethereum/ClientTest.h>
 #include <libethereum/TransactionQueue.h>
 #include <libp2p/Network.h>
+#include <libskale/httpserveroverride.h>
 #include <libweb3jsonrpc/AccountHolder.h>
 #include <libweb3jsonrpc/AdminEth.h>
 #include <libweb3jsonrpc/JsonHelper.h>
@@ -762,6 +763,9 @@ contract Logger{
     logs = fixture.rpcClient->eth_getLogs(t);
     BOOST_REQUIRE(logs.isArray());
     BOOST_REQUIRE_EQUAL(logs.size(), 256+64);
+    // chain order, as with blooms
+    for(size_t i=1; i<logs.size(); ++i)
+        BOOST_REQUIRE_LE(dev::jsToU256(logs[(int)i-1]["blockNumber"].asString()), dev::jsToU256(logs[(int)i]["blockNumber"].asString()));
 
     // and filter
     res = fixture.rpcClient->eth_getFilterChanges(filterId);
@@ -1691,6 +1695,192 @@ BOOST_AUTO_TEST_CASE( setSchainExitTime ){
     BOOST_REQUIRE_THROW(fixture.rpcClient->setSchainExitTime(requestJson), jsonrpc::JsonRpcException);
 }
 
+// SkaleServerOverride without listeners, its jsoncpp fallback is the fixture's server
+struct NativeDispatchFixture : public JsonRpcFixture {
+    NativeDispatchFixture() : chainParams( client->chainParams() ) {
+        server = new SkaleServerOverride( chainParams, nullptr, 1, client.get(), "", -1, "", -1,
+            "", -1, "", -1, "", -1, "", -1, "", -1, "", -1, "", "", 1.0 );
+        rpcServer->addConnector( server );  // takes ownership
+    }
+    ~NativeDispatchFixture() { rpcServer.reset(); }  // server refers to chainParams
+
+    // what the server did for every call before native dispatch
+    string viaJsoncpp( string const& _request ) {
+        nlohmann::json joRequest = nlohmann::json::parse( _request );
+        string strResponse;
+        static_cast< jsonrpc::AbstractServerConnector* >( server )->GetHandler()->HandleRequest(
+            joRequest.dump(), strResponse );
+        return nlohmann::json::parse( strResponse ).dump();
+    }
+
+    string viaNative( string const& _request ) {
+        nlohmann::json joRequest = nlohmann::json::parse( _request );
+        string strResponse;
+        if ( !server->handleNativeRequest( joRequest, strResponse ) )
+            return string();
+        return strResponse;
+    }
+
+    ChainParams chainParams;
+    SkaleServerOverride* server;
+};
+
+string nativeDispatchRequest( string const& _method, string const& _params ) {
+    return "{\"jsonrpc\":\"2.0\",\"id\":17,\"method\":\"" + _method + "\",\"params\":[" +
+           _params + "]}";
+}
+
+BOOST_AUTO_TEST_CASE( native_dispatch_matches_jsoncpp ) {
+    NativeDispatchFixture fixture;
+    string address = "\"" + toJS( fixture.coinbase.address() ) + "\"";
+    dev::eth::simulateMining( *( fixture.client ), 1 );
+
+    vector< string > requests = {nativeDispatchRequest( "eth_blockNumber", "" ),
+        nativeDispatchRequest( "eth_chainId", "" ), nativeDispatchRequest( "eth_gasPrice", "" ),
+        nativeDispatchRequest( "eth_getBalance", address + ",\"latest\"" ),
+        nativeDispatchRequest( "eth_getTransactionCount", address + ",\"latest\"" ),
+        nativeDispatchRequest( "eth_getCode", address + ",\"latest\"" ),
+        nativeDispatchRequest( "eth_getStorageAt", address + ",\"0x0\",\"latest\"" ),
+        "{\"jsonrpc\":\"2.0\",\"id\":\"string id\",\"method\":\"eth_blockNumber\",\"params\":[]}"};
+    for ( string const& request : requests )
+        BOOST_REQUIRE_EQUAL( fixture.viaNative( request ), fixture.viaJsoncpp( request ) );
+
+    // anything unusual goes to jsoncpp, including errors
+    vector< string > fallbacks = {nativeDispatchRequest( "eth_getBalance", "\"0x12\",\"latest\"" ),
+        nativeDispatchRequest( "eth_getBalance", address ),
+        nativeDispatchRequest( "eth_blockNumber", "\"latest\"" ),
+        nativeDispatchRequest( "eth_accounts", "" ),
+        "{\"jsonrpc\":\"2.0\",\"id\":1.5,\"method\":\"eth_blockNumber\",\"params\":[]}",
+        "{\"jsonrpc\":\"1.0\",\"id\":1,\"method\":\"eth_blockNumber\",\"params\":[]}",
+        "{\"jsonrpc\":\"2.0\",\"id\":1,\"method\":\"eth_blockNumber\"}"};
+    for ( string const& request : fallbacks )
+        BOOST_REQUIRE( fixture.viaNative( request ).empty() );
+}
+
+BOOST_AUTO_TEST_CASE( batch_execution_keeps_order ) {
+    NativeDispatchFixture fixture;
+    fixture.server->maxParallelInBatchJsonRpcRequest_ = 4;
+    string address = "\"" + toJS( fixture.coinbase.address() ) + "\"";
+    vector< string > requests;
+    for ( size_t i = 0; i < 100; ++i )
+        requests.push_back( i % 2 ? nativeDispatchRequest( "eth_blockNumber", "" ) :
+                                    nativeDispatchRequest( "eth_getBalance", address + ",1" ) );
+
+    nlohmann::json jarrRequest = nlohmann::json::array();
+    for ( string const& request : requests )
+        jarrRequest.push_back( nlohmann::json::parse( request ) );
+    vector< string > responses( requests.size() );
+    fixture.server->executeBatch(
+        jarrRequest, [&]( size_t i ) { responses[i] = fixture.viaJsoncpp( requests[i] ); } );
+    nlohmann::json jarrAnswer =
+        nlohmann::json::parse( skale::server::helper::composeBatchAnswer( responses ) );
+    BOOST_REQUIRE_EQUAL( jarrAnswer.size(), requests.size() );
+    for ( size_t i = 0; i < requests.size(); ++i )
+        BOOST_REQUIRE_EQUAL( jarrAnswer[i].dump(), fixture.viaJsoncpp( requests[i] ) );
+
+    nlohmann::json joStats = fixture.server->batchStats();
+    BOOST_REQUIRE_EQUAL( joStats["count"].get< size_t >(), 1 );
+    BOOST_REQUIRE_EQUAL( joStats["items"].get< size_t >(), requests.size() );
+    BOOST_REQUIRE_EQUAL( joStats["maxSize"].get< size_t >(), requests.size() );
+}
+
+BOOST_AUTO_TEST_CASE( batch_execution_serializes_writes ) {
+    NativeDispatchFixture fixture;
+    fixture.server->maxParallelInBatchJsonRpcRequest_ = 4;
+    vector< string > methods = {"eth_blockNumber", "eth_getBalance", "eth_sendRawTransaction",
+        "eth_call", "eth_getTransactionReceipt", "personal_unlockAccount", "eth_blockNumber",
+        "eth_sendTransaction", "eth_getLogs", "eth_gasPrice", "eth_chainId"};
+    nlohmann::json jarrRequest = nlohmann::json::array();
+    for ( size_t i = 0; i < 40; ++i )
+        jarrRequest.push_back( nlohmann::json::parse(
+            nativeDispatchRequest( methods[i % methods.size()], "" ) ) );
+
+    // an element that changes state starts after all before it and runs alone
+    std::mutex mtx;
+    vector< size_t > started, finished;
+    std::atomic_size_t cntRunning{0};
+    std::atomic_bool bOverlapped{false};
+    fixture.server->executeBatch( jarrRequest, [&]( size_t i ) {
+        bool isParallelSafe = skale::server::helper::isParallelSafeBatchItem( jarrRequest[i] );
+        if ( ++cntRunning > 1 && !isParallelSafe )
+            bOverlapped = true;
+        {
+            std::lock_guard< std::mutex > lock( mtx );
+            if ( !isParallelSafe && finished.size() != i )
+                bOverlapped = true;
+            started.push_back( i );
+        }
+        std::this_thread::sleep_for( std::chrono::milliseconds( 1 ) );
+        if ( --cntRunning > 0 && !isParallelSafe )
+            bOverlapped = true;
+        std::lock_guard< std::mutex > lock( mtx );
+        finished.push_back( i );
+    } );
+    BOOST_REQUIRE( !bOverlapped );
+    BOOST_REQUIRE_EQUAL( finished.size(), jarrRequest.size() );
+
+    BOOST_REQUIRE( skale::server::helper::isParallelSafeBatchItem(
+        nlohmann::json::parse( nativeDispatchRequest( "eth_getBalance", "" ) ) ) );
+    BOOST_REQUIRE( !skale::server::helper::isParallelSafeBatchItem(
+        nlohmann::json::parse( nativeDispatchRequest( "eth_sendRawTransaction", "" ) ) ) );
+    BOOST_REQUIRE( !skale::server::helper::isParallelSafeBatchItem(
+        nlohmann::json::parse( nativeDispatchRequest( "personal_sendTransaction", "" ) ) ) );
+    BOOST_REQUIRE( !skale::server::helper::isParallelSafeBatchItem( nlohmann::json( 5 ) ) );
+}
+
+BOOST_AUTO_TEST_CASE( native_dispatch_performance,
+    *boost::unit_test::label( "perf" ) *
+        boost::unit_test::precondition( dev::test::run_not_express ) ) {
+    if ( !test::Options::get().all ) {
+        std::cout << "Skipping test native_dispatch_performance. Use --all to run it.\n";
+        return;
+    }
+
+    NativeDispatchFixture fixture;
+    string address = "\"" + toJS( fixture.coinbase.address() ) + "\"";
+    vector< string > requests = {nativeDispatchRequest( "eth_blockNumber", "" ),
+        nativeDispatchRequest( "eth_getBalance", address + ",\"latest\"" ),
+        nativeDispatchRequest( "eth_getTransactionCount", address + ",\"latest\"" ),
+        nativeDispatchRequest( "eth_getStorageAt", address + ",\"0x0\",\"latest\"" )};
+    size_t const iterations = 100000;
+
+    for ( string const& request : requests ) {
+        string method = nlohmann::json::parse( request )["method"].get< string >();
+        auto start = std::chrono::steady_clock::now();
+        for ( size_t i = 0; i < iterations; ++i )
+            fixture.viaJsoncpp( request );
+        double jsoncppSeconds =
+            std::chrono::duration< double >( std::chrono::steady_clock::now() - start ).count();
+        start = std::chrono::steady_clock::now();
+        for ( size_t i = 0; i < iterations; ++i )
+            fixture.viaNative( request );
+        double nativeSeconds =
+            std::chrono::duration< double >( std::chrono::steady_clock::now() - start ).count();
+        std::cout << method << ": jsoncpp " << iterations / jsoncppSeconds << " calls/s, native "
+                  << iterations / nativeSeconds << " calls/s\n";
+    }
+}
+
+BOOST_AUTO_TEST_CASE( stats_key_of_unknown_method ) {
+    NativeDispatchFixture fixture;
+    auto key = [&]( string const& _method ) {
+        return string( fixture.server->methodStatsKey( _method ) );
+    };
+    string const unknown = skutils::stats::time_tracker::element::g_strMethodNameUnknown;
+    // methods served by server itself are known without handler
+    BOOST_REQUIRE_EQUAL( key( "eth_blockNumber" ), "eth_blockNumber" );
+    BOOST_REQUIRE_EQUAL( key( "setSchainExitTime" ), "setSchainExitTime" );
+    BOOST_REQUIRE_EQUAL( key( "eth_accounts" ), unknown );
+
+    ModularServer<>* pRpcServer = fixture.rpcServer.get();
+    fixture.server->setKnownMethods(
+        [pRpcServer]( string const& _method ) { return pRpcServer->hasMethod( _method ); } );
+    BOOST_REQUIRE_EQUAL( key( "eth_accounts" ), "eth_accounts" );
+    BOOST_REQUIRE_EQUAL( key( "rpc_modules" ), "rpc_modules" );
+    BOOST_REQUIRE_EQUAL( key( "eth_accounts_" + toJS( 1 ) ), unknown );
+    BOOST_REQUIRE_EQUAL( key( "" ), unknown );
+}
+
 BOOST_FIXTURE_TEST_SUITE( RestrictedAddressSuite, RestrictedAddressFixture )
 
 BOOST_AUTO_TEST_CASE( direct_call ) {